@@ -179,6 +179,7 @@ public:
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const = 0; ///< get an array of bytes, needs to be overwritten by children.
 	Vector<uint8_t> get_buffer(int64_t p_length) const;
+	virtual const uint8_t *get_read_only_mapping() { return nullptr; } ///< read-only view of the whole file (get_length() bytes), valid until closed; nullptr if it can't be mapped (only POSIX platforms map files)
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
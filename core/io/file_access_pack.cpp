@@ -30,7 +30,10 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/file_access_memory.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
 #include "core/version.h"
@@ -68,29 +71,34 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 	}
 
 	if (!exists) {
-		// Search for directory.
-		PackedDir *cd = root;
-
-		if (simplified_path.contains("/")) { // In a subdirectory.
-			Vector<String> ds = simplified_path.get_base_dir().split("/");
-
-			for (int j = 0; j < ds.size(); j++) {
-				if (!cd->subdirs.has(ds[j])) {
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+		_flush_pending_dir_paths();
+		_add_dir_path(simplified_path);
+	}
+}
+
+void PackedData::_add_dir_path(const String &p_simplified_path) {
+	// Search for directory.
+	PackedDir *cd = root;
+
+	if (p_simplified_path.contains("/")) { // In a subdirectory.
+		Vector<String> ds = p_simplified_path.get_base_dir().split("/");
+
+		for (int j = 0; j < ds.size(); j++) {
+			if (!cd->subdirs.has(ds[j])) {
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		String filename = simplified_path.get_file();
-		// Don't add as a file if the path points to a directory.
-		if (!filename.is_empty()) {
-			cd->files.insert(filename);
-		}
+	}
+	String filename = p_simplified_path.get_file();
+	// Don't add as a file if the path points to a directory.
+	if (!filename.is_empty()) {
+		cd->files.insert(filename);
 	}
 }
 
@@ -101,11 +109,18 @@ void PackedData::remove_path(const String &p_path) {
 		return;
 	}
 
+	_flush_pending_dir_paths();
+	_remove_dir_path(simplified_path);
+
+	files.erase(pmd5);
+}
+
+void PackedData::_remove_dir_path(const String &p_simplified_path) {
 	// Search for directory.
 	PackedDir *cd = root;
 
-	if (simplified_path.contains("/")) { // In a subdirectory.
-		Vector<String> ds = simplified_path.get_base_dir().split("/");
+	if (p_simplified_path.contains("/")) { // In a subdirectory.
+		Vector<String> ds = p_simplified_path.get_base_dir().split("/");
 
 		for (int j = 0; j < ds.size(); j++) {
 			if (!cd->subdirs.has(ds[j])) {
@@ -116,11 +131,88 @@ void PackedData::remove_path(const String &p_path) {
 		}
 	}
 
-	cd->files.erase(simplified_path.get_file());
+	cd->files.erase(p_simplified_path.get_file());
+}
+
+uint32_t PackedData::add_path_table(const Vector<uint8_t> &p_path_table) {
+	MutexLock lock(pending_dir_paths_mutex);
+	path_tables.push_back(p_path_table);
+	return path_tables.size() - 1;
+}
+
+void PackedData::add_hashed_path(const String &p_pkg_path, const uint8_t *p_path_md5, uint32_t p_path_table, uint32_t p_path_ofs, uint32_t p_path_len, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_compressed) {
+	PathMD5 pmd5(p_path_md5);
+
+	bool exists = files.has(pmd5);
+
+	if (!exists || p_replace_files) {
+		PackedFile &pf = files[pmd5];
+		pf.encrypted = p_encrypted;
+		pf.compressed = p_compressed;
+		pf.pack = p_pkg_path;
+		pf.offset = p_ofs;
+		pf.size = p_size;
+		memcpy(pf.md5, p_md5, 16);
+		pf.src = p_src;
+	}
+
+	if (!exists) {
+		PendingDirPath pending;
+		pending.table = p_path_table;
+		pending.offset = p_path_ofs;
+		pending.length = p_path_len;
+		MutexLock lock(pending_dir_paths_mutex);
+		pending_dir_paths.push_back(pending);
+		has_pending_dir_paths.set();
+	}
+}
+
+void PackedData::remove_hashed_path(const uint8_t *p_path_md5, uint32_t p_path_table, uint32_t p_path_ofs, uint32_t p_path_len) {
+	PathMD5 pmd5(p_path_md5);
+	if (!files.has(pmd5)) {
+		return;
+	}
+
+	PendingDirPath pending;
+	pending.table = p_path_table;
+	pending.offset = p_path_ofs;
+	pending.length = p_path_len;
+	pending.removal = true;
+	{
+		MutexLock lock(pending_dir_paths_mutex);
+		pending_dir_paths.push_back(pending);
+		has_pending_dir_paths.set();
+	}
 
 	files.erase(pmd5);
 }
 
+void PackedData::_flush_pending_dir_paths() {
+	if (likely(!has_pending_dir_paths.is_set())) {
+		return;
+	}
+
+	MutexLock lock(pending_dir_paths_mutex);
+	for (const PendingDirPath &E : pending_dir_paths) {
+		const Vector<uint8_t> &table = path_tables[E.table];
+		ERR_CONTINUE(E.offset + (uint64_t)E.length > (uint64_t)table.size());
+		String path;
+		path.parse_utf8((const char *)table.ptr() + E.offset, E.length);
+		if (E.removal) {
+			_remove_dir_path(path);
+		} else {
+			_add_dir_path(path);
+		}
+	}
+	pending_dir_paths.reset();
+	has_pending_dir_paths.clear();
+}
+
+PackedData::PackedDir *PackedData::_get_root() {
+	_flush_pending_dir_paths();
+	return root;
+}
+
 void PackedData::add_pack_source(PackSource *p_source) {
 	if (p_source != nullptr) {
 		sources.push_back(p_source);
@@ -138,9 +230,24 @@ uint8_t *PackedData::get_file_hash(const String &p_path) {
 	return E->value.md5;
 }
 
+bool PackedData::get_file_location(const String &p_path, String &r_pack, uint64_t &r_offset, uint64_t &r_size) const {
+	String simplified_path = p_path.simplify_path().trim_prefix("res://");
+	PathMD5 pmd5(simplified_path.md5_buffer());
+	HashMap<PathMD5, PackedFile, PathMD5>::ConstIterator E = files.find(pmd5);
+	if (!E) {
+		return false;
+	}
+
+	r_pack = E->value.pack;
+	r_offset = E->value.offset;
+	r_size = E->value.size;
+	return true;
+}
+
 HashSet<String> PackedData::get_file_paths() const {
+	PackedDir *dirs = const_cast<PackedData *>(this)->_get_root();
 	HashSet<String> file_paths;
-	_get_file_paths(root, root->name, file_paths);
+	_get_file_paths(dirs, dirs->name, file_paths);
 	return file_paths;
 }
 
@@ -154,8 +261,42 @@ void PackedData::_get_file_paths(PackedDir *p_dir, const String &p_parent_dir, H
 	}
 }
 
+const uint8_t *PackedData::get_pack_mapping(const String &p_pack, Ref<FileAccess> &r_owner, uint64_t &r_length) {
+	MutexLock lock(pack_mappings_mutex);
+
+	HashMap<String, PackMapping>::Iterator E = pack_mappings.find(p_pack);
+	if (!E) {
+		// Failures are kept too, so that unmappable packs are only tried once.
+		PackMapping mapping;
+		mapping.file = FileAccess::open(p_pack, FileAccess::READ);
+		if (mapping.file.is_valid()) {
+			mapping.data = mapping.file->get_read_only_mapping();
+			mapping.length = mapping.file->get_length();
+		}
+		if (!mapping.data) {
+			mapping.file.unref();
+		}
+		E = pack_mappings.insert(p_pack, mapping);
+	}
+
+	r_owner = E->value.file;
+	r_length = E->value.length;
+	return E->value.data;
+}
+
 void PackedData::clear() {
 	files.clear();
+	{
+		MutexLock lock(pending_dir_paths_mutex);
+		pending_dir_paths.clear();
+		path_tables.clear();
+		has_pending_dir_paths.clear();
+	}
+	{
+		// Files still open keep their own reference to the mapping.
+		MutexLock lock(pack_mappings_mutex);
+		pack_mappings.clear();
+	}
 	_free_packed_dirs(root);
 	root = memnew(PackedDir);
 }
@@ -265,11 +406,15 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, vformat("Pack version unsupported: %d.", version));
+	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION && version != PACK_FORMAT_VERSION_INDEXED, false, vformat("Pack version unsupported: %d.", version));
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, vformat("Pack created with a newer version of the engine: %d.%d.", ver_major, ver_minor));
 
 	uint32_t pack_flags = f->get_32();
 	uint64_t file_base = f->get_64();
+	uint64_t dir_base = 0;
+	if (version == PACK_FORMAT_VERSION_INDEXED) {
+		dir_base = f->get_64(); // Relative to the start of the pack.
+	}
 
 	bool enc_directory = (pack_flags & PACK_DIR_ENCRYPTED);
 	bool rel_filebase = (pack_flags & PACK_REL_FILEBASE);
@@ -279,6 +424,10 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f->get_32();
 	}
 
+	if (version == PACK_FORMAT_VERSION_INDEXED) {
+		f->seek(pck_start_pos + dir_base);
+	}
+
 	int file_count = f->get_32();
 
 	if (rel_filebase) {
@@ -301,6 +450,10 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
+	if (version == PACK_FORMAT_VERSION_INDEXED) {
+		return _read_indexed_directory(f, p_path, file_count, file_base + p_offset, p_replace_files);
+	}
+
 	for (int i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -327,6 +480,40 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 	return true;
 }
 
+bool PackedSourcePCK::_read_indexed_directory(Ref<FileAccess> p_f, const String &p_path, uint32_t p_file_count, uint64_t p_file_base, bool p_replace_files) {
+	// The index is made of fixed-size entries keyed by the MD5 of their path, which is what PackedData looks files up by,
+	// so it's read in one go and nothing needs to be hashed or parsed per file. Paths are kept as a table for directory listings.
+	uint32_t path_table_size = p_f->get_32();
+	Vector<uint8_t> path_table;
+	path_table.resize(path_table_size);
+	ERR_FAIL_COND_V_MSG(p_f->get_buffer(path_table.ptrw(), path_table_size) != path_table_size, false, "Pack directory is truncated.");
+
+	Vector<uint8_t> index;
+	index.resize((uint64_t)p_file_count * PACK_INDEX_ENTRY_SIZE);
+	ERR_FAIL_COND_V_MSG(p_f->get_buffer(index.ptrw(), index.size()) != (uint64_t)index.size(), false, "Pack directory is truncated.");
+
+	PackedData *packed_data = PackedData::get_singleton();
+	uint32_t table = packed_data->add_path_table(path_table);
+	const uint8_t *entry = index.ptr();
+	for (uint32_t i = 0; i < p_file_count; i++, entry += PACK_INDEX_ENTRY_SIZE) {
+		// Path MD5 (16), path offset (4), path length (4), data offset (8), size (8), MD5 (16), flags (4).
+		uint32_t path_ofs = decode_uint32(entry + 16);
+		uint32_t path_len = decode_uint32(entry + 20);
+		uint64_t ofs = decode_uint64(entry + 24);
+		uint64_t size = decode_uint64(entry + 32);
+		uint32_t flags = decode_uint32(entry + 56);
+		ERR_CONTINUE_MSG((uint64_t)path_ofs + path_len > path_table_size, "Pack directory entry has an invalid path.");
+
+		if (flags & PACK_FILE_REMOVAL) { // The file was removed.
+			packed_data->remove_hashed_path(entry, table, path_ofs, path_len);
+		} else {
+			packed_data->add_hashed_path(p_path, entry, table, path_ofs, path_len, p_file_base + ofs, size, entry + 40, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED), (flags & PACK_FILE_COMPRESSED));
+		}
+	}
+
+	return true;
+}
+
 Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
 	return memnew(FileAccessPack(p_path, *p_file));
 }
@@ -399,6 +586,15 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_read_only_mapping() {
+	ERR_FAIL_COND_V_MSG(f.is_null(), nullptr, "File must be opened before use.");
+
+	if (pf.encrypted || pf.compressed || mapped_pack.is_null()) {
+		return nullptr;
+	}
+	return f->get_read_only_mapping();
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
 
@@ -427,15 +623,31 @@ bool FileAccessPack::file_exists(const String &p_name) {
 
 void FileAccessPack::close() {
 	f = Ref<FileAccess>();
+	mapped_pack = Ref<FileAccess>();
 }
 
 FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
-	ERR_FAIL_COND_MSG(f.is_null(), vformat("Can't open pack-referenced file '%s'.", String(pf.pack)));
+		pf(p_file) {
+	uint64_t pack_length = 0;
+	const uint8_t *pack_data = PackedData::get_singleton()->get_pack_mapping(pf.pack, mapped_pack, pack_length);
+	// The size is the one of the plain file. The stored data of encrypted or compressed files has another size, only
+	// known once its header is parsed, so they get the rest of the pack.
+	const bool stored_as_is = !pf.encrypted && !pf.compressed;
+	if (pack_data && (stored_as_is ? pf.offset + pf.size <= pack_length : pf.offset < pack_length)) {
+		// Read straight from the pages of the mapped pack, without opening it again.
+		Ref<FileAccessMemory> fam;
+		fam.instantiate();
+		fam->open_custom(pack_data + pf.offset, stored_as_is ? pf.size : pack_length - pf.offset);
+		f = fam;
+		off = 0;
+	} else {
+		mapped_pack = Ref<FileAccess>();
+		f = FileAccess::open(pf.pack, FileAccess::READ);
+		ERR_FAIL_COND_MSG(f.is_null(), vformat("Can't open pack-referenced file '%s'.", String(pf.pack)));
 
-	f->seek(pf.offset);
-	off = pf.offset;
+		f->seek(pf.offset);
+		off = pf.offset;
+	}
 
 	if (pf.encrypted) {
 		Ref<FileAccessEncrypted> fae;
@@ -453,6 +665,19 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		f = fae;
 		off = 0;
 	}
+
+	if (pf.compressed) {
+		// Stored in the FileAccessCompressed layout, so only the blocks being read are decompressed.
+		uint32_t magic = f->get_32();
+		ERR_FAIL_COND_MSG(magic != PACK_COMPRESSED_FILE_MAGIC, vformat("Compressed pack-referenced file '%s' is corrupted.", String(pf.pack)));
+
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		Error err = fac->open_after_magic(f);
+		ERR_FAIL_COND_MSG(err, vformat("Can't open compressed pack-referenced file '%s'.", String(pf.pack)));
+		f = fac;
+		off = 0;
+	}
 	pos = 0;
 	eof = false;
 }
@@ -543,7 +768,7 @@ PackedData::PackedDir *DirAccessPack::_find_dir(const String &p_dir) {
 	PackedData::PackedDir *pd;
 
 	if (absolute) {
-		pd = PackedData::get_singleton()->root;
+		pd = PackedData::get_singleton()->_get_root();
 	} else {
 		pd = current;
 	}
@@ -622,5 +847,5 @@ String DirAccessPack::get_filesystem_type() const {
 }
 
 DirAccessPack::DirAccessPack() {
-	current = PackedData::get_singleton()->root;
+	current = PackedData::get_singleton()->_get_root();
 }
@@ -33,15 +33,27 @@
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
+#include "core/templates/safe_refcount.h"
 
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
 #define PACK_FORMAT_VERSION 2
+// Packed file format version with a fixed-size directory index keyed by path hash, written after the file data.
+// Files with the same contents are stored once, and files can be stored block-compressed.
+#define PACK_FORMAT_VERSION_INDEXED 3
+// Size of an entry in the directory index of indexed packs.
+#define PACK_INDEX_ENTRY_SIZE 60
+// Compressed files are stored in the FileAccessCompressed layout with this magic ("GCPF" in ASCII).
+#define PACK_COMPRESSED_FILE_MAGIC 0x46504347
+// Uncompressed size of the blocks compressed files are split in, which is the unit of random access.
+#define PACK_COMPRESSION_BLOCK_SIZE 65536
 
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0,
@@ -51,6 +63,7 @@ enum PackFlags {
 enum PackFileFlags {
 	PACK_FILE_ENCRYPTED = 1 << 0,
 	PACK_FILE_REMOVAL = 1 << 1,
+	PACK_FILE_COMPRESSED = 1 << 2,
 };
 
 class PackSource;
@@ -68,6 +81,7 @@ public:
 		uint8_t md5[16];
 		PackSource *src = nullptr;
 		bool encrypted;
+		bool compressed = false;
 	};
 
 private:
@@ -96,6 +110,11 @@ private:
 			a = *((uint64_t *)&p_buf[0]);
 			b = *((uint64_t *)&p_buf[8]);
 		}
+
+		explicit PathMD5(const uint8_t *p_buf) {
+			memcpy(&a, p_buf, 8);
+			memcpy(&b, p_buf + 8, 8);
+		}
 	};
 
 	HashMap<PathMD5, PackedFile, PathMD5> files;
@@ -104,17 +123,51 @@ private:
 
 	PackedDir *root = nullptr;
 
+	// Paths of files added by hash are only parsed into the directory tree once it's needed.
+	struct PendingDirPath {
+		uint32_t table = 0;
+		uint32_t offset = 0;
+		uint32_t length = 0;
+		bool removal = false;
+	};
+	LocalVector<Vector<uint8_t>> path_tables;
+	LocalVector<PendingDirPath> pending_dir_paths;
+	BinaryMutex pending_dir_paths_mutex;
+	SafeFlag has_pending_dir_paths; // Lets directory accesses skip the mutex once everything is parsed.
+
+	// Read-only mappings of whole pack files, created when a file is first opened from them. Files opened
+	// from a mapped pack are views into it, and keep `file` (which owns the mapping) alive.
+	struct PackMapping {
+		Ref<FileAccess> file;
+		const uint8_t *data = nullptr;
+		uint64_t length = 0;
+	};
+	HashMap<String, PackMapping> pack_mappings;
+	BinaryMutex pack_mappings_mutex;
+
 	static PackedData *singleton;
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
 	void _get_file_paths(PackedDir *p_dir, const String &p_parent_dir, HashSet<String> &r_paths) const;
+	void _add_dir_path(const String &p_simplified_path);
+	void _remove_dir_path(const String &p_simplified_path);
+	void _flush_pending_dir_paths();
+	PackedDir *_get_root();
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
 	void remove_path(const String &p_path);
+	// For sources with a hashed index: p_path_md5 is the MD5 of the simplified path, which is read from a table
+	// registered with add_path_table() when directories are first accessed.
+	uint32_t add_path_table(const Vector<uint8_t> &p_path_table);
+	void add_hashed_path(const String &p_pkg_path, const uint8_t *p_path_md5, uint32_t p_path_table, uint32_t p_path_ofs, uint32_t p_path_len, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, bool p_compressed);
+	void remove_hashed_path(const uint8_t *p_path_md5, uint32_t p_path_table, uint32_t p_path_ofs, uint32_t p_path_len);
 	uint8_t *get_file_hash(const String &p_path);
+	bool get_file_location(const String &p_path, String &r_pack, uint64_t &r_offset, uint64_t &r_size) const;
+	// Returns nullptr if the pack can't be mapped, in which case files are read through FileAccess.
+	const uint8_t *get_pack_mapping(const String &p_pack, Ref<FileAccess> &r_owner, uint64_t &r_length);
 	HashSet<String> get_file_paths() const;
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
@@ -143,6 +196,8 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	bool _read_indexed_directory(Ref<FileAccess> p_f, const String &p_path, uint32_t p_file_count, uint64_t p_file_base, bool p_replace_files);
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
@@ -156,6 +211,7 @@ class FileAccessPack : public FileAccess {
 	uint64_t off;
 
 	Ref<FileAccess> f;
+	Ref<FileAccess> mapped_pack; // Set if `f` is a view of the mapped pack, keeps the mapping alive.
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
 	virtual uint64_t _get_modified_time(const String &p_file) override { return 0; }
 	virtual BitField<FileAccess::UnixPermissionFlags> _get_unix_permissions(const String &p_file) override { return 0; }
@@ -177,6 +233,7 @@ public:
 	virtual bool eof_reached() const override;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_read_only_mapping() override;
 
 	virtual void set_big_endian(bool p_big_endian) override;
 
@@ -0,0 +1,294 @@
+/**************************************************************************/
+/*  file_prefetcher.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "file_prefetcher.h"
+
+#include "core/config/project_settings.h"
+#include "core/io/file_access.h"
+#include "core/io/file_access_pack.h"
+#include "core/io/resource_importer.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_uid.h"
+#include "core/os/os.h"
+
+// Size of the reads done by the I/O thread.
+static const uint64_t PREFETCH_READ_SIZE = 256 * 1024;
+// Larger files are only read up to this size, as they're unlikely to stay cached until loaded.
+static const uint64_t PREFETCH_MAX_FILE_SIZE = 64 * 1024 * 1024;
+// Dependencies read ahead for a single file, to bound the reads done for resources with many of them.
+static const int PREFETCH_MAX_DEPENDENCIES = 64;
+// Number of recently requested paths that are remembered to avoid reading them twice.
+static const uint32_t PREFETCH_MAX_REQUESTED = 4096;
+
+FilePrefetcher *FilePrefetcher::singleton = nullptr;
+
+void FilePrefetcher::_thread_func(void *p_userdata) {
+	FilePrefetcher *prefetcher = (FilePrefetcher *)p_userdata;
+
+	while (true) {
+		prefetcher->semaphore.wait();
+		if (prefetcher->exit_thread.is_set()) {
+			break;
+		}
+
+		LocalVector<Request> batch;
+		{
+			MutexLock lock(prefetcher->mutex);
+			SWAP(batch, prefetcher->queue);
+		}
+		if (!batch.is_empty()) {
+			prefetcher->_process_batch(batch);
+		}
+	}
+}
+
+void FilePrefetcher::_queue(const String &p_path, int p_dependency_depth) {
+	Request request;
+	request.path = p_path;
+	request.dependency_depth = p_dependency_depth;
+
+	MutexLock lock(mutex);
+	if (exit_thread.is_set()) {
+		return;
+	}
+	queue.push_back(request);
+	queue_depth.increment();
+	semaphore.post();
+}
+
+bool FilePrefetcher::_mark_requested(const String &p_path) {
+	MutexLock lock(mutex);
+	if (requested.has(p_path)) {
+		return false;
+	}
+	if (requested.size() >= PREFETCH_MAX_REQUESTED) {
+		requested.clear();
+	}
+	requested.insert(p_path);
+	return true;
+}
+
+bool FilePrefetcher::_locate(const String &p_path, Read &r_read) const {
+	if (ResourceCache::has(p_path)) {
+		return false; // Already loaded.
+	}
+
+	// Find the file that will actually be loaded.
+	String path = ResourceLoader::path_remap(p_path);
+	if (ResourceFormatImporter::get_singleton()) {
+		String imported_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(path);
+		if (!imported_path.is_empty()) {
+			path = imported_path;
+		}
+	}
+
+	PackedData *packed_data = PackedData::get_singleton();
+	if (packed_data && !packed_data->is_disabled() && packed_data->get_file_location(path, r_read.file, r_read.offset, r_read.size)) {
+		return true;
+	}
+
+	if (!FileAccess::exists(path)) {
+		return false;
+	}
+	r_read.file = path;
+	r_read.offset = 0;
+	r_read.size = UINT64_MAX;
+	return true;
+}
+
+void FilePrefetcher::_locate_dependencies(const Request &p_request, LocalVector<Read> &r_reads) {
+	// Only the built-in formats, which list their dependencies in their header.
+	String path = ResourceLoader::path_remap(p_request.path);
+	if (ResourceFormatImporter::get_singleton()) {
+		String imported_path = ResourceFormatImporter::get_singleton()->get_internal_resource_path(path);
+		if (!imported_path.is_empty()) {
+			path = imported_path;
+		}
+	}
+	String extension = path.get_extension().to_lower();
+	if (extension != "res" && extension != "scn" && extension != "tres" && extension != "tscn") {
+		return;
+	}
+
+	List<String> dependencies;
+	ResourceLoader::get_dependencies(p_request.path, &dependencies);
+	int count = 0;
+	for (const String &dependency : dependencies) {
+		if (count == PREFETCH_MAX_DEPENDENCIES) {
+			break;
+		}
+
+		// Dependencies are either a path, or a UID with the path as fallback.
+		String path = dependency.get_slice("::", 0);
+		if (path.begins_with("uid://")) {
+			ResourceUID::ID id = ResourceUID::get_singleton()->text_to_id(path);
+			if (ResourceUID::get_singleton()->has_id(id)) {
+				path = ResourceUID::get_singleton()->get_id_path(id);
+			} else {
+				path = dependency.get_slice("::", 2);
+			}
+		}
+		if (path.is_empty() || !_mark_requested(path)) {
+			continue;
+		}
+
+		Read read;
+		if (_locate(path, read)) {
+			read.path = path;
+			read.dependency_depth = p_request.dependency_depth - 1;
+			r_reads.push_back(read);
+			queue_depth.increment();
+			count++;
+		}
+	}
+}
+
+void FilePrefetcher::_process_batch(const LocalVector<Request> &p_batch) {
+	LocalVector<Read> reads;
+	for (const Request &request : p_batch) {
+		if (exit_thread.is_set()) {
+			return;
+		}
+		_locate_dependencies(request, reads);
+		queue_depth.decrement();
+	}
+
+	// Read files in the same pack in order, reusing the same handle.
+	reads.sort();
+
+	Ref<FileAccess> f;
+	Vector<uint8_t> buffer;
+	buffer.resize(PREFETCH_READ_SIZE);
+	for (const Read &read : reads) {
+		if (exit_thread.is_set()) {
+			return;
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		if (f.is_null() || f->get_path() != read.file) {
+			f = FileAccess::open(read.file, FileAccess::READ);
+		}
+		uint64_t total = 0;
+		if (f.is_valid()) {
+			uint64_t size = MIN(MIN(read.size, PREFETCH_MAX_FILE_SIZE), f->get_length() - MIN(read.offset, f->get_length()));
+			f->seek(read.offset);
+			while (total < size && !exit_thread.is_set()) {
+				uint64_t r = f->get_buffer(buffer.ptrw(), MIN(PREFETCH_READ_SIZE, size - total));
+				if (r == 0) {
+					break;
+				}
+				total += r;
+			}
+		}
+		read_usec.add(OS::get_singleton()->get_ticks_usec() - begin);
+		bytes_read.add(total);
+		files_read.increment();
+
+		// Its dependencies are looked up once it is cached.
+		if (read.dependency_depth > 0) {
+			_queue(read.path, read.dependency_depth);
+		}
+		queue_depth.decrement();
+	}
+}
+
+void FilePrefetcher::_set_enabled(bool p_enabled) {
+	if (!started) {
+		max_dependency_depth = GLOBAL_GET("filesystem/prefetch/dependency_depth");
+		started = true;
+	}
+#ifdef THREADS_ENABLED
+	enabled = p_enabled;
+	if (enabled && !thread.is_started()) {
+		thread.start(&FilePrefetcher::_thread_func, this);
+	}
+#endif
+}
+
+void FilePrefetcher::prefetch(const String &p_path) {
+	{
+		MutexLock lock(mutex);
+		if (!started) {
+			if (exit_thread.is_set()) {
+				return; // Finished.
+			}
+			_set_enabled(GLOBAL_GET("filesystem/prefetch/enabled"));
+		}
+		if (!enabled || max_dependency_depth <= 0) {
+			return;
+		}
+	}
+
+	// The file itself is about to be read by its loader, only its dependencies are read ahead.
+	if (_mark_requested(p_path)) {
+		_queue(p_path, max_dependency_depth);
+	}
+}
+
+void FilePrefetcher::set_enabled(bool p_enabled) {
+	MutexLock lock(mutex);
+	ERR_FAIL_COND_MSG(exit_thread.is_set(), "The file prefetcher has already finished.");
+	_set_enabled(p_enabled);
+}
+
+bool FilePrefetcher::is_enabled() const {
+	MutexLock lock(mutex);
+	return enabled;
+}
+
+double FilePrefetcher::get_throughput() const {
+	uint64_t usec = read_usec.get();
+	if (usec == 0) {
+		return 0;
+	}
+	return double(bytes_read.get()) * 1000000.0 / double(usec);
+}
+
+void FilePrefetcher::finish() {
+	{
+		MutexLock lock(mutex);
+		exit_thread.set();
+		queue.clear();
+	}
+	if (thread.is_started()) {
+		semaphore.post();
+		thread.wait_to_finish();
+	}
+	queue_depth.set(0);
+}
+
+FilePrefetcher::FilePrefetcher() {
+	singleton = this;
+}
+
+FilePrefetcher::~FilePrefetcher() {
+	finish();
+	singleton = nullptr;
+}
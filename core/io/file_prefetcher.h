@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*  file_prefetcher.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FILE_PREFETCHER_H
+#define FILE_PREFETCHER_H
+
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// Reads the dependencies of threaded resource loads ahead, from a single I/O thread, so
+// the OS cache can serve the loader tasks' reads. The requested file is left to its own
+// loader; its dependencies are looked up, through remaps and imports, and read while it
+// is being loaded, up to a configurable depth. Files found while a batch is being read
+// are read together in the next batch, ordered by location, so reads from concurrent
+// loads become mostly sequential.
+class FilePrefetcher {
+	static FilePrefetcher *singleton;
+
+	struct Request {
+		String path;
+		int dependency_depth = 0;
+	};
+
+	struct Read {
+		String file; // The pack containing the file, or the file itself.
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		String path;
+		int dependency_depth = 0;
+
+		bool operator<(const Read &p_read) const { return file == p_read.file ? offset < p_read.offset : file < p_read.file; }
+	};
+
+	Thread thread;
+	mutable BinaryMutex mutex;
+	Semaphore semaphore;
+	LocalVector<Request> queue;
+	HashSet<String> requested; // Recently requested paths, which don't need to be read again.
+	bool started = false;
+	bool enabled = false;
+	int max_dependency_depth = 0;
+	SafeFlag exit_thread;
+
+	SafeNumeric<uint32_t> queue_depth;
+	SafeNumeric<uint64_t> bytes_read;
+	SafeNumeric<uint64_t> files_read;
+	SafeNumeric<uint64_t> read_usec;
+
+	static void _thread_func(void *p_userdata);
+	void _queue(const String &p_path, int p_dependency_depth);
+	bool _mark_requested(const String &p_path);
+	void _process_batch(const LocalVector<Request> &p_batch);
+	void _locate_dependencies(const Request &p_request, LocalVector<Read> &r_reads);
+	bool _locate(const String &p_path, Read &r_read) const;
+	void _set_enabled(bool p_enabled);
+
+public:
+	static FilePrefetcher *get_singleton() { return singleton; }
+
+	void prefetch(const String &p_path);
+
+	// Overrides the `filesystem/prefetch/enabled` project setting.
+	void set_enabled(bool p_enabled);
+	bool is_enabled() const;
+
+	uint32_t get_queue_depth() const { return queue_depth.get(); }
+	uint64_t get_bytes_prefetched() const { return bytes_read.get(); }
+	uint64_t get_files_prefetched() const { return files_read.get(); }
+	double get_throughput() const; // Bytes per second while reading.
+
+	void finish();
+
+	FilePrefetcher();
+	~FilePrefetcher();
+};
+
+#endif // FILE_PREFETCHER_H
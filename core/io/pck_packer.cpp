@@ -31,9 +31,10 @@
 #include "pck_packer.h"
 
 #include "core/crypto/crypto_core.h"
+#include "core/io/compression.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
-#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
+#include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION_INDEXED
 #include "core/version.h"
 
 static int _get_pad(int p_alignment, int p_n) {
@@ -46,10 +47,71 @@ static int _get_pad(int p_alignment, int p_n) {
 	return pad;
 }
 
+static Error _store_stream(const Ref<FileAccess> &p_src, const Ref<FileAccess> &p_dst, uint64_t p_size) {
+	const uint64_t buf_max = 65536;
+	LocalVector<uint8_t> buf;
+	buf.resize(buf_max);
+	uint64_t to_write = p_size;
+	while (to_write > 0) {
+		uint64_t read = p_src->get_buffer(buf.ptr(), MIN(to_write, buf_max));
+		ERR_FAIL_COND_V(read == 0, ERR_FILE_CANT_READ);
+		ERR_FAIL_COND_V(!p_dst->store_buffer(buf.ptr(), read), ERR_FILE_CANT_WRITE);
+		to_write -= read;
+	}
+	return OK;
+}
+
+// Uses the FileAccessCompressed layout, so the file can be read by decompressing only the blocks being accessed.
+// Blocks are read, compressed and written one at a time. Returns ERR_SKIP if the result wouldn't be smaller than p_size.
+static Error _store_compressed_blocks(const Ref<FileAccess> &p_src, const Ref<FileAccess> &p_dst, uint64_t p_size, Compression::Mode p_mode) {
+	const uint32_t block_size = PACK_COMPRESSION_BLOCK_SIZE;
+	const uint32_t block_count = (p_size / block_size) + 1;
+	const uint64_t header_size = 16 + block_count * 4;
+	const uint64_t start = p_dst->get_position();
+
+	p_dst->store_32(PACK_COMPRESSED_FILE_MAGIC);
+	p_dst->store_32(p_mode);
+	p_dst->store_32(block_size);
+	p_dst->store_32(p_size);
+	for (uint32_t i = 0; i < block_count; i++) {
+		p_dst->store_32(0); // Block sizes, written once known.
+	}
+
+	LocalVector<uint8_t> block;
+	block.resize(block_size);
+	LocalVector<uint8_t> compressed;
+	compressed.resize(Compression::get_max_compressed_buffer_size(block_size, p_mode));
+	LocalVector<uint32_t> block_sizes;
+	block_sizes.resize(block_count);
+
+	uint64_t compressed_size = header_size;
+	for (uint32_t i = 0; i < block_count; i++) {
+		uint32_t bl = i == (block_count - 1) ? p_size % block_size : block_size;
+		ERR_FAIL_COND_V(p_src->get_buffer(block.ptr(), bl) != bl, ERR_FILE_CANT_READ);
+		int s = Compression::compress(compressed.ptr(), block.ptr(), bl, p_mode);
+		ERR_FAIL_COND_V(s < 0, ERR_CANT_CREATE);
+		compressed_size += s;
+		if (compressed_size >= p_size) {
+			return ERR_SKIP;
+		}
+		ERR_FAIL_COND_V(!p_dst->store_buffer(compressed.ptr(), s), ERR_FILE_CANT_WRITE);
+		block_sizes[i] = s;
+	}
+
+	const uint64_t end = p_dst->get_position();
+	p_dst->seek(start + 16);
+	for (uint32_t i = 0; i < block_count; i++) {
+		p_dst->store_32(block_sizes[i]);
+	}
+	p_dst->seek(end);
+	return OK;
+}
+
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_path", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file", "target_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("add_file_removal", "target_path"), &PCKPacker::add_file_removal);
+	ClassDB::bind_method(D_METHOD("set_compression", "enabled", "compression_mode"), &PCKPacker::set_compression, DEFVAL(FileAccess::COMPRESSION_ZSTD));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
@@ -90,7 +152,7 @@ Error PCKPacker::pck_start(const String &p_pck_path, int p_alignment, const Stri
 	alignment = p_alignment;
 
 	file->store_32(PACK_HEADER_MAGIC);
-	file->store_32(PACK_FORMAT_VERSION);
+	file->store_32(PACK_FORMAT_VERSION_INDEXED);
 	file->store_32(VERSION_MAJOR);
 	file->store_32(VERSION_MINOR);
 	file->store_32(VERSION_PATCH);
@@ -102,11 +164,17 @@ Error PCKPacker::pck_start(const String &p_pck_path, int p_alignment, const Stri
 	file->store_32(pack_flags); // flags
 
 	files.clear();
-	ofs = 0;
 
 	return OK;
 }
 
+void PCKPacker::set_compression(bool p_enabled, FileAccess::CompressionMode p_mode) {
+	ERR_FAIL_COND_MSG(p_mode == FileAccess::COMPRESSION_BROTLI, "Brotli is only supported for decompression.");
+
+	compress = p_enabled;
+	compression_mode = p_mode;
+}
+
 Error PCKPacker::add_file_removal(const String &p_target_path) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
@@ -114,7 +182,6 @@ Error PCKPacker::add_file_removal(const String &p_target_path) {
 	// Simplify path here and on every 'files' access so that paths that have extra '/'
 	// symbols or 'res://' in them still match the MD5 hash for the saved path.
 	pf.path = p_target_path.simplify_path().trim_prefix("res://");
-	pf.ofs = ofs;
 	pf.size = 0;
 	pf.removal = true;
 
@@ -139,32 +206,26 @@ Error PCKPacker::add_file(const String &p_target_path, const String &p_source_pa
 	// symbols or 'res://' in them still match the MD5 hash for the saved path.
 	pf.path = p_target_path.simplify_path().trim_prefix("res://");
 	pf.src_path = p_source_path;
-	pf.ofs = ofs;
 	pf.size = f->get_length();
 
-	Vector<uint8_t> data = FileAccess::get_file_as_bytes(p_source_path);
 	{
-		unsigned char hash[16];
-		CryptoCore::md5(data.ptr(), data.size(), hash);
-		pf.md5.resize(16);
-		for (int i = 0; i < 16; i++) {
-			pf.md5.write[i] = hash[i];
+		CryptoCore::MD5Context ctx;
+		ctx.start();
+		LocalVector<uint8_t> buf;
+		buf.resize(65536);
+		uint64_t to_read = pf.size;
+		while (to_read > 0) {
+			uint64_t read = f->get_buffer(buf.ptr(), MIN(to_read, (uint64_t)buf.size()));
+			ERR_FAIL_COND_V_MSG(read == 0, ERR_FILE_CANT_READ, vformat("Can't read file '%s'.", p_source_path));
+			ctx.update(buf.ptr(), read);
+			to_read -= read;
 		}
+		pf.md5.resize(16);
+		ctx.finish(pf.md5.ptrw());
 	}
 	pf.encrypted = p_encrypt;
-
-	uint64_t _size = pf.size;
-	if (p_encrypt) { // Add encryption overhead.
-		if (_size % 16) { // Pad to encryption block size.
-			_size += 16 - (_size % 16);
-		}
-		_size += 16; // hash
-		_size += 8; // data size
-		_size += 16; // iv
-	}
-
-	int pad = _get_pad(alignment, ofs + _size);
-	ofs = ofs + _size + pad;
+	// Encrypted data doesn't compress, and the compressed layout stores sizes in 32 bits.
+	pf.compressed = compress && !p_encrypt && pf.size > 0 && pf.size <= UINT32_MAX;
 
 	files.push_back(pf);
 
@@ -176,15 +237,94 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	int64_t file_base_ofs = file->get_position();
 	file->store_64(0); // files base
+	file->store_64(0); // directory base
 
 	for (int i = 0; i < 16; i++) {
 		file->store_32(0); // reserved
 	}
 
-	// write the index
-	file->store_32(files.size());
+	int header_padding = _get_pad(alignment, file->get_position());
+	for (int i = 0; i < header_padding; i++) {
+		file->store_8(0);
+	}
+
+	int64_t file_base = file->get_position();
 
 	Ref<FileAccessEncrypted> fae;
+	HashMap<String, int> stored_files; // Files with the same contents are only stored once.
+	uint64_t data_end = 0; // Furthest position written, in case a file is rewritten uncompressed over a shorter length.
+
+	int count = 0;
+	for (int i = 0; i < files.size(); i++) {
+		if (files[i].removal) {
+			continue;
+		}
+
+		count += 1;
+		const int file_num = files.size();
+		if (p_verbose && (file_num > 0)) {
+			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, files[i].src_path, files[i].path));
+		}
+
+		String contents_key = String::hex_encode_buffer(files[i].md5.ptr(), 16) + "-" + itos(files[i].size) + (files[i].encrypted ? "e" : "") + (files[i].compressed ? "c" : "");
+		HashMap<String, int>::Iterator E = stored_files.find(contents_key);
+		if (E) {
+			files.write[i].ofs = files[E->value].ofs;
+			files.write[i].compressed = files[E->value].compressed;
+			continue;
+		}
+		stored_files[contents_key] = i;
+
+		files.write[i].ofs = file->get_position() - file_base;
+
+		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(src.is_null() || src->get_length() != files[i].size, ERR_FILE_CANT_READ, vformat("Can't read file '%s'.", files[i].src_path));
+
+		if (files[i].compressed) {
+			const uint64_t start = file->get_position();
+			Error err = _store_compressed_blocks(src, file, files[i].size, (Compression::Mode)compression_mode);
+			if (err == ERR_SKIP) {
+				// Not worth it, store as is over what was written.
+				files.write[i].compressed = false;
+				data_end = MAX(data_end, file->get_position());
+				file->seek(start);
+				src->seek(0);
+			} else {
+				ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Can't compress file '%s'.", files[i].src_path));
+			}
+		}
+
+		if (!files[i].compressed) {
+			Ref<FileAccess> ftmp = file;
+			if (files[i].encrypted) {
+				fae.instantiate();
+				ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+
+				Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
+				ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+				ftmp = fae;
+			}
+
+			Error err = _store_stream(src, ftmp, files[i].size);
+			ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Can't read file '%s'.", files[i].src_path));
+
+			if (fae.is_valid()) {
+				ftmp.unref();
+				fae.unref();
+			}
+		}
+
+		int pad = _get_pad(alignment, file->get_position());
+		for (int j = 0; j < pad; j++) {
+			file->store_8(0);
+		}
+	}
+
+	// Write the index after the data, now that offsets are known. Entries are keyed by the MD5 of their path,
+	// and paths are stored separately since they're only needed to list directories.
+	int64_t dir_base = file->get_position();
+	file->store_32(files.size());
+
 	Ref<FileAccess> fhead = file;
 
 	if (enc_dir) {
@@ -197,16 +337,22 @@ Error PCKPacker::flush(bool p_verbose) {
 		fhead = fae;
 	}
 
+	Vector<uint8_t> path_table;
+	Vector<uint32_t> path_offsets;
 	for (int i = 0; i < files.size(); i++) {
-		int string_len = files[i].path.utf8().length();
-		int pad = _get_pad(4, string_len);
-
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)files[i].path.utf8().get_data(), string_len);
-		for (int j = 0; j < pad; j++) {
-			fhead->store_8(0);
-		}
+		CharString utf8 = files[i].path.utf8();
+		int path_ofs = path_table.size();
+		path_offsets.push_back(path_ofs);
+		path_table.resize(path_ofs + utf8.length());
+		memcpy(path_table.ptrw() + path_ofs, utf8.get_data(), utf8.length());
+	}
+	fhead->store_32(path_table.size());
+	fhead->store_buffer(path_table);
 
+	for (int i = 0; i < files.size(); i++) {
+		fhead->store_buffer(files[i].path.md5_buffer());
+		fhead->store_32(path_offsets[i]);
+		fhead->store_32(files[i].path.utf8().length());
 		fhead->store_64(files[i].ofs);
 		fhead->store_64(files[i].size); // pay attention here, this is where file is
 		fhead->store_buffer(files[i].md5.ptr(), 16); //also save md5 for file
@@ -215,6 +361,9 @@ Error PCKPacker::flush(bool p_verbose) {
 		if (files[i].encrypted) {
 			flags |= PACK_FILE_ENCRYPTED;
 		}
+		if (files[i].compressed) {
+			flags |= PACK_FILE_COMPRESSED;
+		}
 		if (files[i].removal) {
 			flags |= PACK_FILE_REMOVAL;
 		}
@@ -226,63 +375,16 @@ Error PCKPacker::flush(bool p_verbose) {
 		fae.unref();
 	}
 
-	int header_padding = _get_pad(alignment, file->get_position());
-	for (int i = 0; i < header_padding; i++) {
-		file->store_8(0);
+	if (data_end > file->get_position()) {
+		// Drop what's left of a discarded compressed file at the end.
+		file->resize(file->get_position());
 	}
 
-	int64_t file_base = file->get_position();
 	file->seek(file_base_ofs);
 	file->store_64(file_base); // update files base
-	file->seek(file_base);
-
-	const uint32_t buf_max = 65536;
-	uint8_t *buf = memnew_arr(uint8_t, buf_max);
-
-	int count = 0;
-	for (int i = 0; i < files.size(); i++) {
-		if (files[i].removal) {
-			continue;
-		}
-
-		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-
-		Ref<FileAccess> ftmp = file;
-		if (files[i].encrypted) {
-			fae.instantiate();
-			ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
-
-			Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
-			ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
-			ftmp = fae;
-		}
-
-		while (to_write > 0) {
-			uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
-			ftmp->store_buffer(buf, read);
-			to_write -= read;
-		}
-
-		if (fae.is_valid()) {
-			ftmp.unref();
-			fae.unref();
-		}
-
-		int pad = _get_pad(alignment, file->get_position());
-		for (int j = 0; j < pad; j++) {
-			file->store_8(0);
-		}
-
-		count += 1;
-		const int file_num = files.size();
-		if (p_verbose && (file_num > 0)) {
-			print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s", count, file_num, float(count) / file_num * 100, files[i].src_path, files[i].path));
-		}
-	}
+	file->store_64(dir_base); // update directory base
 
 	file.unref();
-	memdelete_arr(buf);
 
 	return OK;
 }
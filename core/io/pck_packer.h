@@ -31,19 +31,19 @@
 #ifndef PCK_PACKER_H
 #define PCK_PACKER_H
 
+#include "core/io/file_access.h"
 #include "core/object/ref_counted.h"
 
-class FileAccess;
-
 class PCKPacker : public RefCounted {
 	GDCLASS(PCKPacker, RefCounted);
 
 	Ref<FileAccess> file;
 	int alignment = 0;
-	uint64_t ofs = 0;
 
 	Vector<uint8_t> key;
 	bool enc_dir = false;
+	bool compress = false;
+	FileAccess::CompressionMode compression_mode = FileAccess::COMPRESSION_ZSTD;
 
 	static void _bind_methods();
 
@@ -53,6 +53,7 @@ class PCKPacker : public RefCounted {
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool compressed = false;
 		bool removal = false;
 		Vector<uint8_t> md5;
 	};
@@ -62,6 +63,7 @@ public:
 	Error pck_start(const String &p_pck_path, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
 	Error add_file(const String &p_target_path, const String &p_source_path, bool p_encrypt = false);
 	Error add_file_removal(const String &p_target_path);
+	void set_compression(bool p_enabled, FileAccess::CompressionMode p_mode = FileAccess::COMPRESSION_ZSTD);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker() {}
@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access_compressed.h"
+#include "core/io/file_access_memory.h"
 #include "core/io/image.h"
 #include "core/io/marshalls.h"
 #include "core/io/missing_resource.h"
@@ -100,6 +101,13 @@ enum {
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
 };
 
+// Files smaller than this are read through FileAccess, mapping them isn't worth the extra system calls.
+static const uint64_t MAPPED_LOAD_MIN_SIZE = 64 * 1024;
+// Below this many internal resources, decoding them on other threads isn't worth the overhead.
+static const int PARALLEL_DECODE_MIN_RESOURCES = 8;
+// How many resources decoding may run ahead of the one being instanced, which bounds the memory held by decoded values.
+static const uint32_t PARALLEL_DECODE_LOOKAHEAD = 32;
+
 void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	uint32_t extra = 4 - (p_len % 4);
 	if (extra < 4) {
@@ -400,21 +408,13 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 				} break;
 				case OBJECT_INTERNAL_RESOURCE: {
 					uint32_t index = f->get_32();
-					String path;
-
-					if (using_named_scene_ids) { // New format.
-						ERR_FAIL_INDEX_V((int)index, internal_resources.size(), ERR_PARSE_ERROR);
-						path = internal_resources[index].path;
-					} else {
-						path += res_path + "::" + itos(index);
-					}
-
-					//always use internal cache for loading internal resources
-					if (!internal_index_cache.has(path)) {
-						WARN_PRINT(vformat("Couldn't load resource (no cache): %s.", path));
-						r_v = Variant();
+					if (decoding) {
+						_defer_object(objtype, index);
 					} else {
-						r_v = internal_index_cache[path];
+						Error err = _get_internal_resource(index, r_v);
+						if (err) {
+							return err;
+						}
 					}
 				} break;
 				case OBJECT_EXTERNAL_RESOURCE: {
@@ -423,6 +423,11 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					String exttype = get_unicode_string();
 					String path = get_unicode_string();
 
+					if (decoding) {
+						decoding->decode_serially = true;
+						break;
+					}
+
 					if (!path.contains("://") && path.is_relative_path()) {
 						// path is relative to file being loaded, so convert to a resource path
 						path = ProjectSettings::get_singleton()->localize_path(res_path.get_base_dir().path_join(path));
@@ -443,27 +448,12 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 				case OBJECT_EXTERNAL_RESOURCE_INDEX: {
 					//new file format, just refers to an index in the external list
 					int erindex = f->get_32();
-
-					if (erindex < 0 || erindex >= external_resources.size()) {
-						WARN_PRINT("Broken external resource! (index out of size)");
-						r_v = Variant();
+					if (decoding) {
+						_defer_object(objtype, erindex);
 					} else {
-						Ref<ResourceLoader::LoadToken> &load_token = external_resources.write[erindex].load_token;
-						if (load_token.is_valid()) { // If not valid, it's OK since then we know this load accepts broken dependencies.
-							Error err;
-							Ref<Resource> res = ResourceLoader::_load_complete(*load_token.ptr(), &err);
-							if (res.is_null()) {
-								if (!ResourceLoader::is_cleaning_tasks()) {
-									if (!ResourceLoader::get_abort_on_missing_resources()) {
-										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
-									} else {
-										error = ERR_FILE_MISSING_DEPENDENCIES;
-										ERR_FAIL_V_MSG(error, vformat("Can't load dependency: '%s'.", external_resources[erindex].path));
-									}
-								}
-							} else {
-								r_v = res;
-							}
+						Error err = _get_external_resource(erindex, r_v);
+						if (err) {
+							return err;
 						}
 					}
 				} break;
@@ -487,10 +477,17 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 				Variant key;
 				Error err = parse_variant(key);
 				ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Error when trying to parse Variant.");
+				if (decoding && !decoding->deferred_objects.is_empty() && !decoding->deferred_objects[decoding->deferred_objects.size() - 1].assigned) {
+					// Resources used as keys can't be patched in place.
+					decoding->decode_serially = true;
+				}
 				Variant value;
 				err = parse_variant(value);
 				ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Error when trying to parse Variant.");
 				d[key] = value;
+				if (decoding) {
+					_assign_deferred_object(d, key);
+				}
 			}
 			r_v = d;
 		} break;
@@ -504,6 +501,9 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 				Error err = parse_variant(val);
 				ERR_FAIL_COND_V_MSG(err, ERR_FILE_CORRUPT, "Error when trying to parse Variant.");
 				a[i] = val;
+				if (decoding) {
+					_assign_deferred_object(a, i);
+				}
 			}
 			r_v = a;
 
@@ -676,6 +676,236 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 	return OK; //never reach anyway
 }
 
+Error ResourceLoaderBinary::_get_internal_resource(uint32_t p_index, Variant &r_v) {
+	String path;
+
+	if (using_named_scene_ids) { // New format.
+		ERR_FAIL_INDEX_V((int)p_index, internal_resources.size(), ERR_PARSE_ERROR);
+		path = internal_resources[p_index].path;
+	} else {
+		path += res_path + "::" + itos(p_index);
+	}
+
+	//always use internal cache for loading internal resources
+	if (!internal_index_cache.has(path)) {
+		WARN_PRINT(vformat("Couldn't load resource (no cache): %s.", path));
+		r_v = Variant();
+	} else {
+		r_v = internal_index_cache[path];
+	}
+	return OK;
+}
+
+Error ResourceLoaderBinary::_get_external_resource(int p_index, Variant &r_v) {
+	if (p_index < 0 || p_index >= external_resources.size()) {
+		WARN_PRINT("Broken external resource! (index out of size)");
+		r_v = Variant();
+		return OK;
+	}
+
+	Ref<ResourceLoader::LoadToken> &load_token = external_resources.write[p_index].load_token;
+	if (load_token.is_valid()) { // If not valid, it's OK since then we know this load accepts broken dependencies.
+		Error err;
+		Ref<Resource> res = ResourceLoader::_load_complete(*load_token.ptr(), &err);
+		if (res.is_null()) {
+			if (!ResourceLoader::is_cleaning_tasks()) {
+				if (!ResourceLoader::get_abort_on_missing_resources()) {
+					ResourceLoader::notify_dependency_error(local_path, external_resources[p_index].path, external_resources[p_index].type);
+				} else {
+					error = ERR_FILE_MISSING_DEPENDENCIES;
+					ERR_FAIL_V_MSG(error, vformat("Can't load dependency: '%s'.", external_resources[p_index].path));
+				}
+			}
+		} else {
+			r_v = res;
+		}
+	}
+	return OK;
+}
+
+void ResourceLoaderBinary::_defer_object(uint32_t p_type, uint32_t p_index) {
+	DeferredObject deferred;
+	deferred.type = p_type;
+	deferred.index = p_index;
+	decoding->deferred_objects.push_back(deferred);
+}
+
+void ResourceLoaderBinary::_assign_deferred_object(const Variant &p_container, const Variant &p_key) {
+	// Only the value just parsed can be an unassigned reference, nested ones were assigned to their own container.
+	if (decoding->deferred_objects.is_empty()) {
+		return;
+	}
+	DeferredObject &deferred = decoding->deferred_objects[decoding->deferred_objects.size() - 1];
+	if (!deferred.assigned) {
+		deferred.container = p_container;
+		deferred.key = p_key;
+		deferred.assigned = true;
+	}
+}
+
+Error ResourceLoaderBinary::_resolve_deferred_objects(DecodedResource &p_decoded) {
+	for (const DeferredObject &deferred : p_decoded.deferred_objects) {
+		Variant value;
+		Error err = deferred.type == OBJECT_INTERNAL_RESOURCE ? _get_internal_resource(deferred.index, value) : _get_external_resource(deferred.index, value);
+		if (err) {
+			return err;
+		}
+
+		if (deferred.container.get_type() == Variant::ARRAY) {
+			Array array = deferred.container;
+			array[deferred.key] = value;
+		} else if (deferred.container.get_type() == Variant::DICTIONARY) {
+			Dictionary dict = deferred.container;
+			dict[deferred.key] = value;
+		} else {
+			p_decoded.property_values.write[deferred.key] = value;
+		}
+	}
+	p_decoded.deferred_objects.clear();
+	return OK;
+}
+
+void ResourceLoaderBinary::_decode_internal_resource(uint32_t p_index) {
+	DecodedResource &decoded = decoded_resources[p_index];
+
+	Ref<FileAccessMemory> fam;
+	fam.instantiate();
+	fam->open_custom(mapped_data, mapped_length);
+	fam->set_big_endian(f->is_big_endian());
+	fam->real_is_double = f->real_is_double;
+	fam->seek(decoded.offset);
+
+	ResourceLoaderBinary decoder;
+	decoder.f = fam;
+	decoder.ver_format = ver_format;
+	decoder.string_map = string_map;
+	decoder.decoding = &decoded;
+
+	decoded.type = decoder.get_unicode_string();
+	int pc = fam->get_32();
+	for (int j = 0; j < pc && !decoded.decode_serially; j++) {
+		StringName name = decoder._get_string();
+		Variant value;
+		if (name == StringName() || decoder.parse_variant(value) != OK) {
+			decoded.decode_serially = true;
+			break;
+		}
+		decoded.property_names.push_back(name);
+		decoded.property_values.push_back(value);
+		decoder._assign_deferred_object(Variant(), j);
+	}
+
+	if (decoded.decode_serially) {
+		// load() will go through the file again and report errors with the usual messages.
+		decoded.property_names.clear();
+		decoded.property_values.clear();
+		decoded.deferred_objects.clear();
+	}
+
+	MutexLock lock(decode_mutex);
+	decoded.done.set();
+	decode_cond.notify_all();
+}
+
+void ResourceLoaderBinary::_decode_internal_resources_task(void *p_userdata) {
+	MutexLock lock(decode_mutex);
+	while (decode_next < decode_limit) {
+		uint32_t index = decode_next++;
+		lock.temp_unlock();
+		_decode_internal_resource(index);
+		lock.temp_relock();
+	}
+	decode_tasks_running--;
+}
+
+void ResourceLoaderBinary::_post_decode_tasks() {
+	// Called with decode_mutex locked.
+	while (decode_tasks_running < decode_max_tasks && decode_next + decode_tasks_running < decode_limit) {
+		decode_tasks.push_back(WorkerThreadPool::get_singleton()->add_template_task(this, &ResourceLoaderBinary::_decode_internal_resources_task, (void *)nullptr, true, SNAME("ResourceLoaderBinaryDecode")));
+		decode_tasks_running++;
+	}
+}
+
+void ResourceLoaderBinary::_start_decoding_internal_resources() {
+	if (!use_sub_threads || mapped_file.is_null() || internal_resources.size() < PARALLEL_DECODE_MIN_RESOURCES) {
+		return;
+	}
+	int task_count = MIN(WorkerThreadPool::get_singleton()->get_thread_count(), internal_resources.size());
+	if (task_count < 2) {
+		return;
+	}
+
+	mapped_data = mapped_file->get_read_only_mapping();
+	ERR_FAIL_NULL(mapped_data);
+	mapped_length = f->get_length();
+
+	decoded_resources.resize(internal_resources.size());
+	for (int i = 0; i < internal_resources.size(); i++) {
+		decoded_resources[i].offset = internal_resources[i].offset;
+	}
+
+	MutexLock lock(decode_mutex);
+	decode_next = 0;
+	decode_limit = MIN(PARALLEL_DECODE_LOOKAHEAD, decoded_resources.size());
+	decode_max_tasks = task_count;
+	_post_decode_tasks();
+}
+
+void ResourceLoaderBinary::_finish_decoding_internal_resources() {
+	if (decoded_resources.is_empty()) {
+		return;
+	}
+
+	{
+		// Tasks that haven't started yet will find nothing left to claim.
+		MutexLock lock(decode_mutex);
+		decode_limit = decode_next;
+	}
+	// Individual tasks rather than a group, so that waiting from a pool thread (as threaded loads do) runs
+	// pending tasks instead of blocking a worker the decoding tasks may need.
+	for (WorkerThreadPool::TaskID task : decode_tasks) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	}
+	decode_tasks.clear();
+	decoded_resources.clear();
+}
+
+ResourceLoaderBinary::DecodedResource *ResourceLoaderBinary::_get_decoded_resource(int p_index) {
+	if (decoded_resources.is_empty()) {
+		return nullptr;
+	}
+
+	DecodedResource &decoded = decoded_resources[p_index];
+	MutexLock lock(decode_mutex);
+	decode_limit = MAX(decode_limit, MIN(p_index + 1 + PARALLEL_DECODE_LOOKAHEAD, decoded_resources.size()));
+	_post_decode_tasks();
+
+	while (!decoded.done.is_set()) {
+		if (decode_next <= (uint32_t)p_index) {
+			// Decode it here rather than wait for a task to pick it up.
+			uint32_t index = decode_next++;
+			lock.temp_unlock();
+			_decode_internal_resource(index);
+			lock.temp_relock();
+			continue;
+		}
+		decode_cond.wait(lock);
+	}
+
+	return decoded.decode_serially ? nullptr : &decoded;
+}
+
+void ResourceLoaderBinary::_release_decoded_resource(int p_index) {
+	if (decoded_resources.is_empty()) {
+		return;
+	}
+	DecodedResource &decoded = decoded_resources[p_index];
+	decoded.type = String();
+	decoded.property_names.clear();
+	decoded.property_values.clear();
+	decoded.deferred_objects.clear();
+}
+
 Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
@@ -709,6 +939,13 @@ Error ResourceLoaderBinary::load() {
 		}
 	}
 
+	_start_decoding_internal_resources();
+	Error err = _load_internal_resources();
+	_finish_decoding_internal_resources();
+	return err;
+}
+
+Error ResourceLoaderBinary::_load_internal_resources() {
 	for (int i = 0; i < internal_resources.size(); i++) {
 		bool main = i == (internal_resources.size() - 1);
 
@@ -733,6 +970,9 @@ Error ResourceLoaderBinary::load() {
 					//already loaded, don't do anything
 					error = OK;
 					internal_index_cache[path] = cached;
+					if (_get_decoded_resource(i)) {
+						_release_decoded_resource(i);
+					}
 					continue;
 				}
 			}
@@ -742,11 +982,14 @@ Error ResourceLoaderBinary::load() {
 			}
 		}
 
-		uint64_t offset = internal_resources[i].offset;
-
-		f->seek(offset);
-
-		String t = get_unicode_string();
+		DecodedResource *decoded = _get_decoded_resource(i);
+		String t;
+		if (decoded) {
+			t = decoded->type;
+		} else {
+			f->seek(internal_resources[i].offset);
+			t = get_unicode_string();
+		}
 
 		Ref<Resource> res;
 		Resource *r = nullptr;
@@ -811,25 +1054,40 @@ Error ResourceLoaderBinary::load() {
 			internal_index_cache[path] = res;
 		}
 
-		int pc = f->get_32();
+		int pc;
+		if (decoded) {
+			error = _resolve_deferred_objects(*decoded);
+			if (error) {
+				return error;
+			}
+			pc = decoded->property_names.size();
+		} else {
+			pc = f->get_32();
+		}
 
 		//set properties
 
 		Dictionary missing_resource_properties;
 
 		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
+			StringName name;
+			Variant value;
 
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
+			if (decoded) {
+				name = decoded->property_names[j];
+				value = decoded->property_values[j];
+			} else {
+				name = _get_string();
 
-			Variant value;
+				if (name == StringName()) {
+					error = ERR_FILE_CORRUPT;
+					ERR_FAIL_V(ERR_FILE_CORRUPT);
+				}
 
-			error = parse_variant(value);
-			if (error) {
-				return error;
+				error = parse_variant(value);
+				if (error) {
+					return error;
+				}
 			}
 
 			bool set_valid = true;
@@ -875,6 +1133,10 @@ Error ResourceLoaderBinary::load() {
 			}
 		}
 
+		if (decoded) {
+			_release_decoded_resource(i);
+		}
+
 		if (missing_resource) {
 			missing_resource->set_recording_properties(false);
 		}
@@ -894,7 +1156,9 @@ Error ResourceLoaderBinary::load() {
 		resource_cache.push_back(res);
 
 		if (main) {
+			_finish_decoding_internal_resources();
 			f.unref();
+			mapped_file.unref();
 			resource = res;
 			resource->set_as_translation_remapped(translation_remapped);
 			error = OK;
@@ -1008,6 +1272,19 @@ void ResourceLoaderBinary::open(Ref<FileAccess> p_f, bool p_no_resources, bool p
 		error = ERR_FILE_UNRECOGNIZED;
 		f.unref();
 		ERR_FAIL_MSG(vformat("Unrecognized binary resource file: '%s'.", local_path));
+	} else if (!p_no_resources && f->get_length() >= MAPPED_LOAD_MIN_SIZE) {
+		// Uncompressed files that can be memory-mapped are parsed from the mapping. Values (packed arrays in
+		// particular) are then copied straight from the page cache, without going through buffered reads.
+		const uint8_t *mapped = f->get_read_only_mapping();
+		if (mapped) {
+			Ref<FileAccessMemory> fam;
+			fam.instantiate();
+			if (fam->open_custom(mapped, f->get_length()) == OK) {
+				fam->seek(f->get_position());
+				mapped_file = f;
+				f = fam;
+			}
+		}
 	}
 
 	bool big_endian = f->get_32();
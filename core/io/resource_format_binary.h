@@ -34,6 +34,9 @@
 #include "core/io/file_access.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/condition_variable.h"
+#include "core/templates/local_vector.h"
 
 class ResourceLoaderBinary {
 	bool translation_remapped = false;
@@ -44,6 +47,7 @@ class ResourceLoaderBinary {
 	uint32_t ver_format = 0;
 
 	Ref<FileAccess> f;
+	Ref<FileAccess> mapped_file; // Keeps the mapping `f` reads from alive.
 
 	uint64_t importmd_ofs = 0;
 
@@ -90,9 +94,57 @@ class ResourceLoaderBinary {
 	friend class ResourceFormatLoaderBinary;
 
 	Error parse_variant(Variant &r_v);
+	Error _get_internal_resource(uint32_t p_index, Variant &r_v);
+	Error _get_external_resource(int p_index, Variant &r_v);
 
 	HashMap<String, Ref<Resource>> dependency_cache;
 
+	// With sub-threads, internal resources of files read from a mapping are decoded on the WorkerThreadPool
+	// a bounded number of resources ahead of load(), which keeps instancing them in file order. References to
+	// other resources can only be resolved in that order, so decoding leaves them as nil and records where they go.
+	struct DeferredObject {
+		uint32_t type = 0;
+		uint32_t index = 0;
+		Variant container; // Array or Dictionary holding the reference, nil if it's the property value itself.
+		Variant key; // Index, key or property index.
+		bool assigned = false;
+	};
+
+	struct DecodedResource {
+		uint64_t offset = 0;
+		String type;
+		Vector<StringName> property_names;
+		Vector<Variant> property_values;
+		LocalVector<DeferredObject> deferred_objects;
+		bool decode_serially = false; // Failed to decode, or uses data that needs in-order decoding.
+		SafeFlag done;
+	};
+
+	DecodedResource *decoding = nullptr; // Set on the helper loaders used by decoding tasks.
+	LocalVector<DecodedResource> decoded_resources;
+	const uint8_t *mapped_data = nullptr;
+	uint64_t mapped_length = 0;
+	BinaryMutex decode_mutex;
+	ConditionVariable decode_cond;
+	// Guarded by decode_mutex. Resources are claimed in order, up to decode_limit.
+	uint32_t decode_next = 0;
+	uint32_t decode_limit = 0;
+	uint32_t decode_tasks_running = 0;
+	uint32_t decode_max_tasks = 0;
+	LocalVector<WorkerThreadPool::TaskID> decode_tasks;
+
+	void _defer_object(uint32_t p_type, uint32_t p_index);
+	void _assign_deferred_object(const Variant &p_container, const Variant &p_key);
+	Error _resolve_deferred_objects(DecodedResource &p_decoded);
+	void _decode_internal_resource(uint32_t p_index);
+	void _decode_internal_resources_task(void *p_userdata);
+	void _post_decode_tasks();
+	void _start_decoding_internal_resources();
+	void _finish_decoding_internal_resources();
+	DecodedResource *_get_decoded_resource(int p_index);
+	void _release_decoded_resource(int p_index);
+	Error _load_internal_resources();
+
 public:
 	Ref<Resource> get_resource();
 	Error load();
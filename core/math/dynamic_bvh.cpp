@@ -386,6 +386,36 @@ bool DynamicBVH::update(const ID &p_id, const AABB &p_box) {
 	return true;
 }
 
+bool DynamicBVH::refit(const ID &p_id, const AABB &p_box) {
+	ERR_FAIL_COND_V(!p_id.is_valid(), false);
+	Node *leaf = p_id.node;
+
+	Volume volume;
+	volume.min = p_box.position;
+	volume.max = p_box.position + p_box.size;
+
+	if (leaf->volume.min.is_equal_approx(volume.min) && leaf->volume.max.is_equal_approx(volume.max)) {
+		// noop
+		return false;
+	}
+
+	if (!leaf->volume.intersects(volume)) {
+		// Moved too far, growing the parents would hurt the tree quality more than reinserting.
+		return update(p_id, p_box);
+	}
+
+	// Keep the tree topology and only grow or shrink the parents, stopping as soon as one is unchanged.
+	leaf->volume = volume;
+	for (Node *node = leaf->parent; node; node = node->parent) {
+		Volume merged = node->children[0]->volume.merge(node->children[1]->volume);
+		if (!merged.is_not_equal_to(node->volume)) {
+			break;
+		}
+		node->volume = merged;
+	}
+	return true;
+}
+
 void DynamicBVH::remove(const ID &p_id) {
 	ERR_FAIL_COND(!p_id.is_valid());
 	Node *leaf = p_id.node;
@@ -293,6 +293,8 @@ public:
 	void optimize_incremental(int passes);
 	ID insert(const AABB &p_box, void *p_userdata);
 	bool update(const ID &p_id, const AABB &p_box);
+	// Cheaper than update() for small motions, as the leaf is not reinserted. Relies on optimize_incremental() to keep the tree quality.
+	bool refit(const ID &p_id, const AABB &p_box);
 	void remove(const ID &p_id);
 	void get_elements(List<ID> *r_elements);
 
@@ -45,6 +45,7 @@
 #include "core/io/config_file.h"
 #include "core/io/dir_access.h"
 #include "core/io/dtls_server.h"
+#include "core/io/file_prefetcher.h"
 #include "core/io/http_client.h"
 #include "core/io/image_loader.h"
 #include "core/io/json.h"
@@ -108,6 +109,7 @@ static core_bind::Geometry2D *_geometry_2d = nullptr;
 static core_bind::Geometry3D *_geometry_3d = nullptr;
 
 static WorkerThreadPool *worker_thread_pool = nullptr;
+static FilePrefetcher *file_prefetcher = nullptr;
 
 extern Mutex _global_mutex;
 
@@ -299,6 +301,7 @@ void register_core_types() {
 	GDREGISTER_NATIVE_STRUCT(ScriptLanguageExtensionProfilingInfo, "StringName signature;uint64_t call_count;uint64_t total_time;uint64_t self_time");
 
 	worker_thread_pool = memnew(WorkerThreadPool);
+	file_prefetcher = memnew(FilePrefetcher);
 
 	OS::get_singleton()->benchmark_end_measure("Core", "Register Types");
 }
@@ -311,6 +314,9 @@ void register_core_settings() {
 
 	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
 	GLOBAL_DEF("threading/worker_pool/low_priority_thread_ratio", 0.3);
+
+	GLOBAL_DEF("filesystem/prefetch/enabled", false);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "filesystem/prefetch/dependency_depth", PROPERTY_HINT_RANGE, "1,8,1"), 2);
 }
 
 void register_early_core_singletons() {
@@ -389,6 +395,7 @@ void unregister_core_types() {
 
 	// Destroy singletons in reverse order to ensure dependencies are not broken.
 
+	memdelete(file_prefetcher);
 	memdelete(worker_thread_pool);
 
 	memdelete(_engine_debugger);
@@ -836,6 +836,10 @@ const void *Array::id() const {
 	return _p;
 }
 
+int Array::get_reference_count() const {
+	return _p->refcount.get();
+}
+
 Array::Array(const Array &p_from, uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
 	_p = memnew(ArrayPrivate);
 	_p->refcount.init();
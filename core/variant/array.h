@@ -184,6 +184,7 @@ public:
 	Variant max() const;
 
 	const void *id() const;
+	int get_reference_count() const;
 
 	void set_typed(uint32_t p_type, const StringName &p_class_name, const Variant &p_script);
 	bool is_typed() const;
@@ -110,6 +110,7 @@ public:
 	bool is_read_only() const;
 
 	const void *id() const;
+	int get_reference_count() const;
 
 	Dictionary(const Dictionary &p_base, uint32_t p_key_type, const StringName &p_key_class_name, const Variant &p_key_script, uint32_t p_value_type, const StringName &p_value_class_name, const Variant &p_value_script);
 	Dictionary(const Dictionary &p_from);
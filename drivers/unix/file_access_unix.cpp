@@ -37,6 +37,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -171,6 +172,13 @@ void FileAccessUnix::_close() {
 		return;
 	}
 
+	if (mapped_data) {
+		munmap(mapped_data, mapped_size);
+		mapped_data = nullptr;
+		mapped_size = 0;
+	}
+	mapping_failed = false;
+
 	fclose(f);
 	f = nullptr;
 
@@ -266,6 +274,31 @@ bool FileAccessUnix::eof_reached() const {
 	return feof(f);
 }
 
+const uint8_t *FileAccessUnix::get_read_only_mapping() {
+	ERR_FAIL_NULL_V_MSG(f, nullptr, "File must be opened before use.");
+
+	if (mapped_data || mapping_failed || flags != READ) {
+		return mapped_data;
+	}
+
+	uint64_t size = get_length();
+	if (size == 0 || size != (uint64_t)(size_t)size) {
+		mapping_failed = true;
+		return nullptr;
+	}
+
+	// Private and read-only, so the pages are shared with the page cache until something writes to them (which nothing should).
+	void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (data == MAP_FAILED) {
+		mapping_failed = true;
+		return nullptr;
+	}
+
+	mapped_data = (uint8_t *)data;
+	mapped_size = size;
+	return mapped_data;
+}
+
 uint64_t FileAccessUnix::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	ERR_FAIL_NULL_V_MSG(f, -1, "File must be opened before use.");
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
@@ -43,6 +43,9 @@ typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 class FileAccessUnix : public FileAccess {
 	FILE *f = nullptr;
 	int flags = 0;
+	uint8_t *mapped_data = nullptr;
+	uint64_t mapped_size = 0;
+	bool mapping_failed = false;
 	void check_errors(bool p_write = false) const;
 	mutable Error last_error = OK;
 	String save_path;
@@ -72,6 +75,7 @@ public:
 	virtual bool eof_reached() const override; ///< reading passed EOF
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual const uint8_t *get_read_only_mapping() override;
 
 	virtual Error get_error() const override; ///< get last error
 
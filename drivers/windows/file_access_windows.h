@@ -70,6 +70,9 @@ public:
 	virtual bool eof_reached() const override; ///< reading passed EOF
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	// Not supported: a mapped file can't be replaced or deleted until it's unmapped, which saving resources relies on.
+	// Callers fall back to get_buffer().
+	virtual const uint8_t *get_read_only_mapping() override { return nullptr; }
 
 	virtual Error get_error() const override; ///< get last error
 
@@ -42,6 +42,7 @@
 #include "core/io/dir_access.h"
 #include "core/io/file_access_pack.h"
 #include "core/io/file_access_zip.h"
+#include "core/io/file_prefetcher.h"
 #include "core/io/image.h"
 #include "core/io/image_loader.h"
 #include "core/io/ip.h"
@@ -829,6 +830,7 @@ void Main::test_cleanup() {
 		TextServerManager::get_singleton()->get_interface(i)->cleanup();
 	}
 
+	FilePrefetcher::get_singleton()->finish();
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 	PropertyListHelper::clear_base_helpers();
@@ -4582,6 +4584,7 @@ void Main::cleanup(bool p_force) {
 		movie_writer->end();
 	}
 
+	FilePrefetcher::get_singleton()->finish();
 	ResourceLoader::clear_thread_load_tasks();
 
 	ResourceLoader::remove_custom_loaders();
@@ -30,6 +30,7 @@
 
 #include "performance.h"
 
+#include "core/io/file_prefetcher.h"
 #include "core/os/os.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
@@ -97,6 +98,11 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_SURFACE);
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_DRAW);
 	BIND_ENUM_CONSTANT(PIPELINE_COMPILATIONS_SPECIALIZATION);
+	BIND_ENUM_CONSTANT(IO_PREFETCH_QUEUE_DEPTH);
+	BIND_ENUM_CONSTANT(IO_PREFETCHED_BYTES);
+	BIND_ENUM_CONSTANT(IO_PREFETCH_THROUGHPUT);
+	BIND_ENUM_CONSTANT(OBJECT_PROCESS_BUDGET_DEFERRED_NODES);
+	BIND_ENUM_CONSTANT(OBJECT_PROCESS_BUDGET_EXHAUSTED_GROUPS);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -109,6 +115,24 @@ int Performance::_get_node_count() const {
 	return sml->get_node_count();
 }
 
+int Performance::_get_process_budget_deferred_node_count() const {
+	MainLoop *ml = OS::get_singleton()->get_main_loop();
+	SceneTree *sml = Object::cast_to<SceneTree>(ml);
+	if (!sml) {
+		return 0;
+	}
+	return sml->get_process_budget_deferred_node_count();
+}
+
+int Performance::_get_process_budget_exhausted_group_count() const {
+	MainLoop *ml = OS::get_singleton()->get_main_loop();
+	SceneTree *sml = Object::cast_to<SceneTree>(ml);
+	if (!sml) {
+		return 0;
+	}
+	return sml->get_process_budget_exhausted_group_count();
+}
+
 String Performance::get_monitor_name(Monitor p_monitor) const {
 	ERR_FAIL_INDEX_V(p_monitor, MONITOR_MAX, String());
 	static const char *names[MONITOR_MAX] = {
@@ -151,6 +175,11 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("pipeline/compilations_surface"),
 		PNAME("pipeline/compilations_draw"),
 		PNAME("pipeline/compilations_specialization"),
+		PNAME("io/prefetch_queue_depth"),
+		PNAME("io/prefetched_bytes"),
+		PNAME("io/prefetch_throughput"),
+		PNAME("object/process_budget_deferred_nodes"),
+		PNAME("object/process_budget_exhausted_groups"),
 	};
 
 	return names[p_monitor];
@@ -246,6 +275,16 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
 		case NAVIGATION_OBSTACLE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_OBSTACLE_COUNT);
+		case IO_PREFETCH_QUEUE_DEPTH:
+			return FilePrefetcher::get_singleton()->get_queue_depth();
+		case IO_PREFETCHED_BYTES:
+			return FilePrefetcher::get_singleton()->get_bytes_prefetched();
+		case IO_PREFETCH_THROUGHPUT:
+			return FilePrefetcher::get_singleton()->get_throughput();
+		case OBJECT_PROCESS_BUDGET_DEFERRED_NODES:
+			return _get_process_budget_deferred_node_count();
+		case OBJECT_PROCESS_BUDGET_EXHAUSTED_GROUPS:
+			return _get_process_budget_exhausted_group_count();
 
 		default: {
 		}
@@ -292,7 +331,16 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
-
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 	};
 
 	return types[p_monitor];
@@ -47,6 +47,8 @@ class Performance : public Object {
 	static void _bind_methods();
 
 	int _get_node_count() const;
+	int _get_process_budget_deferred_node_count() const;
+	int _get_process_budget_exhausted_group_count() const;
 
 	double _process_time;
 	double _physics_process_time;
@@ -106,6 +108,11 @@ public:
 		PIPELINE_COMPILATIONS_SURFACE,
 		PIPELINE_COMPILATIONS_DRAW,
 		PIPELINE_COMPILATIONS_SPECIALIZATION,
+		IO_PREFETCH_QUEUE_DEPTH,
+		IO_PREFETCHED_BYTES,
+		IO_PREFETCH_THROUGHPUT,
+		OBJECT_PROCESS_BUDGET_DEFERRED_NODES,
+		OBJECT_PROCESS_BUDGET_EXHAUSTED_GROUPS,
 		MONITOR_MAX
 	};
 
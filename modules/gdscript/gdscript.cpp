@@ -35,6 +35,7 @@
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_tokenizer_buffer.h"
 #include "gdscript_warning.h"
 
@@ -1560,6 +1561,9 @@ void GDScript::clear(ClearData *p_clear_data) {
 	}
 	clearing = true;
 
+	// Functions and members are about to be freed.
+	GDScriptFunction::invalidate_inline_caches();
+
 	ClearData data;
 	ClearData *clear_data = p_clear_data;
 	bool is_root = false;
@@ -2301,6 +2305,11 @@ void GDScriptLanguage::init() {
 	}
 #endif
 
+	GDScriptSamplingProfiler::register_debugger_profiler();
+	if (!String(GLOBAL_GET("debug/settings/gdscript/sampling_profiler_output")).is_empty()) {
+		GDScriptSamplingProfiler::start(GLOBAL_GET("debug/settings/gdscript/sampling_profiler_interval_usec"));
+	}
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
@@ -2342,6 +2351,14 @@ void GDScriptLanguage::finish() {
 	}
 	finishing = true;
 
+	GDScriptSamplingProfiler::stop();
+	const String sampling_profiler_output = GLOBAL_GET("debug/settings/gdscript/sampling_profiler_output");
+	if (!sampling_profiler_output.is_empty()) {
+		GDScriptSamplingProfiler::save_folded_stacks(sampling_profiler_output);
+	}
+	GDScriptSamplingProfiler::clear();
+	GDScriptSamplingProfiler::unregister_debugger_profiler();
+
 	_call_stack.free();
 
 	// Clear the cache before parsing the script_list
@@ -2972,6 +2989,9 @@ GDScriptLanguage::GDScriptLanguage() {
 		_debug_max_call_stack = 0;
 	}
 
+	GLOBAL_DEF(PropertyInfo(Variant::STRING, "debug/settings/gdscript/sampling_profiler_output", PROPERTY_HINT_GLOBAL_SAVE_FILE, "*.folded"), "");
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "debug/settings/gdscript/sampling_profiler_interval_usec", PROPERTY_HINT_RANGE, "100,100000,1"), 1000);
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/exclude_addons", true);
@@ -208,6 +208,24 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_constant_count = 0;
 	}
 
+	if (container_pool_size) {
+		function->_container_pool_count = container_pool_size;
+		function->container_pool.resize(container_pool_size);
+		function->_container_pool_ptr = function->container_pool.ptrw();
+	} else {
+		function->_container_pool_ptr = nullptr;
+		function->_container_pool_count = 0;
+	}
+
+	if (inline_cache_size) {
+		function->_inline_caches_count = inline_cache_size;
+		function->inline_caches.resize(inline_cache_size);
+		function->_inline_caches_ptr = function->inline_caches.ptrw();
+	} else {
+		function->_inline_caches_ptr = nullptr;
+		function->_inline_caches_count = 0;
+	}
+
 	if (name_map.size()) {
 		function->global_names.resize(name_map.size());
 		function->_global_names_ptr = &function->global_names[0];
@@ -861,6 +879,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append(inline_cache_size++);
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -879,6 +898,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append(inline_cache_size++);
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -1093,6 +1113,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_size++);
 	ct.cleanup();
 }
 
@@ -1118,6 +1139,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_size++);
 	ct.cleanup();
 }
 
@@ -1352,6 +1374,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_size++);
 	ct.cleanup();
 }
 
@@ -1365,6 +1388,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_size++);
 	ct.cleanup();
 }
 
@@ -1378,6 +1402,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(inline_cache_size++);
 	ct.cleanup();
 }
 
@@ -1451,7 +1476,7 @@ void GDScriptByteCodeGenerator::write_construct(const Address &p_target, Variant
 	ct.cleanup();
 }
 
-void GDScriptByteCodeGenerator::write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) {
+void GDScriptByteCodeGenerator::write_construct_array(const Address &p_target, const Vector<Address> &p_arguments, bool p_pooled) {
 	append_opcode_and_argcount(GDScriptFunction::OPCODE_CONSTRUCT_ARRAY, 1 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
@@ -1459,10 +1484,11 @@ void GDScriptByteCodeGenerator::write_construct_array(const Address &p_target, c
 	CallTarget ct = get_call_target(p_target);
 	append(ct.target);
 	append(p_arguments.size());
+	append(p_pooled ? container_pool_size++ : -1);
 	ct.cleanup();
 }
 
-void GDScriptByteCodeGenerator::write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments) {
+void GDScriptByteCodeGenerator::write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments, bool p_pooled) {
 	append_opcode_and_argcount(GDScriptFunction::OPCODE_CONSTRUCT_TYPED_ARRAY, 2 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
@@ -1473,10 +1499,11 @@ void GDScriptByteCodeGenerator::write_construct_typed_array(const Address &p_tar
 	append(p_arguments.size());
 	append(p_element_type.builtin_type);
 	append(p_element_type.native_type);
+	append(p_pooled ? container_pool_size++ : -1);
 	ct.cleanup();
 }
 
-void GDScriptByteCodeGenerator::write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) {
+void GDScriptByteCodeGenerator::write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments, bool p_pooled) {
 	append_opcode_and_argcount(GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY, 1 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
@@ -1484,10 +1511,11 @@ void GDScriptByteCodeGenerator::write_construct_dictionary(const Address &p_targ
 	CallTarget ct = get_call_target(p_target);
 	append(ct.target);
 	append(p_arguments.size() / 2); // This is number of key-value pairs, so only half of actual arguments.
+	append(p_pooled ? container_pool_size++ : -1);
 	ct.cleanup();
 }
 
-void GDScriptByteCodeGenerator::write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments) {
+void GDScriptByteCodeGenerator::write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments, bool p_pooled) {
 	append_opcode_and_argcount(GDScriptFunction::OPCODE_CONSTRUCT_TYPED_DICTIONARY, 3 + p_arguments.size());
 	for (int i = 0; i < p_arguments.size(); i++) {
 		append(p_arguments[i]);
@@ -1501,6 +1529,7 @@ void GDScriptByteCodeGenerator::write_construct_typed_dictionary(const Address &
 	append(p_key_type.native_type);
 	append(p_value_type.builtin_type);
 	append(p_value_type.native_type);
+	append(p_pooled ? container_pool_size++ : -1);
 	ct.cleanup();
 }
 
@@ -98,6 +98,8 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int container_pool_size = 0;
+	int inline_cache_size = 0;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -526,10 +528,10 @@ public:
 	virtual void write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) override;
 	virtual void write_lambda(const Address &p_target, GDScriptFunction *p_function, const Vector<Address> &p_captures, bool p_use_self) override;
 	virtual void write_construct(const Address &p_target, Variant::Type p_type, const Vector<Address> &p_arguments) override;
-	virtual void write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) override;
-	virtual void write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments) override;
-	virtual void write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments) override;
-	virtual void write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments) override;
+	virtual void write_construct_array(const Address &p_target, const Vector<Address> &p_arguments, bool p_pooled = false) override;
+	virtual void write_construct_typed_array(const Address &p_target, const GDScriptDataType &p_element_type, const Vector<Address> &p_arguments, bool p_pooled = false) override;
+	virtual void write_construct_dictionary(const Address &p_target, const Vector<Address> &p_arguments, bool p_pooled = false) override;
+	virtual void write_construct_typed_dictionary(const Address &p_target, const GDScriptDataType &p_key_type, const GDScriptDataType &p_value_type, const Vector<Address> &p_arguments, bool p_pooled = false) override;
 	virtual void write_await(const Address &p_target, const Address &p_operand) override;
 	virtual void write_if(const Address &p_condition) override;
 	virtual void write_else() override;
@@ -498,82 +498,15 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 			}
 			return GDScriptCodeGenerator::Address(GDScriptCodeGenerator::Address::SELF);
 		} break;
-		case GDScriptParser::Node::ARRAY: {
-			const GDScriptParser::ArrayNode *an = static_cast<const GDScriptParser::ArrayNode *>(p_expression);
-			Vector<GDScriptCodeGenerator::Address> values;
-
-			// Create the result temporary first since it's the last to be killed.
-			GDScriptDataType array_type = _gdtype_from_datatype(an->get_datatype(), codegen.script);
-			GDScriptCodeGenerator::Address result = codegen.add_temporary(array_type);
-
-			for (int i = 0; i < an->elements.size(); i++) {
-				GDScriptCodeGenerator::Address val = _parse_expression(codegen, r_error, an->elements[i]);
-				if (r_error) {
-					return GDScriptCodeGenerator::Address();
-				}
-				values.push_back(val);
-			}
-
-			if (array_type.has_container_element_type(0)) {
-				gen->write_construct_typed_array(result, array_type.get_container_element_type(0), values);
-			} else {
-				gen->write_construct_array(result, values);
-			}
-
-			for (int i = 0; i < values.size(); i++) {
-				if (values[i].mode == GDScriptCodeGenerator::Address::TEMPORARY) {
-					gen->pop_temporary();
-				}
-			}
-
-			return result;
-		} break;
+		case GDScriptParser::Node::ARRAY:
 		case GDScriptParser::Node::DICTIONARY: {
-			const GDScriptParser::DictionaryNode *dn = static_cast<const GDScriptParser::DictionaryNode *>(p_expression);
-			Vector<GDScriptCodeGenerator::Address> elements;
-
 			// Create the result temporary first since it's the last to be killed.
-			GDScriptDataType dict_type = _gdtype_from_datatype(dn->get_datatype(), codegen.script);
-			GDScriptCodeGenerator::Address result = codegen.add_temporary(dict_type);
-
-			for (int i = 0; i < dn->elements.size(); i++) {
-				// Key.
-				GDScriptCodeGenerator::Address element;
-				switch (dn->style) {
-					case GDScriptParser::DictionaryNode::PYTHON_DICT:
-						// Python-style: key is any expression.
-						element = _parse_expression(codegen, r_error, dn->elements[i].key);
-						if (r_error) {
-							return GDScriptCodeGenerator::Address();
-						}
-						break;
-					case GDScriptParser::DictionaryNode::LUA_TABLE:
-						// Lua-style: key is an identifier interpreted as StringName.
-						StringName key = dn->elements[i].key->reduced_value.operator StringName();
-						element = codegen.add_constant(key);
-						break;
-				}
-
-				elements.push_back(element);
-
-				element = _parse_expression(codegen, r_error, dn->elements[i].value);
-				if (r_error) {
-					return GDScriptCodeGenerator::Address();
-				}
-
-				elements.push_back(element);
-			}
-
-			if (dict_type.has_container_element_types()) {
-				gen->write_construct_typed_dictionary(result, dict_type.get_container_element_type_or_variant(0), dict_type.get_container_element_type_or_variant(1), elements);
-			} else {
-				gen->write_construct_dictionary(result, elements);
-			}
+			GDScriptDataType container_type = _gdtype_from_datatype(p_expression->get_datatype(), codegen.script);
+			GDScriptCodeGenerator::Address result = codegen.add_temporary(container_type);
 
-			for (int i = 0; i < elements.size(); i++) {
-				if (elements[i].mode == GDScriptCodeGenerator::Address::TEMPORARY) {
-					gen->pop_temporary();
-				}
+			_write_container_literal(codegen, r_error, p_expression, container_type, result, false);
+			if (r_error) {
+				return GDScriptCodeGenerator::Address();
 			}
 
 			return result;
@@ -1430,6 +1363,71 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 	}
 }
 
+void GDScriptCompiler::_write_container_literal(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_literal, const GDScriptDataType &p_type, const GDScriptCodeGenerator::Address &p_target, bool p_pooled) {
+	GDScriptCodeGenerator *gen = codegen.generator;
+	Vector<GDScriptCodeGenerator::Address> elements;
+
+	if (p_literal->type == GDScriptParser::Node::ARRAY) {
+		const GDScriptParser::ArrayNode *an = static_cast<const GDScriptParser::ArrayNode *>(p_literal);
+
+		for (int i = 0; i < an->elements.size(); i++) {
+			GDScriptCodeGenerator::Address val = _parse_expression(codegen, r_error, an->elements[i]);
+			if (r_error) {
+				return;
+			}
+			elements.push_back(val);
+		}
+
+		if (p_type.has_container_element_type(0)) {
+			gen->write_construct_typed_array(p_target, p_type.get_container_element_type(0), elements, p_pooled);
+		} else {
+			gen->write_construct_array(p_target, elements, p_pooled);
+		}
+	} else {
+		const GDScriptParser::DictionaryNode *dn = static_cast<const GDScriptParser::DictionaryNode *>(p_literal);
+
+		for (int i = 0; i < dn->elements.size(); i++) {
+			// Key.
+			GDScriptCodeGenerator::Address element;
+			switch (dn->style) {
+				case GDScriptParser::DictionaryNode::PYTHON_DICT:
+					// Python-style: key is any expression.
+					element = _parse_expression(codegen, r_error, dn->elements[i].key);
+					if (r_error) {
+						return;
+					}
+					break;
+				case GDScriptParser::DictionaryNode::LUA_TABLE:
+					// Lua-style: key is an identifier interpreted as StringName.
+					StringName key = dn->elements[i].key->reduced_value.operator StringName();
+					element = codegen.add_constant(key);
+					break;
+			}
+
+			elements.push_back(element);
+
+			element = _parse_expression(codegen, r_error, dn->elements[i].value);
+			if (r_error) {
+				return;
+			}
+
+			elements.push_back(element);
+		}
+
+		if (p_type.has_container_element_types()) {
+			gen->write_construct_typed_dictionary(p_target, p_type.get_container_element_type_or_variant(0), p_type.get_container_element_type_or_variant(1), elements, p_pooled);
+		} else {
+			gen->write_construct_dictionary(p_target, elements, p_pooled);
+		}
+	}
+
+	for (int i = 0; i < elements.size(); i++) {
+		if (elements[i].mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+			gen->pop_temporary();
+		}
+	}
+}
+
 GDScriptCodeGenerator::Address GDScriptCompiler::_parse_match_pattern(CodeGen &codegen, Error &r_error, const GDScriptParser::PatternNode *p_pattern, const GDScriptCodeGenerator::Address &p_value_addr, const GDScriptCodeGenerator::Address &p_type_addr, const GDScriptCodeGenerator::Address &p_previous_test, bool p_is_first, bool p_is_nested) {
 	switch (p_pattern->pattern_type) {
 		case GDScriptParser::PatternNode::PT_LITERAL: {
@@ -1889,6 +1887,149 @@ void GDScriptCompiler::_clear_block_locals(CodeGen &codegen, const List<GDScript
 	}
 }
 
+// Finds the local variables whose value may outlive the statement reading them, i.e. anything other than
+// a plain read, a method call on it, or an assignment to it. Container literals assigned to the others can be
+// pooled by the function instead of being allocated again on each execution.
+static void _mark_escaping_locals(const GDScriptParser::Node *p_node, bool p_escapes, HashSet<const GDScriptParser::VariableNode *> &r_escaping) {
+	if (p_node == nullptr) {
+		return;
+	}
+
+	switch (p_node->type) {
+		case GDScriptParser::Node::IDENTIFIER: {
+			const GDScriptParser::IdentifierNode *id = static_cast<const GDScriptParser::IdentifierNode *>(p_node);
+			if (p_escapes && id->source == GDScriptParser::IdentifierNode::LOCAL_VARIABLE) {
+				r_escaping.insert(id->variable_source);
+			}
+		} break;
+		case GDScriptParser::Node::ARRAY: {
+			const GDScriptParser::ArrayNode *an = static_cast<const GDScriptParser::ArrayNode *>(p_node);
+			for (const GDScriptParser::ExpressionNode *element : an->elements) {
+				_mark_escaping_locals(element, true, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::DICTIONARY: {
+			const GDScriptParser::DictionaryNode *dn = static_cast<const GDScriptParser::DictionaryNode *>(p_node);
+			for (const GDScriptParser::DictionaryNode::Pair &pair : dn->elements) {
+				_mark_escaping_locals(pair.key, true, r_escaping);
+				_mark_escaping_locals(pair.value, true, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::ASSIGNMENT: {
+			const GDScriptParser::AssignmentNode *an = static_cast<const GDScriptParser::AssignmentNode *>(p_node);
+			if (an->assignee->type != GDScriptParser::Node::IDENTIFIER) {
+				_mark_escaping_locals(an->assignee, false, r_escaping);
+			}
+			_mark_escaping_locals(an->assigned_value, true, r_escaping);
+		} break;
+		case GDScriptParser::Node::AWAIT: {
+			_mark_escaping_locals(static_cast<const GDScriptParser::AwaitNode *>(p_node)->to_await, true, r_escaping);
+		} break;
+		case GDScriptParser::Node::BINARY_OPERATOR: {
+			const GDScriptParser::BinaryOpNode *bn = static_cast<const GDScriptParser::BinaryOpNode *>(p_node);
+			_mark_escaping_locals(bn->left_operand, false, r_escaping);
+			_mark_escaping_locals(bn->right_operand, false, r_escaping);
+		} break;
+		case GDScriptParser::Node::CALL: {
+			const GDScriptParser::CallNode *cn = static_cast<const GDScriptParser::CallNode *>(p_node);
+			if (cn->callee && cn->callee->type == GDScriptParser::Node::SUBSCRIPT) {
+				const GDScriptParser::SubscriptNode *sn = static_cast<const GDScriptParser::SubscriptNode *>(cn->callee);
+				_mark_escaping_locals(sn->base, false, r_escaping);
+			}
+			for (const GDScriptParser::ExpressionNode *argument : cn->arguments) {
+				_mark_escaping_locals(argument, true, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::CAST: {
+			_mark_escaping_locals(static_cast<const GDScriptParser::CastNode *>(p_node)->operand, p_escapes, r_escaping);
+		} break;
+		case GDScriptParser::Node::LAMBDA: {
+			// Captures are copied into the lambda.
+			const GDScriptParser::LambdaNode *ln = static_cast<const GDScriptParser::LambdaNode *>(p_node);
+			for (const GDScriptParser::IdentifierNode *capture : ln->captures) {
+				_mark_escaping_locals(capture, true, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::SUBSCRIPT: {
+			const GDScriptParser::SubscriptNode *sn = static_cast<const GDScriptParser::SubscriptNode *>(p_node);
+			_mark_escaping_locals(sn->base, false, r_escaping);
+			if (!sn->is_attribute) {
+				_mark_escaping_locals(sn->index, true, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::TERNARY_OPERATOR: {
+			const GDScriptParser::TernaryOpNode *tn = static_cast<const GDScriptParser::TernaryOpNode *>(p_node);
+			_mark_escaping_locals(tn->condition, false, r_escaping);
+			_mark_escaping_locals(tn->true_expr, p_escapes, r_escaping);
+			_mark_escaping_locals(tn->false_expr, p_escapes, r_escaping);
+		} break;
+		case GDScriptParser::Node::TYPE_TEST: {
+			_mark_escaping_locals(static_cast<const GDScriptParser::TypeTestNode *>(p_node)->operand, false, r_escaping);
+		} break;
+		case GDScriptParser::Node::UNARY_OPERATOR: {
+			_mark_escaping_locals(static_cast<const GDScriptParser::UnaryOpNode *>(p_node)->operand, false, r_escaping);
+		} break;
+		case GDScriptParser::Node::SUITE: {
+			const GDScriptParser::SuiteNode *suite = static_cast<const GDScriptParser::SuiteNode *>(p_node);
+			for (const GDScriptParser::Node *statement : suite->statements) {
+				_mark_escaping_locals(statement, false, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::ASSERT: {
+			const GDScriptParser::AssertNode *an = static_cast<const GDScriptParser::AssertNode *>(p_node);
+			_mark_escaping_locals(an->condition, false, r_escaping);
+			_mark_escaping_locals(an->message, true, r_escaping);
+		} break;
+		case GDScriptParser::Node::FOR: {
+			const GDScriptParser::ForNode *fn = static_cast<const GDScriptParser::ForNode *>(p_node);
+			_mark_escaping_locals(fn->list, false, r_escaping);
+			_mark_escaping_locals(fn->loop, false, r_escaping);
+		} break;
+		case GDScriptParser::Node::IF: {
+			const GDScriptParser::IfNode *in = static_cast<const GDScriptParser::IfNode *>(p_node);
+			_mark_escaping_locals(in->condition, false, r_escaping);
+			_mark_escaping_locals(in->true_block, false, r_escaping);
+			_mark_escaping_locals(in->false_block, false, r_escaping);
+		} break;
+		case GDScriptParser::Node::MATCH: {
+			const GDScriptParser::MatchNode *mn = static_cast<const GDScriptParser::MatchNode *>(p_node);
+			_mark_escaping_locals(mn->test, true, r_escaping);
+			for (const GDScriptParser::MatchBranchNode *branch : mn->branches) {
+				_mark_escaping_locals(branch->guard_body, false, r_escaping);
+				_mark_escaping_locals(branch->block, false, r_escaping);
+			}
+		} break;
+		case GDScriptParser::Node::RETURN: {
+			_mark_escaping_locals(static_cast<const GDScriptParser::ReturnNode *>(p_node)->return_value, true, r_escaping);
+		} break;
+		case GDScriptParser::Node::VARIABLE: {
+			_mark_escaping_locals(static_cast<const GDScriptParser::VariableNode *>(p_node)->initializer, true, r_escaping);
+		} break;
+		case GDScriptParser::Node::WHILE: {
+			const GDScriptParser::WhileNode *wn = static_cast<const GDScriptParser::WhileNode *>(p_node);
+			_mark_escaping_locals(wn->condition, false, r_escaping);
+			_mark_escaping_locals(wn->loop, false, r_escaping);
+		} break;
+		default:
+			break;
+	}
+}
+
+static bool _is_same_builtin_type(const GDScriptDataType &p_a, const GDScriptDataType &p_b) {
+	if (!p_a.has_type || !p_b.has_type || p_a.kind != GDScriptDataType::BUILTIN || p_b.kind != GDScriptDataType::BUILTIN) {
+		return false;
+	}
+	if (p_a.builtin_type != p_b.builtin_type || p_a.container_element_types.size() != p_b.container_element_types.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_a.container_element_types.size(); i++) {
+		if (!_is_same_builtin_type(p_a.container_element_types[i], p_b.container_element_types[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::SuiteNode *p_block, bool p_add_locals, bool p_clear_locals) {
 	Error err = OK;
 	GDScriptCodeGenerator *gen = codegen.generator;
@@ -2183,7 +2324,18 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				GDScriptDataType local_type = _gdtype_from_datatype(lv->get_datatype(), codegen.script);
 
 				bool initialized = false;
-				if (lv->initializer != nullptr) {
+				if (lv->initializer != nullptr && (lv->initializer->type == GDScriptParser::Node::ARRAY || lv->initializer->type == GDScriptParser::Node::DICTIONARY) && !lv->use_conversion_assign && !codegen.escaping_locals.has(lv)) {
+					// A literal of builtin elements that never leaves this variable can be built in place and reused.
+					GDScriptDataType literal_type = _gdtype_from_datatype(lv->initializer->get_datatype(), codegen.script);
+					if (!literal_type.can_contain_object() && _is_same_builtin_type(literal_type, local_type)) {
+						_write_container_literal(codegen, err, lv->initializer, literal_type, local, true);
+						if (err) {
+							return err;
+						}
+						initialized = true;
+					}
+				}
+				if (!initialized && lv->initializer != nullptr) {
 					GDScriptCodeGenerator::Address src_address = _parse_expression(codegen, err, lv->initializer);
 					if (err) {
 						return err;
@@ -2412,6 +2564,8 @@ GDScriptFunction *GDScriptCompiler::_parse_function(Error &r_error, GDScript *p_
 			codegen.generator->end_parameters();
 		}
 
+		_mark_escaping_locals(p_func->body, false, codegen.escaping_locals);
+
 		// No need to reset locals at the end of the function, the stack will be cleared anyway.
 		r_error = _parse_block(codegen, p_func->body, true, false);
 		if (r_error) {
@@ -3268,6 +3422,10 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	make_scripts(p_script, root, p_keep_state);
 
 	main_script->_owner = nullptr;
+
+	// Member layouts and functions are about to be replaced.
+	GDScriptFunction::invalidate_inline_caches();
+
 	Error err = _prepare_compilation(main_script, parser->get_tree(), p_keep_state);
 
 	if (err) {
@@ -3275,6 +3433,7 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	}
 
 	err = _compile_class(main_script, root, p_keep_state);
+	GDScriptFunction::invalidate_inline_caches();
 	if (err) {
 		return err;
 	}
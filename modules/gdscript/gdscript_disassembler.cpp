@@ -308,7 +308,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += "\"] = ";
 				text += DADDR(2);
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_SET_NAMED_VALIDATED: {
 				text += "set_named validated ";
@@ -329,7 +329,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -556,7 +556,11 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				text += "]";
 
-				incr += 3 + argc;
+				if (_code_ptr[ip + 2 + instr_var_args] >= 0) {
+					text += " (pooled)";
+				}
+
+				incr += 4 + argc;
 			} break;
 			case OPCODE_CONSTRUCT_TYPED_ARRAY: {
 				int instr_var_args = _code_ptr[++ip];
@@ -591,7 +595,11 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				text += "]";
 
-				incr += 6 + argc;
+				if (_code_ptr[ip + argc + 6] >= 0) {
+					text += " (pooled)";
+				}
+
+				incr += 7 + argc;
 			} break;
 			case OPCODE_CONSTRUCT_DICTIONARY: {
 				int instr_var_args = _code_ptr[++ip];
@@ -611,7 +619,11 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				text += "}";
 
-				incr += 3 + argc * 2;
+				if (_code_ptr[ip + argc * 2 + 3] >= 0) {
+					text += " (pooled)";
+				}
+
+				incr += 4 + argc * 2;
 			} break;
 			case OPCODE_CONSTRUCT_TYPED_DICTIONARY: {
 				int instr_var_args = _code_ptr[++ip];
@@ -663,7 +675,11 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				text += "}";
 
-				incr += 9 + argc * 2;
+				if (_code_ptr[ip + argc * 2 + 9] >= 0) {
+					text += " (pooled)";
+				}
+
+				incr += 10 + argc * 2;
 			} break;
 			case OPCODE_CALL:
 			case OPCODE_CALL_RETURN:
@@ -698,7 +714,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
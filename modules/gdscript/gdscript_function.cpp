@@ -32,6 +32,8 @@
 
 #include "gdscript.h"
 
+SafeNumeric<uint32_t> GDScriptFunction::inline_cache_epoch;
+
 Variant GDScriptFunction::get_constant(int p_idx) const {
 	ERR_FAIL_INDEX_V(p_idx, constants.size(), "<errconst>");
 	return constants[p_idx];
@@ -446,6 +446,52 @@ private:
 	friend class GDScriptByteCodeGenerator;
 	friend class GDScriptLanguage;
 
+	// Polymorphic inline cache of a named access or call on an untyped receiver. Entries are keyed on the
+	// receiver's built-in type, or its class and script, and keep what the generic lookup resolved to.
+	struct InlineCache {
+		static constexpr int MAX_ENTRIES = 4;
+
+		enum Kind : uint8_t {
+			KIND_BUILTIN_MEMBER, // Validated getter or setter of a built-in type.
+			KIND_SCRIPT_MEMBER, // GDScript member variable without getter or setter.
+			KIND_SCRIPT_METHOD, // GDScript function.
+			KIND_NATIVE_PROPERTY, // ClassDB property getter or setter.
+			KIND_NATIVE_METHOD, // ClassDB method.
+		};
+
+		struct Entry {
+			Kind kind = KIND_BUILTIN_MEMBER;
+			Variant::Type base_type = Variant::NIL;
+			Variant::Type member_type = Variant::NIL;
+			const GDScript *script = nullptr;
+			StringName class_name;
+			int member_index = -1;
+			const GDScriptDataType *member_data_type = nullptr;
+			union {
+				Variant::ValidatedGetter getter = nullptr;
+				Variant::ValidatedSetter setter;
+				GDScriptFunction *function;
+				MethodBind *method;
+			};
+		};
+
+		Entry entries[MAX_ENTRIES];
+		int entry_count = 0;
+		uint32_t epoch = 0;
+		bool megamorphic = false;
+
+		void add_entry(const Entry &p_entry) {
+			if (entry_count == MAX_ENTRIES) {
+				// Too many receiver kinds, stop resolving and let the generic path handle the rest.
+				megamorphic = true;
+				return;
+			}
+			entries[entry_count++] = p_entry;
+		}
+	};
+
+	static SafeNumeric<uint32_t> inline_cache_epoch;
+
 	StringName name;
 	StringName source;
 	bool _static = false;
@@ -482,6 +528,8 @@ private:
 	Vector<GDScriptUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
+	Vector<Variant> container_pool;
+	Vector<InlineCache> inline_caches;
 
 	int _code_size = 0;
 	int _default_arg_count = 0;
@@ -500,6 +548,8 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _container_pool_count = 0;
+	int _inline_caches_count = 0;
 
 	int *_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
@@ -518,6 +568,8 @@ private:
 	const GDScriptUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	Variant *_container_pool_ptr = nullptr;
+	InlineCache *_inline_caches_ptr = nullptr;
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -554,6 +606,14 @@ private:
 
 	_FORCE_INLINE_ String _get_call_error(const String &p_where, const Variant **p_argptrs, const Variant &p_ret, const Callable::CallError &p_err) const;
 	Variant _get_default_variant_for_data_type(const GDScriptDataType &p_data_type);
+	Array *_get_pooled_array(int p_pool_index, const Variant *p_dst);
+	Dictionary *_get_pooled_dictionary(int p_pool_index, const Variant *p_dst);
+	_FORCE_INLINE_ InlineCache *_get_inline_cache(int p_cache_index);
+	static bool _get_inline_cache_receiver(Object *p_object, GDScriptInstance *&r_instance);
+	static bool _is_native_member_cacheable(const Object *p_object, const GDScriptInstance *p_instance, const StringName &p_name, const StringName &p_hook);
+	bool _get_named_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret);
+	bool _set_named_cached(InlineCache &p_cache, Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid);
+	bool _call_cached(InlineCache &p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_err, bool p_sampled);
 
 public:
 	static constexpr int MAX_CALL_DEPTH = 2048; // Limit to try to avoid crash because of a stack overflow.
@@ -587,6 +647,7 @@ public:
 	StringName get_global_name(int p_idx) const;
 
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
+	static void invalidate_inline_caches() { inline_cache_epoch.increment(); }
 	void debug_get_stack_member_state(int p_line, List<Pair<StringName, int>> *r_stackvars) const;
 
 #ifdef DEBUG_ENABLED
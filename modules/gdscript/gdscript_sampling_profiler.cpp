@@ -0,0 +1,244 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#include "gdscript.h"
+#include "gdscript_function.h"
+
+#include "core/debugger/engine_debugger.h"
+#include "core/debugger/engine_profiler.h"
+#include "core/io/file_access.h"
+#include "core/object/method_bind.h"
+#include "core/os/os.h"
+
+thread_local GDScriptSamplingProfiler::ThreadStack GDScriptSamplingProfiler::thread_stack;
+
+SafeFlag GDScriptSamplingProfiler::active;
+SafeNumeric<uint32_t> GDScriptSamplingProfiler::tick;
+Thread GDScriptSamplingProfiler::sampler_thread;
+uint32_t GDScriptSamplingProfiler::interval_usec = 1000;
+
+Mutex GDScriptSamplingProfiler::mutex;
+HashMap<String, uint64_t> GDScriptSamplingProfiler::folded_stacks;
+uint64_t GDScriptSamplingProfiler::sample_count = 0;
+
+void GDScriptSamplingProfiler::_sampler_thread_func(void *p_userdata) {
+	Thread::set_name("GDScript Sampling Profiler");
+	while (active.is_set()) {
+		OS::get_singleton()->delay_usec(interval_usec);
+		tick.increment();
+	}
+}
+
+void GDScriptSamplingProfiler::_take_sample(uint32_t p_weight) {
+	if (thread_stack.frames.is_empty()) {
+		return;
+	}
+
+	String stack = Thread::get_caller_id() == Thread::get_main_id() ? String("main") : vformat("thread_%d", Thread::get_caller_id());
+	for (const Frame &frame : thread_stack.frames) {
+		// The separator characters of the folded format must not appear inside frame names.
+		String source = String(frame.function->get_source()).replace(";", "_").replace(" ", "_");
+		if (source.is_empty()) {
+			source = "<built-in>";
+		}
+		stack += ";" + source + ":" + String(frame.function->get_name()) + ":" + itos(*frame.line);
+		if (frame.native) {
+			stack += ";" + String(frame.native->get_instance_class()) + "::" + String(frame.native->get_name());
+		} else if (frame.native_method != StringName()) {
+			stack += ";" + String(frame.native_class) + "::" + String(frame.native_method);
+		}
+	}
+
+	MutexLock lock(mutex);
+	HashMap<String, uint64_t>::Iterator E = folded_stacks.find(stack);
+	if (E) {
+		E->value += p_weight;
+	} else {
+		folded_stacks.insert(stack, p_weight);
+	}
+	sample_count += p_weight;
+}
+
+void GDScriptSamplingProfiler::begin_variant_call(const Variant *p_base, const StringName &p_method) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		if (Variant::has_builtin_method(p_base->get_type(), p_method)) {
+			begin_native_call(Variant::get_type_name(p_base->get_type()), p_method);
+		}
+		return;
+	}
+
+	Object *obj = p_base->get_validated_object();
+	if (!obj) {
+		return;
+	}
+	// Script methods push their own frame.
+	ScriptInstance *script_instance = obj->get_script_instance();
+	if (script_instance && script_instance->has_method(p_method)) {
+		return;
+	}
+	MethodBind *method = ClassDB::get_method(obj->get_class_name(), p_method);
+	if (method) {
+		begin_native_call(method);
+	}
+}
+
+void GDScriptSamplingProfiler::start(uint32_t p_interval_usec) {
+	ERR_FAIL_COND_MSG(p_interval_usec == 0, "The sampling interval must be greater than zero.");
+	if (active.is_set()) {
+		stop();
+	}
+
+	interval_usec = p_interval_usec;
+	active.set();
+	sampler_thread.start(_sampler_thread_func, nullptr);
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!active.is_set()) {
+		return;
+	}
+	active.clear();
+	if (sampler_thread.is_started()) {
+		sampler_thread.wait_to_finish();
+	}
+}
+
+void GDScriptSamplingProfiler::clear() {
+	MutexLock lock(mutex);
+	folded_stacks.clear();
+	sample_count = 0;
+}
+
+uint64_t GDScriptSamplingProfiler::get_sample_count() {
+	MutexLock lock(mutex);
+	return sample_count;
+}
+
+String GDScriptSamplingProfiler::get_folded_stacks(bool p_clear) {
+	Vector<String> lines;
+	{
+		MutexLock lock(mutex);
+		lines.resize(folded_stacks.size());
+		int idx = 0;
+		for (const KeyValue<String, uint64_t> &E : folded_stacks) {
+			lines.write[idx++] = E.key + " " + itos(E.value);
+		}
+		if (p_clear) {
+			folded_stacks.clear();
+			sample_count = 0;
+		}
+	}
+
+	lines.sort();
+	String result;
+	for (const String &line : lines) {
+		result += line + "\n";
+	}
+	return result;
+}
+
+Error GDScriptSamplingProfiler::save_folded_stacks(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Cannot save GDScript sampling profile to file '%s'.", p_path));
+	f->store_string(get_folded_stacks());
+	return OK;
+}
+
+/* ENGINE DEBUGGER PROFILER */
+
+// Toggle options: [interval_usec: int, flush_interval_sec: float].
+// Folded stacks are sent as "gdscript_sampler:profile" when the profiler is stopped,
+// and periodically while it runs if a flush interval is given.
+class GDScriptSamplingEngineProfiler : public EngineProfiler {
+	double flush_interval = 0.0;
+	double time_since_flush = 0.0;
+
+	void _send_profile() {
+		uint64_t samples = GDScriptSamplingProfiler::get_sample_count();
+		Array msg;
+		msg.push_back(GDScriptSamplingProfiler::get_folded_stacks(true));
+		msg.push_back(samples);
+		EngineDebugger::get_singleton()->send_message("gdscript_sampler:profile", msg);
+	}
+
+public:
+	void toggle(bool p_enable, const Array &p_opts) override {
+		if (p_enable) {
+			uint32_t interval = 1000;
+			if (p_opts.size() > 0 && p_opts[0].get_type() == Variant::INT) {
+				interval = MAX(1, int(p_opts[0]));
+			}
+			flush_interval = 0.0;
+			if (p_opts.size() > 1 && (p_opts[1].get_type() == Variant::FLOAT || p_opts[1].get_type() == Variant::INT)) {
+				flush_interval = MAX(0.0, double(p_opts[1]));
+			}
+			time_since_flush = 0.0;
+			GDScriptSamplingProfiler::clear();
+			GDScriptSamplingProfiler::start(interval);
+		} else {
+			GDScriptSamplingProfiler::stop();
+			_send_profile();
+		}
+	}
+
+	void tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) override {
+		if (flush_interval <= 0.0) {
+			return;
+		}
+		time_since_flush += p_frame_time;
+		if (time_since_flush >= flush_interval) {
+			time_since_flush = 0.0;
+			_send_profile();
+		}
+	}
+};
+
+static Ref<GDScriptSamplingEngineProfiler> debugger_profiler;
+
+void GDScriptSamplingProfiler::register_debugger_profiler() {
+	if (!EngineDebugger::is_active() || debugger_profiler.is_valid()) {
+		return;
+	}
+	debugger_profiler.instantiate();
+	debugger_profiler->bind("gdscript_sampler");
+}
+
+void GDScriptSamplingProfiler::unregister_debugger_profiler() {
+	if (debugger_profiler.is_null()) {
+		return;
+	}
+	if (debugger_profiler->is_bound()) {
+		debugger_profiler->unbind();
+	}
+	debugger_profiler.unref();
+}
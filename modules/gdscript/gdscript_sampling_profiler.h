@@ -0,0 +1,140 @@
+/**************************************************************************/
+/*  gdscript_sampling_profiler.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScriptFunction;
+class MethodBind;
+class Variant;
+
+// Low-overhead, timer-driven alternative to the instrumenting GDScript profiler.
+// A background thread bumps a tick counter at a fixed interval. VM threads notice the change at
+// the next line or after a native call returns, and record their script call stack (plus the
+// native method being executed, if any) as folded stacks that flamegraph tools can read directly.
+class GDScriptSamplingProfiler {
+	struct Frame {
+		const GDScriptFunction *function = nullptr;
+		const int *line = nullptr;
+		const MethodBind *native = nullptr;
+		// Set instead of `native` for built-in type methods, which have no MethodBind.
+		StringName native_class;
+		StringName native_method;
+	};
+
+	struct ThreadStack {
+		LocalVector<Frame> frames;
+		uint32_t last_tick = 0;
+	};
+
+	static thread_local ThreadStack thread_stack;
+
+	static SafeFlag active;
+	static SafeNumeric<uint32_t> tick;
+	static Thread sampler_thread;
+	static uint32_t interval_usec;
+
+	static Mutex mutex;
+	static HashMap<String, uint64_t> folded_stacks;
+	static uint64_t sample_count;
+
+	static void _sampler_thread_func(void *p_userdata);
+	static void _take_sample(uint32_t p_weight);
+
+public:
+	_FORCE_INLINE_ static bool is_active() { return active.is_set(); }
+
+	// The following are called by the VM only for frames that were entered while sampling was active.
+	_FORCE_INLINE_ static void enter_function(const GDScriptFunction *p_function, const int *p_line) {
+		if (thread_stack.frames.is_empty()) {
+			// Don't attribute the time this thread spent outside of scripts to its first sampled line.
+			thread_stack.last_tick = tick.get();
+		}
+		thread_stack.frames.push_back({ p_function, p_line, nullptr });
+	}
+
+	_FORCE_INLINE_ static void exit_function() {
+		thread_stack.frames.resize(thread_stack.frames.size() - 1);
+	}
+
+	_FORCE_INLINE_ static void poll() {
+		uint32_t current = tick.get();
+		if (unlikely(current != thread_stack.last_tick)) {
+			_take_sample(current - thread_stack.last_tick);
+			thread_stack.last_tick = current;
+		}
+	}
+
+	_FORCE_INLINE_ static void begin_native_call(const MethodBind *p_method) {
+		thread_stack.frames[thread_stack.frames.size() - 1].native = p_method;
+	}
+
+	_FORCE_INLINE_ static void begin_native_call(const StringName &p_class, const StringName &p_method) {
+		Frame &frame = thread_stack.frames[thread_stack.frames.size() - 1];
+		frame.native_class = p_class;
+		frame.native_method = p_method;
+	}
+
+	// Resolves the native method a generic Variant::callp() dispatches to, if any.
+	static void begin_variant_call(const Variant *p_base, const StringName &p_method);
+
+	_FORCE_INLINE_ static void end_native_call() {
+		// Samples requested while inside the native call are attributed to it.
+		poll();
+		Frame &frame = thread_stack.frames[thread_stack.frames.size() - 1];
+		frame.native = nullptr;
+		if (frame.native_method != StringName()) {
+			frame.native_class = StringName();
+			frame.native_method = StringName();
+		}
+	}
+
+	static void start(uint32_t p_interval_usec);
+	static void stop();
+	static void clear();
+
+	static uint64_t get_sample_count();
+	// Returns one "frame;frame;frame count" line per distinct stack, as used by flamegraph.pl and compatible tools.
+	static String get_folded_stacks(bool p_clear = false);
+	static Error save_folded_stacks(const String &p_path);
+
+	static void register_debugger_profiler();
+	static void unregister_debugger_profiler();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -31,8 +31,10 @@
 #include "gdscript.h"
 #include "gdscript_function.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_sampling_profiler.h"
 
 #include "core/os/os.h"
+#include "scene/scene_string_names.h"
 
 #ifdef DEBUG_ENABLED
 
@@ -150,6 +152,357 @@ Variant GDScriptFunction::_get_default_variant_for_data_type(const GDScriptDataT
 	return Variant();
 }
 
+// Pooled containers stay referenced by the function between executions. One can be refilled in
+// place when nothing but the pool (and the destination it is about to be assigned to again) holds
+// it, since the reuse can't be observed then. The pool is shared by all callers, so only the main
+// thread uses it.
+Array *GDScriptFunction::_get_pooled_array(int p_pool_index, const Variant *p_dst) {
+	if (!Thread::is_main_thread()) {
+		return nullptr;
+	}
+	Variant &pooled = _container_pool_ptr[p_pool_index];
+	if (pooled.get_type() != Variant::ARRAY) {
+		return nullptr;
+	}
+	Array *array = VariantInternal::get_array(&pooled);
+	int expected_refs = (p_dst->get_type() == Variant::ARRAY && VariantInternal::get_array(p_dst)->id() == array->id()) ? 2 : 1;
+	if (array->get_reference_count() != expected_refs || array->is_read_only()) {
+		return nullptr;
+	}
+	return array;
+}
+
+Dictionary *GDScriptFunction::_get_pooled_dictionary(int p_pool_index, const Variant *p_dst) {
+	if (!Thread::is_main_thread()) {
+		return nullptr;
+	}
+	Variant &pooled = _container_pool_ptr[p_pool_index];
+	if (pooled.get_type() != Variant::DICTIONARY) {
+		return nullptr;
+	}
+	Dictionary *dict = VariantInternal::get_dictionary(&pooled);
+	int expected_refs = (p_dst->get_type() == Variant::DICTIONARY && VariantInternal::get_dictionary(p_dst)->id() == dict->id()) ? 2 : 1;
+	if (dict->get_reference_count() != expected_refs || dict->is_read_only()) {
+		return nullptr;
+	}
+	return dict;
+}
+
+GDScriptFunction::InlineCache *GDScriptFunction::_get_inline_cache(int p_cache_index) {
+	// Caches are filled and read without locking, so only the main thread uses them.
+	if (!Thread::is_main_thread()) {
+		return nullptr;
+	}
+	InlineCache *cache = &_inline_caches_ptr[p_cache_index];
+	uint32_t epoch = inline_cache_epoch.get();
+	if (unlikely(cache->epoch != epoch)) {
+		// Scripts were compiled or cleared since the entries were resolved, they may point to freed data.
+		cache->entry_count = 0;
+		cache->megamorphic = false;
+		cache->epoch = epoch;
+	}
+	return cache;
+}
+
+bool GDScriptFunction::_get_inline_cache_receiver(Object *p_object, GDScriptInstance *&r_instance) {
+	ScriptInstance *script_instance = p_object->get_script_instance();
+	if (!script_instance) {
+		r_instance = nullptr;
+		return true;
+	}
+	if (script_instance->get_language() != GDScriptLanguage::get_singleton() || script_instance->is_placeholder()) {
+		return false;
+	}
+	r_instance = static_cast<GDScriptInstance *>(script_instance);
+	return true;
+}
+
+// Whether `p_name` always resolves to the native class of the object, i.e. nothing the script instance
+// looks up first (members, constants, signals, functions, inner classes, or the `_get`/`_set` hook) can take it.
+bool GDScriptFunction::_is_native_member_cacheable(const Object *p_object, const GDScriptInstance *p_instance, const StringName &p_name, const StringName &p_hook) {
+	ClassDB::APIType api = ClassDB::get_api_type(p_object->get_class_name());
+	if (api != ClassDB::API_CORE && api != ClassDB::API_EDITOR) {
+		// Extension classes can be reloaded, and have their own property hooks.
+		return false;
+	}
+	if (!p_instance) {
+		return true;
+	}
+	if (p_instance->script->member_indices.has(p_name)) {
+		return false;
+	}
+	for (const GDScript *sptr = p_instance->script.ptr(); sptr; sptr = sptr->_base) {
+		if (!sptr->valid || sptr->constants.has(p_name) || sptr->static_variables_indices.has(p_name) || sptr->_signals.has(p_name) ||
+				sptr->member_functions.has(p_name) || sptr->member_functions.has(p_hook) || sptr->subclasses.has(p_name)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptFunction::_get_named_cached(InlineCache &p_cache, const Variant *p_base, const StringName &p_name, Variant &r_ret) {
+	Variant::Type base_type = p_base->get_type();
+	Object *obj = nullptr;
+	GDScriptInstance *instance = nullptr;
+	if (base_type == Variant::OBJECT) {
+		obj = p_base->get_validated_object();
+		if (!obj || !_get_inline_cache_receiver(obj, instance)) {
+			return false;
+		}
+	}
+	const GDScript *script = instance ? instance->script.ptr() : nullptr;
+
+	for (int i = 0; i < p_cache.entry_count; i++) {
+		const InlineCache::Entry &entry = p_cache.entries[i];
+		switch (entry.kind) {
+			case InlineCache::KIND_BUILTIN_MEMBER: {
+				if (entry.base_type == base_type) {
+					VariantInternal::initialize(&r_ret, entry.member_type);
+					entry.getter(p_base, &r_ret);
+					return true;
+				}
+			} break;
+			case InlineCache::KIND_SCRIPT_MEMBER: {
+				if (instance && entry.script == script) {
+					r_ret = instance->members[entry.member_index];
+					return true;
+				}
+			} break;
+			case InlineCache::KIND_NATIVE_PROPERTY: {
+				if (obj && entry.script == script && obj->get_class_name() == entry.class_name) {
+					Callable::CallError ce;
+					r_ret = entry.method->call(obj, nullptr, 0, ce);
+					return true;
+				}
+			} break;
+			default:
+				break;
+		}
+	}
+
+	if (p_cache.megamorphic) {
+		return false;
+	}
+
+	// Miss. Resolve what this receiver kind maps to for the next executions; this one takes the generic path.
+	const GDScript::MemberInfo *member = instance ? instance->script->member_indices.getptr(p_name) : nullptr;
+	InlineCache::Entry entry;
+	if (!obj) {
+		entry.getter = Variant::get_member_validated_getter(base_type, p_name);
+		if (!entry.getter) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_BUILTIN_MEMBER;
+		entry.base_type = base_type;
+		entry.member_type = Variant::get_member_type(base_type, p_name);
+	} else if (member) {
+		if (member->getter != StringName()) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_SCRIPT_MEMBER;
+		entry.script = script;
+		entry.member_index = member->index;
+	} else {
+		if (!_is_native_member_cacheable(obj, instance, p_name, GDScriptLanguage::get_singleton()->strings._get)) {
+			return false;
+		}
+		const StringName &class_name = obj->get_class_name();
+		bool is_property = false;
+		int index = ClassDB::get_property_index(class_name, p_name, &is_property);
+		if (!is_property || index >= 0) {
+			return false;
+		}
+		StringName getter = ClassDB::get_property_getter(class_name, p_name);
+		entry.method = getter == StringName() ? nullptr : ClassDB::get_method(class_name, getter);
+		if (!entry.method) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_NATIVE_PROPERTY;
+		entry.script = script;
+		entry.class_name = class_name;
+	}
+	p_cache.add_entry(entry);
+	return false;
+}
+
+bool GDScriptFunction::_set_named_cached(InlineCache &p_cache, Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid) {
+	Variant::Type base_type = p_base->get_type();
+	Object *obj = nullptr;
+	GDScriptInstance *instance = nullptr;
+	if (base_type == Variant::OBJECT) {
+		obj = p_base->get_validated_object();
+		if (!obj || !_get_inline_cache_receiver(obj, instance)) {
+			return false;
+		}
+	}
+	const GDScript *script = instance ? instance->script.ptr() : nullptr;
+
+	for (int i = 0; i < p_cache.entry_count; i++) {
+		const InlineCache::Entry &entry = p_cache.entries[i];
+		switch (entry.kind) {
+			case InlineCache::KIND_BUILTIN_MEMBER: {
+				if (entry.base_type == base_type) {
+					// Values needing a conversion take the generic path.
+					if (p_value->get_type() != entry.member_type) {
+						return false;
+					}
+					entry.setter(p_base, p_value);
+					r_valid = true;
+					return true;
+				}
+			} break;
+			case InlineCache::KIND_SCRIPT_MEMBER: {
+				if (instance && entry.script == script) {
+					if (entry.member_data_type->has_type && !entry.member_data_type->is_type(*p_value)) {
+						return false;
+					}
+#ifdef TOOLS_ENABLED
+					// Same as `Object::set()`.
+					obj->set_edited_flag();
+#endif
+					instance->members.write[entry.member_index] = *p_value;
+					r_valid = true;
+					return true;
+				}
+			} break;
+			case InlineCache::KIND_NATIVE_PROPERTY: {
+				if (obj && entry.script == script && obj->get_class_name() == entry.class_name) {
+#ifdef TOOLS_ENABLED
+					// Same as `Object::set()`.
+					obj->set_edited_flag();
+#endif
+					Callable::CallError ce;
+					entry.method->call(obj, &p_value, 1, ce);
+					r_valid = ce.error == Callable::CallError::CALL_OK;
+					return true;
+				}
+			} break;
+			default:
+				break;
+		}
+	}
+
+	if (p_cache.megamorphic) {
+		return false;
+	}
+
+	const GDScript::MemberInfo *member = instance ? instance->script->member_indices.getptr(p_name) : nullptr;
+	InlineCache::Entry entry;
+	if (!obj) {
+		entry.setter = Variant::get_member_validated_setter(base_type, p_name);
+		if (!entry.setter) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_BUILTIN_MEMBER;
+		entry.base_type = base_type;
+		entry.member_type = Variant::get_member_type(base_type, p_name);
+	} else if (member) {
+		if (member->setter != StringName()) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_SCRIPT_MEMBER;
+		entry.script = script;
+		entry.member_index = member->index;
+		entry.member_data_type = &member->data_type;
+	} else {
+		if (!_is_native_member_cacheable(obj, instance, p_name, GDScriptLanguage::get_singleton()->strings._set)) {
+			return false;
+		}
+		const StringName &class_name = obj->get_class_name();
+		bool is_property = false;
+		int index = ClassDB::get_property_index(class_name, p_name, &is_property);
+		if (!is_property || index >= 0) {
+			return false;
+		}
+		StringName setter = ClassDB::get_property_setter(class_name, p_name);
+		entry.method = setter == StringName() ? nullptr : ClassDB::get_method(class_name, setter);
+		if (!entry.method) {
+			return false;
+		}
+		entry.kind = InlineCache::KIND_NATIVE_PROPERTY;
+		entry.script = script;
+		entry.class_name = class_name;
+	}
+	p_cache.add_entry(entry);
+	return false;
+}
+
+bool GDScriptFunction::_call_cached(InlineCache &p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_err, bool p_sampled) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+	// Freed receivers are left to Variant::callp(), which reports them.
+	Object *obj = p_base->get_validated_object();
+	GDScriptInstance *instance = nullptr;
+	if (!obj || !_get_inline_cache_receiver(obj, instance)) {
+		return false;
+	}
+	const GDScript *script = instance ? instance->script.ptr() : nullptr;
+
+	for (int i = 0; i < p_cache.entry_count; i++) {
+		const InlineCache::Entry &entry = p_cache.entries[i];
+		if (entry.script != script) {
+			continue;
+		}
+		if (entry.kind == InlineCache::KIND_SCRIPT_METHOD) {
+#ifdef DEBUG_ENABLED
+			// Same as Object::callp(), so that the receiver can't be freed while its method runs.
+			_ObjectDebugLock debug_lock(obj);
+#endif
+			r_err.error = Callable::CallError::CALL_OK;
+			r_ret = entry.function->call(instance, p_args, p_argcount, r_err);
+			return true;
+		}
+		if (entry.kind == InlineCache::KIND_NATIVE_METHOD && obj->get_class_name() == entry.class_name) {
+#ifdef DEBUG_ENABLED
+			_ObjectDebugLock debug_lock(obj);
+#endif
+			r_err.error = Callable::CallError::CALL_OK;
+			if (unlikely(p_sampled)) {
+				GDScriptSamplingProfiler::begin_native_call(entry.method);
+			}
+			r_ret = entry.method->call(obj, p_args, p_argcount, r_err);
+			if (unlikely(p_sampled)) {
+				GDScriptSamplingProfiler::end_native_call();
+			}
+			return true;
+		}
+	}
+
+	if (p_cache.megamorphic || p_method == CoreStringName(free_) || p_method == SceneStringName(_ready)) {
+		return false;
+	}
+
+	InlineCache::Entry entry;
+	entry.script = script;
+	for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+		if (!sptr->valid) {
+			return false;
+		}
+		HashMap<StringName, GDScriptFunction *>::ConstIterator E = sptr->member_functions.find(p_method);
+		if (E) {
+			entry.kind = InlineCache::KIND_SCRIPT_METHOD;
+			entry.function = E->value;
+			p_cache.add_entry(entry);
+			return false;
+		}
+	}
+
+	const StringName &class_name = obj->get_class_name();
+	ClassDB::APIType api = ClassDB::get_api_type(class_name);
+	if (api != ClassDB::API_CORE && api != ClassDB::API_EDITOR) {
+		return false;
+	}
+	entry.method = ClassDB::get_method(class_name, p_method);
+	if (!entry.method) {
+		return false;
+	}
+	entry.kind = InlineCache::KIND_NATIVE_METHOD;
+	entry.class_name = class_name;
+	p_cache.add_entry(entry);
+	return false;
+}
+
 String GDScriptFunction::_get_call_error(const String &p_where, const Variant **p_argptrs, const Variant &p_ret, const Callable::CallError &p_err) const {
 	switch (p_err.error) {
 		case Callable::CallError::CALL_OK:
@@ -627,6 +980,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	// Only frames entered while sampling are tracked, so toggling the sampler mid-call stays balanced.
+	const bool sampled = GDScriptSamplingProfiler::is_active();
+	if (unlikely(sampled)) {
+		GDScriptSamplingProfiler::enter_function(this, &line);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	if (EngineDebugger::is_active()) {
@@ -1166,7 +1525,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 
 				GET_VARIANT_PTR(dst, 0);
 				GET_VARIANT_PTR(value, 1);
@@ -1176,8 +1535,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_caches_count);
+				InlineCache *cache = _get_inline_cache(cache_index);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!cache || !_set_named_cached(*cache, dst, *index, value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -1198,7 +1563,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1228,22 +1593,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int cache_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_caches_count);
+				InlineCache *cache = _get_inline_cache(cache_index);
 
-#else
-				*dst = src->get_named(*index, valid);
-#endif
+				bool valid;
+				Variant ret;
+				if (cache && _get_named_cached(*cache, src, *index, ret)) {
+					valid = true;
+				} else {
+					// Also allows a better error message in cases where src and dst are the same stack position.
+					ret = src->get_named(*index, valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1744,29 +2113,49 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_CONSTRUCT_ARRAY) {
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(1 + instr_arg_count);
+				CHECK_SPACE(2 + instr_arg_count);
 				ip += instr_arg_count;
 
 				int argc = _code_ptr[ip + 1];
-				Array array;
-				array.resize(argc);
-
-				for (int i = 0; i < argc; i++) {
-					array[i] = *(instruction_args[i]);
-				}
+				int pool_index = _code_ptr[ip + 2];
+				GD_ERR_BREAK(pool_index >= _container_pool_count);
 
 				GET_INSTRUCTION_ARG(dst, argc);
-				*dst = Variant(); // Clear potential previous typed array.
 
-				*dst = array;
+				Array *pooled = pool_index >= 0 ? _get_pooled_array(pool_index, dst) : nullptr;
+				if (pooled) {
+					pooled->resize(argc);
+					for (int i = 0; i < argc; i++) {
+						(*pooled)[i] = *(instruction_args[i]);
+					}
+					if (dst->get_type() != Variant::ARRAY || VariantInternal::get_array(dst)->id() != pooled->id()) {
+						*dst = Variant(); // Clear potential previous typed array.
+						*dst = *pooled;
+					}
+				} else {
+					Array array;
+					array.resize(argc);
 
-				ip += 2;
+					for (int i = 0; i < argc; i++) {
+						array[i] = *(instruction_args[i]);
+					}
+
+					*dst = Variant(); // Clear potential previous typed array.
+
+					*dst = array;
+
+					if (pool_index >= 0 && Thread::is_main_thread()) {
+						_container_pool_ptr[pool_index] = *dst;
+					}
+				}
+
+				ip += 3;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_TYPED_ARRAY) {
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 				ip += instr_arg_count;
 
 				int argc = _code_ptr[ip + 1];
@@ -1776,50 +2165,91 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				int native_type_idx = _code_ptr[ip + 3];
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
-
-				Array array;
-				array.resize(argc);
-				for (int i = 0; i < argc; i++) {
-					array[i] = *(instruction_args[i]);
-				}
+				int pool_index = _code_ptr[ip + 4];
+				GD_ERR_BREAK(pool_index >= _container_pool_count);
 
 				GET_INSTRUCTION_ARG(dst, argc);
-				*dst = Variant(); // Clear potential previous typed array.
 
-				*dst = Array(array, builtin_type, native_type, *script_type);
+				Array *pooled = pool_index >= 0 ? _get_pooled_array(pool_index, dst) : nullptr;
+				if (pooled) {
+					// Same instruction, so the pooled array already has the right element type.
+					pooled->resize(argc);
+					for (int i = 0; i < argc; i++) {
+						pooled->set(i, *(instruction_args[i]));
+					}
+					if (dst->get_type() != Variant::ARRAY || VariantInternal::get_array(dst)->id() != pooled->id()) {
+						*dst = Variant(); // Clear potential previous typed array.
+						*dst = *pooled;
+					}
+				} else {
+					Array array;
+					array.resize(argc);
+					for (int i = 0; i < argc; i++) {
+						array[i] = *(instruction_args[i]);
+					}
+
+					*dst = Variant(); // Clear potential previous typed array.
 
-				ip += 4;
+					*dst = Array(array, builtin_type, native_type, *script_type);
+
+					if (pool_index >= 0 && Thread::is_main_thread()) {
+						_container_pool_ptr[pool_index] = *dst;
+					}
+				}
+
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_DICTIONARY) {
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(2 + instr_arg_count);
+				CHECK_SPACE(3 + instr_arg_count);
 
 				ip += instr_arg_count;
 
 				int argc = _code_ptr[ip + 1];
-				Dictionary dict;
-
-				for (int i = 0; i < argc; i++) {
-					GET_INSTRUCTION_ARG(k, i * 2 + 0);
-					GET_INSTRUCTION_ARG(v, i * 2 + 1);
-					dict[*k] = *v;
-				}
+				int pool_index = _code_ptr[ip + 2];
+				GD_ERR_BREAK(pool_index >= _container_pool_count);
 
 				GET_INSTRUCTION_ARG(dst, argc * 2);
 
-				*dst = Variant(); // Clear potential previous typed dictionary.
+				Dictionary *pooled = pool_index >= 0 ? _get_pooled_dictionary(pool_index, dst) : nullptr;
+				if (pooled) {
+					pooled->clear();
+					for (int i = 0; i < argc; i++) {
+						GET_INSTRUCTION_ARG(k, i * 2 + 0);
+						GET_INSTRUCTION_ARG(v, i * 2 + 1);
+						(*pooled)[*k] = *v;
+					}
+					if (dst->get_type() != Variant::DICTIONARY || VariantInternal::get_dictionary(dst)->id() != pooled->id()) {
+						*dst = Variant(); // Clear potential previous typed dictionary.
+						*dst = *pooled;
+					}
+				} else {
+					Dictionary dict;
+
+					for (int i = 0; i < argc; i++) {
+						GET_INSTRUCTION_ARG(k, i * 2 + 0);
+						GET_INSTRUCTION_ARG(v, i * 2 + 1);
+						dict[*k] = *v;
+					}
 
-				*dst = dict;
+					*dst = Variant(); // Clear potential previous typed dictionary.
 
-				ip += 2;
+					*dst = dict;
+
+					if (pool_index >= 0 && Thread::is_main_thread()) {
+						_container_pool_ptr[pool_index] = *dst;
+					}
+				}
+
+				ip += 3;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_CONSTRUCT_TYPED_DICTIONARY) {
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(6 + instr_arg_count);
+				CHECK_SPACE(7 + instr_arg_count);
 				ip += instr_arg_count;
 
 				int argc = _code_ptr[ip + 1];
@@ -1836,21 +2266,43 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(value_native_type_idx < 0 || value_native_type_idx >= _global_names_count);
 				const StringName value_native_type = _global_names_ptr[value_native_type_idx];
 
-				Dictionary dict;
-
-				for (int i = 0; i < argc; i++) {
-					GET_INSTRUCTION_ARG(k, i * 2 + 0);
-					GET_INSTRUCTION_ARG(v, i * 2 + 1);
-					dict[*k] = *v;
-				}
+				int pool_index = _code_ptr[ip + 6];
+				GD_ERR_BREAK(pool_index >= _container_pool_count);
 
 				GET_INSTRUCTION_ARG(dst, argc * 2);
 
-				*dst = Variant(); // Clear potential previous typed dictionary.
+				Dictionary *pooled = pool_index >= 0 ? _get_pooled_dictionary(pool_index, dst) : nullptr;
+				if (pooled) {
+					// Same instruction, so the pooled dictionary already has the right key and value types.
+					pooled->clear();
+					for (int i = 0; i < argc; i++) {
+						GET_INSTRUCTION_ARG(k, i * 2 + 0);
+						GET_INSTRUCTION_ARG(v, i * 2 + 1);
+						pooled->set(*k, *v);
+					}
+					if (dst->get_type() != Variant::DICTIONARY || VariantInternal::get_dictionary(dst)->id() != pooled->id()) {
+						*dst = Variant(); // Clear potential previous typed dictionary.
+						*dst = *pooled;
+					}
+				} else {
+					Dictionary dict;
+
+					for (int i = 0; i < argc; i++) {
+						GET_INSTRUCTION_ARG(k, i * 2 + 0);
+						GET_INSTRUCTION_ARG(v, i * 2 + 1);
+						dict[*k] = *v;
+					}
 
-				*dst = Dictionary(dict, key_builtin_type, key_native_type, *key_script_type, value_builtin_type, value_native_type, *value_script_type);
+					*dst = Variant(); // Clear potential previous typed dictionary.
 
-				ip += 6;
+					*dst = Dictionary(dict, key_builtin_type, key_native_type, *key_script_type, value_builtin_type, value_native_type, *value_script_type);
+
+					if (pool_index >= 0 && Thread::is_main_thread()) {
+						_container_pool_ptr[pool_index] = *dst;
+					}
+				}
+
+				ip += 7;
 			}
 			DISPATCH_OPCODE;
 
@@ -1862,7 +2314,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
@@ -1873,6 +2325,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_index = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _inline_caches_count);
+				InlineCache *cache = _get_inline_cache(cache_index);
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1891,7 +2347,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					if (!cache || !_call_cached(*cache, base, *methodname, (const Variant **)argptrs, argc, temp_ret, err, sampled)) {
+						if (unlikely(sampled)) {
+							GDScriptSamplingProfiler::begin_variant_call(base, *methodname);
+						}
+						base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+						if (unlikely(sampled)) {
+							GDScriptSamplingProfiler::end_native_call();
+						}
+					}
 					*ret = temp_ret;
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
@@ -1921,7 +2385,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					}
 #endif
 				} else {
-					base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+					if (!cache || !_call_cached(*cache, base, *methodname, (const Variant **)argptrs, argc, temp_ret, err, sampled)) {
+						if (unlikely(sampled)) {
+							GDScriptSamplingProfiler::begin_variant_call(base, *methodname);
+						}
+						base->callp(*methodname, (const Variant **)argptrs, argc, temp_ret, err);
+						if (unlikely(sampled)) {
+							GDScriptSamplingProfiler::end_native_call();
+						}
+					}
 				}
 #ifdef DEBUG_ENABLED
 
@@ -1971,7 +2443,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif // DEBUG_ENABLED
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -2016,10 +2488,22 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
+					if (unlikely(sampled)) {
+						GDScriptSamplingProfiler::begin_native_call(method);
+					}
 					temp_ret = method->call(base_obj, (const Variant **)argptrs, argc, err);
+					if (unlikely(sampled)) {
+						GDScriptSamplingProfiler::end_native_call();
+					}
 					*ret = temp_ret;
 				} else {
+					if (unlikely(sampled)) {
+						GDScriptSamplingProfiler::begin_native_call(method);
+					}
 					temp_ret = method->call(base_obj, (const Variant **)argptrs, argc, err);
+					if (unlikely(sampled)) {
+						GDScriptSamplingProfiler::end_native_call();
+					}
 				}
 
 #ifdef DEBUG_ENABLED
@@ -2118,7 +2602,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				Callable::CallError err;
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::begin_native_call(method);
+				}
 				*ret = method->call(nullptr, argptrs, argc, err);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::end_native_call();
+				}
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2159,7 +2649,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::begin_native_call(method);
+				}
 				method->validated_call(nullptr, (const Variant **)argptrs, ret);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::end_native_call();
+				}
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2195,7 +2691,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GET_INSTRUCTION_ARG(ret, argc);
 				VariantInternal::initialize(ret, Variant::NIL);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::begin_native_call(method);
+				}
 				method->validated_call(nullptr, (const Variant **)argptrs, nullptr);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::end_native_call();
+				}
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2247,7 +2749,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::begin_native_call(method);
+				}
 				method->validated_call(base_obj, (const Variant **)argptrs, ret);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::end_native_call();
+				}
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2297,7 +2805,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GET_INSTRUCTION_ARG(ret, argc + 1);
 				VariantInternal::initialize(ret, Variant::NIL);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::begin_native_call(method);
+				}
 				method->validated_call(base_obj, (const Variant **)argptrs, nullptr);
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::end_native_call();
+				}
 
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling && GDScriptLanguage::get_singleton()->profile_native_calls) {
@@ -2469,7 +2983,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						if (!mb) {
 							err.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
 						} else {
+							if (unlikely(sampled)) {
+								GDScriptSamplingProfiler::begin_native_call(mb);
+							}
 							*dst = mb->call(p_instance->owner, (const Variant **)argptrs, argc, err);
+							if (unlikely(sampled)) {
+								GDScriptSamplingProfiler::end_native_call();
+							}
 						}
 					} else {
 						err.error = Callable::CallError::CALL_OK;
@@ -3782,6 +4302,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
+				if (unlikely(sampled)) {
+					GDScriptSamplingProfiler::poll();
+				}
+
 				if (EngineDebugger::is_active()) {
 					// line
 					bool do_break = false;
@@ -3863,6 +4387,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 
 	OPCODES_OUT
+	if (unlikely(sampled)) {
+		GDScriptSamplingProfiler::exit_function();
+	}
+
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
@@ -33,6 +33,10 @@
 
 #include "gdscript_test_runner.h"
 
+#include "../gdscript_sampling_profiler.h"
+
+#include "scene/main/node.h"
+
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -70,6 +74,94 @@ func _init():
 	ref_counted->set_script(gdscript);
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
+
+TEST_CASE("[Modules][GDScript] Inline caches behave like generic access") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends Node
+
+func free_self():
+	free()
+
+func call_free_self(receiver):
+	receiver.free_self()
+
+func set_receiver_name(receiver, value):
+	receiver.name = value
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE(error == OK);
+
+	Node *caller = memnew(Node);
+	caller->set_script(gdscript);
+	Node *receiver = memnew(Node);
+	receiver->set_script(gdscript);
+	const ObjectID receiver_id = receiver->get_instance_id();
+
+	// The first call of each pair fills the inline cache, the second one uses it.
+	SUBCASE("Receivers can't be freed while their method runs") {
+		ERR_PRINT_OFF;
+		for (int i = 0; i < 2; i++) {
+			caller->call("call_free_self", receiver);
+			CHECK(ObjectDB::get_instance(receiver_id) != nullptr);
+		}
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("Setting properties marks the receiver as edited") {
+		for (int i = 0; i < 2; i++) {
+			receiver->set_edited(false);
+			caller->call("set_receiver_name", receiver, vformat("Receiver%d", i));
+			CHECK(receiver->get_name() == StringName(vformat("Receiver%d", i)));
+			CHECK(receiver->is_edited());
+		}
+	}
+
+	memdelete(receiver);
+	memdelete(caller);
+}
+
+TEST_CASE("[Modules][GDScript] Sampling profiler records script and native frames") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func outer():
+	inner()
+
+func inner():
+	# Untyped, so the call goes through Variant::callp().
+	var os = OS
+	os.delay_usec(20000)
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE(error == OK);
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(gdscript);
+
+	GDScriptSamplingProfiler::clear();
+	GDScriptSamplingProfiler::start(200);
+	ref_counted->call("outer");
+	GDScriptSamplingProfiler::stop();
+
+	CHECK(GDScriptSamplingProfiler::get_sample_count() > 0);
+	const String folded_stacks = GDScriptSamplingProfiler::get_folded_stacks(true);
+	String native_stack;
+	for (const String &line : folded_stacks.split("\n", false)) {
+		if (line.contains(";OS::delay_usec ")) {
+			native_stack = line;
+		}
+	}
+	INFO(folded_stacks);
+	REQUIRE_MESSAGE(!native_stack.is_empty(), "Time spent in the native call should be attributed to it.");
+	CHECK(native_stack.begins_with("main;<built-in>:outer:5;<built-in>:inner:10;OS::delay_usec "));
+	CHECK(GDScriptSamplingProfiler::get_sample_count() == 0);
+}
 #endif // TOOLS_ENABLED
 
 TEST_CASE("[Modules][GDScript] Validate built-in API") {
@@ -0,0 +1,29 @@
+# Container literals assigned to locals that don't escape are reused across executions.
+# Reuse must never be observable.
+
+func fill(depth: int) -> int:
+	var values: Array[int] = [depth, depth]
+	values.append(depth)
+	if depth > 0:
+		# The outer call still holds its array, so the recursive one needs its own.
+		fill(depth - 1)
+	return values.size() + values[0]
+
+func make() -> Array[int]:
+	var values: Array[int] = [1, 2]
+	return values
+
+func test():
+	for i in 3:
+		var values: Array[int] = [i]
+		values.append(i * 10)
+		var lookup: Dictionary[String, int] = { "a": i }
+		lookup["b"] = i + 1
+		print(values, " ", lookup)
+
+	print(fill(3))
+
+	var first := make()
+	var second := make()
+	first.append(3)
+	print(first, " ", second)
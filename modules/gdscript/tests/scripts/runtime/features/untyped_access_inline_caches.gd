@@ -0,0 +1,63 @@
+# Named access and calls on untyped receivers go through per-instruction caches.
+# Results must not depend on which receivers a call site saw before.
+
+class A:
+	var value = 1
+	func describe():
+		return "A %s" % value
+
+class B extends A:
+	var extra := 2.0
+	func describe():
+		return "B %s %s" % [value, extra]
+
+class C:
+	var value: int:
+		get:
+			return 30
+	func describe():
+		return "C"
+
+class D:
+	var value := 4
+	func _get(property):
+		if property == &"missing":
+			return "from _get"
+		return null
+
+func read(receiver):
+	return receiver.value
+
+func write(receiver, what):
+	receiver.value = what
+
+func describe(receiver):
+	return receiver.describe()
+
+func test():
+	var receivers = [A.new(), B.new(), C.new(), D.new(), Vector2i(5, 6), RefCounted.new(), A.new()]
+	for receiver in receivers:
+		if receiver is Object and receiver.has_method(&"describe"):
+			print(describe(receiver))
+		if receiver is Vector2i:
+			print(receiver.x)
+		elif receiver is A or receiver is C or receiver is D:
+			print(read(receiver))
+
+	for i in 2:
+		var b = receivers[1]
+		write(b, i + 10)
+		b.extra = i
+		print(read(b), " ", b.extra)
+
+	# The typed member converts the float, the untyped one keeps it.
+	var d = receivers[3]
+	write(d, 7.5)
+	print(d.value)
+	print(d.missing)
+
+	var node = Node.new()
+	for i in 2:
+		node.name = "Node%d" % i
+		print(node.name, " ", node.get_child_count())
+	node.free()
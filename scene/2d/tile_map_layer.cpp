@@ -224,6 +224,7 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 			kv.value->cells.clear();
 		}
 		rendering_quadrant_map.clear();
+		rendering_quadrant_draw_order.clear();
 		_rendering_was_cleaned_up = true;
 	}
 
@@ -243,7 +244,9 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 			}
 		}
 
-		// Update all dirty quadrants.
+		// Update all dirty quadrants. Their canvas items are redrawn entirely when all cells are updated, or when what is
+		// baked into the draw commands changed.
+		bool redraw_all_cells = dirty.flags[DIRTY_FLAGS_TILE_SET] || dirty.flags[DIRTY_FLAGS_LAYER_IN_TREE] || dirty.flags[DIRTY_FLAGS_LAYER_SELF_MODULATE] || _rendering_was_cleaned_up;
 		bool needs_set_not_interpolated = is_inside_tree() && get_tree()->is_physics_interpolation_enabled() && !is_physics_interpolated();
 		for (SelfList<RenderingQuadrant> *quadrant_list_element = dirty_rendering_quadrant_list.first(); quadrant_list_element;) {
 			SelfList<RenderingQuadrant> *next_quadrant_list_element = quadrant_list_element->next(); // "Hack" to clear the list while iterating.
@@ -263,12 +266,6 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 			if (has_a_tile) {
 				// Process the quadrant.
 
-				// First, clear the quadrant's canvas items.
-				for (RID &ci : rendering_quadrant->canvas_items) {
-					rs->free(ci);
-				}
-				rendering_quadrant->canvas_items.clear();
-
 				// Sort the quadrant cells.
 				if (is_y_sort_enabled() && x_draw_order_reversed) {
 					rendering_quadrant->cells.sort_custom<CellDataYSortedXReversedComparator>();
@@ -276,36 +273,60 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 					rendering_quadrant->cells.sort();
 				}
 
-				// Those allow to group cell per material or z-index.
-				Ref<Material> prev_material;
-				int prev_z_index = 0;
-				RID prev_ci;
-
+				// Group the cells per material and z-index, each group being drawn in its own CanvasItem.
+				LocalVector<RenderingQuadrant::CanvasItemCells> canvas_item_cells;
+				LocalVector<LocalVector<CellData *>> canvas_item_cell_data;
 				for (SelfList<CellData> *cell_data_quadrant_list_element = rendering_quadrant->cells.first(); cell_data_quadrant_list_element; cell_data_quadrant_list_element = cell_data_quadrant_list_element->next()) {
 					CellData &cell_data = *cell_data_quadrant_list_element->self();
-
-					TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(cell_data.cell.source_id));
-
-					// Get the tile data.
-					const TileData *tile_data;
-					if (cell_data.runtime_tile_data_cache) {
-						tile_data = cell_data.runtime_tile_data_cache;
-					} else {
-						tile_data = atlas_source->get_tile_data(cell_data.cell.get_atlas_coords(), cell_data.cell.alternative_tile);
-					}
+					const TileData *tile_data = _rendering_get_cell_tile_data(cell_data);
 
 					Ref<Material> mat = tile_data->get_material();
 					int tile_z_index = tile_data->get_z_index();
+					if (canvas_item_cells.is_empty() || canvas_item_cells[canvas_item_cells.size() - 1].material != mat || canvas_item_cells[canvas_item_cells.size() - 1].z_index != tile_z_index) {
+						RenderingQuadrant::CanvasItemCells group;
+						group.material = mat;
+						group.z_index = tile_z_index;
+						canvas_item_cells.push_back(group);
+						canvas_item_cell_data.push_back(LocalVector<CellData *>());
+					}
+					canvas_item_cells[canvas_item_cells.size() - 1].cells.push_back(cell_data.coords);
+					canvas_item_cell_data[canvas_item_cell_data.size() - 1].push_back(&cell_data);
+				}
 
-					// Quandrant pos.
+				// Keep the quadrant's canvas items if the cells are still grouped the same way.
+				bool reuse_canvas_items = !redraw_all_cells && canvas_item_cells.size() == rendering_quadrant->canvas_item_cells.size();
+				for (uint32_t i = 0; reuse_canvas_items && i < canvas_item_cells.size(); i++) {
+					const RenderingQuadrant::CanvasItemCells &previous = rendering_quadrant->canvas_item_cells[i];
+					reuse_canvas_items = canvas_item_cells[i].material == previous.material && canvas_item_cells[i].z_index == previous.z_index;
+				}
+
+				if (reuse_canvas_items) {
+					// Only redraw the canvas items with dirty, added or removed cells.
+					uint32_t group_index = 0;
+					for (const RID &ci : rendering_quadrant->canvas_items) {
+						bool changed = canvas_item_cells[group_index].cells != rendering_quadrant->canvas_item_cells[group_index].cells;
+						for (uint32_t i = 0; !changed && i < canvas_item_cell_data[group_index].size(); i++) {
+							changed = canvas_item_cell_data[group_index][i]->dirty_list_element.in_list();
+						}
+						if (changed) {
+							rs->canvas_item_clear(ci);
+							for (const CellData *cell_data : canvas_item_cell_data[group_index]) {
+								_rendering_draw_cell(ci, rendering_quadrant->canvas_items_position, *cell_data);
+							}
+						}
+						group_index++;
+					}
+				} else {
+					// Otherwise, recreate the quadrant's canvas items.
+					for (RID &ci : rendering_quadrant->canvas_items) {
+						rs->free(ci);
+					}
+					rendering_quadrant->canvas_items.clear();
 
-					// --- CanvasItems ---
-					RID ci;
+					for (uint32_t group_index = 0; group_index < canvas_item_cells.size(); group_index++) {
+						const Ref<Material> &mat = canvas_item_cells[group_index].material;
 
-					// Check if the material or the z_index changed.
-					if (prev_ci == RID() || prev_material != mat || prev_z_index != tile_z_index) {
-						// If so, create a new CanvasItem.
-						ci = rs->canvas_item_create();
+						RID ci = rs->canvas_item_create();
 						if (needs_set_not_interpolated) {
 							rs->canvas_item_set_interpolated(ci, false);
 						}
@@ -320,44 +341,40 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 
 						rs->canvas_item_set_light_mask(ci, get_light_mask());
 						rs->canvas_item_set_z_as_relative_to_parent(ci, true);
-						rs->canvas_item_set_z_index(ci, tile_z_index);
+						rs->canvas_item_set_z_index(ci, canvas_item_cells[group_index].z_index);
 
 						rs->canvas_item_set_default_texture_filter(ci, RS::CanvasItemTextureFilter(get_texture_filter_in_tree()));
 						rs->canvas_item_set_default_texture_repeat(ci, RS::CanvasItemTextureRepeat(get_texture_repeat_in_tree()));
 
 						rendering_quadrant->canvas_items.push_back(ci);
 
-						prev_ci = ci;
-						prev_material = mat;
-						prev_z_index = tile_z_index;
-
-					} else {
-						// Keep the same canvas_item to draw on.
-						ci = prev_ci;
+						for (const CellData *cell_data : canvas_item_cell_data[group_index]) {
+							_rendering_draw_cell(ci, rendering_quadrant->canvas_items_position, *cell_data);
+						}
 					}
 
-					const Vector2 local_tile_pos = tile_set->map_to_local(cell_data.coords);
-
-					// Random animation offset.
-					real_t random_animation_offset = 0.0;
-					if (atlas_source->get_tile_animation_mode(cell_data.cell.get_atlas_coords()) != TileSetAtlasSource::TILE_ANIMATION_MODE_DEFAULT) {
-						Array to_hash;
-						to_hash.push_back(local_tile_pos);
-						to_hash.push_back(get_instance_id()); // Use instance id as a random hash
-						random_animation_offset = RandomPCG(to_hash.hash()).randf();
+					// Draw the new canvas items at the same place as the old ones, if they fit.
+					if (!rendering_draw_order_dirty) {
+						if (rendering_quadrant->canvas_items.size() <= rendering_quadrant->draw_index_slots) {
+							int index = rendering_quadrant->draw_index_first;
+							for (const RID &ci : rendering_quadrant->canvas_items) {
+								rs->canvas_item_set_draw_index(ci, index++);
+							}
+						} else {
+							rendering_draw_order_dirty = true;
+						}
 					}
 
-					// Drawing the tile in the canvas item.
-					draw_tile(ci, local_tile_pos - rendering_quadrant->canvas_items_position, tile_set, cell_data.cell.source_id, cell_data.cell.get_atlas_coords(), cell_data.cell.alternative_tile, -1, get_self_modulate(), tile_data, random_animation_offset);
-				}
-
-				// Reset physics interpolation for any recreated canvas items.
-				if (is_physics_interpolated_and_enabled() && is_visible_in_tree()) {
-					for (const RID &ci : rendering_quadrant->canvas_items) {
-						rs->canvas_item_reset_physics_interpolation(ci);
+					// Reset physics interpolation for any recreated canvas items.
+					if (is_physics_interpolated_and_enabled() && is_visible_in_tree()) {
+						for (const RID &ci : rendering_quadrant->canvas_items) {
+							rs->canvas_item_reset_physics_interpolation(ci);
+						}
 					}
 				}
 
+				rendering_quadrant->canvas_item_cells = canvas_item_cells;
+
 			} else {
 				// Free the quadrant.
 				for (const RID &ci : rendering_quadrant->canvas_items) {
@@ -366,6 +383,11 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 					}
 				}
 				rendering_quadrant->cells.clear();
+				// Removing a quadrant leaves the others in order.
+				RBMap<Vector2, Ref<RenderingQuadrant>, RenderingQuadrant::CoordsWorldComparator>::Element *draw_order_element = rendering_quadrant_draw_order.find(rendering_quadrant->draw_order_key);
+				if (draw_order_element && draw_order_element->value() == rendering_quadrant) {
+					rendering_quadrant_draw_order.erase(draw_order_element);
+				}
 				rendering_quadrant_map.erase(rendering_quadrant->quadrant_coords);
 			}
 
@@ -374,23 +396,9 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 
 		dirty_rendering_quadrant_list.clear();
 
-		// Reset the drawing indices.
-		{
-			int index = -(int64_t)0x80000000; // Always must be drawn below children.
-
-			// Sort the quadrants coords per local coordinates.
-			RBMap<Vector2, Ref<RenderingQuadrant>, RenderingQuadrant::CoordsWorldComparator> local_to_map;
-			for (KeyValue<Vector2i, Ref<RenderingQuadrant>> &kv : rendering_quadrant_map) {
-				Ref<RenderingQuadrant> &rendering_quadrant = kv.value;
-				local_to_map[tile_set->map_to_local(rendering_quadrant->quadrant_coords)] = rendering_quadrant;
-			}
-
-			// Sort the quadrants.
-			for (const KeyValue<Vector2, Ref<RenderingQuadrant>> &E : local_to_map) {
-				for (const RID &ci : E.value->canvas_items) {
-					RS::get_singleton()->canvas_item_set_draw_index(ci, index++);
-				}
-			}
+		// Reset the drawing indices, only when quadrants were added or outgrew their range.
+		if (rendering_draw_order_dirty) {
+			_rendering_update_draw_order();
 		}
 
 		// Updates on rendering changes.
@@ -411,13 +419,16 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 	}
 
 	// ----------- Occluders processing -----------
-	if (forced_cleanup || !occlusion_enabled) {
-		// Clean everything.
-		for (KeyValue<Vector2i, CellData> &kv : tile_map_layer_data) {
-			_rendering_occluders_clear_cell(kv.value);
+	bool occluders_cleanup = forced_cleanup || !occlusion_enabled;
+	if (occluders_cleanup) {
+		// Clean everything, unless it already is.
+		if (!_rendering_occluders_were_cleaned_up) {
+			for (KeyValue<Vector2i, CellData> &kv : tile_map_layer_data) {
+				_rendering_occluders_clear_cell(kv.value);
+			}
 		}
 	} else {
-		if (_rendering_was_cleaned_up || dirty.flags[DIRTY_FLAGS_TILE_SET]) {
+		if (_rendering_occluders_were_cleaned_up || _rendering_was_cleaned_up || dirty.flags[DIRTY_FLAGS_TILE_SET]) {
 			// Update all cells.
 			for (KeyValue<Vector2i, CellData> &kv : tile_map_layer_data) {
 				_rendering_occluders_update_cell(kv.value);
@@ -433,7 +444,52 @@ void TileMapLayer::_rendering_update(bool p_force_cleanup) {
 
 	// -----------
 	// Mark the rendering state as up to date.
-	_rendering_was_cleaned_up = forced_cleanup || !occlusion_enabled;
+	_rendering_was_cleaned_up = forced_cleanup;
+	_rendering_occluders_were_cleaned_up = occluders_cleanup;
+}
+
+void TileMapLayer::_rendering_update_draw_order() {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	int index = -(int64_t)0x80000000; // Always must be drawn below children.
+
+	// Leave room for each quadrant to get more canvas items later on.
+	for (const KeyValue<Vector2, Ref<RenderingQuadrant>> &E : rendering_quadrant_draw_order) {
+		const Ref<RenderingQuadrant> &rendering_quadrant = E.value;
+		rendering_quadrant->draw_index_first = index;
+		rendering_quadrant->draw_index_slots = MAX(rendering_quadrant->canvas_items.size() * 2, 4);
+		for (const RID &ci : rendering_quadrant->canvas_items) {
+			rs->canvas_item_set_draw_index(ci, index++);
+		}
+		index = rendering_quadrant->draw_index_first + rendering_quadrant->draw_index_slots;
+	}
+	rendering_draw_order_dirty = false;
+}
+
+const TileData *TileMapLayer::_rendering_get_cell_tile_data(const CellData &p_cell_data) const {
+	if (p_cell_data.runtime_tile_data_cache) {
+		return p_cell_data.runtime_tile_data_cache;
+	}
+	TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(p_cell_data.cell.source_id));
+	return atlas_source->get_tile_data(p_cell_data.cell.get_atlas_coords(), p_cell_data.cell.alternative_tile);
+}
+
+void TileMapLayer::_rendering_draw_cell(RID p_canvas_item, const Vector2 &p_canvas_items_position, const CellData &p_cell_data) {
+	TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(p_cell_data.cell.source_id));
+	const TileData *tile_data = _rendering_get_cell_tile_data(p_cell_data);
+
+	const Vector2 local_tile_pos = tile_set->map_to_local(p_cell_data.coords);
+
+	// Random animation offset.
+	real_t random_animation_offset = 0.0;
+	if (atlas_source->get_tile_animation_mode(p_cell_data.cell.get_atlas_coords()) != TileSetAtlasSource::TILE_ANIMATION_MODE_DEFAULT) {
+		Array to_hash;
+		to_hash.push_back(local_tile_pos);
+		to_hash.push_back(get_instance_id()); // Use instance id as a random hash
+		random_animation_offset = RandomPCG(to_hash.hash()).randf();
+	}
+
+	// Drawing the tile in the canvas item.
+	draw_tile(p_canvas_item, local_tile_pos - p_canvas_items_position, tile_set, p_cell_data.cell.source_id, p_cell_data.cell.get_atlas_coords(), p_cell_data.cell.alternative_tile, -1, get_self_modulate(), tile_data, random_animation_offset);
 }
 
 void TileMapLayer::_rendering_notification(int p_what) {
@@ -514,7 +570,10 @@ void TileMapLayer::_rendering_quadrants_update_cell(CellData &r_cell_data, SelfL
 			rendering_quadrant.instantiate();
 			rendering_quadrant->quadrant_coords = quadrant_coords;
 			rendering_quadrant->canvas_items_position = canvas_items_position;
+			rendering_quadrant->draw_order_key = tile_set->map_to_local(quadrant_coords);
 			rendering_quadrant_map[quadrant_coords] = rendering_quadrant;
+			rendering_quadrant_draw_order[rendering_quadrant->draw_order_key] = rendering_quadrant;
+			rendering_draw_order_dirty = true;
 		}
 
 		// Mark the old quadrant as dirty (if it exists).
@@ -709,9 +768,11 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 		for (KeyValue<Vector2i, CellData> &kv : tile_map_layer_data) {
 			_physics_clear_cell(kv.value);
 		}
+		_physics_clear_merge_regions();
 	} else {
-		if (_physics_was_cleaned_up || dirty.flags[DIRTY_FLAGS_TILE_SET] || dirty.flags[DIRTY_FLAGS_LAYER_USE_KINEMATIC_BODIES] || dirty.flags[DIRTY_FLAGS_LAYER_IN_TREE]) {
+		if (_physics_was_cleaned_up || dirty.flags[DIRTY_FLAGS_TILE_SET] || dirty.flags[DIRTY_FLAGS_LAYER_USE_KINEMATIC_BODIES] || dirty.flags[DIRTY_FLAGS_LAYER_USE_COLLISION_MERGING] || dirty.flags[DIRTY_FLAGS_LAYER_IN_TREE]) {
 			// Update all cells.
+			_physics_clear_merge_regions();
 			for (KeyValue<Vector2i, CellData> &kv : tile_map_layer_data) {
 				_physics_update_cell(kv.value);
 			}
@@ -722,7 +783,13 @@ void TileMapLayer::_physics_update(bool p_force_cleanup) {
 				_physics_update_cell(cell_data);
 			}
 		}
+
+		// Rebuild the merged bodies of the regions containing updated cells.
+		for (const Vector2i &region_coords : physics_merge_dirty_regions) {
+			_physics_update_merge_region(region_coords);
+		}
 	}
+	physics_merge_dirty_regions.clear();
 
 	// -----------
 	// Mark the physics state as up to date.
@@ -748,6 +815,16 @@ void TileMapLayer::_physics_notification(int p_what) {
 						}
 					}
 				}
+
+				for (const KeyValue<Vector2i, PhysicsMergeRegion> &kv : physics_merge_regions) {
+					Transform2D xform(0, tile_set->map_to_local(kv.key * PHYSICS_MERGE_REGION_SIZE));
+					xform = gl_transform * xform;
+					for (RID body : kv.value.bodies) {
+						if (body.is_valid()) {
+							ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
+						}
+					}
+				}
 			}
 			break;
 		case NOTIFICATION_ENTER_TREE:
@@ -764,6 +841,14 @@ void TileMapLayer::_physics_notification(int p_what) {
 						}
 					}
 				}
+
+				for (const KeyValue<Vector2i, PhysicsMergeRegion> &kv : physics_merge_regions) {
+					for (RID body : kv.value.bodies) {
+						if (body.is_valid()) {
+							ps->body_set_space(body, space);
+						}
+					}
+				}
 			}
 	}
 }
@@ -783,9 +868,13 @@ void TileMapLayer::_physics_clear_cell(CellData &r_cell_data) {
 
 void TileMapLayer::_physics_update_cell(CellData &r_cell_data) {
 	Transform2D gl_transform = get_global_transform();
-	RID space = get_world_2d()->get_space();
 	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
 
+	if (use_collision_merging) {
+		// The cell might enter or leave its region's merged bodies.
+		physics_merge_dirty_regions.insert(Vector2i((int)Math::floor((real_t)r_cell_data.coords.x / PHYSICS_MERGE_REGION_SIZE), (int)Math::floor((real_t)r_cell_data.coords.y / PHYSICS_MERGE_REGION_SIZE)));
+	}
+
 	// Recreate bodies and shapes.
 	TileMapCell &c = r_cell_data.cell;
 
@@ -820,14 +909,9 @@ void TileMapLayer::_physics_update_cell(CellData &r_cell_data) {
 				r_cell_data.bodies.resize(tile_set->get_physics_layers_count());
 
 				for (uint32_t tile_set_physics_layer = 0; tile_set_physics_layer < (uint32_t)tile_set->get_physics_layers_count(); tile_set_physics_layer++) {
-					Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(tile_set_physics_layer);
-					uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(tile_set_physics_layer);
-					uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(tile_set_physics_layer);
-					real_t physics_priority = tile_set->get_physics_layer_collision_priority(tile_set_physics_layer);
-
 					RID body = r_cell_data.bodies[tile_set_physics_layer];
-					if (tile_data->get_collision_polygons_count(tile_set_physics_layer) == 0) {
-						// No body needed, free it if it exists.
+					if (tile_data->get_collision_polygons_count(tile_set_physics_layer) == 0 || (use_collision_merging && _physics_is_tile_mergeable(tile_data, transpose, tile_set_physics_layer))) {
+						// No body needed (or the shape is part of a merged body), free it if it exists.
 						if (body.is_valid()) {
 							bodies_coords.erase(body);
 							ps->free(body);
@@ -839,29 +923,11 @@ void TileMapLayer::_physics_update_cell(CellData &r_cell_data) {
 							body = ps->body_create();
 						}
 						bodies_coords[body] = r_cell_data.coords;
-						ps->body_set_mode(body, use_kinematic_bodies ? PhysicsServer2D::BODY_MODE_KINEMATIC : PhysicsServer2D::BODY_MODE_STATIC);
-						ps->body_set_space(body, space);
 
 						Transform2D xform;
 						xform.set_origin(tile_set->map_to_local(r_cell_data.coords));
 						xform = gl_transform * xform;
-						ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
-
-						ps->body_attach_object_instance_id(body, tile_map_node ? tile_map_node->get_instance_id() : get_instance_id());
-						ps->body_set_collision_layer(body, physics_layer);
-						ps->body_set_collision_mask(body, physics_mask);
-						ps->body_set_collision_priority(body, physics_priority);
-						ps->body_set_pickable(body, false);
-						ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, tile_data->get_constant_linear_velocity(tile_set_physics_layer));
-						ps->body_set_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, tile_data->get_constant_angular_velocity(tile_set_physics_layer));
-
-						if (!physics_material.is_valid()) {
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, 0);
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, 1);
-						} else {
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
-							ps->body_set_param(body, PhysicsServer2D::BODY_PARAM_FRICTION, physics_material->computed_friction());
-						}
+						_physics_setup_body(body, tile_set_physics_layer, xform, tile_data->get_constant_linear_velocity(tile_set_physics_layer), tile_data->get_constant_angular_velocity(tile_set_physics_layer));
 
 						// Clear body's shape if needed.
 						ps->body_clear_shapes(body);
@@ -897,6 +963,188 @@ void TileMapLayer::_physics_update_cell(CellData &r_cell_data) {
 	_physics_clear_cell(r_cell_data);
 }
 
+bool TileMapLayer::_physics_is_tile_mergeable(const TileData *p_tile_data, bool p_transpose, int p_physics_layer) const {
+	// Only tiles fully covered by a single, plain rectangle can be merged with their neighbors.
+	if (tile_set->get_tile_shape() != TileSet::TILE_SHAPE_SQUARE) {
+		return false;
+	}
+	if (p_tile_data->get_collision_polygons_count(p_physics_layer) != 1 || p_tile_data->is_collision_polygon_one_way(p_physics_layer, 0)) {
+		return false;
+	}
+	if (p_tile_data->get_constant_linear_velocity(p_physics_layer) != Vector2() || p_tile_data->get_constant_angular_velocity(p_physics_layer) != 0.0) {
+		return false;
+	}
+
+	// Flipping a full cell rectangle does not change it, so the untransformed points can be checked. Transposing only
+	// leaves it unchanged when the cells are square.
+	Vector2 half_size = tile_set->get_tile_size() / 2.0;
+	if (p_transpose && half_size.x != half_size.y) {
+		return false;
+	}
+	Vector<Vector2> points = p_tile_data->get_collision_polygon_points(p_physics_layer, 0);
+	if (points.size() != 4) {
+		return false;
+	}
+	uint8_t corners_found = 0;
+	for (const Vector2 &point : points) {
+		if (!Math::is_equal_approx(Math::abs(point.x), half_size.x) || !Math::is_equal_approx(Math::abs(point.y), half_size.y)) {
+			return false;
+		}
+		corners_found |= 1 << ((point.x > 0 ? 1 : 0) + (point.y > 0 ? 2 : 0));
+	}
+	return corners_found == 0b1111;
+}
+
+void TileMapLayer::_physics_setup_body(RID p_body, int p_physics_layer, const Transform2D &p_transform, const Vector2 &p_linear_velocity, real_t p_angular_velocity) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	Ref<PhysicsMaterial> physics_material = tile_set->get_physics_layer_physics_material(p_physics_layer);
+	uint32_t physics_layer = tile_set->get_physics_layer_collision_layer(p_physics_layer);
+	uint32_t physics_mask = tile_set->get_physics_layer_collision_mask(p_physics_layer);
+	real_t physics_priority = tile_set->get_physics_layer_collision_priority(p_physics_layer);
+
+	ps->body_set_mode(p_body, use_kinematic_bodies ? PhysicsServer2D::BODY_MODE_KINEMATIC : PhysicsServer2D::BODY_MODE_STATIC);
+	ps->body_set_space(p_body, get_world_2d()->get_space());
+	ps->body_set_state(p_body, PhysicsServer2D::BODY_STATE_TRANSFORM, p_transform);
+
+	ps->body_attach_object_instance_id(p_body, tile_map_node ? tile_map_node->get_instance_id() : get_instance_id());
+	ps->body_set_collision_layer(p_body, physics_layer);
+	ps->body_set_collision_mask(p_body, physics_mask);
+	ps->body_set_collision_priority(p_body, physics_priority);
+	ps->body_set_pickable(p_body, false);
+	ps->body_set_state(p_body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, p_linear_velocity);
+	ps->body_set_state(p_body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, p_angular_velocity);
+
+	if (!physics_material.is_valid()) {
+		ps->body_set_param(p_body, PhysicsServer2D::BODY_PARAM_BOUNCE, 0);
+		ps->body_set_param(p_body, PhysicsServer2D::BODY_PARAM_FRICTION, 1);
+	} else {
+		ps->body_set_param(p_body, PhysicsServer2D::BODY_PARAM_BOUNCE, physics_material->computed_bounce());
+		ps->body_set_param(p_body, PhysicsServer2D::BODY_PARAM_FRICTION, physics_material->computed_friction());
+	}
+}
+
+void TileMapLayer::_physics_clear_merge_region(PhysicsMergeRegion &r_region) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	for (RID body : r_region.bodies) {
+		if (body.is_valid()) {
+			bodies_coords.erase(body);
+			ps->free(body);
+		}
+	}
+	r_region.bodies.clear();
+	for (RID shape : r_region.shapes) {
+		ps->free(shape);
+	}
+	r_region.shapes.clear();
+}
+
+void TileMapLayer::_physics_clear_merge_regions() {
+	for (KeyValue<Vector2i, PhysicsMergeRegion> &kv : physics_merge_regions) {
+		_physics_clear_merge_region(kv.value);
+	}
+	physics_merge_regions.clear();
+}
+
+void TileMapLayer::_physics_update_merge_region(const Vector2i &p_region_coords) {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	PhysicsMergeRegion *region = physics_merge_regions.getptr(p_region_coords);
+	if (region) {
+		_physics_clear_merge_region(*region);
+	} else {
+		region = &physics_merge_regions.insert(p_region_coords, PhysicsMergeRegion())->value;
+	}
+
+	// Gather the tile data of the region's cells once.
+	const Vector2i region_origin = p_region_coords * PHYSICS_MERGE_REGION_SIZE;
+	const TileData *region_tile_data[PHYSICS_MERGE_REGION_SIZE * PHYSICS_MERGE_REGION_SIZE] = {};
+	bool region_transposed[PHYSICS_MERGE_REGION_SIZE * PHYSICS_MERGE_REGION_SIZE] = {};
+	bool has_tiles = false;
+	for (int y = 0; y < PHYSICS_MERGE_REGION_SIZE; y++) {
+		for (int x = 0; x < PHYSICS_MERGE_REGION_SIZE; x++) {
+			const CellData *cell_data = tile_map_layer_data.getptr(region_origin + Vector2i(x, y));
+			if (!cell_data) {
+				continue;
+			}
+			const TileMapCell &c = cell_data->cell;
+			region_transposed[y * PHYSICS_MERGE_REGION_SIZE + x] = c.alternative_tile & TileSetAtlasSource::TRANSFORM_TRANSPOSE;
+			if (cell_data->runtime_tile_data_cache) {
+				region_tile_data[y * PHYSICS_MERGE_REGION_SIZE + x] = cell_data->runtime_tile_data_cache;
+			} else if (tile_set->has_source(c.source_id)) {
+				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(c.source_id));
+				if (atlas_source && atlas_source->has_tile(c.get_atlas_coords()) && atlas_source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+					region_tile_data[y * PHYSICS_MERGE_REGION_SIZE + x] = atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile);
+				}
+			}
+			has_tiles = has_tiles || region_tile_data[y * PHYSICS_MERGE_REGION_SIZE + x];
+		}
+	}
+
+	Transform2D xform(0, tile_set->map_to_local(region_origin));
+	xform = get_global_transform() * xform;
+	const Vector2 tile_size = tile_set->get_tile_size();
+
+	int physics_layers_count = has_tiles ? tile_set->get_physics_layers_count() : 0;
+	for (int tile_set_physics_layer = 0; tile_set_physics_layer < physics_layers_count; tile_set_physics_layer++) {
+		bool mergeable[PHYSICS_MERGE_REGION_SIZE * PHYSICS_MERGE_REGION_SIZE];
+		bool any_mergeable = false;
+		for (int i = 0; i < PHYSICS_MERGE_REGION_SIZE * PHYSICS_MERGE_REGION_SIZE; i++) {
+			mergeable[i] = region_tile_data[i] && _physics_is_tile_mergeable(region_tile_data[i], region_transposed[i], tile_set_physics_layer);
+			any_mergeable = any_mergeable || mergeable[i];
+		}
+		if (!any_mergeable) {
+			continue;
+		}
+
+		RID body = ps->body_create();
+		bodies_coords[body] = region_origin;
+		_physics_setup_body(body, tile_set_physics_layer, xform, Vector2(), 0.0);
+
+		// Greedily grow rectangles, first along the row then downwards, consuming the merged cells.
+		for (int y = 0; y < PHYSICS_MERGE_REGION_SIZE; y++) {
+			for (int x = 0; x < PHYSICS_MERGE_REGION_SIZE; x++) {
+				if (!mergeable[y * PHYSICS_MERGE_REGION_SIZE + x]) {
+					continue;
+				}
+				int width = 1;
+				while (x + width < PHYSICS_MERGE_REGION_SIZE && mergeable[y * PHYSICS_MERGE_REGION_SIZE + x + width]) {
+					width++;
+				}
+				int height = 1;
+				while (y + height < PHYSICS_MERGE_REGION_SIZE) {
+					bool row_full = true;
+					for (int i = 0; i < width && row_full; i++) {
+						row_full = mergeable[(y + height) * PHYSICS_MERGE_REGION_SIZE + x + i];
+					}
+					if (!row_full) {
+						break;
+					}
+					height++;
+				}
+				for (int j = 0; j < height; j++) {
+					for (int i = 0; i < width; i++) {
+						mergeable[(y + j) * PHYSICS_MERGE_REGION_SIZE + x + i] = false;
+					}
+				}
+
+				RID shape = ps->rectangle_shape_create();
+				ps->shape_set_data(shape, Vector2(width, height) * tile_size / 2.0);
+				region->shapes.push_back(shape);
+				ps->body_add_shape(body, shape, Transform2D(0, Vector2(x * 2 + width - 1, y * 2 + height - 1) * tile_size / 2.0));
+			}
+		}
+
+		region->bodies.resize(tile_set_physics_layer + 1);
+		region->bodies[tile_set_physics_layer] = body;
+	}
+
+	if (region->bodies.is_empty()) {
+		physics_merge_regions.erase(p_region_coords);
+	}
+}
+
 #ifdef DEBUG_ENABLED
 void TileMapLayer::_physics_draw_cell_debug(const RID &p_canvas_item, const Vector2 &p_quadrant_pos, const CellData &r_cell_data) {
 	// Draw the debug collision shapes.
@@ -948,6 +1196,32 @@ void TileMapLayer::_physics_draw_cell_debug(const RID &p_canvas_item, const Vect
 			rs->canvas_item_add_set_transform(p_canvas_item, Transform2D());
 		}
 	}
+
+	// Merged cells have no body of their own, draw the part of the merged rectangles they cover instead.
+	const PhysicsMergeRegion *region = physics_merge_regions.getptr(Vector2i((int)Math::floor((real_t)r_cell_data.coords.x / PHYSICS_MERGE_REGION_SIZE), (int)Math::floor((real_t)r_cell_data.coords.y / PHYSICS_MERGE_REGION_SIZE)));
+	if (!region) {
+		return;
+	}
+	const TileMapCell &c = r_cell_data.cell;
+	if (!tile_set->has_source(c.source_id)) {
+		return;
+	}
+	TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(*tile_set->get_source(c.source_id));
+	if (!atlas_source || !atlas_source->has_tile(c.get_atlas_coords()) || !atlas_source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+		return;
+	}
+	const TileData *tile_data = r_cell_data.runtime_tile_data_cache ? r_cell_data.runtime_tile_data_cache : atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile);
+	bool transpose = (c.alternative_tile & TileSetAtlasSource::TRANSFORM_TRANSPOSE);
+
+	Vector2 half_size = tile_set->get_tile_size() / 2.0;
+	Vector<Vector2> cell_rect = { -half_size, Vector2(half_size.x, -half_size.y), half_size, Vector2(-half_size.x, half_size.y) };
+	for (uint32_t tile_set_physics_layer = 0; tile_set_physics_layer < region->bodies.size(); tile_set_physics_layer++) {
+		if (region->bodies[tile_set_physics_layer].is_valid() && _physics_is_tile_mergeable(tile_data, transpose, tile_set_physics_layer)) {
+			rs->canvas_item_add_set_transform(p_canvas_item, Transform2D(0, tile_set->map_to_local(r_cell_data.coords) - p_quadrant_pos));
+			rs->canvas_item_add_polygon(p_canvas_item, cell_rect, color);
+			rs->canvas_item_add_set_transform(p_canvas_item, Transform2D());
+		}
+	}
 }
 #endif // DEBUG_ENABLED
 
@@ -1868,6 +2142,8 @@ void TileMapLayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_collision_enabled"), &TileMapLayer::is_collision_enabled);
 	ClassDB::bind_method(D_METHOD("set_use_kinematic_bodies", "use_kinematic_bodies"), &TileMapLayer::set_use_kinematic_bodies);
 	ClassDB::bind_method(D_METHOD("is_using_kinematic_bodies"), &TileMapLayer::is_using_kinematic_bodies);
+	ClassDB::bind_method(D_METHOD("set_use_collision_merging", "use_collision_merging"), &TileMapLayer::set_use_collision_merging);
+	ClassDB::bind_method(D_METHOD("is_using_collision_merging"), &TileMapLayer::is_using_collision_merging);
 	ClassDB::bind_method(D_METHOD("set_collision_visibility_mode", "visibility_mode"), &TileMapLayer::set_collision_visibility_mode);
 	ClassDB::bind_method(D_METHOD("get_collision_visibility_mode"), &TileMapLayer::get_collision_visibility_mode);
 
@@ -1897,6 +2173,7 @@ void TileMapLayer::_bind_methods() {
 	ADD_GROUP("Physics", "");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "collision_enabled"), "set_collision_enabled", "is_collision_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_kinematic_bodies"), "set_use_kinematic_bodies", "is_using_kinematic_bodies");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_collision_merging"), "set_use_collision_merging", "is_using_collision_merging");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_visibility_mode", PROPERTY_HINT_ENUM, "Default,Force Show,Force Hide"), "set_collision_visibility_mode", "get_collision_visibility_mode");
 	ADD_GROUP("Navigation", "");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "navigation_enabled"), "set_navigation_enabled", "is_navigation_enabled");
@@ -2994,6 +3271,20 @@ bool TileMapLayer::is_using_kinematic_bodies() const {
 	return use_kinematic_bodies;
 }
 
+void TileMapLayer::set_use_collision_merging(bool p_use_collision_merging) {
+	if (use_collision_merging == p_use_collision_merging) {
+		return;
+	}
+	use_collision_merging = p_use_collision_merging;
+	dirty.flags[DIRTY_FLAGS_LAYER_USE_COLLISION_MERGING] = true;
+	_queue_internal_update();
+	emit_signal(CoreStringName(changed));
+}
+
+bool TileMapLayer::is_using_collision_merging() const {
+	return use_collision_merging;
+}
+
 void TileMapLayer::set_collision_visibility_mode(TileMapLayer::DebugVisibilityMode p_show_collision) {
 	if (collision_visibility_mode == p_show_collision) {
 		return;
@@ -208,6 +208,21 @@ public:
 	List<RID> canvas_items;
 	Vector2 canvas_items_position;
 
+	// The material, z-index and cells of each canvas item, in the same order. As long as the cells are grouped the
+	// same way, only the canvas items with changed cells are redrawn.
+	struct CanvasItemCells {
+		Ref<Material> material;
+		int z_index = 0;
+		Vector<Vector2i> cells;
+	};
+	LocalVector<CanvasItemCells> canvas_item_cells;
+
+	// Key in the layer's draw order, and the range of draw indices reserved for the canvas items,
+	// so redrawing the quadrant doesn't require renumbering all the others.
+	Vector2 draw_order_key;
+	int draw_index_first = 0;
+	int draw_index_slots = 0;
+
 	SelfList<RenderingQuadrant> dirty_quadrant_list_element;
 
 	RenderingQuadrant() :
@@ -253,6 +268,7 @@ public:
 		DIRTY_FLAGS_LAYER_RENDERING_QUADRANT_SIZE,
 		DIRTY_FLAGS_LAYER_COLLISION_ENABLED,
 		DIRTY_FLAGS_LAYER_USE_KINEMATIC_BODIES,
+		DIRTY_FLAGS_LAYER_USE_COLLISION_MERGING,
 		DIRTY_FLAGS_LAYER_COLLISION_VISIBILITY_MODE,
 		DIRTY_FLAGS_LAYER_OCCLUSION_ENABLED,
 		DIRTY_FLAGS_LAYER_NAVIGATION_ENABLED,
@@ -287,6 +303,7 @@ private:
 
 	bool collision_enabled = true;
 	bool use_kinematic_bodies = false;
+	bool use_collision_merging = false;
 	DebugVisibilityMode collision_visibility_mode = DEBUG_VISIBILITY_MODE_DEFAULT;
 
 	bool occlusion_enabled = true;
@@ -333,22 +350,42 @@ private:
 #endif // DEBUG_ENABLED
 
 	HashMap<Vector2i, Ref<RenderingQuadrant>> rendering_quadrant_map;
+	RBMap<Vector2, Ref<RenderingQuadrant>, RenderingQuadrant::CoordsWorldComparator> rendering_quadrant_draw_order;
+	bool rendering_draw_order_dirty = false;
 	bool _rendering_was_cleaned_up = false;
+	bool _rendering_occluders_were_cleaned_up = false;
+	void _rendering_update_draw_order();
 	void _rendering_update(bool p_force_cleanup);
 	void _rendering_notification(int p_what);
 	void _rendering_quadrants_update_cell(CellData &r_cell_data, SelfList<RenderingQuadrant>::List &r_dirty_rendering_quadrant_list);
+	const TileData *_rendering_get_cell_tile_data(const CellData &p_cell_data) const;
+	void _rendering_draw_cell(RID p_canvas_item, const Vector2 &p_canvas_items_position, const CellData &p_cell_data);
 	void _rendering_occluders_clear_cell(CellData &r_cell_data);
 	void _rendering_occluders_update_cell(CellData &r_cell_data);
 #ifdef DEBUG_ENABLED
 	void _rendering_draw_cell_debug(const RID &p_canvas_item, const Vector2 &p_quadrant_pos, const CellData &r_cell_data);
 #endif // DEBUG_ENABLED
 
+	// Merged collision, grouping full-cell rectangle shapes of a region into a few larger rectangles.
+	static constexpr int PHYSICS_MERGE_REGION_SIZE = 16;
+	struct PhysicsMergeRegion {
+		LocalVector<RID> bodies; // One per physics layer, may be invalid.
+		LocalVector<RID> shapes;
+	};
+	HashMap<Vector2i, PhysicsMergeRegion> physics_merge_regions;
+	HashSet<Vector2i> physics_merge_dirty_regions;
+
 	HashMap<RID, Vector2i> bodies_coords; // Mapping for RID to coords.
 	bool _physics_was_cleaned_up = false;
 	void _physics_update(bool p_force_cleanup);
 	void _physics_notification(int p_what);
 	void _physics_clear_cell(CellData &r_cell_data);
 	void _physics_update_cell(CellData &r_cell_data);
+	bool _physics_is_tile_mergeable(const TileData *p_tile_data, bool p_transpose, int p_physics_layer) const;
+	void _physics_setup_body(RID p_body, int p_physics_layer, const Transform2D &p_transform, const Vector2 &p_linear_velocity, real_t p_angular_velocity);
+	void _physics_clear_merge_region(PhysicsMergeRegion &r_region);
+	void _physics_clear_merge_regions();
+	void _physics_update_merge_region(const Vector2i &p_region_coords);
 #ifdef DEBUG_ENABLED
 	void _physics_draw_cell_debug(const RID &p_canvas_item, const Vector2 &p_quadrant_pos, const CellData &r_cell_data);
 #endif // DEBUG_ENABLED
@@ -499,6 +536,8 @@ public:
 	bool is_collision_enabled() const;
 	void set_use_kinematic_bodies(bool p_use_kinematic_bodies);
 	bool is_using_kinematic_bodies() const;
+	void set_use_collision_merging(bool p_use_collision_merging);
+	bool is_using_collision_merging() const;
 	void set_collision_visibility_mode(DebugVisibilityMode p_show_collision);
 	DebugVisibilityMode get_collision_visibility_mode() const;
 
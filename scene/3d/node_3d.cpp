@@ -470,28 +470,57 @@ Transform3D Node3D::get_global_transform() const {
 	 * the dirty/update process is thread safe by utilizing atomic copies.
 	 */
 
-	uint32_t dirty = _read_dirty_mask();
-	if (dirty & DIRTY_GLOBAL_TRANSFORM) {
-		if (dirty & DIRTY_LOCAL_TRANSFORM) {
-			_update_local_transform(); // Update local transform atomically.
+	if (_test_dirty_bits(DIRTY_GLOBAL_TRANSFORM)) {
+		// Collect the dirty ancestors and update them from the top down in a single pass, instead of recursing
+		// into each parent. Hierarchies deeper than the chain are resolved one chunk at a time.
+		const Node3D *chain[GLOBAL_TRANSFORM_CHAIN_MAX];
+		int count = 0;
+		const Node3D *node = this;
+		while (true) {
+			chain[count++] = node;
+			if (node->data.top_level || !node->data.parent || !node->data.parent->_test_dirty_bits(DIRTY_GLOBAL_TRANSFORM)) {
+				break;
+			}
+			if (count == GLOBAL_TRANSFORM_CHAIN_MAX) {
+				node->data.parent->get_global_transform();
+				break;
+			}
+			node = node->data.parent;
 		}
 
-		Transform3D new_global;
-		if (data.parent && !data.top_level) {
-			new_global = data.parent->get_global_transform() * data.local_transform;
-		} else {
-			new_global = data.local_transform;
+		for (int i = count - 1; i >= 0; i--) {
+			chain[i]->_update_global_transform();
 		}
+	}
 
-		if (data.disable_scale) {
-			new_global.basis.orthonormalize();
-		}
+	return data.global_transform;
+}
+
+void Node3D::_update_pending_global_transform() const {
+	if (_test_dirty_bits(DIRTY_GLOBAL_TRANSFORM)) {
+		get_global_transform();
+	}
+}
 
-		data.global_transform = new_global;
-		_clear_dirty_bits(DIRTY_GLOBAL_TRANSFORM);
+void Node3D::_update_global_transform() const {
+	// The parent, if any, must already be up to date.
+	if (_test_dirty_bits(DIRTY_LOCAL_TRANSFORM)) {
+		_update_local_transform(); // Update local transform atomically.
 	}
 
-	return data.global_transform;
+	Transform3D new_global;
+	if (data.parent && !data.top_level) {
+		new_global = data.parent->data.global_transform * data.local_transform;
+	} else {
+		new_global = data.local_transform;
+	}
+
+	if (data.disable_scale) {
+		new_global.basis.orthonormalize();
+	}
+
+	data.global_transform = new_global;
+	_clear_dirty_bits(DIRTY_GLOBAL_TRANSFORM);
 }
 
 #ifdef TOOLS_ENABLED
@@ -85,6 +85,8 @@ private:
 		DIRTY_GLOBAL_TRANSFORM = 4
 	};
 
+	static constexpr int GLOBAL_TRANSFORM_CHAIN_MAX = 64;
+
 	struct ClientPhysicsInterpolationData {
 		Transform3D global_xform_curr;
 		Transform3D global_xform_prev;
@@ -163,6 +165,9 @@ protected:
 
 	_FORCE_INLINE_ void _update_local_transform() const;
 	_FORCE_INLINE_ void _update_rotation_and_scale() const;
+	void _update_global_transform() const;
+	virtual void _update_pending_global_transform() const override;
+	bool _is_global_transform_dirty() const { return _test_dirty_bits(DIRTY_GLOBAL_TRANSFORM); }
 
 	void _set_vi_visible(bool p_visible) { data.vi_visible = p_visible; }
 	bool _is_vi_visible() const { return data.vi_visible; }
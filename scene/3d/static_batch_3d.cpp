@@ -0,0 +1,615 @@
+/**************************************************************************/
+/*  static_batch_3d.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "static_batch_3d.h"
+
+#include "core/io/marshalls.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/resources/3d/importer_mesh.h"
+#include "scene/resources/3d/skin.h"
+#include "scene/resources/shader.h"
+#include "scene/resources/surface_tool.h"
+#include "scene/scene_string_names.h"
+
+// Vertex attributes and custom channel formats, which must match for surfaces to be merged.
+static const uint64_t BATCH_FORMAT_MASK = (1ULL << (RS::ARRAY_FORMAT_CUSTOM3_SHIFT + RS::ARRAY_FORMAT_CUSTOM_BITS)) - 1;
+static const uint64_t BATCH_CUSTOM_FORMAT_MASK = BATCH_FORMAT_MASK & ~((1ULL << RS::ARRAY_FORMAT_CUSTOM_BASE) - 1);
+
+bool StaticBatch3D::_is_material_transparent(const Ref<Material> &p_material) {
+	// Transparent surfaces are sorted per instance, which merging would break. Next passes are drawn the same way.
+	for (Ref<Material> material = p_material; material.is_valid(); material = material->get_next_pass()) {
+		Ref<BaseMaterial3D> base_material = material;
+		if (base_material.is_valid()) {
+			if (base_material->get_transparency() == BaseMaterial3D::TRANSPARENCY_ALPHA || base_material->get_transparency() == BaseMaterial3D::TRANSPARENCY_ALPHA_DEPTH_PRE_PASS || base_material->get_blend_mode() != BaseMaterial3D::BLEND_MODE_MIX) {
+				return true;
+			}
+			continue;
+		}
+
+		// Whether a shader is transparent is only known once it's compiled, so any shader that may write alpha or blend is.
+		Ref<ShaderMaterial> shader_material = material;
+		if (shader_material.is_valid() && shader_material->get_shader().is_valid()) {
+			const String code = shader_material->get_shader()->get_code();
+			if (code.contains("ALPHA") || code.contains("blend_")) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool StaticBatch3D::_can_batch(const MeshInstance3D *p_mesh_instance) const {
+	Ref<Mesh> mesh = p_mesh_instance->get_mesh();
+	if (mesh.is_null() || mesh->get_surface_count() == 0 || mesh->get_blend_shape_count() > 0) {
+		return false;
+	}
+
+	// Per-instance settings that can't be applied to part of a merged mesh.
+	if (p_mesh_instance->get_skin().is_valid() || p_mesh_instance->get_material_overlay().is_valid() || p_mesh_instance->get_transparency() > 0.0) {
+		return false;
+	}
+	if (p_mesh_instance->get_visibility_range_begin() > 0.0 || p_mesh_instance->get_visibility_range_end() > 0.0) {
+		return false;
+	}
+	if (p_mesh_instance->get_lod_bias() != 1.0 || p_mesh_instance->get_extra_cull_margin() != 0.0 || p_mesh_instance->get_custom_aabb() != AABB()) {
+		return false;
+	}
+
+	List<PropertyInfo> shader_parameters;
+	RS::get_singleton()->instance_geometry_get_shader_parameter_list(p_mesh_instance->get_instance(), &shader_parameters);
+	for (const PropertyInfo &E : shader_parameters) {
+		const Variant value = RS::get_singleton()->instance_geometry_get_shader_parameter(p_mesh_instance->get_instance(), E.name);
+		if (value != RS::get_singleton()->instance_geometry_get_shader_parameter_default_value(p_mesh_instance->get_instance(), E.name)) {
+			return false;
+		}
+	}
+	if (Math::is_zero_approx(p_mesh_instance->get_global_basis().determinant())) {
+		return false;
+	}
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
+			return false;
+		}
+		uint64_t format = mesh->surface_get_format(i);
+		if (!(format & RS::ARRAY_FORMAT_INDEX) || (format & (RS::ARRAY_FORMAT_BONES | RS::ARRAY_FLAG_USE_2D_VERTICES))) {
+			return false;
+		}
+		// A baked lightmap is assigned per instance, and can't be applied to part of a merged mesh.
+		if ((format & RS::ARRAY_FORMAT_TEX_UV2) && p_mesh_instance->get_gi_mode() == GeometryInstance3D::GI_MODE_STATIC) {
+			return false;
+		}
+		if (_is_material_transparent(p_mesh_instance->get_active_material(i))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void StaticBatch3D::_find_mesh_instances(Node *p_node, LocalVector<MeshInstance3D *> &r_mesh_instances, LocalVector<ObjectID> &r_hidden_nodes) const {
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		Node *child = p_node->get_child(i);
+		if (Object::cast_to<StaticBatch3D>(child)) {
+			continue; // Batches its own children.
+		}
+
+		MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(child);
+		if (mi && !mi->is_visible_in_tree()) {
+			r_hidden_nodes.push_back(mi->get_instance_id());
+		} else if (mi && _can_batch(mi)) {
+			r_mesh_instances.push_back(mi);
+		}
+
+		_find_mesh_instances(child, r_mesh_instances, r_hidden_nodes);
+	}
+}
+
+template <typename T>
+static void _append_array(Variant &r_dst, const Variant &p_src) {
+	T dst = r_dst;
+	r_dst = Variant(); // Don't copy on write.
+	dst.append_array(p_src);
+	r_dst = dst;
+}
+
+void StaticBatch3D::_append_surface_arrays(Array &r_arrays, const Array &p_arrays, const Transform3D &p_xform) {
+	ERR_FAIL_COND(p_arrays.size() != Mesh::ARRAY_MAX);
+	if (r_arrays.is_empty()) {
+		r_arrays.resize(Mesh::ARRAY_MAX);
+	}
+
+	// Normals are transformed by the inverse transpose, so they stay perpendicular with non-uniform scales.
+	// Mirroring reverses the winding, which is flipped back so faces aren't culled from the wrong side.
+	const Basis normal_basis = p_xform.basis.inverse().transposed();
+	const bool mirrored = p_xform.basis.determinant() < 0.0;
+	const int vertex_offset = PackedVector3Array(r_arrays[Mesh::ARRAY_VERTEX]).size();
+
+	for (int i = 0; i < Mesh::ARRAY_MAX; i++) {
+		if (p_arrays[i].get_type() == Variant::NIL) {
+			continue;
+		}
+
+		switch (i) {
+			case Mesh::ARRAY_VERTEX:
+			case Mesh::ARRAY_NORMAL: {
+				PackedVector3Array src = p_arrays[i];
+				PackedVector3Array dst = r_arrays[i];
+				r_arrays[i] = Variant();
+				int from = dst.size();
+				dst.resize(from + src.size());
+				Vector3 *dst_ptr = dst.ptrw() + from;
+				for (int j = 0; j < src.size(); j++) {
+					dst_ptr[j] = i == Mesh::ARRAY_VERTEX ? p_xform.xform(src[j]) : normal_basis.xform(src[j]).normalized();
+				}
+				r_arrays[i] = dst;
+			} break;
+			case Mesh::ARRAY_TANGENT: {
+				PackedFloat32Array src = p_arrays[i];
+				PackedFloat32Array dst = r_arrays[i];
+				r_arrays[i] = Variant();
+				int from = dst.size();
+				dst.resize(from + src.size());
+				float *dst_ptr = dst.ptrw() + from;
+				for (int j = 0; j + 3 < src.size(); j += 4) {
+					Vector3 tangent = p_xform.basis.xform(Vector3(src[j], src[j + 1], src[j + 2])).normalized();
+					dst_ptr[j] = tangent.x;
+					dst_ptr[j + 1] = tangent.y;
+					dst_ptr[j + 2] = tangent.z;
+					dst_ptr[j + 3] = mirrored ? -src[j + 3] : src[j + 3];
+				}
+				r_arrays[i] = dst;
+			} break;
+			case Mesh::ARRAY_INDEX: {
+				PackedInt32Array src = p_arrays[i];
+				PackedInt32Array dst = r_arrays[i];
+				r_arrays[i] = Variant();
+				int from = dst.size();
+				dst.resize(from + src.size());
+				int *dst_ptr = dst.ptrw() + from;
+				for (int j = 0; j < src.size(); j++) {
+					dst_ptr[j] = src[j] + vertex_offset;
+				}
+				if (mirrored) {
+					for (int j = 0; j + 2 < src.size(); j += 3) {
+						SWAP(dst_ptr[j + 1], dst_ptr[j + 2]);
+					}
+				}
+				r_arrays[i] = dst;
+			} break;
+			default: {
+				switch (p_arrays[i].get_type()) {
+					case Variant::PACKED_VECTOR2_ARRAY: {
+						_append_array<PackedVector2Array>(r_arrays[i], p_arrays[i]);
+					} break;
+					case Variant::PACKED_COLOR_ARRAY: {
+						_append_array<PackedColorArray>(r_arrays[i], p_arrays[i]);
+					} break;
+					case Variant::PACKED_FLOAT32_ARRAY: {
+						_append_array<PackedFloat32Array>(r_arrays[i], p_arrays[i]);
+					} break;
+					case Variant::PACKED_BYTE_ARRAY: {
+						_append_array<PackedByteArray>(r_arrays[i], p_arrays[i]);
+					} break;
+					default: {
+						ERR_PRINT(vformat("Unsupported array type for mesh array %d.", i));
+					} break;
+				}
+			} break;
+		}
+	}
+}
+
+bool StaticBatch3D::_simplify_surface_arrays(Array &r_arrays, real_t p_triangle_ratio) {
+	PackedVector3Array vertices = r_arrays[Mesh::ARRAY_VERTEX];
+	PackedInt32Array indices = r_arrays[Mesh::ARRAY_INDEX];
+	Vector<float> vertices_f32 = vector3_to_float32_array(vertices.ptr(), vertices.size());
+
+	// The error bound is the whole extent of the mesh, so the triangle target is what limits simplification.
+	const int target_index_count = MAX(3, int(indices.size() * p_triangle_ratio) / 3 * 3);
+	float error = -1.0f;
+	r_arrays[Mesh::ARRAY_INDEX] = Variant();
+	int index_count = SurfaceTool::simplify_func(
+			(unsigned int *)indices.ptrw(),
+			(const unsigned int *)indices.ptr(),
+			indices.size(),
+			vertices_f32.ptr(), vertices.size(), sizeof(float) * 3,
+			target_index_count, 1.0f, 0, &error);
+	indices.resize(index_count);
+	r_arrays[Mesh::ARRAY_INDEX] = indices;
+
+	return index_count > 0;
+}
+
+RID StaticBatch3D::_create_instance(const Ref<Mesh> &p_mesh, const ClusterKey &p_key) {
+	RID instance = RS::get_singleton()->instance_create();
+	RS::get_singleton()->instance_set_base(instance, p_mesh->get_rid());
+	RS::get_singleton()->instance_attach_object_instance_id(instance, get_instance_id());
+	RS::get_singleton()->instance_set_layer_mask(instance, p_key.layer_mask);
+	RS::get_singleton()->instance_geometry_set_cast_shadows_setting(instance, p_key.cast_shadows);
+	RS::get_singleton()->instance_geometry_set_flag(instance, RS::INSTANCE_FLAG_USE_BAKED_LIGHT, p_key.gi_mode == GeometryInstance3D::GI_MODE_STATIC);
+	RS::get_singleton()->instance_geometry_set_flag(instance, RS::INSTANCE_FLAG_USE_DYNAMIC_GI, p_key.gi_mode == GeometryInstance3D::GI_MODE_DYNAMIC);
+	RS::get_singleton()->instance_set_scenario(instance, get_world_3d()->get_scenario());
+	RS::get_singleton()->instance_set_transform(instance, get_global_transform());
+	return instance;
+}
+
+void StaticBatch3D::make_baked_meshes() {
+	ERR_FAIL_COND_MSG(!is_inside_tree(), "StaticBatch3D must be inside the scene tree to batch its children.");
+	clear_baked_meshes();
+
+	LocalVector<MeshInstance3D *> mesh_instances;
+	_find_mesh_instances(this, mesh_instances, hidden_nodes);
+
+	HashMap<ClusterKey, HashMap<SurfaceKey, Array, SurfaceKey>, ClusterKey> cluster_map;
+	const Transform3D global_to_local = get_global_transform().affine_inverse();
+
+	for (MeshInstance3D *mi : mesh_instances) {
+		Ref<Mesh> mesh = mi->get_mesh();
+		Transform3D xform = global_to_local * mi->get_global_transform();
+
+		// Instances are assigned to a cell by their center, so clusters stay close to the cell size and can still be culled.
+		ClusterKey cluster_key;
+		cluster_key.cell = Vector3i((xform.xform(mesh->get_aabb()).get_center() / cluster_size).floor());
+		cluster_key.layer_mask = mi->get_layer_mask();
+		cluster_key.cast_shadows = RS::ShadowCastingSetting(mi->get_cast_shadows_setting());
+		cluster_key.gi_mode = mi->get_gi_mode();
+		HashMap<SurfaceKey, Array, SurfaceKey> &surface_map = cluster_map[cluster_key];
+
+		for (int i = 0; i < mesh->get_surface_count(); i++) {
+			SurfaceKey surface_key;
+			surface_key.material = mi->get_active_material(i);
+			surface_key.format = mesh->surface_get_format(i) & BATCH_FORMAT_MASK;
+			Array arrays = mesh->surface_get_arrays(i);
+			source_triangle_count += PackedInt32Array(arrays[Mesh::ARRAY_INDEX]).size() / 3;
+			_append_surface_arrays(surface_map[surface_key], arrays, xform);
+		}
+
+		batched_nodes.push_back(mi->get_instance_id());
+	}
+
+	const Callable visibility_changed = callable_mp(this, &StaticBatch3D::_queue_batched_visibility_update);
+	for (const ObjectID &id : batched_nodes) {
+		Object::cast_to<Node>(ObjectDB::get_instance(id))->connect(SceneStringName(visibility_changed), visibility_changed);
+	}
+	for (const ObjectID &id : hidden_nodes) {
+		Object::cast_to<Node>(ObjectDB::get_instance(id))->connect(SceneStringName(visibility_changed), visibility_changed);
+	}
+
+	const bool use_hlod = hlod_distance > 0.0;
+	if (use_hlod && !SurfaceTool::simplify_func) {
+		WARN_PRINT_ONCE("StaticBatch3D: HLOD generation requires the meshoptimizer module. No HLOD proxies will be generated.");
+	}
+
+	// Clusters in the same cell of the coarser HLOD grid share a proxy, and the baked meshes of each group.
+	HashMap<ClusterKey, HashMap<SurfaceKey, Array, SurfaceKey>, ClusterKey> hlod_map;
+	HashMap<ClusterKey, LocalVector<RID>, ClusterKey> hlod_children;
+
+	for (KeyValue<ClusterKey, HashMap<SurfaceKey, Array, SurfaceKey>> &E : cluster_map) {
+		ClusterKey hlod_key = E.key;
+		hlod_key.cell = Vector3i((Vector3(E.key.cell) / hlod_group_size).floor());
+
+		Ref<ImporterMesh> importer_mesh;
+		importer_mesh.instantiate();
+		for (KeyValue<SurfaceKey, Array> &F : E.value) {
+			importer_mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, F.value, TypedArray<Array>(), Dictionary(), F.key.material, String(), F.key.format & BATCH_CUSTOM_FORMAT_MASK);
+			if (use_hlod && SurfaceTool::simplify_func) {
+				_append_surface_arrays(hlod_map[hlod_key][F.key], F.value, Transform3D());
+			}
+		}
+		if (generate_lods) {
+			importer_mesh->generate_lods(60.0f, Array());
+		}
+		importer_mesh->optimize_indices();
+
+		BakedMesh bm;
+		bm.mesh = importer_mesh->get_mesh();
+		bm.instance = _create_instance(bm.mesh, E.key);
+		baked_meshes.push_back(bm);
+		hlod_children[hlod_key].push_back(bm.instance);
+	}
+
+	for (KeyValue<ClusterKey, HashMap<SurfaceKey, Array, SurfaceKey>> &E : hlod_map) {
+		Ref<ImporterMesh> importer_mesh;
+		importer_mesh.instantiate();
+		for (KeyValue<SurfaceKey, Array> &F : E.value) {
+			if (_simplify_surface_arrays(F.value, hlod_triangle_ratio)) {
+				hlod_triangle_count += PackedInt32Array(F.value[Mesh::ARRAY_INDEX]).size() / 3;
+				importer_mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, F.value, TypedArray<Array>(), Dictionary(), F.key.material, String(), F.key.format & BATCH_CUSTOM_FORMAT_MASK);
+			}
+		}
+		if (importer_mesh->get_surface_count() == 0) {
+			continue;
+		}
+		// Also drops the vertices no longer referenced after simplification.
+		importer_mesh->optimize_indices();
+
+		BakedMesh bm;
+		bm.mesh = importer_mesh->get_mesh();
+		bm.instance = _create_instance(bm.mesh, E.key);
+		RS::get_singleton()->instance_geometry_set_visibility_range(bm.instance, hlod_distance, 0.0, 0.0, 0.0, RS::VISIBILITY_RANGE_FADE_DISABLED);
+		hlod_meshes.push_back(bm);
+
+		// The baked meshes of the group are only drawn while the camera is closer than the proxy's range.
+		for (const RID &child : hlod_children[E.key]) {
+			RS::get_singleton()->instance_set_visibility_parent(child, bm.instance);
+		}
+	}
+
+	_update_visibility();
+}
+
+void StaticBatch3D::_free_baked_meshes() {
+	// Baked meshes are freed before the proxies they depend on.
+	for (int i = 0; i < baked_meshes.size(); i++) {
+		RS::get_singleton()->instance_set_visibility_parent(baked_meshes[i].instance, RID());
+		RS::get_singleton()->free(baked_meshes[i].instance);
+	}
+	baked_meshes.clear();
+	for (int i = 0; i < hlod_meshes.size(); i++) {
+		RS::get_singleton()->free(hlod_meshes[i].instance);
+	}
+	hlod_meshes.clear();
+}
+
+void StaticBatch3D::clear_baked_meshes() {
+	ERR_FAIL_NULL(RenderingServer::get_singleton());
+	_free_baked_meshes();
+	source_triangle_count = 0;
+	hlod_triangle_count = 0;
+
+	const Callable visibility_changed = callable_mp(this, &StaticBatch3D::_queue_batched_visibility_update);
+	for (const ObjectID &id : batched_nodes) {
+		MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(ObjectDB::get_instance(id));
+		if (!mi) {
+			continue;
+		}
+		mi->disconnect(SceneStringName(visibility_changed), visibility_changed);
+		if (mi->is_inside_tree()) {
+			RS::get_singleton()->instance_set_visible(mi->get_instance(), mi->is_visible_in_tree());
+		}
+	}
+	batched_nodes.clear();
+	for (const ObjectID &id : hidden_nodes) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(id));
+		if (node) {
+			node->disconnect(SceneStringName(visibility_changed), visibility_changed);
+		}
+	}
+	hidden_nodes.clear();
+}
+
+Array StaticBatch3D::get_baked_meshes() const {
+	Array arr;
+	for (int i = 0; i < baked_meshes.size(); i++) {
+		arr.push_back(baked_meshes[i].mesh);
+	}
+	return arr;
+}
+
+Array StaticBatch3D::get_hlod_meshes() const {
+	Array arr;
+	for (int i = 0; i < hlod_meshes.size(); i++) {
+		arr.push_back(hlod_meshes[i].mesh);
+	}
+	return arr;
+}
+
+Dictionary StaticBatch3D::get_statistics() const {
+	Dictionary stats;
+	stats["source_instance_count"] = batched_nodes.size();
+	stats["source_triangle_count"] = source_triangle_count;
+	stats["baked_instance_count"] = baked_meshes.size();
+	stats["hlod_instance_count"] = hlod_meshes.size();
+	stats["hlod_triangle_count"] = hlod_triangle_count;
+	return stats;
+}
+
+void StaticBatch3D::_hide_batched_nodes() {
+	for (const ObjectID &id : batched_nodes) {
+		MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(ObjectDB::get_instance(id));
+		if (mi) {
+			RS::get_singleton()->instance_set_visible(mi->get_instance(), false);
+		}
+	}
+}
+
+void StaticBatch3D::_update_visibility() {
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	for (int i = 0; i < baked_meshes.size(); i++) {
+		RS::get_singleton()->instance_set_visible(baked_meshes[i].instance, is_visible_in_tree());
+	}
+	for (int i = 0; i < hlod_meshes.size(); i++) {
+		RS::get_singleton()->instance_set_visible(hlod_meshes[i].instance, is_visible_in_tree());
+	}
+	_hide_batched_nodes();
+}
+
+void StaticBatch3D::_queue_batched_visibility_update() {
+	// Hiding this node emits the signal for every batched node, so the update is only done once.
+	if (!batched_visibility_update_queued) {
+		batched_visibility_update_queued = true;
+		callable_mp(this, &StaticBatch3D::_update_batched_visibility).call_deferred();
+	}
+}
+
+void StaticBatch3D::_update_batched_visibility() {
+	batched_visibility_update_queued = false;
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	// While this node is hidden, so are all the batched nodes, and nothing needs to be batched again.
+	bool rebatch = false;
+	if (is_visible_in_tree()) {
+		for (const ObjectID &id : batched_nodes) {
+			Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(id));
+			rebatch = rebatch || (node && !node->is_visible_in_tree());
+		}
+		for (const ObjectID &id : hidden_nodes) {
+			Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(id));
+			rebatch = rebatch || (node && node->is_visible_in_tree());
+		}
+	}
+
+	if (rebatch) {
+		make_baked_meshes();
+	} else {
+		// Batched nodes that were shown again draw themselves, on top of the baked meshes.
+		_hide_batched_nodes();
+	}
+}
+
+void StaticBatch3D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_READY: {
+			if (batch_on_ready && !Engine::get_singleton()->is_editor_hint()) {
+				make_baked_meshes();
+			}
+		} break;
+
+		case NOTIFICATION_TRANSFORM_CHANGED: {
+			for (int i = 0; i < baked_meshes.size(); i++) {
+				RS::get_singleton()->instance_set_transform(baked_meshes[i].instance, get_global_transform());
+			}
+			for (int i = 0; i < hlod_meshes.size(); i++) {
+				RS::get_singleton()->instance_set_transform(hlod_meshes[i].instance, get_global_transform());
+			}
+		} break;
+
+		case NOTIFICATION_EXIT_TREE: {
+			// Batched again when re-entering the tree, as the batched nodes show themselves again.
+			if (!baked_meshes.is_empty()) {
+				clear_baked_meshes();
+				request_ready();
+			}
+		} break;
+
+		case NOTIFICATION_VISIBILITY_CHANGED: {
+			// The batched nodes are notified after this node, and show themselves again.
+			callable_mp(this, &StaticBatch3D::_update_visibility).call_deferred();
+		} break;
+	}
+}
+
+void StaticBatch3D::set_cluster_size(real_t p_size) {
+	ERR_FAIL_COND(p_size <= 0.0);
+	cluster_size = p_size;
+}
+
+real_t StaticBatch3D::get_cluster_size() const {
+	return cluster_size;
+}
+
+void StaticBatch3D::set_batch_on_ready(bool p_enable) {
+	batch_on_ready = p_enable;
+}
+
+bool StaticBatch3D::is_batch_on_ready_enabled() const {
+	return batch_on_ready;
+}
+
+void StaticBatch3D::set_generate_lods(bool p_enable) {
+	generate_lods = p_enable;
+}
+
+bool StaticBatch3D::is_generate_lods_enabled() const {
+	return generate_lods;
+}
+
+void StaticBatch3D::set_hlod_distance(real_t p_distance) {
+	ERR_FAIL_COND(p_distance < 0.0);
+	hlod_distance = p_distance;
+}
+
+real_t StaticBatch3D::get_hlod_distance() const {
+	return hlod_distance;
+}
+
+void StaticBatch3D::set_hlod_group_size(int p_size) {
+	ERR_FAIL_COND(p_size < 1);
+	hlod_group_size = p_size;
+}
+
+int StaticBatch3D::get_hlod_group_size() const {
+	return hlod_group_size;
+}
+
+void StaticBatch3D::set_hlod_triangle_ratio(real_t p_ratio) {
+	ERR_FAIL_COND(p_ratio <= 0.0 || p_ratio > 1.0);
+	hlod_triangle_ratio = p_ratio;
+}
+
+real_t StaticBatch3D::get_hlod_triangle_ratio() const {
+	return hlod_triangle_ratio;
+}
+
+void StaticBatch3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "size"), &StaticBatch3D::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &StaticBatch3D::get_cluster_size);
+	ClassDB::bind_method(D_METHOD("set_batch_on_ready", "enable"), &StaticBatch3D::set_batch_on_ready);
+	ClassDB::bind_method(D_METHOD("is_batch_on_ready_enabled"), &StaticBatch3D::is_batch_on_ready_enabled);
+	ClassDB::bind_method(D_METHOD("set_generate_lods", "enable"), &StaticBatch3D::set_generate_lods);
+	ClassDB::bind_method(D_METHOD("is_generate_lods_enabled"), &StaticBatch3D::is_generate_lods_enabled);
+	ClassDB::bind_method(D_METHOD("set_hlod_distance", "distance"), &StaticBatch3D::set_hlod_distance);
+	ClassDB::bind_method(D_METHOD("get_hlod_distance"), &StaticBatch3D::get_hlod_distance);
+	ClassDB::bind_method(D_METHOD("set_hlod_group_size", "size"), &StaticBatch3D::set_hlod_group_size);
+	ClassDB::bind_method(D_METHOD("get_hlod_group_size"), &StaticBatch3D::get_hlod_group_size);
+	ClassDB::bind_method(D_METHOD("set_hlod_triangle_ratio", "ratio"), &StaticBatch3D::set_hlod_triangle_ratio);
+	ClassDB::bind_method(D_METHOD("get_hlod_triangle_ratio"), &StaticBatch3D::get_hlod_triangle_ratio);
+
+	ClassDB::bind_method(D_METHOD("make_baked_meshes"), &StaticBatch3D::make_baked_meshes);
+	ClassDB::bind_method(D_METHOD("clear_baked_meshes"), &StaticBatch3D::clear_baked_meshes);
+	ClassDB::bind_method(D_METHOD("get_baked_meshes"), &StaticBatch3D::get_baked_meshes);
+	ClassDB::bind_method(D_METHOD("get_hlod_meshes"), &StaticBatch3D::get_hlod_meshes);
+	ClassDB::bind_method(D_METHOD("get_statistics"), &StaticBatch3D::get_statistics);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cluster_size", PROPERTY_HINT_RANGE, "0.1,256,0.1,or_greater,suffix:m"), "set_cluster_size", "get_cluster_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "batch_on_ready"), "set_batch_on_ready", "is_batch_on_ready_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "generate_lods"), "set_generate_lods", "is_generate_lods_enabled");
+
+	ADD_GROUP("HLOD", "hlod_");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "hlod_distance", PROPERTY_HINT_RANGE, "0,4096,0.01,or_greater,suffix:m"), "set_hlod_distance", "get_hlod_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "hlod_group_size", PROPERTY_HINT_RANGE, "1,16,1,or_greater"), "set_hlod_group_size", "get_hlod_group_size");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "hlod_triangle_ratio", PROPERTY_HINT_RANGE, "0.01,1,0.01"), "set_hlod_triangle_ratio", "get_hlod_triangle_ratio");
+}
+
+StaticBatch3D::StaticBatch3D() {
+	set_notify_transform(true);
+}
+
+StaticBatch3D::~StaticBatch3D() {
+	if (RenderingServer::get_singleton()) {
+		_free_baked_meshes();
+	}
+}
@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*  static_batch_3d.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef STATIC_BATCH_3D_H
+#define STATIC_BATCH_3D_H
+
+#include "scene/3d/node_3d.h"
+#include "scene/3d/visual_instance_3d.h"
+#include "scene/resources/material.h"
+#include "scene/resources/mesh.h"
+
+class MeshInstance3D;
+
+class StaticBatch3D : public Node3D {
+	GDCLASS(StaticBatch3D, Node3D);
+
+	// Instances in the same cell of the cluster grid with the same settings are merged into one.
+	struct ClusterKey {
+		Vector3i cell;
+		uint32_t layer_mask = 0;
+		RS::ShadowCastingSetting cast_shadows = RS::SHADOW_CASTING_SETTING_ON;
+		GeometryInstance3D::GIMode gi_mode = GeometryInstance3D::GI_MODE_STATIC;
+
+		static uint32_t hash(const ClusterKey &p_key) {
+			uint32_t h = hash_murmur3_one_32(p_key.cell.x);
+			h = hash_murmur3_one_32(p_key.cell.y, h);
+			h = hash_murmur3_one_32(p_key.cell.z, h);
+			h = hash_murmur3_one_32(p_key.layer_mask, h);
+			h = hash_murmur3_one_32(p_key.cast_shadows, h);
+			h = hash_murmur3_one_32(p_key.gi_mode, h);
+			return hash_fmix32(h);
+		}
+		_FORCE_INLINE_ bool operator==(const ClusterKey &p_key) const {
+			return cell == p_key.cell && layer_mask == p_key.layer_mask && cast_shadows == p_key.cast_shadows && gi_mode == p_key.gi_mode;
+		}
+	};
+
+	// Surfaces of a cluster with the same material and vertex format are merged into one.
+	struct SurfaceKey {
+		Ref<Material> material;
+		uint64_t format = 0;
+
+		static uint32_t hash(const SurfaceKey &p_key) {
+			return hash_fmix32(hash_murmur3_one_64(p_key.format, hash_murmur3_one_64((uint64_t)p_key.material.ptr())));
+		}
+		_FORCE_INLINE_ bool operator==(const SurfaceKey &p_key) const {
+			return material == p_key.material && format == p_key.format;
+		}
+	};
+
+	struct BakedMesh {
+		Ref<Mesh> mesh;
+		RID instance;
+	};
+
+	real_t cluster_size = 16.0;
+	bool batch_on_ready = true;
+	bool generate_lods = false;
+
+	real_t hlod_distance = 0.0;
+	int hlod_group_size = 4;
+	real_t hlod_triangle_ratio = 0.1;
+
+	Vector<BakedMesh> baked_meshes;
+	// Simplified proxies, each replacing a group of baked meshes beyond hlod_distance.
+	Vector<BakedMesh> hlod_meshes;
+	LocalVector<ObjectID> batched_nodes;
+	// Instances only left out because they were hidden. Batching is redone when any of them is shown,
+	// or when a batched one is hidden, so that no instance is drawn twice or drawn while hidden.
+	LocalVector<ObjectID> hidden_nodes;
+	bool batched_visibility_update_queued = false;
+
+	int source_triangle_count = 0;
+	int hlod_triangle_count = 0;
+
+	static bool _is_material_transparent(const Ref<Material> &p_material);
+	bool _can_batch(const MeshInstance3D *p_mesh_instance) const;
+	void _find_mesh_instances(Node *p_node, LocalVector<MeshInstance3D *> &r_mesh_instances, LocalVector<ObjectID> &r_hidden_nodes) const;
+	static void _append_surface_arrays(Array &r_arrays, const Array &p_arrays, const Transform3D &p_xform);
+	static bool _simplify_surface_arrays(Array &r_arrays, real_t p_triangle_ratio);
+	RID _create_instance(const Ref<Mesh> &p_mesh, const ClusterKey &p_key);
+	void _free_baked_meshes();
+	void _hide_batched_nodes();
+	void _update_visibility();
+	void _queue_batched_visibility_update();
+	void _update_batched_visibility();
+
+protected:
+	void _notification(int p_what);
+	static void _bind_methods();
+
+public:
+	void set_cluster_size(real_t p_size);
+	real_t get_cluster_size() const;
+
+	void set_batch_on_ready(bool p_enable);
+	bool is_batch_on_ready_enabled() const;
+
+	void set_generate_lods(bool p_enable);
+	bool is_generate_lods_enabled() const;
+
+	void set_hlod_distance(real_t p_distance);
+	real_t get_hlod_distance() const;
+
+	void set_hlod_group_size(int p_size);
+	int get_hlod_group_size() const;
+
+	void set_hlod_triangle_ratio(real_t p_ratio);
+	real_t get_hlod_triangle_ratio() const;
+
+	void make_baked_meshes();
+	void clear_baked_meshes();
+	Array get_baked_meshes() const;
+	Array get_hlod_meshes() const;
+	Dictionary get_statistics() const;
+
+	StaticBatch3D();
+	~StaticBatch3D();
+};
+
+#endif // STATIC_BATCH_3D_H
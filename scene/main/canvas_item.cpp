@@ -174,16 +174,38 @@ Transform2D CanvasItem::get_global_transform() const {
 
 	if (_is_global_invalid()) {
 		// This code can enter multiple times from threads if dirty, this is expected.
-		const CanvasItem *pi = get_parent_item();
-		Transform2D new_global;
-		if (pi) {
-			new_global = pi->get_global_transform() * get_transform();
-		} else {
-			new_global = get_transform();
+		// Collect the dirty ancestors and update them from the top down in a single pass, instead of recursing
+		// into each parent. Hierarchies deeper than the chain are resolved one chunk at a time.
+		const CanvasItem *chain[GLOBAL_TRANSFORM_CHAIN_MAX];
+		int count = 0;
+		const CanvasItem *item = this;
+		const CanvasItem *pi = nullptr;
+		while (true) {
+			chain[count++] = item;
+			pi = item->get_parent_item();
+			if (!pi || !pi->_is_global_invalid()) {
+				break;
+			}
+			if (count == GLOBAL_TRANSFORM_CHAIN_MAX) {
+				pi->get_global_transform();
+				break;
+			}
+			item = pi;
 		}
 
-		global_transform = new_global;
-		_set_global_invalid(false);
+		for (int i = count - 1; i >= 0; i--) {
+			item = chain[i];
+			Transform2D new_global;
+			if (pi) {
+				new_global = pi->global_transform * item->get_transform();
+			} else {
+				new_global = item->get_transform();
+			}
+
+			item->global_transform = new_global;
+			item->_set_global_invalid(false);
+			pi = item;
+		}
 	}
 
 	return global_transform;
@@ -986,6 +1008,12 @@ void CanvasItem::_physics_interpolated_changed() {
 	RenderingServer::get_singleton()->canvas_item_set_interpolated(canvas_item, is_physics_interpolated());
 }
 
+void CanvasItem::_update_pending_global_transform() const {
+	if (_is_global_invalid()) {
+		get_global_transform();
+	}
+}
+
 Rect2 CanvasItem::get_viewport_rect() const {
 	ERR_READ_THREAD_GUARD_V(Rect2());
 	ERR_FAIL_COND_V(!is_inside_tree(), Rect2());
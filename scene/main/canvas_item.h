@@ -117,6 +117,8 @@ private:
 
 	Ref<Material> material;
 
+	static constexpr int GLOBAL_TRANSFORM_CHAIN_MAX = 64;
+
 	mutable Transform2D global_transform;
 	mutable MTFlag global_invalid;
 
@@ -141,6 +143,7 @@ private:
 	void _notify_transform(CanvasItem *p_node);
 
 	virtual void _physics_interpolated_changed() override;
+	virtual void _update_pending_global_transform() const override;
 
 	static CanvasItem *current_item_drawn;
 	friend class Viewport;
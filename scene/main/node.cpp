@@ -238,6 +238,10 @@ void Node::_notification(int p_notification) {
 				return;
 			}
 
+			if (data.pooled && SceneTree::get_singleton()) {
+				SceneTree::get_singleton()->_forget_pooled_node(this);
+			}
+
 			if (data.owner) {
 				_clean_up_owner();
 			}
@@ -252,8 +256,13 @@ void Node::_notification(int p_notification) {
 			}
 
 			// kill children as cleanly as possible
-			while (data.children.size()) {
-				Node *child = data.children.last()->value; // begin from the end because its faster and more consistent with creation
+			_compact_children();
+			while (data.ordered_children.size()) {
+				Node *child = data.ordered_children[data.ordered_children.size() - 1]; // begin from the end because its faster and more consistent with creation
+				if (unlikely(!child)) {
+					_compact_children(); // A sibling was removed while freeing the previous child.
+					continue;
+				}
 				memdelete(child);
 			}
 		} break;
@@ -269,8 +278,9 @@ void Node::_notification(int p_notification) {
 void Node::_propagate_ready() {
 	data.ready_notified = true;
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_ready();
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_ready();
 	}
 
 	data.blocked--;
@@ -322,9 +332,10 @@ void Node::_propagate_enter_tree() {
 	data.blocked++;
 	//block while adding children
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		if (!K.value->is_inside_tree()) { // could have been added in enter_tree
-			K.value->_propagate_enter_tree();
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		if (!data.ordered_children[i]->is_inside_tree()) { // could have been added in enter_tree
+			data.ordered_children[i]->_propagate_enter_tree();
 		}
 	}
 
@@ -358,8 +369,9 @@ void Node::_propagate_after_exit_tree() {
 
 	data.blocked++;
 
-	for (HashMap<StringName, Node *>::Iterator I = data.children.last(); I; --I) {
-		I->value->_propagate_after_exit_tree();
+	_compact_children();
+	for (int i = (int)data.ordered_children.size() - 1; i >= 0; i--) {
+		data.ordered_children[i]->_propagate_after_exit_tree();
 	}
 
 	data.blocked--;
@@ -378,8 +390,9 @@ void Node::_propagate_exit_tree() {
 #endif
 	data.blocked++;
 
-	for (HashMap<StringName, Node *>::Iterator I = data.children.last(); I; --I) {
-		I->value->_propagate_exit_tree();
+	_compact_children();
+	for (int i = (int)data.ordered_children.size() - 1; i >= 0; i--) {
+		data.ordered_children[i]->_propagate_exit_tree();
 	}
 
 	data.blocked--;
@@ -441,8 +454,9 @@ void Node::_propagate_physics_interpolated(bool p_interpolated) {
 	_physics_interpolated_changed();
 
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_physics_interpolated(p_interpolated);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_physics_interpolated(p_interpolated);
 	}
 	data.blocked--;
 }
@@ -453,8 +467,9 @@ void Node::_propagate_physics_interpolation_reset_requested(bool p_requested) {
 	}
 
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_physics_interpolation_reset_requested(p_requested);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_physics_interpolation_reset_requested(p_requested);
 	}
 	data.blocked--;
 }
@@ -464,26 +479,26 @@ void Node::move_child(Node *p_child, int p_index) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(p_child->data.parent != this, "Child is not a child of this node.");
 
-	_update_children_cache();
+	_compact_children();
 	// We need to check whether node is internal and move it only in the relevant node range.
 	if (p_child->data.internal_mode == INTERNAL_MODE_FRONT) {
 		if (p_index < 0) {
-			p_index += data.internal_children_front_count_cache;
+			p_index += data.internal_children_front_count;
 		}
-		ERR_FAIL_INDEX_MSG(p_index, data.internal_children_front_count_cache, vformat("Invalid new child index: %d. Child is internal.", p_index));
+		ERR_FAIL_INDEX_MSG(p_index, data.internal_children_front_count, vformat("Invalid new child index: %d. Child is internal.", p_index));
 		_move_child(p_child, p_index);
 	} else if (p_child->data.internal_mode == INTERNAL_MODE_BACK) {
 		if (p_index < 0) {
-			p_index += data.internal_children_back_count_cache;
+			p_index += data.internal_children_back_count;
 		}
-		ERR_FAIL_INDEX_MSG(p_index, data.internal_children_back_count_cache, vformat("Invalid new child index: %d. Child is internal.", p_index));
-		_move_child(p_child, (int)data.children_cache.size() - data.internal_children_back_count_cache + p_index);
+		ERR_FAIL_INDEX_MSG(p_index, data.internal_children_back_count, vformat("Invalid new child index: %d. Child is internal.", p_index));
+		_move_child(p_child, (int)data.ordered_children.size() - data.internal_children_back_count + p_index);
 	} else {
 		if (p_index < 0) {
 			p_index += get_child_count(false);
 		}
-		ERR_FAIL_INDEX_MSG(p_index, (int)data.children_cache.size() + 1 - data.internal_children_front_count_cache - data.internal_children_back_count_cache, vformat("Invalid new child index: %d.", p_index));
-		_move_child(p_child, p_index + data.internal_children_front_count_cache);
+		ERR_FAIL_INDEX_MSG(p_index, (int)data.ordered_children.size() + 1 - data.internal_children_front_count - data.internal_children_back_count, vformat("Invalid new child index: %d.", p_index));
+		_move_child(p_child, p_index + data.internal_children_front_count);
 	}
 }
 
@@ -494,15 +509,15 @@ void Node::_move_child(Node *p_child, int p_index, bool p_ignore_end) {
 	// means the same as moving to the last index
 	if (!p_ignore_end) { // p_ignore_end is a little hack to make back internal children work properly.
 		if (p_child->data.internal_mode == INTERNAL_MODE_FRONT) {
-			if (p_index == data.internal_children_front_count_cache) {
+			if (p_index == data.internal_children_front_count) {
 				p_index--;
 			}
 		} else if (p_child->data.internal_mode == INTERNAL_MODE_BACK) {
-			if (p_index == (int)data.children_cache.size()) {
+			if (p_index == (int)data.ordered_children.size()) {
 				p_index--;
 			}
 		} else {
-			if (p_index == (int)data.children_cache.size() - data.internal_children_back_count_cache) {
+			if (p_index == (int)data.ordered_children.size() - data.internal_children_back_count) {
 				p_index--;
 			}
 		}
@@ -517,8 +532,8 @@ void Node::_move_child(Node *p_child, int p_index, bool p_ignore_end) {
 	int motion_from = MIN(p_index, child_index);
 	int motion_to = MAX(p_index, child_index);
 
-	data.children_cache.remove_at(child_index);
-	data.children_cache.insert(p_index, p_child);
+	data.ordered_children.remove_at(child_index);
+	data.ordered_children.insert(p_index, p_child);
 
 	if (data.tree) {
 		data.tree->tree_changed();
@@ -527,12 +542,12 @@ void Node::_move_child(Node *p_child, int p_index, bool p_ignore_end) {
 	data.blocked++;
 	//new pos first
 	for (int i = motion_from; i <= motion_to; i++) {
-		if (data.children_cache[i]->data.internal_mode == INTERNAL_MODE_DISABLED) {
-			data.children_cache[i]->data.index = i - data.internal_children_front_count_cache;
-		} else if (data.children_cache[i]->data.internal_mode == INTERNAL_MODE_BACK) {
-			data.children_cache[i]->data.index = i - data.internal_children_front_count_cache - data.external_children_count_cache;
+		if (data.ordered_children[i]->data.internal_mode == INTERNAL_MODE_DISABLED) {
+			data.ordered_children[i]->data.index = i - data.internal_children_front_count;
+		} else if (data.ordered_children[i]->data.internal_mode == INTERNAL_MODE_BACK) {
+			data.ordered_children[i]->data.index = i - data.internal_children_front_count - data.external_children_count;
 		} else {
-			data.children_cache[i]->data.index = i;
+			data.ordered_children[i]->data.index = i;
 		}
 	}
 	// notification second
@@ -551,8 +566,9 @@ void Node::_propagate_groups_dirty() {
 		}
 	}
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_groups_dirty();
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_groups_dirty();
 	}
 }
 
@@ -573,6 +589,8 @@ void Node::owner_changed_notify() {
 
 void Node::_physics_interpolated_changed() {}
 
+void Node::_update_pending_global_transform() const {}
+
 void Node::set_physics_process(bool p_process) {
 	ERR_THREAD_GUARD
 	if (data.physics_process == p_process) {
@@ -692,8 +710,9 @@ void Node::_propagate_pause_notification(bool p_enable) {
 	}
 
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_pause_notification(p_enable);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_pause_notification(p_enable);
 	}
 	data.blocked--;
 }
@@ -702,8 +721,9 @@ void Node::_propagate_suspend_notification(bool p_enable) {
 	notification(p_enable ? NOTIFICATION_SUSPENDED : NOTIFICATION_UNSUSPENDED);
 
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &KV : data.children) {
-		KV.value->_propagate_suspend_notification(p_enable);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_suspend_notification(p_enable);
 	}
 	data.blocked--;
 }
@@ -724,8 +744,9 @@ void Node::_propagate_process_owner(Node *p_owner, int p_pause_notification, int
 	}
 
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		Node *c = K.value;
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		Node *c = data.ordered_children[i];
 		if (c->data.process_mode == PROCESS_MODE_INHERIT) {
 			c->_propagate_process_owner(p_owner, p_pause_notification, p_enabled_notification);
 		}
@@ -738,8 +759,9 @@ void Node::set_multiplayer_authority(int p_peer_id, bool p_recursive) {
 	data.multiplayer_authority = p_peer_id;
 
 	if (p_recursive) {
-		for (KeyValue<StringName, Node *> &K : data.children) {
-			K.value->set_multiplayer_authority(p_peer_id, true);
+		_compact_children();
+		for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+			data.ordered_children[i]->set_multiplayer_authority(p_peer_id, true);
 		}
 	}
 }
@@ -1045,12 +1067,13 @@ void Node::_remove_tree_from_process_thread_group() {
 		return; // May not be initialized yet.
 	}
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		if (K.value->data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT) {
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		if (data.ordered_children[i]->data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT) {
 			continue;
 		}
 
-		K.value->_remove_tree_from_process_thread_group();
+		data.ordered_children[i]->_remove_tree_from_process_thread_group();
 	}
 
 	if (_is_any_processing()) {
@@ -1070,12 +1093,13 @@ void Node::_add_tree_to_process_thread_group(Node *p_owner) {
 		data.process_group = &data.tree->default_process_group;
 	}
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		if (K.value->data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT) {
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		if (data.ordered_children[i]->data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT) {
 			continue;
 		}
 
-		K.value->_add_to_process_thread_group();
+		data.ordered_children[i]->_add_to_process_thread_group();
 	}
 }
 bool Node::is_processing_internal() const {
@@ -1102,6 +1126,16 @@ int Node::get_process_thread_group_order() const {
 	return data.process_thread_group_order;
 }
 
+void Node::set_process_thread_group_budget_usec(int p_usec) {
+	ERR_THREAD_GUARD
+	ERR_FAIL_COND(p_usec < 0);
+	data.process_thread_group_budget_usec = p_usec;
+}
+
+int Node::get_process_thread_group_budget_usec() const {
+	return data.process_thread_group_budget_usec;
+}
+
 void Node::set_process_priority(int p_priority) {
 	ERR_THREAD_GUARD
 	if (data.process_priority == p_priority) {
@@ -1369,8 +1403,9 @@ void Node::set_translation_domain_inherited() {
 }
 
 void Node::_propagate_translation_domain_dirty() {
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		Node *child = K.value;
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		Node *child = data.ordered_children[i];
 		if (child->data.is_translation_domain_inherited) {
 			child->data.is_translation_domain_dirty = true;
 			child->_propagate_translation_domain_dirty();
@@ -1606,28 +1641,28 @@ void Node::_add_child_nocheck(Node *p_child, const StringName &p_name, InternalM
 	p_child->data.name = p_name;
 	data.children.insert(p_name, p_child);
 
+	// Children are added at the end of their range, so the indices of their siblings don't change.
 	p_child->data.internal_mode = p_internal_mode;
 	switch (p_internal_mode) {
 		case INTERNAL_MODE_FRONT: {
-			p_child->data.index = data.internal_children_front_count_cache++;
+			p_child->data.index = data.internal_children_front_count + data.internal_children_front_holes;
+			data.ordered_children.insert(p_child->data.index, p_child);
+			data.internal_children_front_count++;
 		} break;
 		case INTERNAL_MODE_BACK: {
-			p_child->data.index = data.internal_children_back_count_cache++;
+			p_child->data.index = data.internal_children_back_count + data.internal_children_back_holes;
+			data.ordered_children.push_back(p_child);
+			data.internal_children_back_count++;
 		} break;
 		case INTERNAL_MODE_DISABLED: {
-			p_child->data.index = data.external_children_count_cache++;
+			p_child->data.index = data.external_children_count + data.external_children_holes;
+			data.ordered_children.insert(data.internal_children_front_count + data.internal_children_front_holes + p_child->data.index, p_child);
+			data.external_children_count++;
 		} break;
 	}
 
 	p_child->data.parent = this;
 
-	if (!data.children_cache_dirty && p_internal_mode == INTERNAL_MODE_DISABLED && data.internal_children_back_count_cache == 0) {
-		// Special case, also add to the cached children array since its cheap.
-		data.children_cache.push_back(p_child);
-	} else {
-		data.children_cache_dirty = true;
-	}
-
 	p_child->notification(NOTIFICATION_PARENTED);
 
 	if (data.tree) {
@@ -1674,7 +1709,7 @@ void Node::add_sibling(Node *p_sibling, bool p_force_readable_name) {
 	ERR_FAIL_COND_MSG(data.parent->data.blocked > 0, "Parent node is busy setting up children, `add_sibling()` failed. Consider using `add_sibling.call_deferred(sibling)` instead.");
 
 	data.parent->add_child(p_sibling, p_force_readable_name, data.internal_mode);
-	data.parent->_update_children_cache();
+	data.parent->_compact_children();
 	data.parent->_move_child(p_sibling, get_index() + 1);
 }
 
@@ -1684,16 +1719,6 @@ void Node::remove_child(Node *p_child) {
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy adding/removing children, `remove_child()` can't be called at this time. Consider using `remove_child.call_deferred(child)` instead.");
 	ERR_FAIL_COND(p_child->data.parent != this);
 
-	/**
-	 *  Do not change the data.internal_children*cache counters here.
-	 *  Because if nodes are re-added, the indices can remain
-	 *  greater-than-everything indices and children added remain
-	 *  properly ordered.
-	 *
-	 *  All children indices and counters will be updated next time the
-	 *  cache is re-generated.
-	 */
-
 	data.blocked++;
 	p_child->_set_tree(nullptr);
 	//}
@@ -1703,10 +1728,39 @@ void Node::remove_child(Node *p_child) {
 
 	data.blocked--;
 
-	data.children_cache_dirty = true;
 	bool success = data.children.erase(p_child->data.name);
 	ERR_FAIL_COND_MSG(!success, "Children name does not match parent name in hashtable, this is a bug.");
 
+	// Leave a hole instead of moving the following children, unless it's the last one.
+	int position = p_child->data.index;
+	if (p_child->data.internal_mode != INTERNAL_MODE_FRONT) {
+		position += data.internal_children_front_count + data.internal_children_front_holes;
+		if (p_child->data.internal_mode == INTERNAL_MODE_BACK) {
+			position += data.external_children_count + data.external_children_holes;
+		}
+	}
+	ERR_FAIL_COND_MSG(position < 0 || position >= (int)data.ordered_children.size() || data.ordered_children[position] != p_child, "Child is not at its index in the parent, this is a bug.");
+	bool is_last = position == (int)data.ordered_children.size() - 1;
+	if (is_last) {
+		data.ordered_children.resize(position);
+	} else {
+		data.ordered_children[position] = nullptr;
+	}
+	switch (p_child->data.internal_mode) {
+		case INTERNAL_MODE_FRONT: {
+			data.internal_children_front_count--;
+			data.internal_children_front_holes += is_last ? 0 : 1;
+		} break;
+		case INTERNAL_MODE_BACK: {
+			data.internal_children_back_count--;
+			data.internal_children_back_holes += is_last ? 0 : 1;
+		} break;
+		case INTERNAL_MODE_DISABLED: {
+			data.external_children_count--;
+			data.external_children_holes += is_last ? 0 : 1;
+		} break;
+	}
+
 	p_child->data.parent = nullptr;
 	p_child->data.index = -1;
 
@@ -1718,65 +1772,62 @@ void Node::remove_child(Node *p_child) {
 	}
 }
 
-void Node::_update_children_cache_impl() const {
-	// Assign children
-	data.children_cache.resize(data.children.size());
-	int idx = 0;
-	for (const KeyValue<StringName, Node *> &K : data.children) {
-		data.children_cache[idx] = K.value;
-		idx++;
-	}
-	// Sort them
-	data.children_cache.sort_custom<ComparatorByIndex>();
-	// Update indices
-	data.external_children_count_cache = 0;
-	data.internal_children_back_count_cache = 0;
-	data.internal_children_front_count_cache = 0;
-
-	for (uint32_t i = 0; i < data.children_cache.size(); i++) {
-		switch (data.children_cache[i]->data.internal_mode) {
-			case INTERNAL_MODE_DISABLED: {
-				data.children_cache[i]->data.index = data.external_children_count_cache++;
-			} break;
+void Node::_compact_children_impl() const {
+	uint32_t count = 0;
+	int front_index = 0;
+	int external_index = 0;
+	int back_index = 0;
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		Node *child = data.ordered_children[i];
+		if (!child) {
+			continue;
+		}
+		data.ordered_children[count++] = child;
+		switch (child->data.internal_mode) {
 			case INTERNAL_MODE_FRONT: {
-				data.children_cache[i]->data.index = data.internal_children_front_count_cache++;
+				child->data.index = front_index++;
+			} break;
+			case INTERNAL_MODE_DISABLED: {
+				child->data.index = external_index++;
 			} break;
 			case INTERNAL_MODE_BACK: {
-				data.children_cache[i]->data.index = data.internal_children_back_count_cache++;
+				child->data.index = back_index++;
 			} break;
 		}
 	}
-	data.children_cache_dirty = false;
+	data.ordered_children.resize(count);
+	data.internal_children_front_holes = 0;
+	data.external_children_holes = 0;
+	data.internal_children_back_holes = 0;
 }
 
 int Node::get_child_count(bool p_include_internal) const {
 	ERR_THREAD_GUARD_V(0);
-	_update_children_cache();
 
 	if (p_include_internal) {
-		return data.children_cache.size();
+		return data.internal_children_front_count + data.external_children_count + data.internal_children_back_count;
 	} else {
-		return data.children_cache.size() - data.internal_children_front_count_cache - data.internal_children_back_count_cache;
+		return data.external_children_count;
 	}
 }
 
 Node *Node::get_child(int p_index, bool p_include_internal) const {
 	ERR_THREAD_GUARD_V(nullptr);
-	_update_children_cache();
+	_compact_children();
 
 	if (p_include_internal) {
 		if (p_index < 0) {
-			p_index += data.children_cache.size();
+			p_index += data.ordered_children.size();
 		}
-		ERR_FAIL_INDEX_V(p_index, (int)data.children_cache.size(), nullptr);
-		return data.children_cache[p_index];
+		ERR_FAIL_INDEX_V(p_index, (int)data.ordered_children.size(), nullptr);
+		return data.ordered_children[p_index];
 	} else {
 		if (p_index < 0) {
-			p_index += (int)data.children_cache.size() - data.internal_children_front_count_cache - data.internal_children_back_count_cache;
+			p_index += (int)data.ordered_children.size() - data.internal_children_front_count - data.internal_children_back_count;
 		}
-		ERR_FAIL_INDEX_V(p_index, (int)data.children_cache.size() - data.internal_children_front_count_cache - data.internal_children_back_count_cache, nullptr);
-		p_index += data.internal_children_front_count_cache;
-		return data.children_cache[p_index];
+		ERR_FAIL_INDEX_V(p_index, (int)data.ordered_children.size() - data.internal_children_front_count - data.internal_children_back_count, nullptr);
+		p_index += data.internal_children_front_count;
+		return data.ordered_children[p_index];
 	}
 }
 
@@ -1889,9 +1940,9 @@ bool Node::has_node(const NodePath &p_path) const {
 Node *Node::find_child(const String &p_pattern, bool p_recursive, bool p_owned) const {
 	ERR_THREAD_GUARD_V(nullptr);
 	ERR_FAIL_COND_V(p_pattern.is_empty(), nullptr);
-	_update_children_cache();
-	Node *const *cptr = data.children_cache.ptr();
-	int ccount = data.children_cache.size();
+	_compact_children();
+	Node *const *cptr = data.ordered_children.ptr();
+	int ccount = data.ordered_children.size();
 	for (int i = 0; i < ccount; i++) {
 		if (p_owned && !cptr[i]->data.owner) {
 			continue;
@@ -1919,9 +1970,9 @@ TypedArray<Node> Node::find_children(const String &p_pattern, const String &p_ty
 	ERR_THREAD_GUARD_V(TypedArray<Node>());
 	TypedArray<Node> ret;
 	ERR_FAIL_COND_V(p_pattern.is_empty() && p_type.is_empty(), ret);
-	_update_children_cache();
-	Node *const *cptr = data.children_cache.ptr();
-	int ccount = data.children_cache.size();
+	_compact_children();
+	Node *const *cptr = data.ordered_children.ptr();
+	int ccount = data.ordered_children.size();
 	for (int i = 0; i < ccount; i++) {
 		if (p_owned && !cptr[i]->data.owner) {
 			continue;
@@ -2052,7 +2103,7 @@ bool Node::is_greater_than(const Node *p_node) const {
 	ERR_FAIL_COND_V(data.depth < 0, false);
 	ERR_FAIL_COND_V(p_node->data.depth < 0, false);
 
-	_update_children_cache();
+	_compact_children();
 
 	int *this_stack = (int *)alloca(sizeof(int) * data.depth);
 	int *that_stack = (int *)alloca(sizeof(int) * p_node->data.depth);
@@ -2105,8 +2156,9 @@ void Node::get_owned_by(Node *p_by, List<Node *> *p_owned) {
 		p_owned->push_back(this);
 	}
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->get_owned_by(p_by, p_owned);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->get_owned_by(p_by, p_owned);
 	}
 }
 
@@ -2444,11 +2496,11 @@ void Node::print_tree() {
 
 String Node::_get_tree_string_pretty(const String &p_prefix, bool p_last) {
 	String new_prefix = p_last ? String::utf8(" ┖╴") : String::utf8(" ┠╴");
-	_update_children_cache();
+	_compact_children();
 	String return_tree = p_prefix + new_prefix + String(get_name()) + "\n";
-	for (uint32_t i = 0; i < data.children_cache.size(); i++) {
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
 		new_prefix = p_last ? String::utf8("   ") : String::utf8(" ┃ ");
-		return_tree += data.children_cache[i]->_get_tree_string_pretty(p_prefix + new_prefix, i == data.children_cache.size() - 1);
+		return_tree += data.ordered_children[i]->_get_tree_string_pretty(p_prefix + new_prefix, i == data.ordered_children.size() - 1);
 	}
 	return return_tree;
 }
@@ -2458,10 +2510,10 @@ String Node::get_tree_string_pretty() {
 }
 
 String Node::_get_tree_string(const Node *p_node) {
-	_update_children_cache();
+	_compact_children();
 	String return_tree = String(p_node->get_path_to(this)) + "\n";
-	for (uint32_t i = 0; i < data.children_cache.size(); i++) {
-		return_tree += data.children_cache[i]->_get_tree_string(p_node);
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		return_tree += data.ordered_children[i]->_get_tree_string(p_node);
 	}
 	return return_tree;
 }
@@ -2473,8 +2525,9 @@ String Node::get_tree_string() {
 void Node::_propagate_reverse_notification(int p_notification) {
 	data.blocked++;
 
-	for (HashMap<StringName, Node *>::Iterator I = data.children.last(); I; --I) {
-		I->value->_propagate_reverse_notification(p_notification);
+	_compact_children();
+	for (int i = (int)data.ordered_children.size() - 1; i >= 0; i--) {
+		data.ordered_children[i]->_propagate_reverse_notification(p_notification);
 	}
 
 	notification(p_notification, true);
@@ -2490,8 +2543,9 @@ void Node::_propagate_deferred_notification(int p_notification, bool p_reverse)
 		MessageQueue::get_singleton()->push_notification(this, p_notification);
 	}
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_deferred_notification(p_notification, p_reverse);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_deferred_notification(p_notification, p_reverse);
 	}
 
 	if (p_reverse) {
@@ -2506,8 +2560,9 @@ void Node::propagate_notification(int p_notification) {
 	data.blocked++;
 	notification(p_notification);
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->propagate_notification(p_notification);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->propagate_notification(p_notification);
 	}
 	data.blocked--;
 }
@@ -2520,8 +2575,9 @@ void Node::propagate_call(const StringName &p_method, const Array &p_args, const
 		callv(p_method, p_args);
 	}
 
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->propagate_call(p_method, p_args, p_parent_first);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->propagate_call(p_method, p_args, p_parent_first);
 	}
 
 	if (!p_parent_first && has_method(p_method)) {
@@ -2537,8 +2593,9 @@ void Node::_propagate_replace_owner(Node *p_owner, Node *p_by_owner) {
 	}
 
 	data.blocked++;
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->_propagate_replace_owner(p_owner, p_by_owner);
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->_propagate_replace_owner(p_owner, p_by_owner);
 	}
 	data.blocked--;
 }
@@ -3378,8 +3435,9 @@ void Node::get_argument_options(const StringName &p_function, int p_idx, List<St
 
 void Node::clear_internal_tree_resource_paths() {
 	clear_internal_resource_paths();
-	for (KeyValue<StringName, Node *> &K : data.children) {
-		K.value->clear_internal_tree_resource_paths();
+	_compact_children();
+	for (uint32_t i = 0; i < data.ordered_children.size(); i++) {
+		data.ordered_children[i]->clear_internal_tree_resource_paths();
 	}
 }
 
@@ -3470,7 +3528,7 @@ void Node::_call_unhandled_key_input(const Ref<InputEvent> &p_event) {
 }
 
 void Node::_validate_property(PropertyInfo &p_property) const {
-	if ((p_property.name == "process_thread_group_order" || p_property.name == "process_thread_messages") && data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+	if ((p_property.name == "process_thread_group_order" || p_property.name == "process_thread_group_budget_usec" || p_property.name == "process_thread_messages") && data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
 		p_property.usage = 0;
 	}
 }
@@ -3653,6 +3711,9 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process_thread_group_order", "order"), &Node::set_process_thread_group_order);
 	ClassDB::bind_method(D_METHOD("get_process_thread_group_order"), &Node::get_process_thread_group_order);
 
+	ClassDB::bind_method(D_METHOD("set_process_thread_group_budget_usec", "usec"), &Node::set_process_thread_group_budget_usec);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group_budget_usec"), &Node::get_process_thread_group_budget_usec);
+
 	ClassDB::bind_method(D_METHOD("set_display_folded", "fold"), &Node::set_display_folded);
 	ClassDB::bind_method(D_METHOD("is_displayed_folded"), &Node::is_displayed_folded);
 
@@ -3858,6 +3919,7 @@ void Node::_bind_methods() {
 	ADD_SUBGROUP("Thread Group", "process_thread");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group_order"), "set_process_thread_group_order", "get_process_thread_group_order");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group_budget_usec", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:µs"), "set_process_thread_group_budget_usec", "get_process_thread_group_budget_usec");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_messages", PROPERTY_HINT_FLAGS, "Process,Physics Process"), "set_process_thread_messages", "get_process_thread_messages");
 
 	ADD_GROUP("Physics Interpolation", "physics_interpolation_");
@@ -3929,16 +3991,18 @@ Node::Node() {
 	data.inside_tree = false;
 	data.ready_notified = false; // This is a small hack, so if a node is added during _ready() to the tree, it correctly gets the _ready() notification.
 	data.ready_first = true;
+
+	data.pooled = false;
 }
 
 Node::~Node() {
 	data.grouped.clear();
 	data.owned.clear();
 	data.children.clear();
-	data.children_cache.clear();
+	data.ordered_children.clear();
 
 	ERR_FAIL_COND(data.parent);
-	ERR_FAIL_COND(data.children_cache.size());
+	ERR_FAIL_COND(data.ordered_children.size());
 
 	orphan_node_count--;
 }
@@ -137,18 +137,6 @@ private:
 		SceneTree::Group *group = nullptr;
 	};
 
-	struct ComparatorByIndex {
-		bool operator()(const Node *p_left, const Node *p_right) const {
-			static const uint32_t order[3] = { 1, 0, 2 };
-			uint32_t order_left = order[p_left->data.internal_mode];
-			uint32_t order_right = order[p_right->data.internal_mode];
-			if (order_left == order_right) {
-				return p_left->data.index < p_right->data.index;
-			}
-			return order_left < order_right;
-		}
-	};
-
 	struct ComparatorWithPriority {
 		bool operator()(const Node *p_a, const Node *p_b) const { return p_b->data.process_priority == p_a->data.process_priority ? p_b->is_greater_than(p_a) : p_b->data.process_priority > p_a->data.process_priority; }
 	};
@@ -165,16 +153,20 @@ private:
 
 		Node *parent = nullptr;
 		Node *owner = nullptr;
-		HashMap<StringName, Node *> children;
-		mutable bool children_cache_dirty = true;
-		mutable LocalVector<Node *> children_cache;
+		HashMap<StringName, Node *> children; // For lookups by name.
+		// Internal front, external and internal back children, in order. Removing a child leaves
+		// a hole instead of moving the following ones, until the holes are compacted.
+		mutable LocalVector<Node *> ordered_children;
 		HashMap<StringName, Node *> owned_unique_nodes;
 		bool unique_name_in_owner = false;
 		InternalMode internal_mode = INTERNAL_MODE_DISABLED;
-		mutable int internal_children_front_count_cache = 0;
-		mutable int internal_children_back_count_cache = 0;
-		mutable int external_children_count_cache = 0;
-		mutable int index = -1; // relative to front, normal or back.
+		int internal_children_front_count = 0;
+		int internal_children_back_count = 0;
+		int external_children_count = 0;
+		mutable int internal_children_front_holes = 0;
+		mutable int internal_children_back_holes = 0;
+		mutable int external_children_holes = 0;
+		mutable int index = -1; // relative to front, normal or back. Counts holes until compacted.
 		int depth = -1;
 		int blocked = 0; // Safeguard that throws an error when attempting to modify the tree in a harmful way while being traversed.
 		StringName name;
@@ -195,6 +187,7 @@ private:
 		ProcessThreadGroup process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
 		Node *process_thread_group_owner = nullptr;
 		int process_thread_group_order = 0;
+		int process_thread_group_budget_usec = 0;
 		BitField<ProcessThreadMessages> process_thread_messages;
 		void *process_group = nullptr; // to avoid cyclic dependency
 
@@ -251,6 +244,8 @@ private:
 		bool ready_notified : 1;
 		bool ready_first : 1;
 
+		bool pooled : 1; // Belongs to a scene pool of the SceneTree.
+
 		AutoTranslateMode auto_translate_mode = AUTO_TRANSLATE_MODE_INHERIT;
 		mutable bool is_auto_translating = true;
 		mutable bool is_auto_translate_dirty = true;
@@ -310,13 +305,13 @@ private:
 
 	void _clean_up_owner();
 
-	_FORCE_INLINE_ void _update_children_cache() const {
-		if (unlikely(data.children_cache_dirty)) {
-			_update_children_cache_impl();
+	_FORCE_INLINE_ void _compact_children() const {
+		if (unlikely(data.internal_children_front_holes + data.external_children_holes + data.internal_children_back_holes > 0)) {
+			_compact_children_impl();
 		}
 	}
 
-	void _update_children_cache_impl() const;
+	void _compact_children_impl() const;
 
 	// Process group management
 	void _add_process_group();
@@ -338,6 +333,7 @@ protected:
 	void _notification(int p_notification);
 
 	virtual void _physics_interpolated_changed();
+	virtual void _update_pending_global_transform() const;
 
 	virtual void add_child_notify(Node *p_child);
 	virtual void remove_child_notify(Node *p_child);
@@ -516,20 +512,20 @@ public:
 		if (!data.parent) {
 			return data.index;
 		}
-		data.parent->_update_children_cache();
+		data.parent->_compact_children();
 
 		if (!p_include_internal) {
 			return data.index;
 		} else {
 			switch (data.internal_mode) {
 				case INTERNAL_MODE_DISABLED: {
-					return data.parent->data.internal_children_front_count_cache + data.index;
+					return data.parent->data.internal_children_front_count + data.index;
 				} break;
 				case INTERNAL_MODE_FRONT: {
 					return data.index;
 				} break;
 				case INTERNAL_MODE_BACK: {
-					return data.parent->data.internal_children_front_count_cache + data.parent->data.external_children_count_cache + data.index;
+					return data.parent->data.internal_children_front_count + data.parent->data.external_children_count + data.index;
 				} break;
 			}
 			return -1;
@@ -593,6 +589,9 @@ public:
 	void set_process_thread_group_order(int p_order);
 	int get_process_thread_group_order() const;
 
+	void set_process_thread_group_budget_usec(int p_usec);
+	int get_process_thread_group_budget_usec() const;
+
 	void set_physics_process_priority(int p_priority);
 	int get_physics_process_priority() const;
 
@@ -199,9 +199,44 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 	}
 }
 
+void SceneTree::_update_pending_global_transforms() {
+	int max_depth = 0;
+	uint32_t count = 0;
+	for (SelfList<Node> *n = xform_change_list.first(); n; n = n->next()) {
+		max_depth = MAX(max_depth, n->self()->data.depth);
+		count++;
+	}
+	if (count < 2) {
+		return; // Nothing to gain over updating on demand.
+	}
+
+	// Counting sort by depth: linear, and keeps the list order within each depth.
+	xform_change_depth_offsets.resize(max_depth + 2);
+	memset(xform_change_depth_offsets.ptr(), 0, xform_change_depth_offsets.size() * sizeof(uint32_t));
+	for (SelfList<Node> *n = xform_change_list.first(); n; n = n->next()) {
+		xform_change_depth_offsets[MAX(n->self()->data.depth, 0) + 1]++;
+	}
+	for (int i = 1; i <= max_depth + 1; i++) {
+		xform_change_depth_offsets[i] += xform_change_depth_offsets[i - 1];
+	}
+	xform_change_sorted.resize(count);
+	for (SelfList<Node> *n = xform_change_list.first(); n; n = n->next()) {
+		xform_change_sorted[xform_change_depth_offsets[MAX(n->self()->data.depth, 0)]++] = n->self();
+	}
+
+	for (const Node *node : xform_change_sorted) {
+		node->_update_pending_global_transform();
+	}
+	xform_change_sorted.clear();
+}
+
 void SceneTree::flush_transform_notifications() {
 	_THREAD_SAFE_METHOD_
 
+	// Bring the global transforms of all pending nodes up to date first, parents before children, so each
+	// one only has to combine its local transform with its parent's. Most notification handlers read it.
+	_update_pending_global_transforms();
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -296,7 +331,15 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 		nodes_removed_on_group_call_lock++;
 	}
 
-	if (p_call_flags & GROUP_CALL_REVERSE) {
+	if (_can_call_group_threaded(p_call_flags)) {
+		ThreadedGroupCall call;
+		call.function = p_function;
+		call.args = p_args;
+		call.argcount = p_argcount;
+		call.reverse = p_call_flags & GROUP_CALL_REVERSE;
+		_call_group_threaded(call, gr_nodes, gr_node_count);
+
+	} else if (p_call_flags & GROUP_CALL_REVERSE) {
 		for (int i = gr_node_count - 1; i >= 0; i--) {
 			if (nodes_removed_on_group_call_lock && nodes_removed_on_group_call.has(gr_nodes[i])) {
 				continue;
@@ -342,6 +385,71 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 	}
 }
 
+bool SceneTree::_can_call_group_threaded(uint32_t p_call_flags) const {
+	if (!(p_call_flags & GROUP_CALL_THREADED) || (p_call_flags & GROUP_CALL_DEFERRED) || node_threading_disabled) {
+		return false;
+	}
+	// Only the main thread can hand nodes over to their thread groups, and not while groups are processing.
+	return is_current_thread_safe_for_nodes() && !Node::is_group_processing();
+}
+
+void SceneTree::_call_group_threaded(ThreadedGroupCall &p_call, Node **p_nodes, int p_node_count) {
+	// Nodes in sub-thread process groups are batched per group, the rest are called right away from this thread.
+	HashMap<Node *, uint32_t> batch_indices;
+	for (int i = 0; i < p_node_count; i++) {
+		Node *node = p_nodes[p_call.reverse ? p_node_count - 1 - i : i];
+		if (nodes_removed_on_group_call.has(node)) {
+			continue;
+		}
+
+		Node *owner = node->data.process_thread_group_owner;
+		if (owner && owner->data.process_thread_group == Node::PROCESS_THREAD_GROUP_SUB_THREAD) {
+			const uint32_t *index = batch_indices.getptr(owner);
+			if (!index) {
+				index = &batch_indices.insert(owner, p_call.batches.size())->value;
+				p_call.batches.push_back(ThreadedGroupCall::Batch());
+				p_call.batches[*index].owner = owner;
+			}
+			p_call.batches[*index].nodes.push_back(node);
+		} else {
+			_call_group_node(node, p_call);
+		}
+	}
+
+	if (p_call.batches.size() == 1) {
+		_call_group_threaded_batch(0, &p_call);
+	} else if (p_call.batches.size() > 1) {
+		WorkerThreadPool::GroupID id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneTree::_call_group_threaded_batch, &p_call, p_call.batches.size(), -1, true, SNAME("SceneTreeGroupCall"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(id);
+	}
+}
+
+void SceneTree::_call_group_threaded_batch(uint32_t p_index, ThreadedGroupCall *p_call) {
+	const ThreadedGroupCall::Batch &batch = p_call->batches[p_index];
+	Node::current_process_thread_group = batch.owner;
+	for (Node *node : batch.nodes) {
+		// Nodes are only removed from the main thread, which is waiting for this.
+		if (nodes_removed_on_group_call.has(node)) {
+			continue;
+		}
+		_call_group_node(node, *p_call);
+	}
+	Node::current_process_thread_group = nullptr;
+}
+
+void SceneTree::_call_group_node(Node *p_node, const ThreadedGroupCall &p_call) {
+	if (p_call.is_notification) {
+		p_node->notification(p_call.notification, p_call.reverse);
+		return;
+	}
+
+	Callable::CallError ce;
+	p_node->callp(p_call.function, p_call.args, p_call.argcount, ce);
+	if (unlikely(ce.error != Callable::CallError::CALL_OK && ce.error != Callable::CallError::CALL_ERROR_INVALID_METHOD)) {
+		ERR_PRINT(vformat("Error calling group method on node \"%s\": %s.", p_node->get_name(), Variant::get_callable_error_text(Callable(p_node, p_call.function), p_call.args, p_call.argcount, ce)));
+	}
+}
+
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
 	Vector<Node *> nodes_copy;
 	{
@@ -368,7 +476,14 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 		nodes_removed_on_group_call_lock++;
 	}
 
-	if (p_call_flags & GROUP_CALL_REVERSE) {
+	if (_can_call_group_threaded(p_call_flags)) {
+		ThreadedGroupCall call;
+		call.notification = p_notification;
+		call.is_notification = true;
+		call.reverse = p_call_flags & GROUP_CALL_REVERSE;
+		_call_group_threaded(call, gr_nodes, gr_node_count);
+
+	} else if (p_call_flags & GROUP_CALL_REVERSE) {
 		for (int i = gr_node_count - 1; i >= 0; i--) {
 			if (nodes_removed_on_group_call.has(gr_nodes[i])) {
 				continue;
@@ -717,6 +832,11 @@ void SceneTree::finalize() {
 
 	_flush_ugc();
 
+	for (KeyValue<ObjectID, ScenePool> &E : scene_pools) {
+		_clear_scene_pool(E.value);
+	}
+	scene_pools.clear();
+
 	if (root) {
 		root->_set_tree(nullptr);
 		root->_propagate_after_exit_tree();
@@ -965,6 +1085,16 @@ Ref<ArrayMesh> SceneTree::get_debug_contact_mesh() {
 	return debug_contact_mesh;
 }
 
+void SceneTree::set_default_process_group_budget_usec(int p_usec) {
+	ERR_FAIL_COND_MSG(!Thread::is_main_thread(), "The process budget can only be set from the main thread.");
+	ERR_FAIL_COND(p_usec < 0);
+	default_process_group_budget_usec = p_usec;
+}
+
+int SceneTree::get_default_process_group_budget_usec() const {
+	return default_process_group_budget_usec;
+}
+
 void SceneTree::set_pause(bool p_enabled) {
 	ERR_FAIL_COND_MSG(!Thread::is_main_thread(), "Pause can only be set from the main thread.");
 	ERR_FAIL_COND_MSG(suspended, "Pause state cannot be modified while suspended.");
@@ -1041,8 +1171,45 @@ void SceneTree::_process_group(ProcessGroup *p_group, bool p_physics) {
 	uint32_t node_count = nodes_copy.size();
 	Node **nodes_ptr = (Node **)nodes_copy.ptr(); // Force cast, pointer will not change.
 
+	// With a budget, start where the last frame ran out of time, and stop once it's spent
+	// (but always process at least one node, so every node gets its turn eventually).
+	uint64_t budget_usec = 0;
+	if (!p_physics) {
+		budget_usec = p_group->owner ? p_group->owner->data.process_thread_group_budget_usec : default_process_group_budget_usec;
+	}
+	uint32_t first = 0;
+	uint64_t budget_end = 0;
+	if (budget_usec > 0) {
+		// The node list may have changed since, so look the node up again. If it's gone, start over.
+		if (p_group->budget_next_node.is_valid()) {
+			for (uint32_t i = 0; i < node_count; i++) {
+				if (nodes_ptr[i]->get_instance_id() == p_group->budget_next_node) {
+					first = i;
+					break;
+				}
+			}
+		}
+		budget_end = OS::get_singleton()->get_ticks_usec() + budget_usec;
+	}
+	if (!p_physics) {
+		p_group->budget_next_node = ObjectID();
+	}
+
 	for (uint32_t i = 0; i < node_count; i++) {
-		Node *n = nodes_ptr[i];
+		uint32_t index = first + i;
+		if (index >= node_count) {
+			index -= node_count;
+		}
+		if (budget_usec > 0 && i > 0 && OS::get_singleton()->get_ticks_usec() >= budget_end) {
+			if (!nodes_removed_on_group_call.has(nodes_ptr[index])) {
+				p_group->budget_next_node = nodes_ptr[index]->get_instance_id();
+			}
+			process_budget_deferred_nodes.add(node_count - i);
+			process_budget_exhausted_groups.increment();
+			break;
+		}
+
+		Node *n = nodes_ptr[index];
 		if (nodes_removed_on_group_call.has(n)) {
 			// Node may have been removed during process, skip it.
 			// Keep in mind removals can only happen on the main thread.
@@ -1108,6 +1275,11 @@ void SceneTree::_process(bool p_physics) {
 		process_groups_dirty = false;
 	}
 
+	if (!p_physics) {
+		process_budget_deferred_nodes.set(0);
+		process_budget_exhausted_groups.set(0);
+	}
+
 	// Cache the group count, because during processing new groups may be added.
 	// They will be added at the end, hence for consistency they will be ignored by this process loop.
 	// No group will be removed from the array during processing (this is done earlier in this function by marking the groups dirty).
@@ -1590,6 +1762,232 @@ Ref<SceneTreeTimer> SceneTree::create_timer(double p_delay_sec, bool p_process_a
 	return stt;
 }
 
+SceneTree::ScenePool *SceneTree::_get_scene_pool(const Ref<PackedScene> &p_scene) {
+	ScenePool *pool = scene_pools.getptr(p_scene->get_instance_id());
+	if (pool) {
+		return pool;
+	}
+
+	Node *instance = p_scene->instantiate();
+	ERR_FAIL_NULL_V_MSG(instance, nullptr, "Failed to instantiate the scene to pool.");
+
+	pool = &scene_pools.insert(p_scene->get_instance_id(), ScenePool())->value;
+	pool->scene = p_scene;
+	_record_pool_initial_state(*pool, instance, instance);
+
+	instance->data.pooled = true;
+	PooledNode pooled_node;
+	pooled_node.scene = p_scene->get_instance_id();
+	pooled_node.released = true;
+	pooled_nodes.insert(instance->get_instance_id(), pooled_node);
+	pool->free_nodes.push_back(instance);
+	return pool;
+}
+
+Node *SceneTree::_instantiate_pooled(ScenePool &p_pool) {
+	Node *instance = p_pool.scene->instantiate();
+	ERR_FAIL_NULL_V_MSG(instance, nullptr, "Failed to instantiate the pooled scene.");
+
+	instance->data.pooled = true;
+	PooledNode pooled_node;
+	pooled_node.scene = p_pool.scene->get_instance_id();
+	pooled_nodes.insert(instance->get_instance_id(), pooled_node);
+	return instance;
+}
+
+void SceneTree::_record_pool_initial_state(ScenePool &p_pool, Node *p_root, Node *p_node) {
+	uint32_t node_index = p_pool.node_paths.size();
+	p_pool.node_paths.push_back(p_root->get_path_to(p_node));
+
+	List<PropertyInfo> properties;
+	p_node->get_property_list(&properties);
+	for (const PropertyInfo &E : properties) {
+		if (!(E.usage & PROPERTY_USAGE_STORAGE) || E.name == CoreStringName(script)) {
+			continue;
+		}
+
+		Variant value = p_node->get(E.name);
+		if (value.get_type() == Variant::OBJECT) {
+			// Nodes and resources local to the scene are unique to each instance, and can't be restored.
+			Object *obj = value;
+			if (Object::cast_to<Node>(obj)) {
+				continue;
+			}
+			Resource *res = Object::cast_to<Resource>(obj);
+			if (res && res->is_local_to_scene()) {
+				continue;
+			}
+		}
+
+		ScenePool::Property property;
+		property.node = node_index;
+		property.name = E.name;
+		property.value = value;
+		p_pool.initial_state.push_back(property);
+	}
+
+	for (int i = 0; i < p_node->get_child_count(false); i++) {
+		_record_pool_initial_state(p_pool, p_root, p_node->get_child(i, false));
+	}
+}
+
+static uint32_t _count_pooled_nodes(const Node *p_node) {
+	uint32_t count = 1;
+	for (int i = 0; i < p_node->get_child_count(false); i++) {
+		count += _count_pooled_nodes(p_node->get_child(i, false));
+	}
+	return count;
+}
+
+bool SceneTree::_reset_pooled(const ScenePool &p_pool, Node *p_node) {
+	// The structure of the instance must not have changed: every node of a fresh instance
+	// is still there, and no node was added.
+	if (_count_pooled_nodes(p_node) != p_pool.node_paths.size()) {
+		return false;
+	}
+	LocalVector<Node *> nodes;
+	nodes.resize(p_pool.node_paths.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		nodes[i] = p_node->get_node_or_null(p_pool.node_paths[i]);
+		if (!nodes[i]) {
+			return false;
+		}
+	}
+
+	for (Node *node : nodes) {
+		node->request_ready();
+	}
+	for (const ScenePool::Property &E : p_pool.initial_state) {
+		Node *node = nodes[E.node];
+		if (E.value.get_type() == Variant::ARRAY || E.value.get_type() == Variant::DICTIONARY) {
+			node->set(E.name, E.value.duplicate());
+		} else {
+			node->set(E.name, E.value);
+		}
+	}
+	return true;
+}
+
+void SceneTree::_clear_scene_pool(ScenePool &p_pool) {
+	for (Node *node : p_pool.free_nodes) {
+		node->data.pooled = false;
+		pooled_nodes.erase(node->get_instance_id());
+		memdelete(node);
+	}
+	p_pool.free_nodes.clear();
+
+	// Nodes in use are freed as usual from now on.
+	ObjectID scene_id = p_pool.scene->get_instance_id();
+	LocalVector<ObjectID> in_use;
+	for (const KeyValue<ObjectID, PooledNode> &E : pooled_nodes) {
+		if (E.value.scene == scene_id) {
+			in_use.push_back(E.key);
+		}
+	}
+	for (const ObjectID &id : in_use) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(id));
+		if (node) {
+			node->data.pooled = false;
+		}
+		pooled_nodes.erase(id);
+	}
+}
+
+void SceneTree::_forget_pooled_node(Node *p_node) {
+	_THREAD_SAFE_METHOD_
+
+	HashMap<ObjectID, PooledNode>::Iterator E = pooled_nodes.find(p_node->get_instance_id());
+	if (!E) {
+		return;
+	}
+	if (E->value.released) {
+		ScenePool *pool = scene_pools.getptr(E->value.scene);
+		if (pool) {
+			pool->free_nodes.erase(p_node);
+		}
+	}
+	pooled_nodes.remove(E);
+}
+
+void SceneTree::prewarm_scene_pool(const Ref<PackedScene> &p_scene, int p_count) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND(p_scene.is_null());
+	ERR_FAIL_COND(p_count < 0);
+
+	ScenePool *pool = _get_scene_pool(p_scene);
+	ERR_FAIL_NULL(pool);
+
+	while ((int)pool->free_nodes.size() < p_count) {
+		Node *instance = _instantiate_pooled(*pool);
+		ERR_FAIL_NULL(instance);
+		pooled_nodes[instance->get_instance_id()].released = true;
+		pool->free_nodes.push_back(instance);
+	}
+}
+
+Node *SceneTree::acquire_pooled_scene(const Ref<PackedScene> &p_scene) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND_V(p_scene.is_null(), nullptr);
+
+	ScenePool *pool = _get_scene_pool(p_scene);
+	ERR_FAIL_NULL_V(pool, nullptr);
+
+	if (pool->free_nodes.is_empty()) {
+		return _instantiate_pooled(*pool);
+	}
+
+	Node *node = pool->free_nodes[pool->free_nodes.size() - 1];
+	pool->free_nodes.resize(pool->free_nodes.size() - 1);
+	pooled_nodes[node->get_instance_id()].released = false;
+	return node;
+}
+
+void SceneTree::release_pooled_scene(Node *p_node) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_NULL(p_node);
+
+	PooledNode *pooled_node = pooled_nodes.getptr(p_node->get_instance_id());
+	ERR_FAIL_NULL_MSG(pooled_node, "The node was not acquired from a scene pool.");
+	ERR_FAIL_COND_MSG(pooled_node->released, "The node was already released to its scene pool.");
+	ScenePool *pool = scene_pools.getptr(pooled_node->scene);
+	ERR_FAIL_NULL(pool);
+
+	if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	if (!_reset_pooled(*pool, p_node)) {
+		WARN_VERBOSE(vformat("The structure of a pooled instance of \"%s\" has changed, so it can't be reused.", pool->scene->get_path()));
+		// It may be released from its own callbacks, so it's only freed at the end of the frame.
+		p_node->data.pooled = false;
+		pooled_nodes.erase(p_node->get_instance_id());
+		queue_delete(p_node);
+		return;
+	}
+
+	pooled_node->released = true;
+	pool->free_nodes.push_back(p_node);
+}
+
+int SceneTree::get_scene_pool_size(const Ref<PackedScene> &p_scene) const {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND_V(p_scene.is_null(), 0);
+
+	const ScenePool *pool = scene_pools.getptr(p_scene->get_instance_id());
+	return pool ? pool->free_nodes.size() : 0;
+}
+
+void SceneTree::clear_scene_pool(const Ref<PackedScene> &p_scene) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND(p_scene.is_null());
+
+	ScenePool *pool = scene_pools.getptr(p_scene->get_instance_id());
+	if (pool) {
+		_clear_scene_pool(*pool);
+		scene_pools.erase(p_scene->get_instance_id());
+	}
+}
+
 Ref<Tween> SceneTree::create_tween() {
 	_THREAD_SAFE_METHOD_
 	Ref<Tween> tween = memnew(Tween(true));
@@ -1708,6 +2106,9 @@ void SceneTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_edited_scene_root", "scene"), &SceneTree::set_edited_scene_root);
 	ClassDB::bind_method(D_METHOD("get_edited_scene_root"), &SceneTree::get_edited_scene_root);
 
+	ClassDB::bind_method(D_METHOD("set_default_process_group_budget_usec", "usec"), &SceneTree::set_default_process_group_budget_usec);
+	ClassDB::bind_method(D_METHOD("get_default_process_group_budget_usec"), &SceneTree::get_default_process_group_budget_usec);
+
 	ClassDB::bind_method(D_METHOD("set_pause", "enable"), &SceneTree::set_pause);
 	ClassDB::bind_method(D_METHOD("is_paused"), &SceneTree::is_paused);
 
@@ -1758,6 +2159,12 @@ void SceneTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("reload_current_scene"), &SceneTree::reload_current_scene);
 	ClassDB::bind_method(D_METHOD("unload_current_scene"), &SceneTree::unload_current_scene);
 
+	ClassDB::bind_method(D_METHOD("prewarm_scene_pool", "packed_scene", "count"), &SceneTree::prewarm_scene_pool);
+	ClassDB::bind_method(D_METHOD("acquire_pooled_scene", "packed_scene"), &SceneTree::acquire_pooled_scene);
+	ClassDB::bind_method(D_METHOD("release_pooled_scene", "node"), &SceneTree::release_pooled_scene);
+	ClassDB::bind_method(D_METHOD("get_scene_pool_size", "packed_scene"), &SceneTree::get_scene_pool_size);
+	ClassDB::bind_method(D_METHOD("clear_scene_pool", "packed_scene"), &SceneTree::clear_scene_pool);
+
 	ClassDB::bind_method(D_METHOD("set_multiplayer", "multiplayer", "root_path"), &SceneTree::set_multiplayer, DEFVAL(NodePath()));
 	ClassDB::bind_method(D_METHOD("get_multiplayer", "for_path"), &SceneTree::get_multiplayer, DEFVAL(NodePath()));
 	ClassDB::bind_method(D_METHOD("set_multiplayer_poll_enabled", "enabled"), &SceneTree::set_multiplayer_poll_enabled);
@@ -1769,6 +2176,7 @@ void SceneTree::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_paths_hint"), "set_debug_paths_hint", "is_debugging_paths_hint");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_navigation_hint"), "set_debug_navigation_hint", "is_debugging_navigation_hint");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "paused"), "set_pause", "is_paused");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_process_group_budget_usec", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:µs"), "set_default_process_group_budget_usec", "get_default_process_group_budget_usec");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "edited_scene_root", PROPERTY_HINT_RESOURCE_TYPE, "Node", PROPERTY_USAGE_NONE), "set_edited_scene_root", "get_edited_scene_root");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "current_scene", PROPERTY_HINT_RESOURCE_TYPE, "Node", PROPERTY_USAGE_NONE), "set_current_scene", "get_current_scene");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "root", PROPERTY_HINT_RESOURCE_TYPE, "Node", PROPERTY_USAGE_NONE), "", "get_root");
@@ -1789,6 +2197,7 @@ void SceneTree::_bind_methods() {
 	BIND_ENUM_CONSTANT(GROUP_CALL_REVERSE);
 	BIND_ENUM_CONSTANT(GROUP_CALL_DEFERRED);
 	BIND_ENUM_CONSTANT(GROUP_CALL_UNIQUE);
+	BIND_ENUM_CONSTANT(GROUP_CALL_THREADED);
 }
 
 SceneTree *SceneTree::singleton = nullptr;
@@ -101,6 +101,7 @@ private:
 		bool removed = false;
 		Node *owner = nullptr;
 		uint64_t last_pass = 0;
+		ObjectID budget_next_node; // Where processing resumes when the budget ran out last frame.
 	};
 
 	struct ProcessGroupSort {
@@ -115,6 +116,11 @@ private:
 	uint64_t process_last_pass = 1;
 
 	ProcessGroup default_process_group;
+	int default_process_group_budget_usec = 0; // Groups with an owner node use its own setting.
+
+	// Nodes postponed and groups out of budget during the current or last process frame.
+	SafeNumeric<uint32_t> process_budget_deferred_nodes;
+	SafeNumeric<uint32_t> process_budget_exhausted_groups;
 
 	bool node_threading_disabled = false;
 
@@ -179,6 +185,36 @@ private:
 
 	List<ObjectID> delete_queue;
 
+	// Instances of packed scenes kept detached from the tree to be reused, instead of
+	// being freed and instantiated again (see acquire_pooled_scene()).
+	struct ScenePool {
+		struct Property {
+			uint32_t node = 0; // Index in node_paths.
+			StringName name;
+			Variant value;
+		};
+
+		Ref<PackedScene> scene;
+		LocalVector<Node *> free_nodes;
+		LocalVector<NodePath> node_paths; // Every node of a fresh instance, to detect changes to its structure.
+		LocalVector<Property> initial_state; // Stored properties of a fresh instance, restored when released.
+	};
+
+	struct PooledNode {
+		ObjectID scene;
+		bool released = false;
+	};
+
+	HashMap<ObjectID, ScenePool> scene_pools;
+	HashMap<ObjectID, PooledNode> pooled_nodes;
+
+	ScenePool *_get_scene_pool(const Ref<PackedScene> &p_scene);
+	Node *_instantiate_pooled(ScenePool &p_pool);
+	void _record_pool_initial_state(ScenePool &p_pool, Node *p_root, Node *p_node);
+	bool _reset_pooled(const ScenePool &p_pool, Node *p_node);
+	void _clear_scene_pool(ScenePool &p_pool);
+	void _forget_pooled_node(Node *p_node);
+
 	HashMap<UGCall, Vector<Variant>, UGCall> unique_group_calls;
 	bool ugc_locked = false;
 	void _flush_ugc();
@@ -238,12 +274,37 @@ private:
 	void _call_group(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
 	void _flush_delete_queue();
+
+	struct ThreadedGroupCall {
+		struct Batch {
+			Node *owner = nullptr;
+			LocalVector<Node *> nodes;
+		};
+
+		LocalVector<Batch> batches; // One per sub-thread process group.
+		StringName function;
+		const Variant **args = nullptr;
+		int argcount = 0;
+		int notification = 0;
+		bool is_notification = false;
+		bool reverse = false;
+	};
+
+	bool _can_call_group_threaded(uint32_t p_call_flags) const;
+	void _call_group_threaded(ThreadedGroupCall &p_call, Node **p_nodes, int p_node_count);
+	void _call_group_threaded_batch(uint32_t p_index, ThreadedGroupCall *p_call);
+	void _call_group_node(Node *p_node, const ThreadedGroupCall &p_call);
 	// Optimization.
 	friend class CanvasItem;
 	friend class Node3D;
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	// Reused between flushes to sort the pending nodes by depth.
+	LocalVector<Node *> xform_change_sorted;
+	LocalVector<uint32_t> xform_change_depth_offsets;
+
+	void _update_pending_global_transforms();
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -285,6 +346,7 @@ public:
 		GROUP_CALL_REVERSE = 1,
 		GROUP_CALL_DEFERRED = 2,
 		GROUP_CALL_UNIQUE = 4,
+		GROUP_CALL_THREADED = 8,
 	};
 
 	_FORCE_INLINE_ Window *get_root() const { return root; }
@@ -388,6 +450,10 @@ public:
 	int64_t get_frame() const;
 
 	int get_node_count() const;
+	void set_default_process_group_budget_usec(int p_usec);
+	int get_default_process_group_budget_usec() const;
+	uint32_t get_process_budget_deferred_node_count() const { return process_budget_deferred_nodes.get(); }
+	uint32_t get_process_budget_exhausted_group_count() const { return process_budget_exhausted_groups.get(); }
 
 	void queue_delete(Object *p_object);
 
@@ -409,6 +475,12 @@ public:
 	Error reload_current_scene();
 	void unload_current_scene();
 
+	void prewarm_scene_pool(const Ref<PackedScene> &p_scene, int p_count);
+	Node *acquire_pooled_scene(const Ref<PackedScene> &p_scene);
+	void release_pooled_scene(Node *p_node);
+	int get_scene_pool_size(const Ref<PackedScene> &p_scene) const;
+	void clear_scene_pool(const Ref<PackedScene> &p_scene);
+
 	Ref<SceneTreeTimer> create_timer(double p_delay_sec, bool p_process_always = true, bool p_process_in_physics = false, bool p_ignore_time_scale = false);
 	Ref<Tween> create_tween();
 	TypedArray<Tween> get_processed_tweens();
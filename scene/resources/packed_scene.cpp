@@ -124,6 +124,109 @@ Ref<Resource> SceneState::get_remap_resource(const Ref<Resource> &p_resource, Ha
 	return remap_resource;
 }
 
+SceneState::InstantiationPlan *SceneState::_reference_instantiation_plan() const {
+	MutexLock lock(instantiation_plan_mutex);
+	if (instantiation_plan) {
+		instantiation_plan->refcount.ref();
+		return instantiation_plan;
+	}
+
+	InstantiationPlan *plan = memnew(InstantiationPlan);
+	plan->refcount.init(2); // Referenced by the state and the caller.
+	plan->nodes.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		PlannedNode &planned = plan->nodes[i];
+		planned.properties.resize(n.properties.size());
+
+		// Only nodes created from their class, whose properties are set right after creation.
+		if (n.type == TYPE_INSTANTIATED || n.instance >= 0 || (i == 0 && base_scene_idx >= 0)) {
+			continue;
+		}
+		if (n.type < 0 || n.type >= names.size()) {
+			continue;
+		}
+		const StringName &type = names[n.type];
+		ClassDB::APIType api = ClassDB::get_api_type(type);
+		if (api != ClassDB::API_CORE && api != ClassDB::API_EDITOR) {
+			continue; // Extension classes may handle properties themselves.
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			const NodeData::Property &prop = n.properties[j];
+			if ((prop.name & FLAG_PATH_PROPERTY_IS_NODE) || prop.name < 0 || prop.name >= names.size() || prop.value < 0 || prop.value >= variants.size()) {
+				continue;
+			}
+			const StringName &name = names[prop.name];
+			const Variant &value = variants[prop.value];
+			if (name == CoreStringName(script)) {
+				continue;
+			}
+			// These may need to be made local to the scene or retyped to match the property.
+			if (value.get_type() == Variant::OBJECT || value.get_type() == Variant::ARRAY || value.get_type() == Variant::DICTIONARY) {
+				continue;
+			}
+
+			int index = -1;
+			MethodBind *setter = ClassDB::get_property_setter_method(type, name, &index);
+			if (!setter || setter->is_vararg()) {
+				continue;
+			}
+
+			PlannedProperty &planned_property = planned.properties[j];
+			planned_property.setter = setter;
+			planned_property.index = index;
+
+			int argc = index >= 0 ? 2 : 1;
+			Variant::Type arg_type = setter->get_argument_type(argc - 1);
+			planned_property.validated = !setter->has_return() && setter->get_argument_count() == argc &&
+					(arg_type == Variant::NIL || arg_type == value.get_type()) &&
+					(index < 0 || setter->get_argument_type(0) == Variant::INT);
+		}
+	}
+
+	instantiation_plan = plan;
+	instantiation_plan_built.set();
+	return plan;
+}
+
+void SceneState::_unreference_instantiation_plan(InstantiationPlan *p_plan) {
+	if (p_plan && p_plan->refcount.unref()) {
+		memdelete(p_plan);
+	}
+}
+
+void SceneState::_clear_instantiation_plan() {
+	if (!instantiation_plan_built.is_set()) {
+		return;
+	}
+
+	InstantiationPlan *plan = nullptr;
+	{
+		MutexLock lock(instantiation_plan_mutex);
+		plan = instantiation_plan;
+		instantiation_plan = nullptr;
+		instantiation_plan_built.clear();
+	}
+	// Instantiations still using the plan keep it alive until they finish.
+	_unreference_instantiation_plan(plan);
+}
+
+// Returns whether the property was set, like the r_valid argument of Object::set().
+bool SceneState::_set_planned_property(Node *p_node, const PlannedProperty &p_property, const Variant &p_value) {
+	Variant index = p_property.index;
+	const Variant *args[2] = { &index, &p_value };
+	const Variant **argptrs = p_property.index >= 0 ? args : &args[1];
+	if (p_property.validated) {
+		p_property.setter->validated_call(p_node, argptrs, nullptr);
+		return true;
+	}
+
+	Callable::CallError ce;
+	p_property.setter->call(p_node, argptrs, p_property.index >= 0 ? 2 : 1, ce);
+	return ce.error == Callable::CallError::CALL_OK;
+}
+
 Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	// Nodes where instantiation failed (because something is missing.)
 	List<Node *> stray_instances;
@@ -165,8 +268,20 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	LocalVector<DeferredNodePathProperties> deferred_node_paths;
 
+	// At runtime, properties of nodes created from their class are set through setters resolved ahead of time.
+	struct PlanReference {
+		InstantiationPlan *plan = nullptr;
+		~PlanReference() { _unreference_instantiation_plan(plan); }
+	} plan_reference;
+	const PlannedNode *plan = nullptr;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint()) {
+		plan_reference.plan = _reference_instantiation_plan();
+		plan = plan_reference.plan->nodes.ptr();
+	}
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
+		const PlannedNode *planned = nullptr;
 
 		Node *parent = nullptr;
 		String old_parent_path;
@@ -261,6 +376,10 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 			node = Object::cast_to<Node>(obj);
 
+			if (node && plan && !node->_get_extension()) {
+				planned = &plan[i];
+			}
+
 			if (!node) {
 				if (obj) {
 					memdelete(obj);
@@ -313,6 +432,12 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 					ERR_FAIL_INDEX_V(nprops[j].value, prop_count, nullptr);
 
+					// The script may have been set by a previous property, and take over the property.
+					if (planned && planned->properties[j].setter && !node->get_script_instance()) {
+						valid = _set_planned_property(node, planned->properties[j], props[nprops[j].value]);
+						continue;
+					}
+
 					if (nprops[j].name & FLAG_PATH_PROPERTY_IS_NODE) {
 						if (!Engine::get_singleton()->is_editor_hint() && node->get_scene_instance_load_placeholder()) {
 							// We cannot know if the referenced nodes exist yet, so instead of deferring, we write the NodePaths directly.
@@ -1311,6 +1436,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instantiation_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1509,6 +1635,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_clear_instantiation_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1970,11 +2098,13 @@ Ref<Resource> SceneState::get_sub_resource(const String &p_path) {
 //add
 
 int SceneState::add_name(const StringName &p_name) {
+	_clear_instantiation_plan();
 	names.push_back(p_name);
 	return names.size() - 1;
 }
 
 int SceneState::add_value(const Variant &p_value) {
+	_clear_instantiation_plan();
 	variants.push_back(p_value);
 	return variants.size() - 1;
 }
@@ -1993,6 +2123,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_clear_instantiation_plan();
 	nodes.push_back(nd);
 
 	return nodes.size() - 1;
@@ -2009,6 +2140,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 		prop.name |= FLAG_PATH_PROPERTY_IS_NODE;
 	}
 	prop.value = p_value;
+	_clear_instantiation_plan();
 	nodes.write[p_node].properties.push_back(prop);
 }
 
@@ -2020,6 +2152,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instantiation_plan();
 	base_scene_idx = p_idx;
 }
 
@@ -2128,6 +2261,10 @@ void SceneState::_bind_methods() {
 SceneState::SceneState() {
 }
 
+SceneState::~SceneState() {
+	_clear_instantiation_plan();
+}
+
 ////////////////
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
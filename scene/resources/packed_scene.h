@@ -89,6 +89,33 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Setters resolved ahead of time for the properties of nodes created from their class,
+	// so instantiating the scene at runtime doesn't look them up by name for every node.
+	struct PlannedProperty {
+		MethodBind *setter = nullptr; // Null if the property must be set through Object::set().
+		int index = -1;
+		bool validated = false; // The stored value has the exact type of the setter's argument.
+	};
+
+	struct PlannedNode {
+		LocalVector<PlannedProperty> properties; // Same order as NodeData::properties.
+	};
+
+	// Referenced by every instantiation using it, so the state can drop it while it's in use.
+	struct InstantiationPlan {
+		SafeRefCount refcount;
+		LocalVector<PlannedNode> nodes;
+	};
+
+	mutable InstantiationPlan *instantiation_plan = nullptr;
+	mutable SafeFlag instantiation_plan_built; // Lets modifications skip the lock when there's no plan.
+	mutable BinaryMutex instantiation_plan_mutex;
+
+	InstantiationPlan *_reference_instantiation_plan() const;
+	static void _unreference_instantiation_plan(InstantiationPlan *p_plan);
+	void _clear_instantiation_plan();
+	static bool _set_planned_property(Node *p_node, const PlannedProperty &p_property, const Variant &p_value);
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -225,6 +252,7 @@ public:
 #endif
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
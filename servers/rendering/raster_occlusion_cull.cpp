@@ -0,0 +1,482 @@
+/**************************************************************************/
+/*  raster_occlusion_cull.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "raster_occlusion_cull.h"
+
+#include "core/object/worker_thread_pool.h"
+
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define RASTER_OCCLUSION_SSE2
+#include <emmintrin.h>
+#endif
+
+RasterOcclusionCull *RasterOcclusionCull::raster_singleton = nullptr;
+
+void RasterOcclusionCull::RasterHZBuffer::resize(const Size2i &p_size) {
+	HZBuffer::resize(p_size);
+
+	if (sizes.is_empty()) {
+		band_triangles.clear();
+		return;
+	}
+	band_triangles.resize((sizes[0].y + BAND_HEIGHT - 1) / BAND_HEIGHT);
+}
+
+void RasterOcclusionCull::RasterHZBuffer::begin(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	ERR_FAIL_COND(is_empty());
+
+	cam_inv_transform = p_cam_transform.affine_inverse();
+	cam_projection = p_cam_projection;
+	cam_position = p_cam_transform.origin;
+	cam_orthogonal = p_cam_orthogonal;
+	cam_planes = p_cam_projection.get_projection_planes(p_cam_transform);
+	z_near = p_cam_projection.get_z_near();
+
+	// Same depth as a ray hitting nothing in the ray-based implementation.
+	float z_far = p_cam_projection.get_z_far();
+	debug_tex_range = z_far;
+	float *depth = mips[0];
+	for (int i = 0; i < sizes[0].x * sizes[0].y; i++) {
+		depth[i] = z_far * 1.05f;
+	}
+
+	triangles.clear();
+	for (LocalVector<uint32_t> &band : band_triangles) {
+		band.clear();
+	}
+}
+
+bool RasterOcclusionCull::RasterHZBuffer::is_aabb_visible(const AABB &p_aabb) const {
+	for (const Plane &plane : cam_planes) {
+		if (plane.distance_to(p_aabb.get_support(-plane.normal)) > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void RasterOcclusionCull::RasterHZBuffer::add_triangles(const Vector3 *p_vertices, uint32_t p_vertex_count, const int32_t *p_indices, uint32_t p_index_count) {
+	ERR_FAIL_COND(is_empty());
+
+	view_vertices.resize(p_vertex_count);
+	for (uint32_t i = 0; i < p_vertex_count; i++) {
+		view_vertices[i] = cam_inv_transform.xform(p_vertices[i]);
+	}
+
+	for (uint32_t i = 0; i + 2 < p_index_count; i += 3) {
+		if ((uint32_t)p_indices[i] >= p_vertex_count || (uint32_t)p_indices[i + 1] >= p_vertex_count || (uint32_t)p_indices[i + 2] >= p_vertex_count) {
+			continue;
+		}
+
+		const Vector3 *triangle[3] = { &view_vertices[p_indices[i]], &view_vertices[p_indices[i + 1]], &view_vertices[p_indices[i + 2]] };
+
+		// Clip against the near plane, which can turn the triangle into a quad.
+		Vector3 clipped[4];
+		int clipped_count = 0;
+		for (int j = 0; j < 3; j++) {
+			const Vector3 &a = *triangle[j];
+			const Vector3 &b = *triangle[(j + 1) % 3];
+			bool a_inside = a.z <= -z_near;
+			bool b_inside = b.z <= -z_near;
+			if (a_inside) {
+				clipped[clipped_count++] = a;
+			}
+			if (a_inside != b_inside) {
+				clipped[clipped_count++] = a.lerp(b, (-z_near - a.z) / (b.z - a.z));
+			}
+		}
+
+		if (clipped_count >= 3) {
+			_add_triangle(clipped[0], clipped[1], clipped[2]);
+		}
+		if (clipped_count == 4) {
+			_add_triangle(clipped[0], clipped[2], clipped[3]);
+		}
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::_add_triangle(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c) {
+	const Size2i &size = sizes[0];
+
+	Vector3 view[3] = { p_a, p_b, p_c };
+	float x[3];
+	float y[3];
+	float inv_w[3];
+	for (int i = 0; i < 3; i++) {
+		Plane projected = cam_projection.xform4(Plane(view[i], 1.0));
+		inv_w[i] = 1.0f / projected.d;
+		x[i] = (projected.normal.x * inv_w[i] * 0.5f + 0.5f) * size.x;
+		y[i] = (projected.normal.y * inv_w[i] * 0.5f + 0.5f) * size.y;
+	}
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (Math::is_zero_approx(area)) {
+		return;
+	}
+
+	Triangle triangle;
+
+	// Pixels are sampled at their centers. Clamp before converting, vertices close to the near plane can project very far.
+	triangle.min_x = (int)Math::ceil(CLAMP(MIN(x[0], MIN(x[1], x[2])), 0.0f, (float)size.x) - 0.5f);
+	triangle.max_x = (int)Math::floor(CLAMP(MAX(x[0], MAX(x[1], x[2])), 0.0f, (float)size.x) - 0.5f);
+	triangle.min_y = (int)Math::ceil(CLAMP(MIN(y[0], MIN(y[1], y[2])), 0.0f, (float)size.y) - 0.5f);
+	triangle.max_y = (int)Math::floor(CLAMP(MAX(y[0], MAX(y[1], y[2])), 0.0f, (float)size.y) - 0.5f);
+	if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y) {
+		return;
+	}
+
+	// Edge functions, normalized so they give the barycentric weight of the opposite vertex.
+	for (int i = 0; i < 3; i++) {
+		int j = (i + 1) % 3;
+		int k = (i + 2) % 3;
+		triangle.edges[i][0] = -(y[k] - y[j]) / area;
+		triangle.edges[i][1] = (x[k] - x[j]) / area;
+		triangle.edges[i][2] = ((y[k] - y[j]) * x[j] - (x[k] - x[j]) * y[j]) / area;
+	}
+
+	// Attributes divided by w interpolate linearly in screen space.
+	for (int i = 0; i < 3; i++) {
+		triangle.inv_w[i] = 0.0f;
+		triangle.view_x[i] = 0.0f;
+		triangle.view_y[i] = 0.0f;
+		triangle.view_z[i] = 0.0f;
+		for (int j = 0; j < 3; j++) {
+			triangle.inv_w[i] += inv_w[j] * triangle.edges[j][i];
+			triangle.view_x[i] += view[j].x * inv_w[j] * triangle.edges[j][i];
+			triangle.view_y[i] += view[j].y * inv_w[j] * triangle.edges[j][i];
+			triangle.view_z[i] += view[j].z * inv_w[j] * triangle.edges[j][i];
+		}
+	}
+
+	uint32_t index = triangles.size();
+	triangles.push_back(triangle);
+	for (int band = triangle.min_y / BAND_HEIGHT; band <= triangle.max_y / BAND_HEIGHT; band++) {
+		band_triangles[band].push_back(index);
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::rasterize() {
+	ERR_FAIL_COND(is_empty());
+
+	if (!triangles.is_empty()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RasterHZBuffer::_rasterize_band, &triangles, band_triangles.size(), -1, true, SNAME("RasterOcclusionCullRasterize"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+
+	update_mips();
+}
+
+void RasterOcclusionCull::RasterHZBuffer::_rasterize_band(uint32_t p_band, const LocalVector<Triangle> *p_triangles) {
+	// Each band owns its rows of the depth buffer, so no synchronization is needed.
+	int from_y = p_band * BAND_HEIGHT;
+	int to_y = MIN(from_y + BAND_HEIGHT, sizes[0].y);
+	for (uint32_t index : band_triangles[p_band]) {
+		_rasterize_triangle((*p_triangles)[index], from_y, to_y);
+	}
+}
+
+void RasterOcclusionCull::RasterHZBuffer::_rasterize_triangle(const Triangle &p_triangle, int p_from_y, int p_to_y) {
+	const int width = sizes[0].x;
+	const Triangle &t = p_triangle;
+
+	for (int y = MAX(t.min_y, p_from_y); y <= MIN(t.max_y, p_to_y - 1); y++) {
+		float *row = mips[0] + y * width;
+		const float py = y + 0.5f;
+
+		// Row constants of all the planes.
+		const float e0 = t.edges[0][1] * py + t.edges[0][2];
+		const float e1 = t.edges[1][1] * py + t.edges[1][2];
+		const float e2 = t.edges[2][1] * py + t.edges[2][2];
+		const float iw = t.inv_w[1] * py + t.inv_w[2];
+		const float vx = t.view_x[1] * py + t.view_x[2];
+		const float vy = t.view_y[1] * py + t.view_y[2];
+		const float vz = t.view_z[1] * py + t.view_z[2];
+
+		int x = t.min_x;
+
+#ifdef RASTER_OCCLUSION_SSE2
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 lane_centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		for (; x + 3 <= t.max_x; x += 4) {
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)x), lane_centers);
+			__m128 w0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edges[0][0]), px), _mm_set1_ps(e0));
+			__m128 w1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edges[1][0]), px), _mm_set1_ps(e1));
+			__m128 w2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edges[2][0]), px), _mm_set1_ps(e2));
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero));
+			if (_mm_movemask_ps(inside) == 0) {
+				continue;
+			}
+
+			__m128 pixel_iw = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.inv_w[0]), px), _mm_set1_ps(iw));
+			__m128 pixel_vz = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.view_z[0]), px), _mm_set1_ps(vz));
+			__m128 depth;
+			if (cam_orthogonal) {
+				depth = _mm_div_ps(_mm_sub_ps(zero, pixel_vz), pixel_iw);
+			} else {
+				__m128 pixel_vx = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.view_x[0]), px), _mm_set1_ps(vx));
+				__m128 pixel_vy = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.view_y[0]), px), _mm_set1_ps(vy));
+				__m128 length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pixel_vx, pixel_vx), _mm_mul_ps(pixel_vy, pixel_vy)), _mm_mul_ps(pixel_vz, pixel_vz));
+				depth = _mm_div_ps(_mm_sqrt_ps(length_squared), pixel_iw);
+			}
+
+			__m128 previous = _mm_loadu_ps(row + x);
+			depth = _mm_min_ps(depth, previous);
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, depth), _mm_andnot_ps(inside, previous)));
+		}
+#endif
+
+		for (; x <= t.max_x; x++) {
+			const float px = x + 0.5f;
+			if (t.edges[0][0] * px + e0 < 0.0f || t.edges[1][0] * px + e1 < 0.0f || t.edges[2][0] * px + e2 < 0.0f) {
+				continue;
+			}
+
+			const float pixel_iw = t.inv_w[0] * px + iw;
+			const float pixel_vz = t.view_z[0] * px + vz;
+			float depth;
+			if (cam_orthogonal) {
+				depth = -pixel_vz / pixel_iw;
+			} else {
+				const float pixel_vx = t.view_x[0] * px + vx;
+				const float pixel_vy = t.view_y[0] * px + vy;
+				depth = Math::sqrt(pixel_vx * pixel_vx + pixel_vy * pixel_vy + pixel_vz * pixel_vz) / pixel_iw;
+			}
+			row[x] = MIN(row[x], depth);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::Scenario::update() {
+	for (KeyValue<RID, OccluderInstance> &E : instances) {
+		OccluderInstance &occ_inst = E.value;
+		if (!occ_inst.dirty) {
+			continue;
+		}
+		occ_inst.dirty = false;
+
+		const Occluder *occ = raster_singleton->occluder_owner.get_or_null(occ_inst.occluder);
+		if (!occ || occ->vertices.is_empty()) {
+			occ_inst.xformed_vertices.clear();
+			occ_inst.aabb = AABB();
+			continue;
+		}
+
+		const Vector3 *read = occ->vertices.ptr();
+		occ_inst.xformed_vertices.resize(occ->vertices.size());
+		for (int i = 0; i < occ->vertices.size(); i++) {
+			occ_inst.xformed_vertices[i] = occ_inst.xform.xform(read[i]);
+			if (i == 0) {
+				occ_inst.aabb = AABB(occ_inst.xformed_vertices[i], Vector3());
+			} else {
+				occ_inst.aabb.expand_to(occ_inst.xformed_vertices[i]);
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////
+
+bool RasterOcclusionCull::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RasterOcclusionCull::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RasterOcclusionCull::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RasterOcclusionCull::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	for (const InstanceID &E : occluder->users) {
+		Scenario *scenario = scenarios.getptr(E.scenario);
+		ERR_CONTINUE(!scenario);
+		OccluderInstance *instance = scenario->instances.getptr(E.instance);
+		ERR_CONTINUE(!instance);
+		instance->dirty = true;
+	}
+}
+
+void RasterOcclusionCull::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_scenario(RID p_scenario) {
+	ERR_FAIL_COND(scenarios.has(p_scenario));
+	scenarios[p_scenario] = Scenario();
+}
+
+void RasterOcclusionCull::remove_scenario(RID p_scenario) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+	for (const KeyValue<RID, OccluderInstance> &E : scenario->instances) {
+		Occluder *occluder = occluder_owner.get_or_null(E.value.occluder);
+		if (occluder) {
+			occluder->users.erase(InstanceID(p_scenario, E.key));
+		}
+	}
+	scenarios.erase(p_scenario);
+}
+
+void RasterOcclusionCull::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (!instance) {
+		instance = &scenario->instances.insert(p_instance, OccluderInstance())->value;
+	}
+
+	if (instance->occluder != p_occluder) {
+		Occluder *old_occluder = occluder_owner.get_or_null(instance->occluder);
+		if (old_occluder) {
+			old_occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		instance->occluder = p_occluder;
+
+		if (p_occluder.is_valid()) {
+			Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+			ERR_FAIL_NULL(occluder);
+			occluder->users.insert(InstanceID(p_scenario, p_instance));
+		}
+		instance->dirty = true;
+	}
+
+	if (instance->xform != p_xform) {
+		instance->xform = p_xform;
+		instance->dirty = true;
+	}
+
+	instance->enabled = p_enabled;
+}
+
+void RasterOcclusionCull::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (!instance) {
+		return;
+	}
+
+	Occluder *occluder = occluder_owner.get_or_null(instance->occluder);
+	if (occluder) {
+		occluder->users.erase(InstanceID(p_scenario, p_instance));
+	}
+	scenario->instances.erase(p_instance);
+}
+
+////////////////////////////////////////////////////////
+
+void RasterOcclusionCull::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RasterOcclusionCull::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RasterOcclusionCull::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RasterOcclusionCull::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RasterOcclusionCull::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer || buffer->is_empty()) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (!scenario) {
+		return;
+	}
+
+	scenario->update();
+
+	buffer->begin(p_cam_transform, _jitter_projection(p_cam_projection, buffer->get_occlusion_buffer_size()), p_cam_orthogonal);
+
+	for (const KeyValue<RID, OccluderInstance> &E : scenario->instances) {
+		const OccluderInstance &occ_inst = E.value;
+		if (!occ_inst.enabled || occ_inst.xformed_vertices.is_empty() || !buffer->is_aabb_visible(occ_inst.aabb)) {
+			continue;
+		}
+		const Occluder *occ = occluder_owner.get_or_null(occ_inst.occluder);
+		if (!occ) {
+			continue;
+		}
+		buffer->add_triangles(occ_inst.xformed_vertices.ptr(), occ_inst.xformed_vertices.size(), occ->indices.ptr(), occ->indices.size());
+	}
+
+	buffer->rasterize();
+}
+
+RendererSceneOcclusionCull::HZBuffer *RasterOcclusionCull::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+RID RasterOcclusionCull::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
+
+////////////////////////////////////////////////////////
+
+RasterOcclusionCull::RasterOcclusionCull() {
+	raster_singleton = this;
+}
+
+RasterOcclusionCull::~RasterOcclusionCull() {
+	raster_singleton = nullptr;
+}
@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
 #include "core/math/transform_interpolator.h"
+#include "core/object/worker_thread_pool.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -50,10 +51,20 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
+	cull_root_items.resize(p_child_item_count);
 	for (int i = 0; i < p_child_item_count; i++) {
-		_cull_canvas_item(p_child_items[i].item, p_transform, p_clip_rect, Color(1, 1, 1, 1), 0, z_list, z_last_list, nullptr, nullptr, false, p_canvas_cull_mask, Point2(), 1, nullptr);
+		cull_root_items[i] = p_child_items[i].item;
 	}
 
+	CullItemList root_list;
+	root_list.items = cull_root_items.ptr();
+	root_list.item_count = p_child_item_count;
+	root_list.xform = p_transform;
+	root_list.clip_rect = p_clip_rect;
+	root_list.modulate = Color(1, 1, 1, 1);
+	root_list.canvas_cull_mask = p_canvas_cull_mask;
+	_cull_canvas_item_list(root_list, z_list, z_last_list);
+
 	RendererCanvasRender::Item *list = nullptr;
 	RendererCanvasRender::Item *list_end = nullptr;
 
@@ -79,6 +90,76 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 	}
 }
 
+void RendererCanvasCull::_cull_canvas_item_list(CullItemList &p_list, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list) {
+	uint32_t thread_count = WorkerThreadPool::get_singleton()->get_thread_count();
+	bool use_threads = !thread_cull_active && thread_count > 1 && p_list.item_count >= thread_cull_threshold;
+
+	if (use_threads && p_list.is_y_sorted) {
+		// Canvas groups and repeated items depend on the items drawn before them in the sorted order, which can be in another thread.
+		for (int i = 0; i < p_list.item_count; i++) {
+			const Item *item = p_list.items[i];
+			if (item->canvas_group || item->repeat_source || item->repeat_source_item) {
+				use_threads = false;
+				break;
+			}
+		}
+	}
+
+	if (!use_threads) {
+		_cull_canvas_item_range(p_list, 0, p_list.item_count, r_z_list, r_z_last_list);
+		return;
+	}
+
+	p_list.task_count = thread_count;
+	if (cull_thread_z_lists.size() < p_list.task_count) {
+		cull_thread_z_lists.resize(p_list.task_count);
+	}
+
+	thread_cull_active = true;
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererCanvasCull::_cull_canvas_item_list_threaded, &p_list, p_list.task_count, -1, true, SNAME("RenderCanvasCullItems"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	thread_cull_active = false;
+
+	// Append in task order, so the items end up in the same order as when culled on a single thread.
+	for (int i = 0; i < z_range; i++) {
+		for (uint32_t j = 0; j < p_list.task_count; j++) {
+			CullThreadZLists &thread_lists = cull_thread_z_lists[j];
+			if (!thread_lists.z_list[i]) {
+				continue;
+			}
+			if (r_z_last_list[i]) {
+				r_z_last_list[i]->next = thread_lists.z_list[i];
+			} else {
+				r_z_list[i] = thread_lists.z_list[i];
+			}
+			r_z_last_list[i] = thread_lists.z_last_list[i];
+		}
+	}
+}
+
+void RendererCanvasCull::_cull_canvas_item_list_threaded(uint32_t p_task, const CullItemList *p_list) {
+	CullThreadZLists &thread_lists = cull_thread_z_lists[p_task];
+	thread_lists.z_list.resize(z_range);
+	thread_lists.z_last_list.resize(z_range);
+	memset(thread_lists.z_list.ptr(), 0, z_range * sizeof(RendererCanvasRender::Item *));
+	memset(thread_lists.z_last_list.ptr(), 0, z_range * sizeof(RendererCanvasRender::Item *));
+
+	int from = (int64_t)p_task * p_list->item_count / p_list->task_count;
+	int to = (int64_t)(p_task + 1) * p_list->item_count / p_list->task_count;
+	_cull_canvas_item_range(*p_list, from, to, thread_lists.z_list.ptr(), thread_lists.z_last_list.ptr());
+}
+
+void RendererCanvasCull::_cull_canvas_item_range(const CullItemList &p_list, int p_from, int p_to, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list) {
+	for (int i = p_from; i < p_to; i++) {
+		Item *item = p_list.items[i];
+		if (p_list.is_y_sorted) {
+			_cull_canvas_item(item, p_list.xform * item->ysort_xform, p_list.clip_rect, p_list.modulate * item->ysort_modulate, item->ysort_parent_abs_z_index, r_z_list, r_z_last_list, p_list.canvas_clip, (Item *)item->material_owner, true, p_list.canvas_cull_mask, item->repeat_size, item->repeat_times, item->repeat_source_item);
+		} else if (item->behind ? !p_list.skip_behind : !p_list.skip_in_front) {
+			_cull_canvas_item(item, p_list.xform, p_list.clip_rect, p_list.modulate, p_list.z, r_z_list, r_z_last_list, p_list.canvas_clip, p_list.material_owner, false, p_list.canvas_cull_mask, p_list.repeat_size, p_list.repeat_times, p_list.repeat_source_item);
+		}
+	}
+}
+
 void RendererCanvasCull::_collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, RendererCanvasCull::Item *p_material_owner, const Color &p_modulate, RendererCanvasCull::Item **r_items, int &r_index, int p_z) {
 	int child_item_count = p_canvas_item->child_items.size();
 	RendererCanvasCull::Item **child_items = p_canvas_item->child_items.ptrw();
@@ -98,7 +179,9 @@ void RendererCanvasCull::_collect_ysort_children(RendererCanvasCull::Item *p_can
 				child_xform.columns[2] = (child_xform.columns[2] + Point2(0.5, 0.5)).floor();
 			}
 
-			r_items[r_index] = child_items[i];
+			if (r_items) {
+				r_items[r_index] = child_items[i];
+			}
 			child_items[i]->ysort_xform = p_canvas_item->ysort_xform * child_xform;
 			child_items[i]->material_owner = child_items[i]->use_parent_material ? p_material_owner : nullptr;
 			child_items[i]->ysort_modulate = p_modulate;
@@ -150,6 +233,117 @@ void RendererCanvasCull::_mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+bool RendererCanvasCull::_is_spatially_indexable(const Item *p_item) const {
+	// Only leaves whose bounds can't change behind the server's back are indexed.
+	if (!p_item->child_items.is_empty() || p_item->visibility_notifier || p_item->copy_back_buffer || p_item->vp_render || p_item->canvas_group || p_item->repeat_source) {
+		return false;
+	}
+	if (p_item->update_when_visible || p_item->skeleton.is_valid()) {
+		return false;
+	}
+	return !_interpolation_data.interpolation_enabled || !p_item->interpolated;
+}
+
+static _FORCE_INLINE_ AABB _canvas_item_spatial_index_aabb(RendererCanvasCull::Item *p_item) {
+	// Grown to account for transform snapping.
+	Rect2 rect = p_item->xform_curr.xform(p_item->get_rect()).grow(1.0);
+	return AABB(Vector3(rect.position.x, rect.position.y, 0), Vector3(rect.size.x, rect.size.y, 0));
+}
+
+void RendererCanvasCull::_update_spatial_index(Item *p_canvas_item) {
+	Item::SpatialIndex *index = p_canvas_item->spatial_index;
+
+	if (index->rebuild || index->interpolation_enabled != _interpolation_data.interpolation_enabled) {
+		index->bvh.clear();
+		index->unindexed.clear();
+		// May point to freed items, which is fine as they're not accessed.
+		index->dirty.clear();
+
+		for (Item *child : p_canvas_item->child_items) {
+			child->spatial_index_dirty = false;
+			if (_is_spatially_indexable(child)) {
+				child->spatial_index_id = index->bvh.insert(_canvas_item_spatial_index_aabb(child), child);
+			} else {
+				child->spatial_index_id = DynamicBVH::ID();
+				index->unindexed.push_back(child);
+			}
+		}
+
+		index->rebuild = false;
+		index->interpolation_enabled = _interpolation_data.interpolation_enabled;
+		return;
+	}
+
+	for (Item *child : index->dirty) {
+		index->bvh.update(child->spatial_index_id, _canvas_item_spatial_index_aabb(child));
+		child->spatial_index_dirty = false;
+	}
+	index->dirty.clear();
+}
+
+bool RendererCanvasCull::_cull_spatial_index(Item *p_canvas_item, const Transform2D &p_xform, const Rect2 &p_clip_rect) {
+	if (p_xform.determinant() == 0) {
+		return false;
+	}
+
+	_update_spatial_index(p_canvas_item);
+
+	Item::SpatialIndex *index = p_canvas_item->spatial_index;
+	index->cull_items.clear();
+
+	struct CullResult {
+		LocalVector<Item *> *items = nullptr;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			items->push_back((Item *)p_data);
+			return false;
+		}
+	};
+
+	// Children are visible when their global rect intersects the clip rect, see _attach_canvas_item_for_draw().
+	// Grown by a pixel to account for transform snapping.
+	Rect2 local_rect = p_xform.affine_inverse().xform(Rect2(Point2(), p_clip_rect.size).grow(1.0));
+	CullResult result;
+	result.items = &index->cull_items;
+	index->bvh.aabb_query(AABB(Vector3(local_rect.position.x, local_rect.position.y, 0), Vector3(local_rect.size.x, local_rect.size.y, 0)), result);
+
+	for (Item *child : index->unindexed) {
+		index->cull_items.push_back(child);
+	}
+	index->cull_items.sort_custom<ItemIndexSort>();
+	return true;
+}
+
+void RendererCanvasCull::_invalidate_spatial_index(Item *p_canvas_item) {
+	if (p_canvas_item->spatial_index) {
+		p_canvas_item->spatial_index->rebuild = true;
+	}
+}
+
+void RendererCanvasCull::_invalidate_parent_spatial_index(Item *p_canvas_item) {
+	if (canvas_item_owner.owns(p_canvas_item->parent)) {
+		_invalidate_spatial_index(canvas_item_owner.get_or_null(p_canvas_item->parent));
+	}
+}
+
+void RendererCanvasCull::_clear_spatial_index(Item *p_canvas_item) {
+	for (Item *child : p_canvas_item->child_items) {
+		child->spatial_index_id = DynamicBVH::ID();
+		child->spatial_index_dirty = false;
+	}
+	memdelete(p_canvas_item->spatial_index);
+	p_canvas_item->spatial_index = nullptr;
+}
+
+void RendererCanvasCull::_queue_spatial_index_update(Item *p_canvas_item) {
+	if (p_canvas_item->spatial_index_dirty) {
+		return;
+	}
+	// Only children of an item with a spatial index have a valid ID.
+	Item *parent = canvas_item_owner.get_or_null(p_canvas_item->parent);
+	parent->spatial_index->dirty.push_back(p_canvas_item);
+	p_canvas_item->spatial_index_dirty = true;
+}
+
 void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *ci, RendererCanvasCull::Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &p_modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from) {
 	if (ci->copy_back_buffer) {
 		ci->copy_back_buffer->screen_rect = p_transform.xform(ci->copy_back_buffer->rect).intersection(p_clip_rect);
@@ -222,7 +416,9 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 		//something to draw?
 
 		if (ci->update_when_visible) {
+			thread_cull_lock.lock();
 			RenderingServerDefault::redraw_request();
+			thread_cull_lock.unlock();
 		}
 
 		if (ci->commands != nullptr || ci->copy_back_buffer) {
@@ -250,7 +446,9 @@ void RendererCanvasCull::_attach_canvas_item_for_draw(RendererCanvasCull::Item *
 
 		if (ci->visibility_notifier) {
 			if (!ci->visibility_notifier->visible_element.in_list()) {
+				thread_cull_lock.lock();
 				visibility_notifier_list.add(&ci->visibility_notifier->visible_element);
+				thread_cull_lock.unlock();
 				ci->visibility_notifier->just_visible = true;
 			}
 
@@ -391,25 +589,45 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		if (!p_is_already_y_sorted) {
 			if (ci->ysort_children_count == -1) {
 				ci->ysort_children_count = _count_ysort_children(ci);
+				ci->ysort_children.clear();
 			}
 
 			child_item_count = ci->ysort_children_count + 1;
-			child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+
+			// Unless the subtree changed, keep the previous frame's order. It's still sorted if no item moved past another one.
+			bool keep_order = ci->ysort_children.size() == (uint32_t)child_item_count;
+			if (!keep_order) {
+				ci->ysort_children.resize(child_item_count);
+				ci->ysort_children[0] = ci;
+			}
+			child_items = ci->ysort_children.ptr();
 
 			ci->ysort_xform = Transform2D();
 			ci->ysort_modulate = Color(1, 1, 1, 1);
 			ci->ysort_index = 0;
 			ci->ysort_parent_abs_z_index = parent_z;
-			child_items[0] = ci;
 			int i = 1;
-			_collect_ysort_children(ci, p_material_owner, Color(1, 1, 1, 1), child_items, i, p_z);
-
-			SortArray<Item *, ItemYSort> sorter;
-			sorter.sort(child_items, child_item_count);
+			_collect_ysort_children(ci, p_material_owner, Color(1, 1, 1, 1), keep_order ? nullptr : child_items, i, p_z);
 
-			for (i = 0; i < child_item_count; i++) {
-				_cull_canvas_item(child_items[i], final_xform * child_items[i]->ysort_xform, p_clip_rect, modulate * child_items[i]->ysort_modulate, child_items[i]->ysort_parent_abs_z_index, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, (Item *)child_items[i]->material_owner, true, p_canvas_cull_mask, child_items[i]->repeat_size, child_items[i]->repeat_times, child_items[i]->repeat_source_item);
+			ItemYSort compare;
+			for (i = 1; keep_order && i < child_item_count; i++) {
+				keep_order = !compare(child_items[i], child_items[i - 1]);
 			}
+			if (!keep_order) {
+				SortArray<Item *, ItemYSort> sorter;
+				sorter.sort(child_items, child_item_count);
+			}
+
+			CullItemList list;
+			list.items = child_items;
+			list.item_count = child_item_count;
+			list.is_y_sorted = true;
+			list.xform = final_xform;
+			list.clip_rect = p_clip_rect;
+			list.modulate = modulate;
+			list.canvas_clip = (Item *)ci->final_clip_owner;
+			list.canvas_cull_mask = p_canvas_cull_mask;
+			_cull_canvas_item_list(list, r_z_list, r_z_last_list);
 		} else {
 			RendererCanvasRender::Item *canvas_group_from = nullptr;
 			bool use_canvas_group = ci->canvas_group != nullptr && (ci->canvas_group->fit_empty || ci->commands != nullptr);
@@ -428,18 +646,36 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			canvas_group_from = r_z_last_list[zidx];
 		}
 
-		for (int i = 0; i < child_item_count; i++) {
-			if (!child_items[i]->behind && !use_canvas_group) {
-				continue;
+		// Repeated children are drawn all around their own rect, which the index doesn't account for.
+		if (ci->spatial_index && child_item_count && !(repeat_source_item && (repeat_size.x || repeat_size.y))) {
+			if (_cull_spatial_index(ci, final_xform, p_clip_rect)) {
+				child_items = ci->spatial_index->cull_items.ptr();
+				child_item_count = ci->spatial_index->cull_items.size();
 			}
-			_cull_canvas_item(child_items[i], final_xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, false, p_canvas_cull_mask, repeat_size, repeat_times, repeat_source_item);
 		}
+
+		CullItemList list;
+		list.items = child_items;
+		list.item_count = child_item_count;
+		list.xform = final_xform;
+		list.clip_rect = p_clip_rect;
+		list.modulate = modulate;
+		list.z = p_z;
+		list.canvas_clip = (Item *)ci->final_clip_owner;
+		list.material_owner = p_material_owner;
+		list.canvas_cull_mask = p_canvas_cull_mask;
+		list.repeat_size = repeat_size;
+		list.repeat_times = repeat_times;
+		list.repeat_source_item = repeat_source_item;
+
+		// Canvas groups draw all their children before themselves.
+		list.skip_in_front = !use_canvas_group;
+		_cull_canvas_item_list(list, r_z_list, r_z_last_list);
 		_attach_canvas_item_for_draw(ci, p_canvas_clip, r_z_list, r_z_last_list, final_xform, p_clip_rect, global_rect, modulate, p_z, p_material_owner, use_canvas_group, canvas_group_from);
-		for (int i = 0; i < child_item_count; i++) {
-			if (child_items[i]->behind || use_canvas_group) {
-				continue;
-			}
-			_cull_canvas_item(child_items[i], final_xform, p_clip_rect, modulate, p_z, r_z_list, r_z_last_list, (Item *)ci->final_clip_owner, p_material_owner, false, p_canvas_cull_mask, repeat_size, repeat_times, repeat_source_item);
+		if (!use_canvas_group) {
+			list.skip_behind = true;
+			list.skip_in_front = false;
+			_cull_canvas_item_list(list, r_z_list, r_z_last_list);
 		}
 	}
 }
@@ -496,6 +732,9 @@ void RendererCanvasCull::canvas_set_item_repeat(RID p_item, const Point2 &p_repe
 	ERR_FAIL_NULL(canvas_item);
 
 	bool is_repeat_source = (p_repeat_size.x || p_repeat_size.y) && p_repeat_times;
+	if (canvas_item->repeat_source != is_repeat_source) {
+		_invalidate_parent_spatial_index(canvas_item);
+	}
 	canvas_item->repeat_source = is_repeat_source;
 	canvas_item->repeat_source_item = is_repeat_source ? canvas_item : nullptr;
 	canvas_item->repeat_size = p_repeat_size;
@@ -542,6 +781,11 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner);
 			}
+
+			_invalidate_spatial_index(item_owner);
+			_invalidate_parent_spatial_index(item_owner);
+			canvas_item->spatial_index_id = DynamicBVH::ID();
+			canvas_item->spatial_index_dirty = false;
 		}
 
 		canvas_item->parent = RID();
@@ -563,6 +807,9 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 				_mark_ysort_dirty(item_owner);
 			}
 
+			_invalidate_spatial_index(item_owner);
+			_invalidate_parent_spatial_index(item_owner);
+
 		} else {
 			ERR_FAIL_MSG("Invalid parent.");
 		}
@@ -601,6 +848,7 @@ void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D
 	}
 
 	canvas_item->xform_curr = p_transform;
+	_canvas_item_bounds_changed(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_visibility_layer(RID p_item, uint32_t p_visibility_layer) {
@@ -638,6 +886,7 @@ void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+	_canvas_item_bounds_changed(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_modulate(RID p_item, const Color &p_color) {
@@ -665,12 +914,16 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 
+	if (canvas_item->update_when_visible != p_update) {
+		_invalidate_parent_spatial_index(canvas_item);
+	}
 	canvas_item->update_when_visible = p_update;
 }
 
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_NULL(line);
@@ -900,6 +1153,7 @@ void RendererCanvasCull::canvas_item_add_polyline(RID p_item, const Vector<Point
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Color color = Color(1, 1, 1, 1);
 
@@ -1170,6 +1424,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 		}
 		Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 		ERR_FAIL_NULL(canvas_item);
+		_canvas_item_bounds_changed(canvas_item);
 
 		Vector<Color> colors;
 		if (p_colors.size() == 1) {
@@ -1212,6 +1467,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1376,6 +1632,7 @@ void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color, bool p_antialiased) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	static const int circle_segments = 64;
 
@@ -1467,6 +1724,7 @@ void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1498,6 +1756,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, int p_outline_size, float p_px_range, float p_scale) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1532,6 +1791,7 @@ void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, co
 void RendererCanvasCull::canvas_item_add_lcd_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1564,6 +1824,7 @@ void RendererCanvasCull::canvas_item_add_lcd_texture_rect_region(RID p_item, con
 void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, bool p_clip_uv) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_NULL(rect);
@@ -1605,6 +1866,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const R
 void RendererCanvasCull::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_NULL(style);
@@ -1629,6 +1891,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_NULL(prim);
@@ -1655,6 +1918,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -1676,6 +1940,7 @@ void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2
 void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -1697,6 +1962,7 @@ void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector
 void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_NULL(tr);
@@ -1706,6 +1972,7 @@ void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transfo
 void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform, const Color &p_modulate, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 	ERR_FAIL_COND(!p_mesh.is_valid());
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
@@ -1725,6 +1992,7 @@ void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_NULL(part);
@@ -1739,6 +2007,7 @@ void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles,
 void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_NULL(mm);
@@ -1750,6 +2019,7 @@ void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_NULL(ci);
@@ -1759,6 +2029,7 @@ void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 void RendererCanvasCull::canvas_item_add_animation_slice(RID p_item, double p_animation_length, double p_slice_begin, double p_slice_end, double p_offset) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	_canvas_item_bounds_changed(canvas_item);
 
 	Item::CommandAnimationSlice *as = canvas_item->alloc_command<Item::CommandAnimationSlice>();
 	ERR_FAIL_NULL(as);
@@ -1773,10 +2044,28 @@ void RendererCanvasCull::canvas_item_set_sort_children_by_y(RID p_item, bool p_e
 	ERR_FAIL_NULL(canvas_item);
 
 	canvas_item->sort_y = p_enable;
+	if (!p_enable) {
+		canvas_item->ysort_children.reset();
+	}
 
 	_mark_ysort_dirty(canvas_item);
 }
 
+void RendererCanvasCull::canvas_item_set_use_spatial_index(RID p_item, bool p_enable) {
+	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
+	ERR_FAIL_NULL(canvas_item);
+
+	if (p_enable == (canvas_item->spatial_index != nullptr)) {
+		return;
+	}
+
+	if (p_enable) {
+		canvas_item->spatial_index = memnew(Item::SpatialIndex);
+	} else {
+		_clear_spatial_index(canvas_item);
+	}
+}
+
 void RendererCanvasCull::canvas_item_set_z_index(RID p_item, int p_z) {
 	ERR_FAIL_COND(p_z < RS::CANVAS_ITEM_Z_MIN || p_z > RS::CANVAS_ITEM_Z_MAX);
 
@@ -1800,6 +2089,7 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 		return;
 	}
 	canvas_item->skeleton = p_skeleton;
+	_invalidate_parent_spatial_index(canvas_item);
 
 	Item::Command *c = canvas_item->commands;
 
@@ -1825,6 +2115,9 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	if (p_enable != (canvas_item->copy_back_buffer != nullptr)) {
+		_invalidate_parent_spatial_index(canvas_item);
+	}
 	if (p_enable && (canvas_item->copy_back_buffer == nullptr)) {
 		canvas_item->copy_back_buffer = memnew(RendererCanvasRender::Item::CopyBackBuffer);
 	}
@@ -1844,6 +2137,7 @@ void RendererCanvasCull::canvas_item_clear(RID p_item) {
 	ERR_FAIL_NULL(canvas_item);
 
 	canvas_item->clear();
+	_canvas_item_bounds_changed(canvas_item);
 #ifdef DEBUG_ENABLED
 	if (debug_redraw) {
 		canvas_item->debug_redraw_time = debug_redraw_time;
@@ -1888,6 +2182,10 @@ void RendererCanvasCull::canvas_item_set_visibility_notifier(RID p_item, bool p_
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 
+	if (p_enable != (canvas_item->visibility_notifier != nullptr)) {
+		_invalidate_parent_spatial_index(canvas_item);
+	}
+
 	if (p_enable) {
 		if (!canvas_item->visibility_notifier) {
 			canvas_item->visibility_notifier = visibility_notifier_allocator.alloc();
@@ -1916,6 +2214,9 @@ bool RendererCanvasCull::canvas_item_get_debug_redraw() const {
 void RendererCanvasCull::canvas_item_set_interpolated(RID p_item, bool p_interpolated) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
+	if (canvas_item->interpolated != p_interpolated) {
+		_invalidate_parent_spatial_index(canvas_item);
+	}
 	canvas_item->interpolated = p_interpolated;
 }
 
@@ -1931,12 +2232,17 @@ void RendererCanvasCull::canvas_item_transform_physics_interpolation(RID p_item,
 	ERR_FAIL_NULL(canvas_item);
 	canvas_item->xform_prev = p_transform * canvas_item->xform_prev;
 	canvas_item->xform_curr = p_transform * canvas_item->xform_curr;
+	_canvas_item_bounds_changed(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
 	Item *canvas_item = canvas_item_owner.get_or_null(p_item);
 	ERR_FAIL_NULL(canvas_item);
 
+	if ((p_mode == RS::CANVAS_GROUP_MODE_DISABLED) != (canvas_item->canvas_group == nullptr)) {
+		_invalidate_parent_spatial_index(canvas_item);
+	}
+
 	if (p_mode == RS::CANVAS_GROUP_MODE_DISABLED) {
 		if (canvas_item->canvas_group != nullptr) {
 			memdelete(canvas_item->canvas_group);
@@ -2457,9 +2763,16 @@ bool RendererCanvasCull::free(RID p_rid) {
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner);
 				}
+
+				_invalidate_spatial_index(item_owner);
+				_invalidate_parent_spatial_index(item_owner);
 			}
 		}
 
+		if (canvas_item->spatial_index) {
+			_clear_spatial_index(canvas_item);
+		}
+
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 			canvas_item->child_items[i]->parent = RID();
 		}
@@ -2641,6 +2954,13 @@ RendererCanvasCull::RendererCanvasCull() {
 
 	debug_redraw_time = GLOBAL_DEF("debug/canvas_items/debug_redraw_time", 1.0);
 	debug_redraw_color = GLOBAL_DEF("debug/canvas_items/debug_redraw_color", Color(1.0, 0.2, 0.2, 0.5));
+
+	thread_cull_threshold = GLOBAL_GET("rendering/2d/cull/threaded_cull_minimum_items");
+}
+
+void RendererCanvasCull::set_threaded_cull_minimum_items(int p_items) {
+	ERR_FAIL_COND(p_items < 1);
+	thread_cull_threshold = p_items;
 }
 
 RendererCanvasCull::~RendererCanvasCull() {
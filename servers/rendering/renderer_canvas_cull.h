@@ -31,6 +31,9 @@
 #ifndef RENDERER_CANVAS_CULL_H
 #define RENDERER_CANVAS_CULL_H
 
+#include "core/math/dynamic_bvh.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
@@ -53,6 +56,7 @@ public:
 		Transform2D ysort_xform; // Relative to y-sorted subtree's root item (identity for such root). Its `origin.y` is used for sorting.
 		int ysort_index;
 		int ysort_parent_abs_z_index; // Absolute Z index of parent. Only populated and used when y-sorting.
+		LocalVector<Item *> ysort_children; // Y-sorted subtree (including this item) in the order of the previous frame. Only used by y-sorted subtree's root item.
 		uint32_t visibility_layer = 0xffffffff;
 
 		Vector<Item *> child_items;
@@ -71,6 +75,20 @@ public:
 
 		VisibilityNotifierData *visibility_notifier = nullptr;
 
+		// Bounds of the child items in this item's local space, so that only those inside the clip rect are culled.
+		struct SpatialIndex {
+			DynamicBVH bvh;
+			LocalVector<Item *> unindexed; // Children whose bounds can't be cached, always culled.
+			LocalVector<Item *> dirty; // Indexed children whose bounds changed since the last update.
+			LocalVector<Item *> cull_items; // Children to cull this frame, in draw order.
+			bool rebuild = true;
+			bool interpolation_enabled = false;
+		};
+
+		SpatialIndex *spatial_index = nullptr;
+		DynamicBVH::ID spatial_index_id; // Leaf in the parent's spatial index, if any.
+		bool spatial_index_dirty = false;
+
 		Item() {
 			children_order_dirty = true;
 			E = nullptr;
@@ -189,10 +207,60 @@ private:
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info = nullptr);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_is_already_y_sorted, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item);
 
+	// Sibling items culled with the same parameters, possibly split across threads.
+	struct CullItemList {
+		Item **items = nullptr;
+		int item_count = 0;
+		bool is_y_sorted = false; // Items of a y-sorted subtree, which carry their own transform, modulate, Z index and material owner.
+		bool skip_behind = false;
+		bool skip_in_front = false;
+		Transform2D xform;
+		Rect2 clip_rect;
+		Color modulate;
+		int z = 0;
+		Item *canvas_clip = nullptr;
+		Item *material_owner = nullptr;
+		uint32_t canvas_cull_mask = 0;
+		Point2 repeat_size;
+		int repeat_times = 1;
+		RendererCanvasRender::Item *repeat_source_item = nullptr;
+		uint32_t task_count = 0;
+	};
+
+	// Each thread fills its own Z lists, which are appended to the main ones in order afterwards.
+	struct CullThreadZLists {
+		LocalVector<RendererCanvasRender::Item *> z_list;
+		LocalVector<RendererCanvasRender::Item *> z_last_list;
+	};
+
+	LocalVector<CullThreadZLists> cull_thread_z_lists;
+	LocalVector<Item *> cull_root_items;
+	int thread_cull_threshold = 1000;
+	bool thread_cull_active = false;
+	SpinLock thread_cull_lock;
+
+	void _cull_canvas_item_list(CullItemList &p_list, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list);
+	void _cull_canvas_item_range(const CullItemList &p_list, int p_from, int p_to, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list);
+	void _cull_canvas_item_list_threaded(uint32_t p_task, const CullItemList *p_list);
+
 	void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, RendererCanvasCull::Item *p_material_owner, const Color &p_modulate, RendererCanvasCull::Item **r_items, int &r_index, int p_z);
 	int _count_ysort_children(RendererCanvasCull::Item *p_canvas_item);
 	void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner);
 
+	bool _is_spatially_indexable(const Item *p_item) const;
+	void _update_spatial_index(Item *p_canvas_item);
+	bool _cull_spatial_index(Item *p_canvas_item, const Transform2D &p_xform, const Rect2 &p_clip_rect);
+	void _invalidate_spatial_index(Item *p_canvas_item);
+	void _invalidate_parent_spatial_index(Item *p_canvas_item);
+	void _clear_spatial_index(Item *p_canvas_item);
+	void _queue_spatial_index_update(Item *p_canvas_item);
+
+	_FORCE_INLINE_ void _canvas_item_bounds_changed(Item *p_canvas_item) {
+		if (unlikely(p_canvas_item->spatial_index_id.is_valid())) {
+			_queue_spatial_index_update(p_canvas_item);
+		}
+	}
+
 	static constexpr int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
 	RendererCanvasRender::Item **z_list;
@@ -203,6 +271,9 @@ public:
 
 	bool was_sdf_used();
 
+	// Overrides `rendering/2d/cull/threaded_cull_minimum_items`.
+	void set_threaded_cull_minimum_items(int p_items);
+
 	RID canvas_allocate();
 	void canvas_initialize(RID p_rid);
 
@@ -255,6 +326,7 @@ public:
 	void canvas_item_add_animation_slice(RID p_item, double p_animation_length, double p_slice_begin, double p_slice_end, double p_offset);
 
 	void canvas_item_set_sort_children_by_y(RID p_item, bool p_enable);
+	void canvas_item_set_use_spatial_index(RID p_item, bool p_enable);
 	void canvas_item_set_z_index(RID p_item, int p_z);
 	void canvas_item_set_z_as_relative_to_parent(RID p_item, bool p_enable);
 	void canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect);
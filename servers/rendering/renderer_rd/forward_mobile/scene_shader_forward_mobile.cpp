@@ -141,10 +141,12 @@ void SceneShaderForwardMobile::ShaderData::set_code(const String &p_code) {
 
 	actions.uniforms = &uniforms;
 
-	MutexLock lock(SceneShaderForwardMobile::singleton_mutex);
+	// The compiler can be used from multiple threads, only the state shared with the pipeline compilation needs the lock.
 	Error err = SceneShaderForwardMobile::singleton->compiler.compile(RS::SHADER_SPATIAL, code, &actions, path, gen_code);
 	ERR_FAIL_COND_MSG(err != OK, "Shader compilation failed.");
 
+	MutexLock lock(SceneShaderForwardMobile::singleton_mutex);
+
 	if (version.is_null()) {
 		version = SceneShaderForwardMobile::singleton->shader.version_create();
 	}
@@ -30,9 +30,206 @@
 
 #include "pipeline_cache_rd.h"
 
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
 #include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/version.h"
 
-RID PipelineCacheRD::_generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
+Mutex PipelineCacheRD::usage_mutex;
+bool PipelineCacheRD::usage_manifest_enabled = false;
+bool PipelineCacheRD::usage_manifest_changed = false;
+HashMap<String, LocalVector<PackedInt64Array>> PipelineCacheRD::usage_manifest;
+
+PackedInt64Array PipelineCacheRD::encode_usage(const Usage &p_usage) {
+	PackedInt64Array data;
+	data.push_back(p_usage.wireframe);
+	data.push_back(p_usage.render_pass);
+	data.push_back(p_usage.bool_specializations);
+
+	data.push_back(p_usage.view_count);
+	data.push_back(p_usage.samples);
+	data.push_back(p_usage.attachments.size());
+	for (const RD::AttachmentFormat &attachment : p_usage.attachments) {
+		data.push_back(attachment.format);
+		data.push_back(attachment.samples);
+		data.push_back(attachment.usage_flags);
+	}
+	data.push_back(p_usage.passes.size());
+	for (const RD::FramebufferPass &pass : p_usage.passes) {
+		for (const Vector<int32_t> *list : { &pass.color_attachments, &pass.input_attachments, &pass.resolve_attachments, &pass.preserve_attachments }) {
+			data.push_back(list->size());
+			for (int32_t index : *list) {
+				data.push_back(index);
+			}
+		}
+		data.push_back(pass.depth_attachment);
+		data.push_back(pass.vrs_attachment);
+	}
+
+	if (!p_usage.use_vertex_format) {
+		data.push_back(-1);
+	} else {
+		data.push_back(p_usage.vertex_attributes.size());
+		for (const RD::VertexAttribute &attribute : p_usage.vertex_attributes) {
+			data.push_back(attribute.location);
+			data.push_back(attribute.offset);
+			data.push_back(attribute.format);
+			data.push_back(attribute.stride);
+			data.push_back(attribute.frequency);
+		}
+	}
+
+	return data;
+}
+
+struct UsageReader {
+	const PackedInt64Array &data;
+	int position = 0;
+	bool valid = true;
+
+	int64_t read() {
+		if (position >= data.size()) {
+			valid = false;
+			return 0;
+		}
+		return data[position++];
+	}
+
+	// Enums are checked against their range, as they're used to create formats.
+	int64_t read_enum(int64_t p_max) {
+		int64_t value = read();
+		if (value < 0 || value >= p_max) {
+			valid = false;
+			return 0;
+		}
+		return value;
+	}
+
+	// Counts are validated against the remaining data, so a corrupt manifest can't cause huge allocations.
+	int read_count() {
+		int64_t count = read();
+		if (count < 0 || count > data.size() - position) {
+			valid = false;
+			return 0;
+		}
+		return count;
+	}
+
+	UsageReader(const PackedInt64Array &p_data) :
+			data(p_data) {}
+};
+
+bool PipelineCacheRD::decode_usage(const PackedInt64Array &p_data, Usage &r_usage) {
+	UsageReader reader(p_data);
+	r_usage.wireframe = reader.read();
+	r_usage.render_pass = reader.read();
+	r_usage.bool_specializations = reader.read();
+
+	r_usage.view_count = reader.read();
+	r_usage.samples = RD::TextureSamples(reader.read_enum(RD::TEXTURE_SAMPLES_MAX));
+	r_usage.attachments.resize(reader.read_count());
+	for (RD::AttachmentFormat &attachment : r_usage.attachments) {
+		attachment.format = RD::DataFormat(reader.read_enum(RD::DATA_FORMAT_MAX));
+		attachment.samples = RD::TextureSamples(reader.read_enum(RD::TEXTURE_SAMPLES_MAX));
+		attachment.usage_flags = reader.read();
+	}
+	r_usage.passes.resize(reader.read_count());
+	for (RD::FramebufferPass &pass : r_usage.passes) {
+		for (Vector<int32_t> *list : { &pass.color_attachments, &pass.input_attachments, &pass.resolve_attachments, &pass.preserve_attachments }) {
+			list->resize(reader.read_count());
+			for (int32_t &index : *list) {
+				index = reader.read();
+			}
+		}
+		pass.depth_attachment = reader.read();
+		pass.vrs_attachment = reader.read();
+	}
+
+	r_usage.use_vertex_format = reader.read() >= 0;
+	r_usage.vertex_attributes.clear();
+	if (r_usage.use_vertex_format) {
+		reader.position--;
+		r_usage.vertex_attributes.resize(reader.read_count());
+		for (RD::VertexAttribute &attribute : r_usage.vertex_attributes) {
+			attribute.location = reader.read();
+			attribute.offset = reader.read();
+			attribute.format = RD::DataFormat(reader.read_enum(RD::DATA_FORMAT_MAX));
+			attribute.stride = reader.read();
+			attribute.frequency = RD::VertexFrequency(reader.read_enum(RD::VERTEX_FREQUENCY_INSTANCE + 1));
+		}
+	}
+
+	return reader.valid && reader.position == p_data.size();
+}
+
+bool PipelineCacheRD::parse_usage_manifest(const Variant &p_manifest, HashMap<String, LocalVector<PackedInt64Array>> &r_usage_manifest) {
+	r_usage_manifest.clear();
+	if (p_manifest.get_type() != Variant::DICTIONARY) {
+		return false;
+	}
+	const Dictionary manifest = p_manifest;
+	// Pipelines recorded by another version may no longer exist, or be set up differently.
+	if (manifest.get("version", Variant()) != Variant(VERSION_FULL_BUILD)) {
+		return false;
+	}
+	const Variant caches_variant = manifest.get("caches", Variant());
+	if (caches_variant.get_type() != Variant::DICTIONARY) {
+		return false;
+	}
+
+	// Entries that can't be decoded are dropped, rather than the whole manifest.
+	const Dictionary caches = caches_variant;
+	const Array keys = caches.keys();
+	for (int i = 0; i < keys.size(); i++) {
+		const Variant &value = caches[keys[i]];
+		if (keys[i].get_type() != Variant::STRING || value.get_type() != Variant::ARRAY) {
+			continue;
+		}
+		const Array usages = value;
+		LocalVector<PackedInt64Array> cache_usages;
+		for (int j = 0; j < usages.size(); j++) {
+			Usage usage;
+			if (usages[j].get_type() == Variant::PACKED_INT64_ARRAY && decode_usage(usages[j], usage)) {
+				cache_usages.push_back(usages[j]);
+			}
+		}
+		if (!cache_usages.is_empty()) {
+			r_usage_manifest[keys[i]] = cache_usages;
+		}
+	}
+	return true;
+}
+
+// Vertex and framebuffer formats are stored by their description, as format IDs depend on the order they're created in.
+static bool _describe_usage(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations, PipelineCacheRD::Usage &r_usage) {
+	if (!RD::get_singleton()->framebuffer_format_get_description(p_framebuffer_format_id, r_usage.attachments, r_usage.passes, r_usage.view_count)) {
+		return false;
+	}
+
+	r_usage.wireframe = p_wireframe;
+	r_usage.render_pass = p_render_pass;
+	r_usage.bool_specializations = p_bool_specializations;
+	r_usage.samples = RD::get_singleton()->framebuffer_format_get_texture_samples(p_framebuffer_format_id, 0);
+	r_usage.use_vertex_format = p_vertex_format_id != RD::INVALID_ID;
+	if (r_usage.use_vertex_format) {
+		r_usage.vertex_attributes = RD::get_singleton()->vertex_format_get_description(p_vertex_format_id);
+	}
+	return true;
+}
+
+static bool _create_usage_formats(const PipelineCacheRD::Usage &p_usage, RD::VertexFormatID &r_vertex_format_id, RD::FramebufferFormatID &r_framebuffer_format_id) {
+	if (p_usage.attachments.is_empty()) {
+		r_framebuffer_format_id = RD::get_singleton()->framebuffer_format_create_empty(p_usage.samples);
+	} else {
+		r_framebuffer_format_id = RD::get_singleton()->framebuffer_format_create_multipass(p_usage.attachments, p_usage.passes, p_usage.view_count);
+	}
+	r_vertex_format_id = p_usage.use_vertex_format ? RD::get_singleton()->vertex_format_create(p_usage.vertex_attributes) : RD::VertexFormatID(RD::INVALID_ID);
+	return r_framebuffer_format_id != RD::INVALID_ID && (!p_usage.use_vertex_format || r_vertex_format_id != RD::INVALID_ID);
+}
+
+RID PipelineCacheRD::_create_pipeline(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
 	RD::PipelineMultisampleState multisample_state_version = multisample_state;
 	multisample_state_version.sample_count = RD::get_singleton()->framebuffer_format_get_texture_samples(p_framebuffer_format_id, p_render_pass);
 
@@ -57,20 +254,201 @@ RID PipelineCacheRD::_generate_version(RD::VertexFormatID p_vertex_format_id, RD
 		bool_index++;
 	}
 
-	RID pipeline = RD::get_singleton()->render_pipeline_create(shader, p_framebuffer_format_id, p_vertex_format_id, render_primitive, raster_state_version, multisample_state_version, depth_stencil_state, blend_state, dynamic_state_flags, p_render_pass, specialization_constants);
-	ERR_FAIL_COND_V(pipeline.is_null(), RID());
+	return RD::get_singleton()->render_pipeline_create(shader, p_framebuffer_format_id, p_vertex_format_id, render_primitive, raster_state_version, multisample_state_version, depth_stencil_state, blend_state, dynamic_state_flags, p_render_pass, specialization_constants);
+}
+
+void PipelineCacheRD::_add_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations, RID p_pipeline) {
 	versions = static_cast<Version *>(memrealloc(versions, sizeof(Version) * (version_count + 1)));
 	versions[version_count].framebuffer_id = p_framebuffer_format_id;
 	versions[version_count].vertex_id = p_vertex_format_id;
-	versions[version_count].wireframe = wireframe;
-	versions[version_count].pipeline = pipeline;
+	versions[version_count].wireframe = p_wireframe;
+	versions[version_count].pipeline = p_pipeline;
 	versions[version_count].render_pass = p_render_pass;
 	versions[version_count].bool_specializations = p_bool_specializations;
 	version_count++;
+}
+
+RID PipelineCacheRD::_generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
+	RID pipeline = _create_pipeline(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
+	ERR_FAIL_COND_V(pipeline.is_null(), RID());
+	_add_version(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations, pipeline);
+	_record_usage(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations);
 	return pipeline;
 }
 
+String PipelineCacheRD::_get_usage_key() const {
+	// Caches are identified by their shader and the state they were set up with, which are the same across runs.
+	// The bytecode hash tells apart versions and variants of a shader with the same name, and shaders edited between runs.
+	String shader_name = RD::get_singleton()->shader_get_name(shader);
+	uint32_t bytecode_hash = RD::get_singleton()->shader_get_bytecode_hash(shader);
+	if (shader_name.is_empty() || bytecode_hash == 0) {
+		return String();
+	}
+
+	uint32_t h = hash_murmur3_one_32(render_primitive);
+	h = hash_murmur3_one_32(rasterization_state.cull_mode, h);
+	h = hash_murmur3_one_32(rasterization_state.front_face, h);
+	h = hash_murmur3_one_32(rasterization_state.depth_bias_enabled, h);
+	h = hash_murmur3_one_32(depth_stencil_state.enable_depth_test, h);
+	h = hash_murmur3_one_32(depth_stencil_state.enable_depth_write, h);
+	h = hash_murmur3_one_32(depth_stencil_state.depth_compare_operator, h);
+	h = hash_murmur3_one_32(depth_stencil_state.enable_stencil, h);
+	h = hash_murmur3_one_32(blend_state.attachments.size(), h);
+	for (const RD::PipelineColorBlendState::Attachment &attachment : blend_state.attachments) {
+		h = hash_murmur3_one_32(attachment.enable_blend, h);
+		h = hash_murmur3_one_32(attachment.src_color_blend_factor, h);
+		h = hash_murmur3_one_32(attachment.dst_color_blend_factor, h);
+	}
+	h = hash_murmur3_one_32(dynamic_state_flags, h);
+	for (const RD::PipelineSpecializationConstant &constant : base_specialization_constants) {
+		h = hash_murmur3_one_32(constant.constant_id, h);
+		h = hash_murmur3_one_32(constant.int_value, h);
+	}
+
+	return shader_name + "/" + String::num_uint64(bytecode_hash, 16) + "/" + String::num_uint64(hash_fmix32(h), 16);
+}
+
+void PipelineCacheRD::_record_usage(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations) {
+	if (!usage_manifest_enabled || usage_key.is_empty()) {
+		return;
+	}
+
+	Usage description;
+	if (!_describe_usage(p_vertex_format_id, p_framebuffer_format_id, p_wireframe, p_render_pass, p_bool_specializations, description)) {
+		return;
+	}
+	const PackedInt64Array usage = encode_usage(description);
+
+	MutexLock lock(usage_mutex);
+	LocalVector<PackedInt64Array> &usages = usage_manifest[usage_key];
+	if (!usages.has(usage)) {
+		usages.push_back(usage);
+		usage_manifest_changed = true;
+	}
+}
+
+void PipelineCacheRD::_start_warm_up() {
+	if (!usage_manifest_enabled || usage_key.is_empty()) {
+		return;
+	}
+
+	{
+		MutexLock lock(usage_mutex);
+		const LocalVector<PackedInt64Array> *usages = usage_manifest.getptr(usage_key);
+		if (!usages) {
+			return;
+		}
+		for (const PackedInt64Array &usage : *usages) {
+			Usage description;
+			Version version;
+			if (decode_usage(usage, description) && _create_usage_formats(description, version.vertex_id, version.framebuffer_id)) {
+				version.wireframe = description.wireframe || rasterization_state.wireframe;
+				version.render_pass = description.render_pass;
+				version.bool_specializations = description.bool_specializations;
+				warm_up_versions.push_back(version);
+			}
+		}
+	}
+
+	if (!warm_up_versions.is_empty()) {
+		warm_up_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &PipelineCacheRD::_warm_up_version, (void *)nullptr, warm_up_versions.size(), -1, false, SNAME("PipelineWarmUp"));
+	}
+}
+
+void PipelineCacheRD::_warm_up_version(uint32_t p_index, void *p_userdata) {
+	const Version &version = warm_up_versions[p_index];
+	RID pipeline = _create_pipeline(version.vertex_id, version.framebuffer_id, version.wireframe, version.render_pass, version.bool_specializations);
+	if (pipeline.is_null()) {
+		return;
+	}
+
+	// The version may have been requested and compiled in the meantime.
+	bool exists = false;
+	spin_lock.lock();
+	for (uint32_t i = 0; i < version_count; i++) {
+		if (versions[i].vertex_id == version.vertex_id && versions[i].framebuffer_id == version.framebuffer_id && versions[i].wireframe == version.wireframe && versions[i].render_pass == version.render_pass && versions[i].bool_specializations == version.bool_specializations) {
+			exists = true;
+			break;
+		}
+	}
+	if (!exists) {
+		_add_version(version.vertex_id, version.framebuffer_id, version.wireframe, version.render_pass, version.bool_specializations, pipeline);
+	}
+	spin_lock.unlock();
+
+	if (exists) {
+		RD::get_singleton()->free(pipeline);
+	}
+}
+
+void PipelineCacheRD::_wait_for_warm_up() {
+	if (warm_up_task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(warm_up_task);
+		warm_up_task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+	warm_up_versions.clear();
+}
+
+String PipelineCacheRD::_get_usage_manifest_path() {
+	String path = vformat("user://vulkan/pipeline_usage.%s.%s",
+			OS::get_singleton()->get_current_rendering_method(),
+			RD::get_singleton()->get_device_name().validate_filename().replace(" ", "_").to_lower());
+	if (Engine::get_singleton()->is_editor_hint()) {
+		path += ".editor";
+	}
+	return path + ".manifest";
+}
+
+void PipelineCacheRD::load_usage_manifest() {
+	usage_manifest_enabled = GLOBAL_GET("rendering/rendering_device/pipeline_cache/usage_manifest");
+	if (!usage_manifest_enabled) {
+		return;
+	}
+
+	MutexLock lock(usage_mutex);
+	usage_manifest.clear();
+	usage_manifest_changed = false;
+
+	Ref<FileAccess> f = FileAccess::open(_get_usage_manifest_path(), FileAccess::READ);
+	if (f.is_null()) {
+		return;
+	}
+	if (!parse_usage_manifest(f->get_var(), usage_manifest)) {
+		return;
+	}
+	print_verbose(vformat("Loaded pipeline usage manifest for %d pipeline caches.", usage_manifest.size()));
+}
+
+void PipelineCacheRD::save_usage_manifest() {
+	MutexLock lock(usage_mutex);
+	if (!usage_manifest_enabled || !usage_manifest_changed) {
+		return;
+	}
+
+	Dictionary caches;
+	for (const KeyValue<String, LocalVector<PackedInt64Array>> &E : usage_manifest) {
+		Array usages;
+		for (const PackedInt64Array &usage : E.value) {
+			usages.push_back(usage);
+		}
+		caches[E.key] = usages;
+	}
+
+	Dictionary manifest;
+	manifest["version"] = VERSION_FULL_BUILD;
+	manifest["caches"] = caches;
+
+	const String path = _get_usage_manifest_path();
+	DirAccess::make_dir_recursive_absolute(path.get_base_dir());
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(f.is_null(), "Can't save the pipeline usage manifest to: " + path);
+	f->store_var(manifest);
+	usage_manifest_changed = false;
+}
+
 void PipelineCacheRD::_clear() {
+	_wait_for_warm_up();
+
 	// TODO: Clear should probably recompile all the variants already compiled instead to avoid stalls? Needs discussion.
 	if (versions) {
 		for (uint32_t i = 0; i < version_count; i++) {
@@ -96,10 +474,14 @@ void PipelineCacheRD::setup(RID p_shader, RD::RenderPrimitive p_primitive, const
 	blend_state = p_blend_state;
 	dynamic_state_flags = p_dynamic_state_flags;
 	base_specialization_constants = p_base_specialization_constants;
+	usage_key = _get_usage_key();
+	_start_warm_up();
 }
 void PipelineCacheRD::update_specialization_constants(const Vector<RD::PipelineSpecializationConstant> &p_base_specialization_constants) {
-	base_specialization_constants = p_base_specialization_constants;
 	_clear();
+	base_specialization_constants = p_base_specialization_constants;
+	usage_key = _get_usage_key();
+	_start_warm_up();
 }
 
 void PipelineCacheRD::update_shader(RID p_shader) {
@@ -111,6 +493,7 @@ void PipelineCacheRD::update_shader(RID p_shader) {
 void PipelineCacheRD::clear() {
 	_clear();
 	shader = RID(); //clear shader
+	usage_key = String();
 }
 
 PipelineCacheRD::PipelineCacheRD() {
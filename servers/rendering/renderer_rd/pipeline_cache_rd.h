@@ -31,6 +31,7 @@
 #ifndef PIPELINE_CACHE_RD_H
 #define PIPELINE_CACHE_RD_H
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/spin_lock.h"
 #include "servers/rendering/rendering_device.h"
 
@@ -59,8 +60,28 @@ class PipelineCacheRD {
 	Version *versions = nullptr;
 	uint32_t version_count;
 
+	RID _create_pipeline(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations);
+	void _add_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations, RID p_pipeline);
 	RID _generate_version(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations = 0);
 
+	// Versions compiled at runtime are recorded in a usage manifest saved on exit. On the next run, the versions
+	// recorded for a cache are compiled in the background as soon as it's set up, instead of on first use.
+	String usage_key;
+	LocalVector<Version> warm_up_versions;
+	WorkerThreadPool::GroupID warm_up_task = WorkerThreadPool::INVALID_TASK_ID;
+
+	static Mutex usage_mutex;
+	static bool usage_manifest_enabled;
+	static bool usage_manifest_changed;
+	static HashMap<String, LocalVector<PackedInt64Array>> usage_manifest;
+
+	String _get_usage_key() const;
+	void _record_usage(RD::VertexFormatID p_vertex_format_id, RD::FramebufferFormatID p_framebuffer_format_id, bool p_wireframe, uint32_t p_render_pass, uint32_t p_bool_specializations);
+	void _start_warm_up();
+	void _warm_up_version(uint32_t p_index, void *p_userdata);
+	void _wait_for_warm_up();
+	static String _get_usage_manifest_path();
+
 	void _clear();
 
 public:
@@ -95,6 +116,27 @@ public:
 		return RD::get_singleton()->shader_get_vertex_input_attribute_mask(shader);
 	}
 	void clear();
+
+	// A recorded pipeline version, with its formats stored by their description.
+	struct Usage {
+		bool wireframe = false;
+		uint32_t render_pass = 0;
+		uint32_t bool_specializations = 0;
+		uint32_t view_count = 1;
+		RD::TextureSamples samples = RD::TEXTURE_SAMPLES_1;
+		Vector<RD::AttachmentFormat> attachments;
+		Vector<RD::FramebufferPass> passes;
+		bool use_vertex_format = false;
+		Vector<RD::VertexAttribute> vertex_attributes;
+	};
+
+	static PackedInt64Array encode_usage(const Usage &p_usage);
+	static bool decode_usage(const PackedInt64Array &p_data, Usage &r_usage);
+	static bool parse_usage_manifest(const Variant &p_manifest, HashMap<String, LocalVector<PackedInt64Array>> &r_usage_manifest);
+
+	static void load_usage_manifest();
+	static void save_usage_manifest();
+
 	PipelineCacheRD();
 	~PipelineCacheRD();
 };
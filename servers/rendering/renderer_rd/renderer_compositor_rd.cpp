@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/dir_access.h"
+#include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
 
 void RendererCompositorRD::blit_render_targets_to_screen(DisplayServer::WindowID p_screen, const BlitToScreen *p_render_targets, int p_amount) {
 	Error err = RD::get_singleton()->screen_prepare_for_drawing(p_screen);
@@ -158,6 +159,8 @@ void RendererCompositorRD::initialize() {
 uint64_t RendererCompositorRD::frame = 1;
 
 void RendererCompositorRD::finalize() {
+	PipelineCacheRD::save_usage_manifest();
+
 	memdelete(scene);
 	memdelete(canvas);
 	memdelete(fog);
@@ -308,6 +311,7 @@ RendererCompositorRD::RendererCompositorRD() {
 					ShaderRD::set_shader_cache_save_compressed(compress);
 					ShaderRD::set_shader_cache_save_compressed_zstd(use_zstd);
 					ShaderRD::set_shader_cache_save_debug(!strip_debug);
+					ShaderCompiler::set_cache_dir(shader_cache_dir.path_join("ShaderCompiler"));
 				}
 			}
 		}
@@ -316,6 +320,9 @@ RendererCompositorRD::RendererCompositorRD() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A RendererCompositorRD singleton already exists.");
 	singleton = this;
 
+	// Loaded before any pipeline cache is set up, so recorded pipelines are compiled while the renderer initializes.
+	PipelineCacheRD::load_usage_manifest();
+
 	utilities = memnew(RendererRD::Utilities);
 	texture_storage = memnew(RendererRD::TextureStorage);
 	material_storage = memnew(RendererRD::MaterialStorage);
@@ -33,12 +33,23 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "raster_occlusion_cull.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_constants.h"
 #include "rendering_server_default.h"
 
 #include <new>
 
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INSTANCE_CULL_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define INSTANCE_CULL_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 #if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
 // This is used only to obtain node paths for user-friendly physics interpolation warnings.
 #include "scene/main/node.h"
@@ -531,6 +542,8 @@ void RendererSceneCull::_instance_update_mesh_instance(Instance *p_instance) con
 			InstanceData &idata = p_instance->scenario->instance_data[p_instance->array_index];
 			if (p_instance->mesh_instance.is_valid()) {
 				idata.flags |= InstanceData::FLAG_USES_MESH_INSTANCE;
+				// Mesh instances need updating when only visible in shadows, see _scene_cull_directional_shadow().
+				_instance_set_dynamic_shadow_caster(p_instance);
 			} else {
 				idata.flags &= ~uint32_t(InstanceData::FLAG_USES_MESH_INSTANCE);
 			}
@@ -895,6 +908,8 @@ void RendererSceneCull::instance_set_layer_mask(RID p_instance, uint32_t p_mask)
 	instance->layer_mask = p_mask;
 	if (instance->scenario && instance->array_index >= 0) {
 		instance->scenario->instance_data[instance->array_index].layer_mask = p_mask;
+		instance->scenario->instance_cull_blocks[instance->array_index / INSTANCE_CULL_BLOCK_SIZE].layer_mask[instance->array_index % INSTANCE_CULL_BLOCK_SIZE] = p_mask;
+		_instance_set_dynamic_shadow_caster(instance);
 	}
 
 	if ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK && instance->base_data) {
@@ -945,12 +960,32 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	Instance *instance = instance_owner.get_or_null(p_instance);
 	ERR_FAIL_NULL(instance);
 
+	instance->refit_bvh = false;
+	_instance_set_transform(instance, p_transform);
+}
+
+void RendererSceneCull::instance_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms) {
+	ERR_FAIL_COND_MSG(p_instances.size() != p_transforms.size(), "The number of transforms must match the number of instances.");
+
+	const RID *instances = p_instances.ptr();
+	const Transform3D *transforms = p_transforms.ptr();
+	for (int i = 0; i < p_instances.size(); i++) {
+		Instance *instance = instance_owner.get_or_null(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		// Moved together, usually by small steps every frame, so refitting the BVH is cheaper than reinserting.
+		instance->refit_bvh = true;
+		_instance_set_transform(instance, transforms[i]);
+	}
+}
+
+void RendererSceneCull::_instance_set_transform(Instance *p_instance, const Transform3D &p_transform) {
 #ifdef RENDERING_SERVER_DEBUG_PHYSICS_INTERPOLATION
 	print_line("instance_set_transform " + rtos(p_transform.origin.x) + " .. tick " + itos(Engine::get_singleton()->get_physics_frames()));
 #endif
 
-	if (!_interpolation_data.interpolation_enabled || !instance->interpolated || !instance->scenario) {
-		if (instance->transform == p_transform) {
+	if (!_interpolation_data.interpolation_enabled || !p_instance->interpolated || !p_instance->scenario) {
+		if (p_instance->transform == p_transform) {
 			return; // Must be checked to avoid worst evil.
 		}
 
@@ -962,12 +997,12 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 		}
 
 #endif
-		instance->transform = p_transform;
-		_instance_queue_update(instance, true);
+		p_instance->transform = p_transform;
+		_instance_queue_update(p_instance, true);
 
 #if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
-		if (_interpolation_data.interpolation_enabled && !instance->interpolated && Engine::get_singleton()->is_in_physics_frame()) {
-			PHYSICS_INTERPOLATION_NODE_WARNING(instance->object_id, "Non-interpolated instance triggered from physics process");
+		if (_interpolation_data.interpolation_enabled && !p_instance->interpolated && Engine::get_singleton()->is_in_physics_frame()) {
+			PHYSICS_INTERPOLATION_NODE_WARNING(p_instance->object_id, "Non-interpolated instance triggered from physics process");
 		}
 #endif
 
@@ -975,14 +1010,14 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	}
 
 	float new_checksum = TransformInterpolator::checksum_transform_3d(p_transform);
-	bool checksums_match = (instance->transform_checksum_curr == new_checksum) && (instance->transform_checksum_prev == new_checksum);
+	bool checksums_match = (p_instance->transform_checksum_curr == new_checksum) && (p_instance->transform_checksum_prev == new_checksum);
 
 	// We can't entirely reject no changes because we need the interpolation
 	// system to keep on stewing.
 
 	// Optimized check. First checks the checksums. If they pass it does the slow check at the end.
 	// Alternatively we can do this non-optimized and ignore the checksum... if no change.
-	if (checksums_match && (instance->transform_curr == p_transform) && (instance->transform_prev == p_transform)) {
+	if (checksums_match && (p_instance->transform_curr == p_transform) && (p_instance->transform_prev == p_transform)) {
 		return;
 	}
 
@@ -995,18 +1030,18 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 
 #endif
 
-	instance->transform_curr = p_transform;
+	p_instance->transform_curr = p_transform;
 
 #ifdef RENDERING_SERVER_DEBUG_PHYSICS_INTERPOLATION
-	print_line("\tprev " + rtos(instance->transform_prev.origin.x) + ", curr " + rtos(instance->transform_curr.origin.x));
+	print_line("\tprev " + rtos(p_instance->transform_prev.origin.x) + ", curr " + rtos(p_instance->transform_curr.origin.x));
 #endif
 
 	// Keep checksums up to date.
-	instance->transform_checksum_curr = new_checksum;
+	p_instance->transform_checksum_curr = new_checksum;
 
-	if (!instance->on_interpolate_transform_list) {
-		_interpolation_data.instance_transform_update_list_curr->push_back(p_instance);
-		instance->on_interpolate_transform_list = true;
+	if (!p_instance->on_interpolate_transform_list) {
+		_interpolation_data.instance_transform_update_list_curr->push_back(p_instance->self);
+		p_instance->on_interpolate_transform_list = true;
 	} else {
 		DEV_ASSERT(_interpolation_data.instance_transform_update_list_curr->size());
 	}
@@ -1015,25 +1050,25 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 	// transform or anything else.
 	// Ideally we would not even call the VisualServer::set_transform() when invisible but that would entail having logic
 	// to keep track of the previous transform on the SceneTree side. The "early out" below is less efficient but a lot cleaner codewise.
-	if (!instance->visible) {
+	if (!p_instance->visible) {
 		return;
 	}
 
 	// Decide on the interpolation method... slerp if possible.
-	instance->interpolation_method = TransformInterpolator::find_method(instance->transform_prev.basis, instance->transform_curr.basis);
+	p_instance->interpolation_method = TransformInterpolator::find_method(p_instance->transform_prev.basis, p_instance->transform_curr.basis);
 
-	if (!instance->on_interpolate_list) {
-		_interpolation_data.instance_interpolate_update_list.push_back(p_instance);
-		instance->on_interpolate_list = true;
+	if (!p_instance->on_interpolate_list) {
+		_interpolation_data.instance_interpolate_update_list.push_back(p_instance->self);
+		p_instance->on_interpolate_list = true;
 	} else {
 		DEV_ASSERT(_interpolation_data.instance_interpolate_update_list.size());
 	}
 
-	_instance_queue_update(instance, true);
+	_instance_queue_update(p_instance, true);
 
 #if defined(DEBUG_ENABLED) && defined(TOOLS_ENABLED)
 	if (!Engine::get_singleton()->is_in_physics_frame()) {
-		PHYSICS_INTERPOLATION_NODE_WARNING(instance->object_id, "Interpolated instance triggered from outside physics process");
+		PHYSICS_INTERPOLATION_NODE_WARNING(p_instance->object_id, "Interpolated instance triggered from outside physics process");
 	}
 #endif
 }
@@ -1234,6 +1269,7 @@ void RendererSceneCull::instance_set_ignore_culling(RID p_instance, bool p_enabl
 		} else {
 			idata.flags &= ~uint32_t(InstanceData::FLAG_IGNORE_ALL_CULLING);
 		}
+		instance->scenario->instance_cull_blocks[instance->array_index / INSTANCE_CULL_BLOCK_SIZE].set_ignore_culling(instance->array_index % INSTANCE_CULL_BLOCK_SIZE, instance->ignore_all_culling);
 	}
 }
 
@@ -1406,6 +1442,8 @@ void RendererSceneCull::instance_geometry_set_cast_shadows_setting(RID p_instanc
 		} else {
 			idata.flags &= ~uint32_t(InstanceData::FLAG_CAST_SHADOWS_ONLY);
 		}
+
+		_instance_set_dynamic_shadow_caster(instance);
 	}
 
 	if ((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK && instance->base_data) {
@@ -1571,6 +1609,11 @@ void RendererSceneCull::_update_instance_visibility_dependencies(Instance *p_ins
 			}
 		}
 
+		if (has_visibility_range || p_instance->visibility_parent) {
+			// Visibility ranges depend on the camera position.
+			_instance_set_dynamic_shadow_caster(p_instance);
+		}
+
 		if ((has_visibility_range || p_instance->visibility_parent) && (p_instance->visibility_index == -1 || p_instance->visibility_dependencies_depth == 0)) {
 			idata.flags |= InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK;
 		} else {
@@ -1735,6 +1778,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) const {
 		RSG::light_storage->light_instance_set_transform(light->instance, *instance_xform);
 		RSG::light_storage->light_instance_set_aabb(light->instance, instance_xform->xform(p_instance->aabb));
 		light->make_shadow_dirty();
+		light->clear_shadow_caster_cache();
 
 		RS::LightBakeMode bake_mode = RSG::light_storage->light_get_bake_mode(p_instance->base);
 		if (RSG::light_storage->light_get_type(p_instance->base) != RS::LIGHT_DIRECTIONAL && bake_mode != light->bake_mode) {
@@ -1942,6 +1986,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) const {
 		}
 		if (p_instance->mesh_instance.is_valid()) {
 			idata.flags |= InstanceData::FLAG_USES_MESH_INSTANCE;
+			p_instance->dynamic_shadow_caster = true;
 		}
 		if (p_instance->ignore_occlusion_culling) {
 			idata.flags |= InstanceData::FLAG_IGNORE_OCCLUSION_CULLING;
@@ -1952,14 +1997,34 @@ void RendererSceneCull::_update_instance(Instance *p_instance) const {
 
 		p_instance->scenario->instance_data.push_back(idata);
 		p_instance->scenario->instance_aabbs.push_back(InstanceBounds(p_instance->transformed_aabb));
+
+		uint32_t cull_lane = p_instance->array_index % INSTANCE_CULL_BLOCK_SIZE;
+		if (cull_lane == 0) {
+			p_instance->scenario->instance_cull_blocks.push_back(InstanceCullBlock());
+		}
+		InstanceCullBlock &cull_block = p_instance->scenario->instance_cull_blocks[p_instance->array_index / INSTANCE_CULL_BLOCK_SIZE];
+		cull_block.set_bounds(cull_lane, InstanceBounds(p_instance->transformed_aabb));
+		cull_block.layer_mask[cull_lane] = idata.layer_mask;
+		cull_block.set_ignore_culling(cull_lane, p_instance->ignore_all_culling);
+		cull_block.set_dynamic_shadow_caster(cull_lane, p_instance->dynamic_shadow_caster);
+		if (!p_instance->dynamic_shadow_caster && ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+			p_instance->scenario->static_shadow_casters_version++;
+		}
 		_update_instance_visibility_dependencies(p_instance);
 	} else {
-		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-			p_instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].update(p_instance->indexer_id, bvh_aabb);
+		if (p_instance->transformed_aabb != p_instance->prev_transformed_aabb) {
+			_instance_set_dynamic_shadow_caster(p_instance);
+		}
+
+		DynamicBVH &indexer = p_instance->scenario->indexers[((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) ? Scenario::INDEXER_GEOMETRY : Scenario::INDEXER_VOLUMES];
+		if (p_instance->refit_bvh) {
+			indexer.refit(p_instance->indexer_id, bvh_aabb);
 		} else {
-			p_instance->scenario->indexers[Scenario::INDEXER_VOLUMES].update(p_instance->indexer_id, bvh_aabb);
+			indexer.update(p_instance->indexer_id, bvh_aabb);
 		}
+		p_instance->refit_bvh = false; // Only for the update queued by instance_set_transforms().
 		p_instance->scenario->instance_aabbs[p_instance->array_index] = InstanceBounds(p_instance->transformed_aabb);
+		p_instance->scenario->instance_cull_blocks[p_instance->array_index / INSTANCE_CULL_BLOCK_SIZE].set_bounds(p_instance->array_index % INSTANCE_CULL_BLOCK_SIZE, InstanceBounds(p_instance->transformed_aabb));
 	}
 
 	if (p_instance->visibility_index != -1) {
@@ -2023,6 +2088,18 @@ void RendererSceneCull::_update_instance(Instance *p_instance) const {
 	p_instance->prev_transformed_aabb = p_instance->transformed_aabb;
 }
 
+void RendererSceneCull::_instance_set_dynamic_shadow_caster(Instance *p_instance) const {
+	if (p_instance->dynamic_shadow_caster || !((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+		return;
+	}
+
+	p_instance->dynamic_shadow_caster = true;
+	if (p_instance->scenario && p_instance->array_index != -1) {
+		p_instance->scenario->instance_cull_blocks[p_instance->array_index / INSTANCE_CULL_BLOCK_SIZE].set_dynamic_shadow_caster(p_instance->array_index % INSTANCE_CULL_BLOCK_SIZE, true);
+		p_instance->scenario->static_shadow_casters_version++;
+	}
+}
+
 void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 	if (!p_instance->indexer_id.is_valid()) {
 		return; //nothing to do
@@ -2043,6 +2120,10 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 
 	p_instance->indexer_id = DynamicBVH::ID();
 
+	if (!p_instance->dynamic_shadow_caster && ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+		p_instance->scenario->static_shadow_casters_version++;
+	}
+
 	//replace this by last
 	int32_t swap_with_index = p_instance->scenario->instance_data.size() - 1;
 	if (swap_with_index != p_instance->array_index) {
@@ -2050,6 +2131,7 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 		swapped_instance->array_index = p_instance->array_index; //swap
 		p_instance->scenario->instance_data[p_instance->array_index] = p_instance->scenario->instance_data[swap_with_index];
 		p_instance->scenario->instance_aabbs[p_instance->array_index] = p_instance->scenario->instance_aabbs[swap_with_index];
+		p_instance->scenario->instance_cull_blocks[p_instance->array_index / INSTANCE_CULL_BLOCK_SIZE].copy_lane(p_instance->array_index % INSTANCE_CULL_BLOCK_SIZE, p_instance->scenario->instance_cull_blocks[swap_with_index / INSTANCE_CULL_BLOCK_SIZE], swap_with_index % INSTANCE_CULL_BLOCK_SIZE);
 
 		if (swapped_instance->visibility_index != -1) {
 			swapped_instance->scenario->instance_visibility[swapped_instance->visibility_index].array_index = swapped_instance->array_index;
@@ -2066,6 +2148,11 @@ void RendererSceneCull::_unpair_instance(Instance *p_instance) {
 	// pop last
 	p_instance->scenario->instance_data.pop_back();
 	p_instance->scenario->instance_aabbs.pop_back();
+	if (swap_with_index % INSTANCE_CULL_BLOCK_SIZE == 0) {
+		p_instance->scenario->instance_cull_blocks.resize(swap_with_index / INSTANCE_CULL_BLOCK_SIZE);
+	} else {
+		p_instance->scenario->instance_cull_blocks[swap_with_index / INSTANCE_CULL_BLOCK_SIZE].clear_lane(swap_with_index % INSTANCE_CULL_BLOCK_SIZE);
+	}
 
 	//uninitialize
 	p_instance->array_index = -1;
@@ -2299,6 +2386,7 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	cull.shadow_count = p_shadow_index + 1;
 	cull.shadows[p_shadow_index].cascade_count = splits;
 	cull.shadows[p_shadow_index].light_instance = light->instance;
+	cull.shadows[p_shadow_index].light = light;
 	cull.shadows[p_shadow_index].caster_mask = RSG::light_storage->light_get_shadow_caster_mask(p_instance->base);
 
 	for (int i = 0; i < splits; i++) {
@@ -2908,6 +2996,66 @@ bool RendererSceneCull::_visibility_parent_check(const CullData &p_cull_data, co
 	return ((parent_flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK) == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE) || (parent_flags & InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
 }
 
+uint32_t RendererSceneCull::InstanceCullBlock::cull(const Frustum &p_frustum, uint32_t p_visible_layers) const {
+	static_assert(INSTANCE_CULL_BLOCK_SIZE % 4 == 0);
+	uint32_t result = 0;
+
+#if defined(INSTANCE_CULL_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128i visible_layers = _mm_set1_epi32(p_visible_layers);
+	for (uint32_t lane = 0; lane < INSTANCE_CULL_BLOCK_SIZE; lane += 4) {
+		// Start with the instances not matching the visible layers, then add those fully outside a plane.
+		__m128i layers = _mm_and_si128(_mm_loadu_si128((const __m128i *)&layer_mask[lane]), visible_layers);
+		__m128 culled = _mm_castsi128_ps(_mm_cmpeq_epi32(layers, _mm_setzero_si128()));
+		for (uint32_t i = 0; i < p_frustum.plane_count; i++) {
+			const Plane &plane = p_frustum.planes_ptr[i];
+			const uint32_t *signs = p_frustum.plane_signs_ptr[i].signs;
+			__m128 dist = _mm_mul_ps(_mm_set1_ps(plane.normal.x), _mm_loadu_ps(&bounds[signs[0]][lane]));
+			dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(plane.normal.y), _mm_loadu_ps(&bounds[signs[1]][lane])));
+			dist = _mm_add_ps(dist, _mm_mul_ps(_mm_set1_ps(plane.normal.z), _mm_loadu_ps(&bounds[signs[2]][lane])));
+			dist = _mm_sub_ps(dist, _mm_set1_ps(plane.d));
+			culled = _mm_or_ps(culled, _mm_cmpge_ps(dist, zero));
+		}
+		result |= uint32_t(~_mm_movemask_ps(culled) & 0xF) << lane;
+	}
+#elif defined(INSTANCE_CULL_NEON)
+	static const uint32_t lane_bits_array[4] = { 1, 2, 4, 8 };
+	const uint32x4_t lane_bits = vld1q_u32(lane_bits_array);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const uint32x4_t visible_layers = vdupq_n_u32(p_visible_layers);
+	for (uint32_t lane = 0; lane < INSTANCE_CULL_BLOCK_SIZE; lane += 4) {
+		// Start with the instances not matching the visible layers, then add those fully outside a plane.
+		uint32x4_t culled = vceqq_u32(vandq_u32(vld1q_u32(&layer_mask[lane]), visible_layers), vdupq_n_u32(0));
+		for (uint32_t i = 0; i < p_frustum.plane_count; i++) {
+			const Plane &plane = p_frustum.planes_ptr[i];
+			const uint32_t *signs = p_frustum.plane_signs_ptr[i].signs;
+			// Not using fused multiply-add, to match the scalar test exactly.
+			float32x4_t dist = vmulq_n_f32(vld1q_f32(&bounds[signs[0]][lane]), plane.normal.x);
+			dist = vaddq_f32(dist, vmulq_n_f32(vld1q_f32(&bounds[signs[1]][lane]), plane.normal.y));
+			dist = vaddq_f32(dist, vmulq_n_f32(vld1q_f32(&bounds[signs[2]][lane]), plane.normal.z));
+			dist = vsubq_f32(dist, vdupq_n_f32(plane.d));
+			culled = vorrq_u32(culled, vcgeq_f32(dist, zero));
+		}
+		result |= vaddvq_u32(vbicq_u32(lane_bits, culled)) << lane;
+	}
+#else
+	for (uint32_t lane = 0; lane < INSTANCE_CULL_BLOCK_SIZE; lane++) {
+		if (!(layer_mask[lane] & p_visible_layers)) {
+			continue;
+		}
+		bool inside = true;
+		for (uint32_t i = 0; i < p_frustum.plane_count && inside; i++) {
+			const uint32_t *signs = p_frustum.plane_signs_ptr[i].signs;
+			Vector3 min(bounds[signs[0]][lane], bounds[signs[1]][lane], bounds[signs[2]][lane]);
+			inside = p_frustum.planes_ptr[i].distance_to(min) < 0.0;
+		}
+		result |= uint32_t(inside) << lane;
+	}
+#endif
+
+	return result;
+}
+
 void RendererSceneCull::_scene_cull_threaded(uint32_t p_thread, CullData *cull_data) {
 	uint32_t cull_total = cull_data->scenario->instance_data.size();
 	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
@@ -2929,7 +3077,30 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	Transform3D inv_cam_transform = cull_data.cam_transform.inverse();
 	float z_near = cull_data.camera_matrix->get_z_near();
 
+	// Layer mask and camera frustum are tested a whole block of instances at a time. Unless SDFGI needs
+	// to look at every instance, those failing this test can be skipped. Directional shadows are culled
+	// separately, see _scene_cull_directional_shadow().
+	const bool camera_cull_only = cull_data.cull->sdfgi.region_count == 0;
+	uint32_t block_in_frustum = 0;
+	uint32_t block_candidates = 0;
+
 	for (uint64_t i = p_from; i < p_to; i++) {
+		const uint32_t cull_lane = i % INSTANCE_CULL_BLOCK_SIZE;
+		if (cull_lane == 0 || i == p_from) {
+			const InstanceCullBlock &cull_block = cull_data.scenario->instance_cull_blocks[i / INSTANCE_CULL_BLOCK_SIZE];
+			block_in_frustum = cull_block.cull(cull_data.cull->frustum, cull_data.visible_layers);
+			block_candidates = block_in_frustum | cull_block.ignore_culling_mask;
+			if (camera_cull_only && (block_candidates >> cull_lane) == 0) {
+				// Nothing left to process in this block.
+				i += INSTANCE_CULL_BLOCK_SIZE - 1 - cull_lane;
+				continue;
+			}
+		}
+		if (camera_cull_only && !(block_candidates & (1 << cull_lane))) {
+			continue;
+		}
+		const bool in_camera_frustum = block_in_frustum & (1 << cull_lane);
+
 		bool mesh_visible = false;
 
 		InstanceData &idata = cull_data.scenario->instance_data[i];
@@ -2937,15 +3108,13 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 		int32_t visibility_check = -1;
 
 #define HIDDEN_BY_VISIBILITY_CHECKS (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN)
-#define LAYER_CHECK (cull_data.visible_layers & idata.layer_mask)
-#define IN_FRUSTUM(f) (cull_data.scenario->instance_aabbs[i].in_frustum(f))
 #define VIS_RANGE_CHECK ((idata.visibility_index == -1) || _visibility_range_check<false>(cull_data.scenario->instance_visibility[idata.visibility_index], cull_data.cam_transform.origin, cull_data.visibility_viewport_mask) == 0)
 #define VIS_PARENT_CHECK (_visibility_parent_check(cull_data, idata))
 #define VIS_CHECK (visibility_check < 0 ? (visibility_check = (visibility_flags != InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK || (VIS_RANGE_CHECK && VIS_PARENT_CHECK))) : visibility_check)
 #define OCCLUSION_CULLED (cull_data.occlusion_buffer != nullptr && (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_OCCLUSION_CULLING) == 0 && cull_data.occlusion_buffer->is_occluded(cull_data.scenario->instance_aabbs[i].bounds, cull_data.cam_transform.origin, inv_cam_transform, *cull_data.camera_matrix, z_near, cull_data.scenario->instance_data[i].occlusion_timeout))
 
 		if (!HIDDEN_BY_VISIBILITY_CHECKS) {
-			if ((LAYER_CHECK && IN_FRUSTUM(cull_data.cull->frustum) && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
+			if ((in_camera_frustum && VIS_CHECK && !OCCLUSION_CULLED) || (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_IGNORE_ALL_CULLING)) {
 				uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 				if (base_type == RS::INSTANCE_LIGHT) {
 					cull_result.lights.push_back(idata.instance);
@@ -3139,27 +3308,9 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 					}
 				}
 			}
-
-			for (uint32_t j = 0; j < cull_data.cull->shadow_count; j++) {
-				if (!light_culler->cull_directional_light(cull_data.scenario->instance_aabbs[i], j)) {
-					continue;
-				}
-				for (uint32_t k = 0; k < cull_data.cull->shadows[j].cascade_count; k++) {
-					if (IN_FRUSTUM(cull_data.cull->shadows[j].cascades[k].frustum) && VIS_CHECK) {
-						uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
-
-						if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS && (LAYER_CHECK & cull_data.cull->shadows[j].caster_mask)) {
-							cull_result.directional_shadows[j].cascade_geometry_instances[k].push_back(idata.instance_geometry);
-							mesh_visible = true;
-						}
-					}
-				}
-			}
 		}
 
 #undef HIDDEN_BY_VISIBILITY_CHECKS
-#undef LAYER_CHECK
-#undef IN_FRUSTUM
 #undef VIS_RANGE_CHECK
 #undef VIS_PARENT_CHECK
 #undef VIS_CHECK
@@ -3193,6 +3344,86 @@ void RendererSceneCull::_scene_cull(CullData &cull_data, InstanceCullResult &cul
 	}
 }
 
+void RendererSceneCull::_scene_cull_directional_shadow_threaded(uint32_t p_index, CullData *cull_data) {
+	// Each cascade of each directional light is split into instance ranges like _scene_cull_threaded().
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	uint32_t thread = p_index % total_threads;
+	uint32_t cascade = p_index / total_threads;
+	uint32_t shadow = cascade / RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES;
+	cascade %= RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES;
+	if (cascade >= cull_data->cull->shadows[shadow].cascade_count) {
+		return;
+	}
+
+	uint32_t cull_total = cull_data->scenario->instance_data.size();
+	uint32_t cull_from = thread * cull_total / total_threads;
+	uint32_t cull_to = (thread + 1 == total_threads) ? cull_total : ((thread + 1) * cull_total / total_threads);
+
+	_scene_cull_directional_shadow(*cull_data, scene_cull_result_threads[thread], shadow, cascade, cull_from, cull_to);
+}
+
+void RendererSceneCull::_scene_cull_directional_shadow(CullData &cull_data, InstanceCullResult &cull_result, uint32_t p_shadow, uint32_t p_cascade, uint64_t p_from, uint64_t p_to) {
+	const Cull::Shadow &shadow = cull_data.cull->shadows[p_shadow];
+	const Cull::Shadow::Cascade &cascade = shadow.cascades[p_cascade];
+	const uint32_t layer_mask = cull_data.visible_layers & shadow.caster_mask;
+	InstanceCullResult::DirectionalShadow &result = cull_result.directional_shadows[p_shadow];
+
+	uint32_t block_candidates = 0;
+	uint32_t block_dynamic = 0;
+
+	for (uint64_t i = p_from; i < p_to; i++) {
+		const uint32_t cull_lane = i % INSTANCE_CULL_BLOCK_SIZE;
+		if (cull_lane == 0 || i == p_from) {
+			// Frustum and layers are tested a whole block at a time. When the static casters are cached, only dynamic instances are left.
+			const InstanceCullBlock &cull_block = cull_data.scenario->instance_cull_blocks[i / INSTANCE_CULL_BLOCK_SIZE];
+			block_dynamic = cull_block.dynamic_shadow_caster_mask;
+			block_candidates = cull_block.cull(cascade.frustum, layer_mask);
+			if (cascade.use_static_casters) {
+				block_candidates &= block_dynamic;
+			}
+			if ((block_candidates >> cull_lane) == 0) {
+				// Nothing left to process in this block.
+				i += INSTANCE_CULL_BLOCK_SIZE - 1 - cull_lane;
+				continue;
+			}
+		}
+		if (!(block_candidates & (1 << cull_lane))) {
+			continue;
+		}
+
+		const InstanceData &idata = cull_data.scenario->instance_data[i];
+		if (!((1 << (idata.flags & InstanceData::FLAG_BASE_TYPE_MASK)) & RS::INSTANCE_GEOMETRY_MASK) || !(idata.flags & InstanceData::FLAG_CAST_SHADOWS)) {
+			continue;
+		}
+
+		const uint32_t visibility_flags = idata.flags & (InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE | InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN | InstanceData::FLAG_VISIBILITY_DEPENDENCY_FADE_CHILDREN);
+		if (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN_CLOSE_RANGE || visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_HIDDEN) {
+			continue;
+		}
+		if (visibility_flags == InstanceData::FLAG_VISIBILITY_DEPENDENCY_NEEDS_CHECK) {
+			// The range check updates the per viewport state, which the other cascades may be checking at the same time.
+			cull_data.cull->lock.lock();
+			const bool visible = (idata.visibility_index == -1 || _visibility_range_check<false>(cull_data.scenario->instance_visibility[idata.visibility_index], cull_data.cam_transform.origin, cull_data.visibility_viewport_mask) == 0) && _visibility_parent_check(cull_data, idata);
+			cull_data.cull->lock.unlock();
+			if (!visible) {
+				continue;
+			}
+		}
+
+		if (!light_culler->cull_directional_light(cull_data.scenario->instance_aabbs[i], p_shadow)) {
+			continue;
+		}
+
+		result.cascade_geometry_instances[p_cascade].push_back(idata.instance_geometry);
+		if (!(block_dynamic & (1 << cull_lane))) {
+			result.cascade_static_geometry_instances[p_cascade].push_back(idata.instance_geometry);
+		}
+		if (idata.flags & InstanceData::FLAG_USES_MESH_INSTANCE) {
+			result.cascade_mesh_instances[p_cascade].push_back(idata.instance->mesh_instance);
+		}
+	}
+}
+
 void RendererSceneCull::_scene_particles_set_view_axis(RID p_particles, const Vector3 &p_axis, const Vector3 &p_up_axis) {
 	RSG::particles_storage->particles_set_view_axis(p_particles, p_axis, p_up_axis);
 }
@@ -3357,6 +3588,70 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 			_scene_cull(cull_data, scene_cull_result, cull_from, cull_to);
 		}
 
+		if (cull.shadow_count > 0) {
+			RENDER_TIMESTAMP("Cull DirectionalLight3D Shadows");
+
+			// Reuse the static casters of cascades where nothing they depend on changed, only dynamic instances are culled for those.
+			for (uint32_t i = 0; i < cull.shadow_count; i++) {
+				Cull::Shadow &shadow = cull.shadows[i];
+				const uint32_t layer_mask = p_visible_layers & shadow.caster_mask;
+				for (uint32_t j = 0; j < shadow.cascade_count; j++) {
+					Cull::Shadow::Cascade &cascade = shadow.cascades[j];
+					const InstanceLightData::ShadowCasterCache &cache = shadow.light->shadow_caster_cache[j];
+					cascade.use_static_casters = cache.static_version == scenario->static_shadow_casters_version && cache.layer_mask == layer_mask && cache.cascade_planes == cascade.frustum.planes && cache.camera_planes == cull.frustum.planes;
+					if (cascade.use_static_casters) {
+						for (RenderGeometryInstance *caster : cache.static_casters) {
+							scene_cull_result.directional_shadows[i].cascade_geometry_instances[j].push_back(caster);
+						}
+					}
+				}
+			}
+
+			if (cull_to > thread_cull_threshold) {
+				// Every cascade of every light is culled in parallel, each of them split in instance ranges.
+				const uint32_t cascade_cull_count = cull.shadow_count * RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES;
+				WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_scene_cull_directional_shadow_threaded, &cull_data, scene_cull_result_threads.size() * cascade_cull_count, -1, true, SNAME("RenderCullDirectionalShadows"));
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+				for (InstanceCullResult &thread : scene_cull_result_threads) {
+					for (uint32_t i = 0; i < cull.shadow_count; i++) {
+						for (uint32_t j = 0; j < cull.shadows[i].cascade_count; j++) {
+							InstanceCullResult::DirectionalShadow &shadow = scene_cull_result.directional_shadows[i];
+							InstanceCullResult::DirectionalShadow &thread_shadow = thread.directional_shadows[i];
+							shadow.cascade_geometry_instances[j].merge_unordered(thread_shadow.cascade_geometry_instances[j]);
+							shadow.cascade_static_geometry_instances[j].merge_unordered(thread_shadow.cascade_static_geometry_instances[j]);
+							shadow.cascade_mesh_instances[j].merge_unordered(thread_shadow.cascade_mesh_instances[j]);
+						}
+					}
+				}
+			} else {
+				for (uint32_t i = 0; i < cull.shadow_count; i++) {
+					for (uint32_t j = 0; j < cull.shadows[i].cascade_count; j++) {
+						_scene_cull_directional_shadow(cull_data, scene_cull_result, i, j, cull_from, cull_to);
+					}
+				}
+			}
+
+			for (uint32_t i = 0; i < cull.shadow_count; i++) {
+				Cull::Shadow &shadow = cull.shadows[i];
+				for (uint32_t j = 0; j < shadow.cascade_count; j++) {
+					InstanceCullResult::DirectionalShadow &result = scene_cull_result.directional_shadows[i];
+					if (!shadow.cascades[j].use_static_casters) {
+						InstanceLightData::ShadowCasterCache &cache = shadow.light->shadow_caster_cache[j];
+						cache.cascade_planes = shadow.cascades[j].frustum.planes;
+						cache.camera_planes = cull.frustum.planes;
+						cache.layer_mask = p_visible_layers & shadow.caster_mask;
+						cache.static_version = scenario->static_shadow_casters_version;
+						cache.static_casters.resize(result.cascade_static_geometry_instances[j].size());
+						for (uint64_t k = 0; k < result.cascade_static_geometry_instances[j].size(); k++) {
+							cache.static_casters[k] = result.cascade_static_geometry_instances[j][k];
+						}
+					}
+					scene_cull_result.mesh_instances.merge_unordered(result.cascade_mesh_instances[j]);
+				}
+			}
+		}
+
 #ifdef DEBUG_CULL_TIME
 		static float time_avg = 0;
 		static uint32_t time_count = 0;
@@ -4338,6 +4633,7 @@ bool RendererSceneCull::free(RID p_rid) {
 		}
 		scenario->instance_aabbs.reset();
 		scenario->instance_data.reset();
+		scenario->instance_cull_blocks.reset();
 		scenario->instance_visibility.reset();
 
 		RSG::light_storage->shadow_atlas_free(scenario->reflection_probe_shadow_atlas);
@@ -4543,7 +4839,8 @@ RendererSceneCull::RendererSceneCull() {
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); //make sure there is at least one thread per CPU
 	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = GLOBAL_GET("rendering/occlusion_culling/jitter_projection");
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	// Replaced by faster implementations from modules, if available.
+	default_occlusion_culling = memnew(RasterOcclusionCull);
 
 	light_culler = memnew(RenderingLightCuller);
 
@@ -4569,8 +4866,8 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (default_occlusion_culling) {
+		memdelete(default_occlusion_culling);
 	}
 
 	if (light_culler) {
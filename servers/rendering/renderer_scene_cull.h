@@ -129,7 +129,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling = nullptr;
+	RendererSceneOcclusionCull *default_occlusion_culling = nullptr;
 
 	/* SCENARIO API */
 
@@ -254,6 +254,55 @@ public:
 		}
 	};
 
+	static constexpr uint32_t INSTANCE_CULL_BLOCK_SIZE = 8;
+
+	struct InstanceCullBlock {
+		// Bounds and layer masks of INSTANCE_CULL_BLOCK_SIZE consecutive instances, stored component by component
+		// (in the same order as InstanceBounds::bounds) so a whole block can be frustum culled with SIMD instructions.
+
+		real_t bounds[6][INSTANCE_CULL_BLOCK_SIZE] = {};
+		uint32_t layer_mask[INSTANCE_CULL_BLOCK_SIZE] = {};
+		uint32_t ignore_culling_mask = 0; // One bit per instance ignoring all culling.
+		uint32_t dynamic_shadow_caster_mask = 0; // One bit per instance tested for directional shadows every frame, see Instance::dynamic_shadow_caster.
+
+		_ALWAYS_INLINE_ void set_bounds(uint32_t p_lane, const InstanceBounds &p_bounds) {
+			for (int i = 0; i < 6; i++) {
+				bounds[i][p_lane] = p_bounds.bounds[i];
+			}
+		}
+		_ALWAYS_INLINE_ void set_ignore_culling(uint32_t p_lane, bool p_ignore) {
+			if (p_ignore) {
+				ignore_culling_mask |= 1 << p_lane;
+			} else {
+				ignore_culling_mask &= ~(1 << p_lane);
+			}
+		}
+		_ALWAYS_INLINE_ void set_dynamic_shadow_caster(uint32_t p_lane, bool p_dynamic) {
+			if (p_dynamic) {
+				dynamic_shadow_caster_mask |= 1 << p_lane;
+			} else {
+				dynamic_shadow_caster_mask &= ~(1 << p_lane);
+			}
+		}
+		_ALWAYS_INLINE_ void copy_lane(uint32_t p_lane, const InstanceCullBlock &p_from, uint32_t p_from_lane) {
+			for (int i = 0; i < 6; i++) {
+				bounds[i][p_lane] = p_from.bounds[i][p_from_lane];
+			}
+			layer_mask[p_lane] = p_from.layer_mask[p_from_lane];
+			set_ignore_culling(p_lane, p_from.ignore_culling_mask & (1 << p_from_lane));
+			set_dynamic_shadow_caster(p_lane, p_from.dynamic_shadow_caster_mask & (1 << p_from_lane));
+		}
+		_ALWAYS_INLINE_ void clear_lane(uint32_t p_lane) {
+			layer_mask[p_lane] = 0;
+			set_ignore_culling(p_lane, false);
+			set_dynamic_shadow_caster(p_lane, false);
+		}
+
+		// Returns one bit per instance which matches the visible layers and is inside the frustum,
+		// with the same (conservative) test as InstanceBounds::in_frustum().
+		uint32_t cull(const Frustum &p_frustum, uint32_t p_visible_layers) const;
+	};
+
 	struct InstanceVisibilityNotifierData;
 
 	struct InstanceData {
@@ -354,8 +403,13 @@ public:
 
 		PagedArray<InstanceBounds> instance_aabbs;
 		PagedArray<InstanceData> instance_data;
+		LocalVector<InstanceCullBlock> instance_cull_blocks; // Mirrors instance_aabbs and layer masks, INSTANCE_CULL_BLOCK_SIZE instances per block.
 		VisibilityArray instance_visibility;
 
+		// Changes whenever a geometry instance which isn't a dynamic shadow caster is added, removed or becomes dynamic,
+		// invalidating the static shadow casters cached by directional lights.
+		uint64_t static_shadow_casters_version = 1;
+
 		Scenario() {
 			indexers[INDEXER_GEOMETRY].set_index(INDEXER_GEOMETRY);
 			indexers[INDEXER_VOLUMES].set_index(INDEXER_VOLUMES);
@@ -439,6 +493,9 @@ public:
 		bool baked_light : 1; // This flag is only to know if it actually did use baked light.
 		bool dynamic_gi : 1; // Same as above for dynamic objects.
 		bool redraw_if_visible : 1;
+		// Changed in a way affecting shadows since it was added to the scenario (or uses a mesh instance or visibility ranges),
+		// so it's tested for directional shadows every frame instead of being cached.
+		bool dynamic_shadow_caster : 1;
 
 		bool on_interpolate_list : 1;
 		bool on_interpolate_transform_list : 1;
@@ -493,6 +550,7 @@ public:
 		//aabb stuff
 		bool update_aabb;
 		bool update_dependencies;
+		bool refit_bvh = false; // Moved by instance_set_transforms() since the last update, refit the BVH instead of reinserting.
 
 		SelfList<Instance> update_item;
 
@@ -598,6 +656,7 @@ public:
 			baked_light = true;
 			dynamic_gi = false;
 			redraw_if_visible = false;
+			dynamic_shadow_caster = false;
 
 			on_interpolate_list = false;
 			on_interpolate_transform_list = false;
@@ -737,6 +796,23 @@ public:
 		RS::LightBakeMode bake_mode;
 		uint32_t max_sdfgi_cascade = 2;
 
+		// Static shadow casters found in each directional shadow cascade. They are reused as long as the cascade,
+		// the camera frustum used for tighter caster culling, the layers and the static instances stay the same.
+		struct ShadowCasterCache {
+			Vector<Plane> cascade_planes;
+			Vector<Plane> camera_planes;
+			uint32_t layer_mask = 0;
+			uint64_t static_version = 0;
+			LocalVector<RenderGeometryInstance *> static_casters;
+		} shadow_caster_cache[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
+
+		void clear_shadow_caster_cache() {
+			for (ShadowCasterCache &cache : shadow_caster_cache) {
+				cache.static_version = 0;
+				cache.static_casters.clear();
+			}
+		}
+
 	private:
 		// Instead of a single dirty flag, we maintain a count
 		// so that we can detect lights that are being made dirty
@@ -926,6 +1002,8 @@ public:
 
 		struct DirectionalShadow {
 			PagedArray<RenderGeometryInstance *> cascade_geometry_instances[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
+			PagedArray<RenderGeometryInstance *> cascade_static_geometry_instances[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES]; // Static casters found while rebuilding the cache.
+			PagedArray<RID> cascade_mesh_instances[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES];
 		} directional_shadows[RendererSceneRender::MAX_DIRECTIONAL_LIGHTS];
 
 		PagedArray<RenderGeometryInstance *> sdfgi_region_geometry_instances[SDFGI_MAX_CASCADES * SDFGI_MAX_REGIONS_PER_CASCADE];
@@ -944,6 +1022,8 @@ public:
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].clear();
+					directional_shadows[i].cascade_static_geometry_instances[j].clear();
+					directional_shadows[i].cascade_mesh_instances[j].clear();
 				}
 			}
 
@@ -969,6 +1049,8 @@ public:
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].reset();
+					directional_shadows[i].cascade_static_geometry_instances[j].reset();
+					directional_shadows[i].cascade_mesh_instances[j].reset();
 				}
 			}
 
@@ -995,6 +1077,8 @@ public:
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].merge_unordered(p_cull_result.directional_shadows[i].cascade_geometry_instances[j]);
+					directional_shadows[i].cascade_static_geometry_instances[j].merge_unordered(p_cull_result.directional_shadows[i].cascade_static_geometry_instances[j]);
+					directional_shadows[i].cascade_mesh_instances[j].merge_unordered(p_cull_result.directional_shadows[i].cascade_mesh_instances[j]);
 				}
 			}
 
@@ -1020,6 +1104,8 @@ public:
 			for (int i = 0; i < RendererSceneRender::MAX_DIRECTIONAL_LIGHTS; i++) {
 				for (int j = 0; j < RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES; j++) {
 					directional_shadows[i].cascade_geometry_instances[j].set_page_pool(p_geometry_instance_pool);
+					directional_shadows[i].cascade_static_geometry_instances[j].set_page_pool(p_geometry_instance_pool);
+					directional_shadows[i].cascade_mesh_instances[j].set_page_pool(p_rid_pool);
 				}
 			}
 
@@ -1059,6 +1145,8 @@ public:
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_pivot_data(RID p_instance, float p_sorting_offset, bool p_use_aabb_center);
 	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform);
+	virtual void instance_set_transforms(const Vector<RID> &p_instances, const Vector<Transform3D> &p_transforms);
+	void _instance_set_transform(Instance *p_instance, const Transform3D &p_transform);
 	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated);
 	virtual void instance_reset_physics_interpolation(RID p_instance);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id);
@@ -1110,6 +1198,7 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance) const;
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance) const;
 	void _unpair_instance(Instance *p_instance);
+	void _instance_set_dynamic_shadow_caster(Instance *p_instance) const;
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform3D p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
@@ -1121,6 +1210,7 @@ public:
 	struct Cull {
 		struct Shadow {
 			RID light_instance;
+			InstanceLightData *light = nullptr;
 			uint32_t caster_mask;
 			struct Cascade {
 				Frustum frustum;
@@ -1134,6 +1224,8 @@ public:
 				real_t range_begin;
 				Vector2 uv_scale;
 
+				bool use_static_casters; // Only dynamic instances need culling, see InstanceLightData::ShadowCasterCache.
+
 			} cascades[RendererSceneRender::MAX_DIRECTIONAL_LIGHT_CASCADES]; //max 4 cascades
 			uint32_t cascade_count;
 
@@ -1184,6 +1276,8 @@ public:
 
 	void _scene_cull_threaded(uint32_t p_thread, CullData *cull_data);
 	void _scene_cull(CullData &cull_data, InstanceCullResult &cull_result, uint64_t p_from, uint64_t p_to);
+	void _scene_cull_directional_shadow_threaded(uint32_t p_index, CullData *cull_data);
+	void _scene_cull_directional_shadow(CullData &cull_data, InstanceCullResult &cull_result, uint32_t p_shadow, uint32_t p_cascade, uint64_t p_from, uint64_t p_to);
 	static void _scene_particles_set_view_axis(RID p_particles, const Vector3 &p_axis, const Vector3 &p_up_axis);
 	_FORCE_INLINE_ bool _visibility_parent_check(const CullData &p_cull_data, const InstanceData &p_instance_data);
 
@@ -2482,6 +2482,19 @@ RenderingDevice::TextureSamples RenderingDevice::framebuffer_format_get_texture_
 	return E->value.pass_samples[p_pass];
 }
 
+bool RenderingDevice::framebuffer_format_get_description(FramebufferFormatID p_format, Vector<AttachmentFormat> &r_attachments, Vector<FramebufferPass> &r_passes, uint32_t &r_view_count) {
+	_THREAD_SAFE_METHOD_
+
+	HashMap<FramebufferFormatID, FramebufferFormat>::Iterator E = framebuffer_formats.find(p_format);
+	ERR_FAIL_COND_V(!E, false);
+
+	const FramebufferFormatKey &key = E->value.E->key();
+	r_attachments = key.attachments;
+	r_passes = key.passes;
+	r_view_count = key.view_count;
+	return true;
+}
+
 RID RenderingDevice::framebuffer_create_empty(const Size2i &p_size, TextureSamples p_samples, FramebufferFormatID p_format_check) {
 	_THREAD_SAFE_METHOD_
 
@@ -2751,6 +2764,14 @@ RenderingDevice::VertexFormatID RenderingDevice::vertex_format_create(const Vect
 	return id;
 }
 
+Vector<RenderingDevice::VertexAttribute> RenderingDevice::vertex_format_get_description(VertexFormatID p_vertex_format) {
+	_THREAD_SAFE_METHOD_
+
+	const VertexDescriptionCache *vd = vertex_formats.getptr(p_vertex_format);
+	ERR_FAIL_NULL_V(vd, Vector<VertexAttribute>());
+	return vd->vertex_formats;
+}
+
 RID RenderingDevice::vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets) {
 	_THREAD_SAFE_METHOD_
 
@@ -2972,6 +2993,7 @@ RID RenderingDevice::shader_create_from_bytecode(const Vector<uint8_t> &p_shader
 	shader->name = name;
 	shader->driver_id = shader_id;
 	shader->layout_hash = driver->shader_get_layout_hash(shader_id);
+	shader->bytecode_hash = hash_murmur3_buffer(p_shader_binary.ptr(), p_shader_binary.size());
 
 	for (int i = 0; i < shader->uniform_sets.size(); i++) {
 		uint32_t format = 0; // No format, default.
@@ -3039,6 +3061,22 @@ uint64_t RenderingDevice::shader_get_vertex_input_attribute_mask(RID p_shader) {
 	return shader->vertex_input_mask;
 }
 
+String RenderingDevice::shader_get_name(RID p_shader) {
+	_THREAD_SAFE_METHOD_
+
+	const Shader *shader = shader_owner.get_or_null(p_shader);
+	ERR_FAIL_NULL_V(shader, String());
+	return shader->name;
+}
+
+uint32_t RenderingDevice::shader_get_bytecode_hash(RID p_shader) {
+	_THREAD_SAFE_METHOD_
+
+	const Shader *shader = shader_owner.get_or_null(p_shader);
+	ERR_FAIL_NULL_V(shader, 0);
+	return shader->bytecode_hash;
+}
+
 /******************/
 /**** UNIFORMS ****/
 /******************/
@@ -535,6 +535,8 @@ public:
 	FramebufferFormatID framebuffer_format_create_multipass(const Vector<AttachmentFormat> &p_attachments, const Vector<FramebufferPass> &p_passes, uint32_t p_view_count = 1);
 	FramebufferFormatID framebuffer_format_create_empty(TextureSamples p_samples = TEXTURE_SAMPLES_1);
 	TextureSamples framebuffer_format_get_texture_samples(FramebufferFormatID p_format, uint32_t p_pass = 0);
+	// Returns the description the format was created from, which, unlike its ID, is the same across runs.
+	bool framebuffer_format_get_description(FramebufferFormatID p_format, Vector<AttachmentFormat> &r_attachments, Vector<FramebufferPass> &r_passes, uint32_t &r_view_count);
 
 	RID framebuffer_create(const Vector<RID> &p_texture_attachments, FramebufferFormatID p_format_check = INVALID_ID, uint32_t p_view_count = 1);
 	RID framebuffer_create_multipass(const Vector<RID> &p_texture_attachments, const Vector<FramebufferPass> &p_passes, FramebufferFormatID p_format_check = INVALID_ID, uint32_t p_view_count = 1);
@@ -685,6 +687,7 @@ public:
 
 	// This ID is warranted to be unique for the same formats, does not need to be freed
 	VertexFormatID vertex_format_create(const Vector<VertexAttribute> &p_vertex_descriptions);
+	Vector<VertexAttribute> vertex_format_get_description(VertexFormatID p_vertex_format);
 	RID vertex_array_create(uint32_t p_vertex_count, VertexFormatID p_vertex_format, const Vector<RID> &p_src_buffers, const Vector<uint64_t> &p_offsets = Vector<uint64_t>());
 
 	RID index_buffer_create(uint32_t p_size_indices, IndexBufferFormat p_format, const Vector<uint8_t> &p_data = Vector<uint8_t>(), bool p_use_restart_indices = false);
@@ -749,6 +752,7 @@ private:
 		String name; // Used for debug.
 		RDD::ShaderID driver_id;
 		uint32_t layout_hash = 0;
+		uint32_t bytecode_hash = 0; // Identifies the compiled code across runs, unlike the RID.
 		BitField<RDD::PipelineStageBits> stage_bits;
 		Vector<uint32_t> set_formats;
 	};
@@ -845,6 +849,8 @@ public:
 	RID shader_create_placeholder();
 
 	uint64_t shader_get_vertex_input_attribute_mask(RID p_shader);
+	String shader_get_name(RID p_shader);
+	uint32_t shader_get_bytecode_hash(RID p_shader);
 
 	/******************/
 	/**** UNIFORMS ****/
@@ -31,7 +31,10 @@
 #include "shader_compiler.h"
 
 #include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
 #include "core/os/os.h"
+#include "core/version.h"
 #include "servers/rendering/rendering_server_globals.h"
 #include "servers/rendering/shader_types.h"
 
@@ -1477,7 +1480,343 @@ ShaderLanguage::DataType ShaderCompiler::_get_global_shader_uniform_type(const S
 	return (ShaderLanguage::DataType)RS::global_shader_uniform_type_get_shader_datatype(gvt);
 }
 
+String ShaderCompiler::cache_dir;
+
+String ShaderCompiler::_get_cache_key(RS::ShaderMode p_mode, const String &p_code, const IdentifierActions &p_actions) const {
+	// Generated code depends on the names in the identifier actions, but not on the pointers they hold.
+	String key = vformat("%s|%s|%d|%d|%s|%x|", VERSION_FULL_BUILD, VERSION_HASH, p_mode, RS::get_singleton()->is_low_end(), OS::get_singleton()->get_current_rendering_method(), actions_hash);
+	for (const KeyValue<StringName, Stage> &E : p_actions.entry_point_stages) {
+		key += String(E.key) + ":" + itos(E.value) + ",";
+	}
+	for (const KeyValue<StringName, Pair<int *, int>> &E : p_actions.render_mode_values) {
+		key += String(E.key) + ":" + itos(E.value.second) + ",";
+	}
+	for (const HashMap<StringName, bool *> *flags : { &p_actions.render_mode_flags, &p_actions.usage_flag_pointers, &p_actions.write_flag_pointers }) {
+		key += "|";
+		for (const KeyValue<StringName, bool *> &E : *flags) {
+			key += String(E.key) + ",";
+		}
+	}
+	// Global uniforms are validated against the project's global shader parameters in the editor.
+	if (Engine::get_singleton()->is_editor_hint() && p_code.contains("global")) {
+		key += "|";
+		for (const StringName &name : RSG::material_storage->global_shader_parameter_get_list()) {
+			key += String(name) + ":" + itos(RSG::material_storage->global_shader_parameter_get_type(name)) + ",";
+		}
+	}
+	return (key + "|" + p_code).sha256_text();
+}
+
+bool ShaderCompiler::_load_cached_code(const String &p_path, IdentifierActions *p_actions, GeneratedCode &r_gen_code) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ);
+	if (f.is_null()) {
+		return false;
+	}
+	const Variant cached_variant = f->get_var();
+	if (cached_variant.get_type() != Variant::DICTIONARY) {
+		return false;
+	}
+
+	// The whole entry is checked before anything is written to the actions or the generated code,
+	// so a corrupt entry falls back to compiling without leaving stale flags behind.
+	static const Pair<const char *, Variant::Type> fields[] = {
+		{ "defines", Variant::PACKED_STRING_ARRAY },
+		{ "texture_uniforms", Variant::ARRAY },
+		{ "uniform_offsets", Variant::PACKED_INT32_ARRAY },
+		{ "uniform_total_size", Variant::INT },
+		{ "uniforms", Variant::STRING },
+		{ "stage_globals", Variant::PACKED_STRING_ARRAY },
+		{ "code", Variant::DICTIONARY },
+		{ "uses", Variant::INT },
+		{ "render_modes", Variant::PACKED_STRING_ARRAY },
+		{ "usage_flags", Variant::PACKED_STRING_ARRAY },
+		{ "write_flags", Variant::PACKED_STRING_ARRAY },
+		{ "uniform_nodes", Variant::DICTIONARY },
+	};
+	const Dictionary cached = cached_variant;
+	for (const Pair<const char *, Variant::Type> &field : fields) {
+		ERR_FAIL_COND_V(cached.get(field.first, Variant()).get_type() != field.second, false);
+	}
+
+	GeneratedCode gen_code;
+	gen_code.defines = PackedStringArray(cached["defines"]);
+	Array textures = cached["texture_uniforms"];
+	for (int i = 0; i < textures.size(); i++) {
+		Array t = textures[i];
+		ERR_FAIL_COND_V(t.size() != 8, false);
+		GeneratedCode::Texture texture;
+		texture.name = t[0];
+		texture.type = SL::DataType(int(t[1]));
+		texture.hint = SL::ShaderNode::Uniform::Hint(int(t[2]));
+		texture.use_color = t[3];
+		texture.filter = SL::TextureFilter(int(t[4]));
+		texture.repeat = SL::TextureRepeat(int(t[5]));
+		texture.global = t[6];
+		texture.array_size = t[7];
+		gen_code.texture_uniforms.push_back(texture);
+	}
+	PackedInt32Array uniform_offsets = cached["uniform_offsets"];
+	for (int32_t offset : uniform_offsets) {
+		gen_code.uniform_offsets.push_back(offset);
+	}
+	gen_code.uniform_total_size = cached["uniform_total_size"];
+	gen_code.uniforms = cached["uniforms"];
+	PackedStringArray stage_globals = cached["stage_globals"];
+	ERR_FAIL_COND_V(stage_globals.size() != STAGE_MAX, false);
+	for (int i = 0; i < STAGE_MAX; i++) {
+		gen_code.stage_globals[i] = stage_globals[i];
+	}
+	Dictionary code = cached["code"];
+	Array code_keys = code.keys();
+	for (int i = 0; i < code_keys.size(); i++) {
+		ERR_FAIL_COND_V(code_keys[i].get_type() != Variant::STRING || code[code_keys[i]].get_type() != Variant::STRING, false);
+		gen_code.code[code_keys[i]] = code[code_keys[i]];
+	}
+	uint32_t uses = cached["uses"];
+	gen_code.uses_global_textures = uses & (1 << 0);
+	gen_code.uses_fragment_time = uses & (1 << 1);
+	gen_code.uses_vertex_time = uses & (1 << 2);
+	gen_code.uses_screen_texture_mipmaps = uses & (1 << 3);
+	gen_code.uses_screen_texture = uses & (1 << 4);
+	gen_code.uses_depth_texture = uses & (1 << 5);
+	gen_code.uses_normal_roughness_texture = uses & (1 << 6);
+
+	HashMap<StringName, SL::ShaderNode::Uniform> uniforms;
+	if (p_actions->uniforms) {
+		Dictionary uniform_nodes = cached["uniform_nodes"];
+		Array uniform_names = uniform_nodes.keys();
+		for (int i = 0; i < uniform_names.size(); i++) {
+			Array u = uniform_nodes[uniform_names[i]];
+			ERR_FAIL_COND_V(u.size() != 18, false);
+			SL::ShaderNode::Uniform uniform;
+			uniform.order = u[0];
+			uniform.prop_order = u[1];
+			uniform.texture_order = u[2];
+			uniform.texture_binding = u[3];
+			uniform.type = SL::DataType(int(u[4]));
+			uniform.precision = SL::DataPrecision(int(u[5]));
+			uniform.array_size = u[6];
+			PackedInt32Array default_value = u[7];
+			uniform.default_value.resize(default_value.size());
+			for (int j = 0; j < default_value.size(); j++) {
+				uniform.default_value.write[j].sint = default_value[j];
+			}
+			uniform.scope = SL::ShaderNode::Uniform::Scope(int(u[8]));
+			uniform.hint = SL::ShaderNode::Uniform::Hint(int(u[9]));
+			uniform.use_color = u[10];
+			uniform.filter = SL::TextureFilter(int(u[11]));
+			uniform.repeat = SL::TextureRepeat(int(u[12]));
+			PackedFloat32Array hint_range = u[13];
+			ERR_FAIL_COND_V(hint_range.size() != 3, false);
+			for (int j = 0; j < 3; j++) {
+				uniform.hint_range[j] = hint_range[j];
+			}
+			uniform.hint_enum_names = u[14];
+			uniform.instance_index = u[15];
+			uniform.group = u[16];
+			uniform.subgroup = u[17];
+			uniforms.insert(uniform_names[i], uniform);
+		}
+	}
+
+	r_gen_code = gen_code;
+
+	// Replay what compiling reported through the identifier actions.
+	PackedStringArray render_modes = cached["render_modes"];
+	for (const String &name : render_modes) {
+		if (Pair<int *, int> *value = p_actions->render_mode_values.getptr(name)) {
+			*value->first = value->second;
+		}
+		if (bool **flag = p_actions->render_mode_flags.getptr(name)) {
+			**flag = true;
+		}
+	}
+	PackedStringArray usage_flags = cached["usage_flags"];
+	for (const String &name : usage_flags) {
+		if (bool **flag = p_actions->usage_flag_pointers.getptr(name)) {
+			**flag = true;
+		}
+	}
+	PackedStringArray write_flags = cached["write_flags"];
+	for (const String &name : write_flags) {
+		if (bool **flag = p_actions->write_flag_pointers.getptr(name)) {
+			**flag = true;
+		}
+	}
+	for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : uniforms) {
+		p_actions->uniforms->insert(E.key, E.value);
+	}
+
+	return true;
+}
+
+void ShaderCompiler::_save_cached_code(const String &p_path, const IdentifierActions *p_actions, const GeneratedCode &p_gen_code) const {
+	Dictionary cached;
+	cached["defines"] = PackedStringArray(p_gen_code.defines);
+	Array textures;
+	for (const GeneratedCode::Texture &texture : p_gen_code.texture_uniforms) {
+		Array t;
+		t.push_back(texture.name);
+		t.push_back(texture.type);
+		t.push_back(texture.hint);
+		t.push_back(texture.use_color);
+		t.push_back(texture.filter);
+		t.push_back(texture.repeat);
+		t.push_back(texture.global);
+		t.push_back(texture.array_size);
+		textures.push_back(t);
+	}
+	cached["texture_uniforms"] = textures;
+	PackedInt32Array uniform_offsets;
+	for (uint32_t offset : p_gen_code.uniform_offsets) {
+		uniform_offsets.push_back(offset);
+	}
+	cached["uniform_offsets"] = uniform_offsets;
+	cached["uniform_total_size"] = p_gen_code.uniform_total_size;
+	cached["uniforms"] = p_gen_code.uniforms;
+	PackedStringArray stage_globals;
+	for (int i = 0; i < STAGE_MAX; i++) {
+		stage_globals.push_back(p_gen_code.stage_globals[i]);
+	}
+	cached["stage_globals"] = stage_globals;
+	Dictionary code;
+	for (const KeyValue<String, String> &E : p_gen_code.code) {
+		code[E.key] = E.value;
+	}
+	cached["code"] = code;
+	uint32_t uses = 0;
+	uses |= p_gen_code.uses_global_textures ? (1 << 0) : 0;
+	uses |= p_gen_code.uses_fragment_time ? (1 << 1) : 0;
+	uses |= p_gen_code.uses_vertex_time ? (1 << 2) : 0;
+	uses |= p_gen_code.uses_screen_texture_mipmaps ? (1 << 3) : 0;
+	uses |= p_gen_code.uses_screen_texture ? (1 << 4) : 0;
+	uses |= p_gen_code.uses_depth_texture ? (1 << 5) : 0;
+	uses |= p_gen_code.uses_normal_roughness_texture ? (1 << 6) : 0;
+	cached["uses"] = uses;
+
+	// The actions only hold pointers, so what compiling reported is recorded by name. Names sharing a pointer with
+	// a reported one are recorded too, which doesn't change the result when replayed.
+	PackedStringArray render_modes;
+	for (const KeyValue<StringName, Pair<int *, int>> &E : p_actions->render_mode_values) {
+		if (*E.value.first == E.value.second) {
+			render_modes.push_back(E.key);
+		}
+	}
+	for (const KeyValue<StringName, bool *> &E : p_actions->render_mode_flags) {
+		if (*E.value) {
+			render_modes.push_back(E.key);
+		}
+	}
+	cached["render_modes"] = render_modes;
+	PackedStringArray usage_flags;
+	for (const KeyValue<StringName, bool *> &E : p_actions->usage_flag_pointers) {
+		if (*E.value) {
+			usage_flags.push_back(E.key);
+		}
+	}
+	cached["usage_flags"] = usage_flags;
+	PackedStringArray write_flags;
+	for (const KeyValue<StringName, bool *> &E : p_actions->write_flag_pointers) {
+		if (*E.value) {
+			write_flags.push_back(E.key);
+		}
+	}
+	cached["write_flags"] = write_flags;
+
+	Dictionary uniforms;
+	if (p_actions->uniforms) {
+		for (const KeyValue<StringName, SL::ShaderNode::Uniform> &E : shader->uniforms) {
+			const SL::ShaderNode::Uniform *uniform = p_actions->uniforms->getptr(E.key);
+			if (!uniform) {
+				continue;
+			}
+			Array u;
+			u.push_back(uniform->order);
+			u.push_back(uniform->prop_order);
+			u.push_back(uniform->texture_order);
+			u.push_back(uniform->texture_binding);
+			u.push_back(uniform->type);
+			u.push_back(uniform->precision);
+			u.push_back(uniform->array_size);
+			PackedInt32Array default_value;
+			for (const SL::Scalar &scalar : uniform->default_value) {
+				default_value.push_back(scalar.sint);
+			}
+			u.push_back(default_value);
+			u.push_back(uniform->scope);
+			u.push_back(uniform->hint);
+			u.push_back(uniform->use_color);
+			u.push_back(uniform->filter);
+			u.push_back(uniform->repeat);
+			u.push_back(PackedFloat32Array{ uniform->hint_range[0], uniform->hint_range[1], uniform->hint_range[2] });
+			u.push_back(uniform->hint_enum_names);
+			u.push_back(uniform->instance_index);
+			u.push_back(uniform->group);
+			u.push_back(uniform->subgroup);
+			uniforms[E.key] = u;
+		}
+	}
+	cached["uniform_nodes"] = uniforms;
+
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(f.is_null(), "Can't save the generated shader code to the cache: " + p_path);
+	f->store_var(cached);
+}
+
+ShaderCompiler *ShaderCompiler::_acquire_helper() {
+	MutexLock lock(helpers_mutex);
+	if (!idle_helpers.is_empty()) {
+		ShaderCompiler *helper = idle_helpers[idle_helpers.size() - 1];
+		idle_helpers.resize(idle_helpers.size() - 1);
+		return helper;
+	}
+	ShaderCompiler *helper = memnew(ShaderCompiler);
+	helper->initialize(actions);
+	return helper;
+}
+
+void ShaderCompiler::_release_helper(ShaderCompiler *p_helper) {
+	MutexLock lock(helpers_mutex);
+	idle_helpers.push_back(p_helper);
+}
+
 Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+	String cache_path;
+	if (!cache_dir.is_empty()) {
+		cache_path = cache_dir.path_join(_get_cache_key(p_mode, p_code, *p_actions) + ".cache");
+		if (_load_cached_code(cache_path, p_actions, r_gen_code)) {
+			return OK;
+		}
+	}
+
+	if (compile_mutex.try_lock()) {
+		Error err = _compile(p_mode, p_code, p_actions, p_path, cache_path, r_gen_code);
+		compile_mutex.unlock();
+		return err;
+	}
+
+	ShaderCompiler *helper = _acquire_helper();
+	Error err = helper->_compile(p_mode, p_code, p_actions, p_path, cache_path, r_gen_code);
+	_release_helper(helper);
+	return err;
+}
+
+void ShaderCompiler::set_cache_dir(const String &p_dir) {
+	cache_dir = p_dir;
+	if (!cache_dir.is_empty()) {
+		Error err = DirAccess::make_dir_recursive_absolute(cache_dir);
+		if (err != OK) {
+			ERR_PRINT("Can't create the generated shader code cache folder: " + cache_dir);
+			cache_dir = String();
+		}
+	}
+}
+
+String ShaderCompiler::get_cache_dir() {
+	return cache_dir;
+}
+
+Error ShaderCompiler::_compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, const String &p_cache_path, GeneratedCode &r_gen_code) {
 	SL::ShaderCompileInfo info;
 	info.functions = ShaderTypes::get_singleton()->get_functions(p_mode);
 	info.render_modes = ShaderTypes::get_singleton()->get_modes(p_mode);
@@ -1582,12 +1921,44 @@ Error ShaderCompiler::compile(RS::ShaderMode p_mode, const String &p_code, Ident
 	function = nullptr;
 	_dump_node_code(shader, 1, r_gen_code, *p_actions, actions, false);
 
+	if (!p_cache_path.is_empty()) {
+		_save_cached_code(p_cache_path, p_actions, r_gen_code);
+	}
+
 	return OK;
 }
 
 void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 	actions = p_actions;
 
+	{
+		MutexLock lock(helpers_mutex);
+		for (ShaderCompiler *helper : idle_helpers) {
+			memdelete(helper);
+		}
+		idle_helpers.clear();
+	}
+
+	uint32_t h = HASH_MURMUR3_SEED;
+	for (const HashMap<StringName, String> *map : { &actions.renames, &actions.render_mode_defines, &actions.usage_defines, &actions.custom_samplers }) {
+		for (const KeyValue<StringName, String> &E : *map) {
+			h = hash_murmur3_one_32(E.key.hash(), h);
+			h = hash_murmur3_one_32(E.value.hash(), h);
+		}
+		h = hash_murmur3_one_32(map->size(), h);
+	}
+	h = hash_murmur3_one_32(actions.default_filter, h);
+	h = hash_murmur3_one_32(actions.default_repeat, h);
+	h = hash_murmur3_one_32(actions.base_texture_binding_index, h);
+	h = hash_murmur3_one_32(actions.texture_layout_set, h);
+	h = hash_murmur3_one_32(actions.base_uniform_string.hash(), h);
+	h = hash_murmur3_one_32(actions.global_buffer_array_variable.hash(), h);
+	h = hash_murmur3_one_32(actions.instance_uniform_index_variable.hash(), h);
+	h = hash_murmur3_one_32(actions.base_varying_index, h);
+	h = hash_murmur3_one_32(actions.apply_luminance_multiplier, h);
+	h = hash_murmur3_one_32(actions.check_multiview_samplers, h);
+	actions_hash = hash_fmix32(h);
+
 	time_name = "TIME";
 
 	List<String> func_list;
@@ -1612,3 +1983,9 @@ void ShaderCompiler::initialize(DefaultIdentifierActions p_actions) {
 
 ShaderCompiler::ShaderCompiler() {
 }
+
+ShaderCompiler::~ShaderCompiler() {
+	for (ShaderCompiler *helper : idle_helpers) {
+		memdelete(helper);
+	}
+}
@@ -31,6 +31,8 @@
 #ifndef SHADER_COMPILER_H
 #define SHADER_COMPILER_H
 
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
 #include "servers/rendering/shader_language.h"
 #include "servers/rendering_server.h"
@@ -124,14 +126,39 @@ private:
 	HashSet<StringName> fragment_varyings;
 
 	DefaultIdentifierActions actions;
+	uint32_t actions_hash = 0;
+
+	// The parser and code generator keep state while compiling, so concurrent calls
+	// (e.g. from resource loading tasks on the WorkerThreadPool) borrow helper compilers with the same actions.
+	Mutex compile_mutex;
+	Mutex helpers_mutex;
+	LocalVector<ShaderCompiler *> idle_helpers;
+
+	ShaderCompiler *_acquire_helper();
+	void _release_helper(ShaderCompiler *p_helper);
+
+	// Generated code is cached on disk by a hash of the shader code and everything else it depends on,
+	// so unchanged shaders skip parsing and code generation on later runs.
+	static String cache_dir;
+
+	String _get_cache_key(RS::ShaderMode p_mode, const String &p_code, const IdentifierActions &p_actions) const;
+	static bool _load_cached_code(const String &p_path, IdentifierActions *p_actions, GeneratedCode &r_gen_code);
+	void _save_cached_code(const String &p_path, const IdentifierActions *p_actions, const GeneratedCode &p_gen_code) const;
+
+	Error _compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, const String &p_cache_path, GeneratedCode &r_gen_code);
 
 	static ShaderLanguage::DataType _get_global_shader_uniform_type(const StringName &p_name);
 
 public:
+	// Safe to call from multiple threads at once.
 	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
 
+	static void set_cache_dir(const String &p_dir);
+	static String get_cache_dir();
+
 	void initialize(DefaultIdentifierActions p_actions);
 	ShaderCompiler();
+	~ShaderCompiler();
 };
 
 #endif // SHADER_COMPILER_H
@@ -725,9 +725,8 @@ ShaderLanguage::Token ShaderLanguage::_get_token() {
 
 					static bool suffix_lut[CASE_MAX][127];
 
-					if (!is_const_suffix_lut_initialized) {
-						is_const_suffix_lut_initialized = true;
-
+					// Shaders can be compiled from several threads at once, so the table is filled by a thread-safe static initializer.
+					static const bool is_const_suffix_lut_initialized = [] {
 						for (int i = 0; i < 127; i++) {
 							char t = char(i);
 
@@ -737,7 +736,9 @@ ShaderLanguage::Token ShaderLanguage::_get_token() {
 							suffix_lut[CASE_SIGN_AFTER_EXPONENT][i] = t == 'f';
 							suffix_lut[CASE_NONE][i] = false;
 						}
-					}
+						return true;
+					}();
+					(void)is_const_suffix_lut_initialized;
 
 					String str;
 					int i = 0;
@@ -3543,8 +3544,6 @@ const ShaderLanguage::BuiltinEntry ShaderLanguage::frag_only_func_defs[] = {
 	{ nullptr }
 };
 
-bool ShaderLanguage::is_const_suffix_lut_initialized = false;
-
 bool ShaderLanguage::_validate_function_call(BlockNode *p_block, const FunctionInfo &p_function_info, OperatorNode *p_func, DataType *r_ret_type, StringName *r_ret_type_str, bool *r_is_custom_function) {
 	ERR_FAIL_COND_V(p_func->op != OP_CALL && p_func->op != OP_CONSTRUCT, false);
 
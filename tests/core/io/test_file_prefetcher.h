@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*  test_file_prefetcher.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FILE_PREFETCHER_H
+#define TEST_FILE_PREFETCHER_H
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/file_prefetcher.h"
+#include "core/os/os.h"
+
+#include "tests/test_utils.h"
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestFilePrefetcher {
+
+// Waits until the I/O thread has gone through its queue.
+static bool wait_for_prefetcher(FilePrefetcher *p_prefetcher) {
+	for (int i = 0; i < 500; i++) {
+		if (p_prefetcher->get_queue_depth() == 0) {
+			return true;
+		}
+		OS::get_singleton()->delay_usec(10000);
+	}
+	return false;
+}
+
+static void store_text(const String &p_path, const String &p_text) {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(f.is_valid());
+	f->store_string(p_text);
+}
+
+TEST_CASE("[FilePrefetcher] Dependencies are read ahead only when enabled") {
+	FilePrefetcher *prefetcher = FilePrefetcher::get_singleton();
+	REQUIRE(prefetcher);
+	const bool was_enabled = prefetcher->is_enabled();
+
+	// A scene using a resource, which uses another one, and a missing one.
+	const String scene_path = TestUtils::get_temp_path("prefetched_scene.tscn");
+	const String resource_path = TestUtils::get_temp_path("prefetched_resource.tres");
+	const String nested_path = TestUtils::get_temp_path("prefetched_nested.tres");
+	store_text(nested_path, "[gd_resource type=\"Resource\" format=3]\n\n[resource]\n");
+	store_text(resource_path, vformat("[gd_resource type=\"Resource\" load_steps=2 format=3]\n\n[ext_resource type=\"Resource\" path=\"%s\" id=\"1\"]\n\n[resource]\nmetadata/nested = ExtResource(\"1\")\n", nested_path));
+	store_text(scene_path, vformat("[gd_scene load_steps=3 format=3]\n\n[ext_resource type=\"Resource\" path=\"%s\" id=\"1\"]\n[ext_resource type=\"Resource\" path=\"%s\" id=\"2\"]\n\n[node name=\"Root\" type=\"Node\"]\nmetadata/resource = ExtResource(\"1\")\n", resource_path, TestUtils::get_temp_path("prefetched_missing.tres")));
+	const uint64_t dependencies_size = FileAccess::get_file_as_bytes(resource_path).size() + FileAccess::get_file_as_bytes(nested_path).size();
+
+	SUBCASE("Disabled") {
+		prefetcher->set_enabled(false);
+		const uint64_t files_before = prefetcher->get_files_prefetched();
+		prefetcher->prefetch(scene_path);
+		CHECK(prefetcher->get_queue_depth() == 0);
+		CHECK(prefetcher->get_files_prefetched() == files_before);
+	}
+
+#ifdef THREADS_ENABLED
+	SUBCASE("Enabled") {
+		prefetcher->set_enabled(true);
+		REQUIRE(prefetcher->is_enabled());
+		const uint64_t files_before = prefetcher->get_files_prefetched();
+		const uint64_t bytes_before = prefetcher->get_bytes_prefetched();
+
+		// The scene is left to its loader, its two levels of existing dependencies are read.
+		prefetcher->prefetch(scene_path);
+		REQUIRE(wait_for_prefetcher(prefetcher));
+		CHECK(prefetcher->get_files_prefetched() == files_before + 2);
+		CHECK(prefetcher->get_bytes_prefetched() == bytes_before + dependencies_size);
+
+		// Recently requested files aren't read again.
+		prefetcher->prefetch(scene_path);
+		prefetcher->prefetch(resource_path);
+		REQUIRE(wait_for_prefetcher(prefetcher));
+		CHECK(prefetcher->get_files_prefetched() == files_before + 2);
+	}
+#endif
+
+	prefetcher->set_enabled(was_enabled);
+	DirAccess::remove_absolute(scene_path);
+	DirAccess::remove_absolute(resource_path);
+	DirAccess::remove_absolute(nested_path);
+}
+
+} // namespace TestFilePrefetcher
+
+#endif // TEST_FILE_PREFETCHER_H
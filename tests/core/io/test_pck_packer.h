@@ -33,6 +33,8 @@
 
 #include "core/io/file_access_pack.h"
 #include "core/io/pck_packer.h"
+#include "core/math/random_number_generator.h"
+#include "core/object/script_language.h"
 #include "core/os/os.h"
 
 #include "tests/test_utils.h"
@@ -117,6 +119,186 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 27000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Load a PCK file with compressed and duplicate files") {
+	// Compressible contents spanning several compression blocks.
+	String text;
+	for (int i = 0; i < 20000; i++) {
+		text += itos(i) + "\n";
+	}
+	const CharString text_utf8 = text.utf8();
+	const String text_path = TestUtils::get_temp_path("pck_text.txt");
+	{
+		Ref<FileAccess> f = FileAccess::open(text_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(text);
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = TestUtils::get_temp_path("output_compressed.pck");
+	CHECK_MESSAGE(
+			pck_packer.pck_start(output_pck_path) == OK,
+			"Starting a PCK file should return an OK error code.");
+
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+
+	pck_packer.set_compression(true);
+	CHECK_MESSAGE(
+			pck_packer.add_file("pck_test/text.txt", text_path) == OK,
+			"Adding a compressed file to the PCK should return an OK error code.");
+	CHECK_MESSAGE(
+			pck_packer.add_file("pck_test/copy/text.txt", text_path) == OK,
+			"Adding a file with the same contents to the PCK should return an OK error code.");
+	pck_packer.set_compression(false);
+	CHECK_MESSAGE(
+			pck_packer.add_file("pck_test/icon.svg", base_dir.path_join("../icon.svg")) == OK,
+			"Adding an uncompressed file to the PCK should return an OK error code.");
+	CHECK_MESSAGE(
+			pck_packer.flush() == OK,
+			"Flushing the PCK should return an OK error code.");
+
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_bytes(output_pck_path).size() < text_utf8.length(),
+			"The generated PCK file should store the text compressed and only once.");
+
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_string("res://pck_test/text.txt") == text,
+			"The compressed file should be read back with its original contents.");
+
+	Ref<FileAccess> f = FileAccess::open("res://pck_test/copy/text.txt", FileAccess::READ);
+	REQUIRE(f.is_valid());
+	CHECK_MESSAGE(
+			f->get_length() == (uint64_t)text_utf8.length(),
+			"The duplicate file should have the length of the original file.");
+	f->seek(100000);
+	uint8_t buf[16];
+	f->get_buffer(buf, 16);
+	CHECK_MESSAGE(
+			memcmp(buf, text_utf8.get_data() + 100000, 16) == 0,
+			"Reading from the middle of a compressed file should return the original contents.");
+
+	Ref<DirAccess> da = PackedData::get_singleton()->try_open_directory("res://pck_test");
+	REQUIRE(da.is_valid());
+	CHECK_MESSAGE(
+			da->file_exists("icon.svg"),
+			"Files in the PCK should be listed in their directory.");
+	CHECK_MESSAGE(
+			da->dir_exists("copy"),
+			"Subdirectories in the PCK should be listed in their directory.");
+
+	PackedData::get_singleton()->clear();
+}
+
+TEST_CASE("[PCKPacker] Incompressible files are stored as is") {
+	// Random bytes spanning several compression blocks don't get smaller when compressed.
+	Vector<uint8_t> noise;
+	noise.resize(3 * 65536 + 100);
+	RandomNumberGenerator rng;
+	rng.set_seed(1234);
+	for (int i = 0; i < noise.size(); i++) {
+		noise.write[i] = rng.randi() & 0xFF;
+	}
+	const String noise_path = TestUtils::get_temp_path("pck_noise.bin");
+	{
+		Ref<FileAccess> f = FileAccess::open(noise_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_buffer(noise);
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = TestUtils::get_temp_path("output_incompressible.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	pck_packer.set_compression(true);
+	REQUIRE(pck_packer.add_file("pck_noise/noise.bin", noise_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_bytes("res://pck_noise/noise.bin") == noise,
+			"The incompressible file should be read back with its original contents.");
+	PackedData::get_singleton()->clear();
+}
+
+TEST_CASE("[PCKPacker] Files opened from a PCK are views of one mapping") {
+	PCKPacker pck_packer;
+	const String output_pck_path = TestUtils::get_temp_path("output_mapped.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+	REQUIRE(pck_packer.add_file("pck_mapped/icon.svg", base_dir.path_join("../icon.svg")) == OK);
+	REQUIRE(pck_packer.add_file("pck_mapped/icon.png", base_dir.path_join("../icon.png")) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+
+	const Vector<uint8_t> svg = FileAccess::get_file_as_bytes(base_dir.path_join("../icon.svg"));
+	Ref<FileAccess> svg_file = FileAccess::open("res://pck_mapped/icon.svg", FileAccess::READ);
+	Ref<FileAccess> png_file = FileAccess::open("res://pck_mapped/icon.png", FileAccess::READ);
+	REQUIRE(svg_file.is_valid());
+	REQUIRE(png_file.is_valid());
+
+#ifdef UNIX_ENABLED
+	String pack;
+	uint64_t svg_offset = 0;
+	uint64_t png_offset = 0;
+	uint64_t size = 0;
+	REQUIRE(PackedData::get_singleton()->get_file_location("res://pck_mapped/icon.svg", pack, svg_offset, size));
+	REQUIRE(PackedData::get_singleton()->get_file_location("res://pck_mapped/icon.png", pack, png_offset, size));
+
+	const uint8_t *svg_mapping = svg_file->get_read_only_mapping();
+	const uint8_t *png_mapping = png_file->get_read_only_mapping();
+	REQUIRE(svg_mapping != nullptr);
+	REQUIRE(png_mapping != nullptr);
+	CHECK_MESSAGE(
+			int64_t(png_mapping - svg_mapping) == int64_t(png_offset) - int64_t(svg_offset),
+			"Both files should point into the same mapping of the pack.");
+	CHECK(memcmp(svg_mapping, svg.ptr(), svg.size()) == 0);
+#endif
+
+	// Open files keep the mapping alive after the pack is removed.
+	PackedData::get_singleton()->clear();
+	CHECK(svg_file->get_length() == (uint64_t)svg.size());
+	CHECK(svg_file->get_buffer(svg_file->get_length()) == svg);
+}
+TEST_CASE("[PCKPacker] Encrypted files are read back from the mapped pack") {
+	String text;
+	for (int i = 0; i < 20000; i++) {
+		text += itos(i) + "\n";
+	}
+	const String text_path = TestUtils::get_temp_path("pck_encrypted.txt");
+	{
+		Ref<FileAccess> f = FileAccess::open(text_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(text);
+	}
+
+	// Files are decrypted with the key the engine was built with.
+	String key;
+	for (int i = 0; i < 32; i++) {
+		key += String::num_int64(script_encryption_key[i], 16).lpad(2, "0");
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = TestUtils::get_temp_path("output_encrypted.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path, 32, key) == OK);
+	REQUIRE(pck_packer.add_file("pck_encrypted/text.txt", text_path, true) == OK);
+	pck_packer.set_compression(true);
+	REQUIRE(pck_packer.add_file("pck_encrypted/encrypted_with_compression.txt", text_path, true) == OK);
+	REQUIRE(pck_packer.add_file("pck_encrypted/compressed.txt", text_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, true, 0) == OK);
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_string("res://pck_encrypted/text.txt") == text,
+			"The encrypted file should be read back with its original contents.");
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_string("res://pck_encrypted/encrypted_with_compression.txt") == text,
+			"Encrypted files are stored uncompressed, and should be read back with their original contents.");
+	CHECK_MESSAGE(
+			FileAccess::get_file_as_string("res://pck_encrypted/compressed.txt") == text,
+			"The compressed file should be read back with its original contents.");
+	PackedData::get_singleton()->clear();
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
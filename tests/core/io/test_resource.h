@@ -34,6 +34,7 @@
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
 #include "thirdparty/doctest/doctest.h"
@@ -112,6 +113,134 @@ TEST_CASE("[Resource] Saving and loading") {
 			"The loaded child resource name should be equal to the expected value.");
 }
 
+TEST_CASE("[Resource] Loading large binary resources") {
+	// Large enough for the binary loader to read it through a memory mapping where supported.
+	PackedByteArray bytes;
+	bytes.resize(256 * 1024);
+	for (int i = 0; i < bytes.size(); i++) {
+		bytes.set(i, i % 251);
+	}
+	PackedVector3Array vertices;
+	vertices.resize(4096);
+	for (int i = 0; i < vertices.size(); i++) {
+		vertices.set(i, Vector3(i, -i, i * 0.5));
+	}
+
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Large resource");
+	resource->set_meta("bytes", bytes);
+	resource->set_meta("vertices", vertices);
+	Ref<Resource> child_resource = memnew(Resource);
+	child_resource->set_name("I'm a child resource");
+	resource->set_meta("other_resource", child_resource);
+	const String save_path = TestUtils::get_temp_path("large_resource.res");
+	ResourceSaver::save(resource, save_path);
+
+	const Ref<Resource> &loaded_resource = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded_resource.is_valid());
+	CHECK_MESSAGE(
+			loaded_resource->get_name() == "Large resource",
+			"The loaded resource name should be equal to the expected value.");
+	CHECK_MESSAGE(
+			PackedByteArray(loaded_resource->get_meta("bytes")) == bytes,
+			"The loaded byte array should be equal to the saved one.");
+	CHECK_MESSAGE(
+			PackedVector3Array(loaded_resource->get_meta("vertices")) == vertices,
+			"The loaded vector array should be equal to the saved one.");
+	const Ref<Resource> &loaded_child_resource = loaded_resource->get_meta("other_resource");
+	CHECK_MESSAGE(
+			loaded_child_resource->get_name() == "I'm a child resource",
+			"The loaded child resource name should be equal to the expected value.");
+}
+
+TEST_CASE("[Resource] Loading binary resources with sub-threads") {
+	// Enough sub-resources for them to be decoded in parallel, each referencing the previous one.
+	Array children;
+	Ref<Resource> previous;
+	for (int i = 0; i < 16; i++) {
+		Ref<Resource> child = memnew(Resource);
+		child->set_name(vformat("Child %d", i));
+		PackedByteArray bytes;
+		bytes.resize(8 * 1024);
+		bytes.fill(i);
+		child->set_meta("bytes", bytes);
+		if (previous.is_valid()) {
+			Dictionary links;
+			links["previous"] = previous;
+			child->set_meta("links", links);
+		}
+		children.push_back(child);
+		previous = child;
+	}
+
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Parent");
+	resource->set_meta("children", children);
+	const String save_path = TestUtils::get_temp_path("sub_threads_resource.res");
+	ResourceSaver::save(resource, save_path);
+
+	ResourceLoader::load_threaded_request(save_path, "", true, ResourceFormatLoader::CACHE_MODE_IGNORE);
+	const Ref<Resource> loaded_resource = ResourceLoader::load_threaded_get(save_path);
+	REQUIRE(loaded_resource.is_valid());
+	const Array loaded_children = loaded_resource->get_meta("children");
+	REQUIRE(loaded_children.size() == 16);
+	for (int i = 0; i < loaded_children.size(); i++) {
+		const Ref<Resource> child = loaded_children[i];
+		REQUIRE(child.is_valid());
+		CHECK_MESSAGE(
+				child->get_name() == vformat("Child %d", i),
+				"The loaded child resources should keep their order.");
+		CHECK_MESSAGE(
+				PackedByteArray(child->get_meta("bytes"))[0] == i,
+				"The loaded child resource data should be equal to the saved one.");
+		if (i > 0) {
+			const Dictionary links = child->get_meta("links");
+			CHECK_MESSAGE(
+					Ref<Resource>(links["previous"]) == Ref<Resource>(loaded_children[i - 1]),
+					"References between sub-resources should point to the loaded instances.");
+		}
+	}
+}
+
+TEST_CASE("[Resource] Loading many binary resources with sub-threads at once") {
+	// More sub-resources than are decoded ahead of time, and more loads than there are worker threads,
+	// so that loads decoding in parallel also wait from inside the pool.
+	Array children;
+	for (int i = 0; i < 80; i++) {
+		Ref<Resource> child = memnew(Resource);
+		child->set_name(vformat("Child %d", i));
+		PackedByteArray bytes;
+		bytes.resize(1024);
+		bytes.fill(i);
+		child->set_meta("bytes", bytes);
+		children.push_back(child);
+	}
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_meta("children", children);
+
+	Vector<String> paths;
+	for (int i = 0; i < WorkerThreadPool::get_singleton()->get_thread_count() + 2; i++) {
+		paths.push_back(TestUtils::get_temp_path(vformat("sub_threads_resource_%d.res", i)));
+		ResourceSaver::save(resource, paths[i]);
+	}
+
+	for (const String &path : paths) {
+		ResourceLoader::load_threaded_request(path, "", true, ResourceFormatLoader::CACHE_MODE_IGNORE);
+	}
+	for (const String &path : paths) {
+		const Ref<Resource> loaded_resource = ResourceLoader::load_threaded_get(path);
+		REQUIRE(loaded_resource.is_valid());
+		const Array loaded_children = loaded_resource->get_meta("children");
+		REQUIRE(loaded_children.size() == 80);
+		for (int i = 0; i < loaded_children.size(); i++) {
+			const Ref<Resource> child = loaded_children[i];
+			REQUIRE(child.is_valid());
+			CHECK(child->get_name() == vformat("Child %d", i));
+			CHECK(PackedByteArray(child->get_meta("bytes"))[0] == i);
+		}
+	}
+}
+
 TEST_CASE("[Resource] Breaking circular references on save") {
 	Ref<Resource> resource_a = memnew(Resource);
 	resource_a->set_name("A");
@@ -32,6 +32,8 @@
 #define TEST_NODE_H
 
 #include "core/object/class_db.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 #include "scene/main/node.h"
 #include "scene/resources/packed_scene.h"
 
@@ -56,11 +58,22 @@ protected:
 			case NOTIFICATION_PROCESS: {
 				process_counter++;
 				push_self();
+				if (process_delay_usec > 0) {
+					OS::get_singleton()->delay_usec(process_delay_usec);
+				}
 			} break;
 			case NOTIFICATION_PHYSICS_PROCESS: {
 				physics_process_counter++;
 				push_self();
 			} break;
+			case NOTIFICATION_TEST_GROUP_CALL: {
+				group_call_counter++;
+				group_call_thread = Thread::get_caller_id();
+				group_call_accessible = is_accessible_from_caller_thread();
+				if (group_call_delay_usec > 0) {
+					OS::get_singleton()->delay_usec(group_call_delay_usec);
+				}
+			} break;
 		}
 	}
 
@@ -82,10 +95,19 @@ private:
 	}
 
 public:
+	enum {
+		NOTIFICATION_TEST_GROUP_CALL = 10000,
+	};
+
 	int internal_process_counter = 0;
 	int internal_physics_process_counter = 0;
 	int process_counter = 0;
 	int physics_process_counter = 0;
+	uint32_t process_delay_usec = 0;
+	int group_call_counter = 0;
+	Thread::ID group_call_thread = Thread::UNASSIGNED_ID;
+	bool group_call_accessible = false;
+	uint32_t group_call_delay_usec = 0;
 
 	Node *exported_node = nullptr;
 	Array exported_nodes;
@@ -499,6 +521,81 @@ TEST_CASE("[SceneTree][Node] Testing node operations with a more complex simple
 	memdelete(node2);
 }
 
+TEST_CASE("[Node] Children order with many siblings") {
+	Node *parent = memnew(Node);
+	Node *front = memnew(Node);
+	Node *back = memnew(Node);
+	parent->add_child(front, false, Node::INTERNAL_MODE_FRONT);
+	parent->add_child(back, false, Node::INTERNAL_MODE_BACK);
+
+	const int child_count = 100;
+	LocalVector<Node *> children;
+	for (int i = 0; i < child_count; i++) {
+		Node *child = memnew(Node);
+		parent->add_child(child);
+		children.push_back(child);
+	}
+	CHECK_EQ(parent->get_child_count(), child_count);
+	CHECK_EQ(parent->get_child_count(true), child_count + 2);
+	CHECK_EQ(parent->get_child(0, true), front);
+	CHECK_EQ(parent->get_child(-1, true), back);
+
+	SUBCASE("Removing children keeps the order and indices of their siblings") {
+		// Remove every other child, without querying indices in between.
+		for (int i = 0; i < child_count; i += 2) {
+			parent->remove_child(children[i]);
+		}
+		CHECK_EQ(parent->get_child_count(), child_count / 2);
+		for (int i = 0; i < child_count / 2; i++) {
+			Node *child = parent->get_child(i);
+			CHECK_EQ(child, children[i * 2 + 1]);
+			CHECK_EQ(child->get_index(false), i);
+			CHECK_EQ(child->get_index(), i + 1);
+		}
+		CHECK_EQ(back->get_index(), child_count / 2 + 1);
+
+		// Add and remove children while the removed ones still leave holes.
+		parent->remove_child(children[child_count - 1]);
+		parent->remove_child(children[child_count - 3]);
+		parent->add_child(children[0]);
+		parent->remove_child(children[1]);
+		CHECK_EQ(parent->get_child(0), children[3]);
+		CHECK_EQ(parent->get_child(-1), children[0]);
+		CHECK_EQ(parent->get_child(-2), children[child_count - 5]);
+		CHECK_EQ(children[0]->get_index(false), child_count / 2 - 3);
+		CHECK_EQ(parent->get_child(-1, true), back);
+
+		for (int i = 0; i < child_count; i++) {
+			if (!children[i]->get_parent()) {
+				memdelete(children[i]);
+			}
+		}
+	}
+
+	SUBCASE("Moving children after removing others") {
+		parent->remove_child(children[10]);
+		parent->move_child(children[50], 0);
+		CHECK_EQ(parent->get_child(0), children[50]);
+		CHECK_EQ(parent->get_child(1), children[0]);
+		CHECK_EQ(parent->get_child(11), children[11]);
+		CHECK_EQ(children[11]->get_index(false), 11);
+		CHECK_EQ(children[51]->get_index(false), 50);
+		memdelete(children[10]);
+	}
+
+	SUBCASE("Removing internal children") {
+		parent->remove_child(front);
+		CHECK_EQ(parent->get_child(0, true), children[0]);
+		CHECK_EQ(children[0]->get_index(), 0);
+		CHECK_EQ(back->get_index(), child_count);
+		parent->add_child(front, false, Node::INTERNAL_MODE_FRONT);
+		CHECK_EQ(parent->get_child(0, true), front);
+		CHECK_EQ(children[0]->get_index(), 1);
+	}
+
+	memdelete(parent);
+}
+
 TEST_CASE("[SceneTree][Node]Exported node checks") {
 	TestNode *node = memnew(TestNode);
 	SceneTree::get_singleton()->get_root()->add_child(node);
@@ -821,6 +918,157 @@ TEST_CASE("[SceneTree][Node] Test the processing") {
 	memdelete(node);
 }
 
+TEST_CASE("[SceneTree][Node] Test the process budget of thread groups") {
+	Node *group = memnew(Node);
+	group->set_process_thread_group(Node::PROCESS_THREAD_GROUP_MAIN_THREAD);
+	// Each node takes longer than the whole budget, so only one fits per frame.
+	group->set_process_thread_group_budget_usec(1);
+	SceneTree::get_singleton()->get_root()->add_child(group);
+
+	TestNode *nodes[3];
+	for (int i = 0; i < 3; i++) {
+		nodes[i] = memnew(TestNode);
+		nodes[i]->process_delay_usec = 100;
+		nodes[i]->set_process(true);
+		nodes[i]->set_physics_process(true);
+		group->add_child(nodes[i]);
+	}
+
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[0]->process_counter, 1);
+	CHECK_EQ(nodes[1]->process_counter, 0);
+	CHECK_EQ(nodes[2]->process_counter, 0);
+	CHECK_EQ(SceneTree::get_singleton()->get_process_budget_deferred_node_count(), 2);
+	CHECK_EQ(SceneTree::get_singleton()->get_process_budget_exhausted_group_count(), 1);
+
+	// Postponed nodes come first on the next frames.
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[1]->process_counter, 1);
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[2]->process_counter, 1);
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[0]->process_counter, 2);
+
+	// Physics processing is never postponed.
+	SceneTree::get_singleton()->physics_process(0);
+	for (int i = 0; i < 3; i++) {
+		CHECK_EQ(nodes[i]->physics_process_counter, 1);
+	}
+
+	// The next node is tracked by identity, so changes to the group don't make it skip nodes.
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[1]->process_counter, 2);
+	memdelete(nodes[0]);
+	nodes[0] = nullptr;
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[2]->process_counter, 2);
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[1]->process_counter, 3);
+	CHECK_EQ(nodes[2]->process_counter, 2);
+
+	// Without a budget, everything processes every frame.
+	group->set_process_thread_group_budget_usec(0);
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[1]->process_counter, 4);
+	CHECK_EQ(nodes[2]->process_counter, 3);
+	CHECK_EQ(SceneTree::get_singleton()->get_process_budget_deferred_node_count(), 0);
+
+	memdelete(group);
+}
+
+TEST_CASE("[SceneTree][Node] Test the process budget of the default process group") {
+	TestNode *nodes[2];
+	for (int i = 0; i < 2; i++) {
+		nodes[i] = memnew(TestNode);
+		nodes[i]->process_delay_usec = 100;
+		nodes[i]->set_process(true);
+		SceneTree::get_singleton()->get_root()->add_child(nodes[i]);
+	}
+
+	// Other nodes in the default group may be processed before these, so only check that
+	// these two take turns.
+	SceneTree::get_singleton()->set_default_process_group_budget_usec(1);
+	for (int frame = 0; frame < 4; frame++) {
+		SceneTree::get_singleton()->process(0);
+		CHECK(nodes[0]->process_counter + nodes[1]->process_counter <= frame + 1);
+	}
+	CHECK(SceneTree::get_singleton()->get_process_budget_exhausted_group_count() == 1);
+
+	SceneTree::get_singleton()->set_default_process_group_budget_usec(0);
+	int counters[2] = { nodes[0]->process_counter, nodes[1]->process_counter };
+	SceneTree::get_singleton()->process(0);
+	CHECK_EQ(nodes[0]->process_counter, counters[0] + 1);
+	CHECK_EQ(nodes[1]->process_counter, counters[1] + 1);
+
+	memdelete(nodes[0]);
+	memdelete(nodes[1]);
+}
+
+TEST_CASE("[SceneTree][Node] Threaded group calls") {
+	// A few sub-thread groups, and a node outside of them.
+	const int group_count = 4;
+	const int nodes_per_group = 8;
+	Node *groups[group_count];
+	LocalVector<TestNode *> nodes;
+	for (int i = 0; i < group_count; i++) {
+		groups[i] = memnew(Node);
+		groups[i]->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		SceneTree::get_singleton()->get_root()->add_child(groups[i]);
+		for (int j = 0; j < nodes_per_group; j++) {
+			TestNode *node = memnew(TestNode);
+			groups[i]->add_child(node);
+			node->add_to_group("threaded");
+			nodes.push_back(node);
+		}
+	}
+	TestNode *main_node = memnew(TestNode);
+	SceneTree::get_singleton()->get_root()->add_child(main_node);
+	main_node->add_to_group("threaded");
+
+	SUBCASE("Notifications") {
+		SceneTree::get_singleton()->notify_group_flags(SceneTree::GROUP_CALL_THREADED, "threaded", TestNode::NOTIFICATION_TEST_GROUP_CALL);
+		for (TestNode *node : nodes) {
+			CHECK_EQ(node->group_call_counter, 1);
+			// Each node is called from a thread that owns its group.
+			CHECK(node->group_call_accessible);
+		}
+		CHECK_EQ(main_node->group_call_counter, 1);
+		CHECK_EQ(main_node->group_call_thread, Thread::get_caller_id());
+		CHECK(main_node->group_call_accessible);
+	}
+
+	SUBCASE("Method calls") {
+		SceneTree::get_singleton()->call_group_flags(SceneTree::GROUP_CALL_THREADED | SceneTree::GROUP_CALL_REVERSE, "threaded", "set_meta", "called", true);
+		for (TestNode *node : nodes) {
+			CHECK(node->has_meta("called"));
+		}
+		CHECK(main_node->has_meta("called"));
+	}
+
+	SUBCASE("Serial and threaded timings") {
+		// Only printed with --verbose, as timings depend on the machine.
+		const int work_usec = 20;
+		for (TestNode *node : nodes) {
+			node->group_call_delay_usec = work_usec;
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		SceneTree::get_singleton()->notify_group_flags(SceneTree::GROUP_CALL_DEFAULT, "threaded", TestNode::NOTIFICATION_TEST_GROUP_CALL);
+		uint64_t serial_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		SceneTree::get_singleton()->notify_group_flags(SceneTree::GROUP_CALL_THREADED, "threaded", TestNode::NOTIFICATION_TEST_GROUP_CALL);
+		uint64_t threaded_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_verbose(vformat("Notified %d nodes in %d usec serially and %d usec threaded.", nodes.size() + 1, serial_usec, threaded_usec));
+	}
+
+	memdelete(main_node);
+	for (int i = 0; i < group_count; i++) {
+		memdelete(groups[i]);
+	}
+}
+
 TEST_CASE("[SceneTree][Node] Test the process priority") {
 	List<Node *> process_order;
 
@@ -84,6 +84,32 @@ TEST_CASE("[SceneTree][Node2D]") {
 		memdelete(outer);
 		memdelete(main);
 	}
+
+	SUBCASE("[Node2D][Global Transform] Global Transform should be correct in deep hierarchies.") {
+		Node2D *main = memnew(Node2D);
+		SceneTree::get_singleton()->get_root()->add_child(main);
+
+		// Deeper than the chain of ancestors updated at once.
+		const int depth = 150;
+		Node2D *parent = main;
+		Node2D *leaf = nullptr;
+		for (int i = 0; i < depth; i++) {
+			leaf = memnew(Node2D);
+			leaf->set_position(Point2(1, 0));
+			parent->add_child(leaf);
+			parent = leaf;
+		}
+		CHECK(leaf->get_global_position().is_equal_approx(Point2(depth, 0)));
+
+		main->set_position(Point2(0, 5));
+		CHECK(leaf->get_global_position().is_equal_approx(Point2(depth, 5)));
+
+		main->set_position(Point2(0, 7));
+		SceneTree::get_singleton()->flush_transform_notifications();
+		CHECK(leaf->get_global_position().is_equal_approx(Point2(depth, 7)));
+
+		memdelete(main);
+	}
 }
 
 TEST_CASE("[SceneTree][Node2D] Utility methods") {
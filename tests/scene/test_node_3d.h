@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*  test_node_3d.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NODE_3D_H
+#define TEST_NODE_3D_H
+
+#include "scene/3d/node_3d.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNode3D {
+
+class TransformProbe3D : public Node3D {
+	GDCLASS(TransformProbe3D, Node3D);
+
+public:
+	bool is_global_transform_dirty() const { return _is_global_transform_dirty(); }
+};
+
+TEST_CASE("[SceneTree][Node3D] Global transform of deep hierarchies") {
+	Node3D *root = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+
+	// Deeper than the chain of ancestors updated at once.
+	const int depth = 150;
+	Node3D *parent = root;
+	Node3D *leaf = nullptr;
+	for (int i = 0; i < depth; i++) {
+		leaf = memnew(Node3D);
+		leaf->set_position(Vector3(1, 0, 0));
+		parent->add_child(leaf);
+		parent = leaf;
+	}
+	CHECK(leaf->get_global_position().is_equal_approx(Vector3(depth, 0, 0)));
+
+	SUBCASE("Moving the root updates every descendant") {
+		root->set_position(Vector3(0, 5, 0));
+		CHECK(leaf->get_global_position().is_equal_approx(Vector3(depth, 5, 0)));
+		Node3D *middle = Object::cast_to<Node3D>(leaf->get_parent()->get_parent());
+		CHECK(middle->get_global_position().is_equal_approx(Vector3(depth - 2, 5, 0)));
+	}
+
+	SUBCASE("Rotated and top level ancestors") {
+		root->set_rotation(Vector3(0, Math_PI / 2, 0));
+		CHECK(leaf->get_global_position().is_equal_approx(Vector3(0, 0, -depth)));
+		root->set_rotation(Vector3());
+
+		Node3D *middle = Object::cast_to<Node3D>(root->get_child(0)->get_child(0)->get_child(0));
+		middle->set_as_top_level(true);
+		middle->set_global_position(Vector3(10, 0, 0));
+		root->set_position(Vector3(0, 5, 0));
+		root->set_rotation(Vector3(0, Math_PI / 2, 0));
+		CHECK(middle->get_global_position().is_equal_approx(Vector3(10, 0, 0)));
+		CHECK(leaf->get_global_position().is_equal_approx(Vector3(10 + depth - 3, 0, 0)));
+	}
+
+	SUBCASE("Pending transforms are up to date after flushing notifications") {
+		// Nodes notified of transform changes, under a chain of nodes that aren't.
+		LocalVector<TransformProbe3D *> probes;
+		for (int i = 0; i < 3; i++) {
+			TransformProbe3D *probe = memnew(TransformProbe3D);
+			probe->set_position(Vector3(0, 1, 0));
+			probe->set_notify_transform(true);
+			(probes.is_empty() ? (Node3D *)leaf : (Node3D *)probes[probes.size() - 1])->add_child(probe);
+			probes.push_back(probe);
+		}
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		root->set_position(Vector3(0, 0, 3));
+		for (TransformProbe3D *probe : probes) {
+			CHECK(probe->is_global_transform_dirty());
+		}
+		SceneTree::get_singleton()->flush_transform_notifications();
+		for (TransformProbe3D *probe : probes) {
+			CHECK_FALSE(probe->is_global_transform_dirty());
+		}
+		CHECK(probes[2]->get_global_transform().origin.is_equal_approx(Vector3(depth, 3, 3)));
+	}
+
+	memdelete(root);
+}
+
+} // namespace TestNode3D
+
+#endif // TEST_NODE_3D_H
@@ -31,6 +31,8 @@
 #ifndef TEST_PACKED_SCENE_H
 #define TEST_PACKED_SCENE_H
 
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
 #include "scene/resources/packed_scene.h"
 
 #include "tests/test_macros.h"
@@ -213,6 +215,157 @@ TEST_CASE("[PackedScene] Instantiate Packed Scene With Children") {
 	memdelete(instance);
 }
 
+TEST_CASE("[PackedScene] Instantiate Packed Scene With Many Nodes") {
+	// Create a scene with many nodes, whose properties are set through pre-resolved setters.
+	Node2D *scene = memnew(Node2D);
+	scene->set_name("TestScene");
+	const int child_count = 500;
+	for (int i = 0; i < child_count; i++) {
+		Node2D *child = memnew(Node2D);
+		child->set_name(vformat("Child%d", i));
+		child->set_position(Vector2(i, i * 2));
+		child->set_rotation(0.5);
+		child->set_z_index(i % 10);
+		child->set_visible(i % 2 == 0);
+		child->set_meta("id", i);
+		scene->add_child(child);
+		child->set_owner(scene);
+	}
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	// The first instantiation builds the plan, the second one reuses it.
+	for (int k = 0; k < 2; k++) {
+		Node *instance = packed_scene->instantiate();
+		REQUIRE(instance != nullptr);
+		CHECK(instance->get_child_count() == child_count);
+		for (int i = 0; i < child_count; i++) {
+			Node2D *child = Object::cast_to<Node2D>(instance->get_child(i));
+			REQUIRE(child != nullptr);
+			CHECK(child->get_name() == vformat("Child%d", i));
+			CHECK(child->get_position() == Vector2(i, i * 2));
+			CHECK(child->get_rotation() == doctest::Approx(0.5));
+			CHECK(child->get_z_index() == i % 10);
+			CHECK(child->is_visible() == (i % 2 == 0));
+			CHECK(int(child->get_meta("id")) == i);
+			CHECK(child->get_owner() == instance);
+		}
+		memdelete(instance);
+	}
+
+	// Packing again drops the plan, and the next instantiation uses the new state.
+	Node2D *repacked = memnew(Node2D);
+	repacked->set_name("Repacked");
+	repacked->set_position(Vector2(3, 4));
+	CHECK(packed_scene->pack(repacked) == OK);
+	memdelete(repacked);
+	Node2D *instance = Object::cast_to<Node2D>(packed_scene->instantiate());
+	REQUIRE(instance != nullptr);
+	CHECK(instance->get_child_count() == 0);
+	CHECK(instance->get_position() == Vector2(3, 4));
+	memdelete(instance);
+}
+
+TEST_CASE("[PackedScene] Instantiate Packed Scene With Values That Need Converting") {
+	// Values whose type doesn't match the setter's argument, as found in hand-edited scenes.
+	Ref<SceneState> state;
+	state.instantiate();
+	int node = state->add_node(-1, -1, state->add_name("Node2D"), state->add_name("Converted"), -1, -1);
+	state->add_node_property(node, state->add_name("rotation"), state->add_value(2));
+	state->add_node_property(node, state->add_name("z_index"), state->add_value(3.0));
+
+	Node2D *instance = Object::cast_to<Node2D>(state->instantiate(SceneState::GEN_EDIT_STATE_DISABLED));
+	REQUIRE(instance != nullptr);
+	CHECK(instance->get_rotation() == doctest::Approx(2.0));
+	CHECK(instance->get_z_index() == 3);
+
+	// The plan is rebuilt when the state changes.
+	state->add_node_property(node, state->add_name("visible"), state->add_value(false));
+	memdelete(instance);
+	instance = Object::cast_to<Node2D>(state->instantiate(SceneState::GEN_EDIT_STATE_DISABLED));
+	REQUIRE(instance != nullptr);
+	CHECK_FALSE(instance->is_visible());
+	memdelete(instance);
+}
+
+TEST_CASE("[SceneTree][PackedScene] Scene Pools") {
+	Node2D *scene = memnew(Node2D);
+	scene->set_name("TestScene");
+	Node2D *child = memnew(Node2D);
+	child->set_name("Child");
+	child->set_position(Vector2(1, 2));
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(scene) == OK);
+	memdelete(scene);
+
+	SceneTree *tree = SceneTree::get_singleton();
+	tree->prewarm_scene_pool(packed_scene, 3);
+	CHECK(tree->get_scene_pool_size(packed_scene) == 3);
+
+	Node *instance = tree->acquire_pooled_scene(packed_scene);
+	REQUIRE(instance != nullptr);
+	CHECK(tree->get_scene_pool_size(packed_scene) == 2);
+	tree->get_root()->add_child(instance);
+	CHECK(instance->is_inside_tree());
+
+	SUBCASE("Released instances are reset and reused") {
+		Node2D *instance_child = Object::cast_to<Node2D>(instance->get_node(NodePath("Child")));
+		REQUIRE(instance_child != nullptr);
+		CHECK(instance_child->get_position() == Vector2(1, 2));
+		instance_child->set_position(Vector2(10, 20));
+		instance_child->hide();
+
+		tree->release_pooled_scene(instance);
+		CHECK_FALSE(instance->is_inside_tree());
+		CHECK(instance->get_parent() == nullptr);
+		CHECK(tree->get_scene_pool_size(packed_scene) == 3);
+		CHECK(instance_child->get_position() == Vector2(1, 2));
+		CHECK(instance_child->is_visible());
+
+		CHECK(tree->acquire_pooled_scene(packed_scene) == instance);
+		tree->release_pooled_scene(instance);
+	}
+
+	SUBCASE("Freed instances leave their pool") {
+		tree->release_pooled_scene(instance);
+		CHECK(tree->get_scene_pool_size(packed_scene) == 3);
+		memdelete(instance);
+		CHECK(tree->get_scene_pool_size(packed_scene) == 2);
+	}
+
+	SUBCASE("Instances with a removed node aren't reused") {
+		const ObjectID instance_id = instance->get_instance_id();
+		memdelete(instance->get_node(NodePath("Child")));
+		tree->release_pooled_scene(instance);
+		CHECK(tree->get_scene_pool_size(packed_scene) == 2);
+
+		// The instance is freed at the end of the frame.
+		CHECK(ObjectDB::get_instance(instance_id) == instance);
+		tree->process(0);
+		CHECK(ObjectDB::get_instance(instance_id) == nullptr);
+	}
+
+	SUBCASE("Instances with an added node aren't reused") {
+		const ObjectID instance_id = instance->get_instance_id();
+		Node *added = memnew(Node);
+		instance->get_node(NodePath("Child"))->add_child(added);
+		tree->release_pooled_scene(instance);
+		CHECK(tree->get_scene_pool_size(packed_scene) == 2);
+		tree->process(0);
+		CHECK(ObjectDB::get_instance(instance_id) == nullptr);
+	}
+
+	tree->clear_scene_pool(packed_scene);
+	CHECK(tree->get_scene_pool_size(packed_scene) == 0);
+}
+
 TEST_CASE("[PackedScene] Set Path") {
 	// Create a scene to pack.
 	Node *scene = memnew(Node);
@@ -0,0 +1,295 @@
+/**************************************************************************/
+/*  test_static_batch_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STATIC_BATCH_3D_H
+#define TEST_STATIC_BATCH_3D_H
+
+#include "modules/modules_enabled.gen.h" // For meshoptimizer.
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/3d/static_batch_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/3d/primitive_meshes.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStaticBatch3D {
+
+// A single triangle facing +Z.
+static Ref<ArrayMesh> create_triangle_mesh() {
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = PackedVector3Array{ Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 1, 0) };
+	arrays[Mesh::ARRAY_NORMAL] = PackedVector3Array{ Vector3(0, 0, 1), Vector3(0, 0, 1), Vector3(0, 0, 1) };
+	arrays[Mesh::ARRAY_INDEX] = PackedInt32Array{ 0, 1, 2 };
+
+	Ref<ArrayMesh> mesh;
+	mesh.instantiate();
+	mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+	return mesh;
+}
+
+static RendererSceneCull::Instance *get_render_instance(RID p_instance) {
+	return static_cast<RendererSceneCull *>(RSG::scene)->instance_owner.get_or_null(p_instance);
+}
+
+static bool is_instance_visible(const RendererSceneCull::Instance *p_instance) {
+	return p_instance->visible;
+}
+
+// Baked meshes are drawn by instances owned by the rendering server, found here by their mesh.
+static RendererSceneCull::Instance *find_render_instance(const Ref<Mesh> &p_mesh) {
+	List<RID> instances;
+	static_cast<RendererSceneCull *>(RSG::scene)->instance_owner.get_owned_list(&instances);
+	for (const RID &rid : instances) {
+		RendererSceneCull::Instance *instance = get_render_instance(rid);
+		if (instance->base == p_mesh->get_rid()) {
+			return instance;
+		}
+	}
+	return nullptr;
+}
+
+static MeshInstance3D *add_mesh_instance(Node *p_parent, const Ref<Mesh> &p_mesh, const Ref<Material> &p_material, const Transform3D &p_xform) {
+	MeshInstance3D *mi = memnew(MeshInstance3D);
+	mi->set_mesh(p_mesh);
+	mi->set_material_override(p_material);
+	mi->set_transform(p_xform);
+	p_parent->add_child(mi);
+	return mi;
+}
+
+TEST_CASE("[SceneTree][StaticBatch3D] Batching mesh instances") {
+	StaticBatch3D *batch = memnew(StaticBatch3D);
+	batch->set_batch_on_ready(false);
+	batch->set_cluster_size(10);
+	SceneTree::get_singleton()->get_root()->add_child(batch);
+
+	Ref<ArrayMesh> mesh = create_triangle_mesh();
+	Ref<StandardMaterial3D> material_a;
+	material_a.instantiate();
+	Ref<StandardMaterial3D> material_b;
+	material_b.instantiate();
+
+	SUBCASE("Instances are merged per cluster and material") {
+		// Two clusters, each with instances using two materials.
+		for (int i = 0; i < 4; i++) {
+			add_mesh_instance(batch, mesh, material_a, Transform3D(Basis(), Vector3(i, 0, 0)));
+			add_mesh_instance(batch, mesh, material_b, Transform3D(Basis(), Vector3(i, 2, 0)));
+			add_mesh_instance(batch, mesh, material_a, Transform3D(Basis(), Vector3(i + 20, 0, 0)));
+			add_mesh_instance(batch, mesh, material_b, Transform3D(Basis(), Vector3(i + 20, 2, 0)));
+		}
+		batch->make_baked_meshes();
+
+		Array baked_meshes = batch->get_baked_meshes();
+		REQUIRE(baked_meshes.size() == 2);
+		for (int i = 0; i < baked_meshes.size(); i++) {
+			Ref<ArrayMesh> baked = baked_meshes[i];
+			REQUIRE(baked.is_valid());
+			REQUIRE(baked->get_surface_count() == 2);
+			for (int j = 0; j < baked->get_surface_count(); j++) {
+				Array arrays = baked->surface_get_arrays(j);
+				CHECK(PackedInt32Array(arrays[Mesh::ARRAY_INDEX]).size() == 4 * 3);
+				Ref<Material> surface_material = baked->surface_get_material(j);
+				CHECK((surface_material == material_a || surface_material == material_b));
+			}
+		}
+
+		batch->clear_baked_meshes();
+		CHECK(batch->get_baked_meshes().is_empty());
+	}
+
+	SUBCASE("Instances that can't be batched are left alone") {
+		add_mesh_instance(batch, mesh, material_a, Transform3D());
+		MeshInstance3D *transparent = add_mesh_instance(batch, mesh, material_a, Transform3D());
+		transparent->set_transparency(0.5);
+		MeshInstance3D *hidden = add_mesh_instance(batch, mesh, material_a, Transform3D());
+		hidden->set_visible(false);
+
+		Ref<StandardMaterial3D> transparent_material;
+		transparent_material.instantiate();
+		transparent_material->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA);
+		add_mesh_instance(batch, mesh, transparent_material, Transform3D());
+		Ref<StandardMaterial3D> additive_material;
+		additive_material.instantiate();
+		additive_material->set_blend_mode(BaseMaterial3D::BLEND_MODE_ADD);
+		add_mesh_instance(batch, mesh, additive_material, Transform3D());
+
+		add_mesh_instance(batch, mesh, material_a, Transform3D())->set_lod_bias(2.0);
+		add_mesh_instance(batch, mesh, material_a, Transform3D())->set_extra_cull_margin(1.0);
+		add_mesh_instance(batch, mesh, material_a, Transform3D())->set_custom_aabb(AABB(Vector3(), Vector3(1, 1, 1)));
+		batch->make_baked_meshes();
+
+		Array baked_meshes = batch->get_baked_meshes();
+		REQUIRE(baked_meshes.size() == 1);
+		Ref<ArrayMesh> baked = baked_meshes[0];
+		REQUIRE(baked->get_surface_count() == 1);
+		Array arrays = baked->surface_get_arrays(0);
+		CHECK(PackedInt32Array(arrays[Mesh::ARRAY_INDEX]).size() == 3);
+		CHECK(int(batch->get_statistics()["source_instance_count"]) == 1);
+	}
+
+	SUBCASE("Instances with different GI modes are kept apart") {
+		add_mesh_instance(batch, mesh, material_a, Transform3D());
+		add_mesh_instance(batch, mesh, material_a, Transform3D())->set_gi_mode(GeometryInstance3D::GI_MODE_DYNAMIC);
+		batch->make_baked_meshes();
+
+		Array baked_meshes = batch->get_baked_meshes();
+		REQUIRE(baked_meshes.size() == 2);
+		int dynamic_gi_count = 0;
+		for (int i = 0; i < baked_meshes.size(); i++) {
+			RendererSceneCull::Instance *instance = find_render_instance(baked_meshes[i]);
+			REQUIRE(instance != nullptr);
+			CHECK(bool(instance->baked_light) != bool(instance->dynamic_gi));
+			dynamic_gi_count += instance->dynamic_gi ? 1 : 0;
+		}
+		CHECK(dynamic_gi_count == 1);
+	}
+
+	SUBCASE("Batched instances are hidden while batched") {
+		MeshInstance3D *mi_a = add_mesh_instance(batch, mesh, material_a, Transform3D());
+		MeshInstance3D *mi_b = add_mesh_instance(batch, mesh, material_a, Transform3D(Basis(), Vector3(1, 0, 0)));
+		MeshInstance3D *hidden = add_mesh_instance(batch, mesh, material_a, Transform3D(Basis(), Vector3(2, 0, 0)));
+		hidden->set_visible(false);
+		batch->make_baked_meshes();
+
+		REQUIRE(batch->get_baked_meshes().size() == 1);
+		CHECK(is_instance_visible(find_render_instance(batch->get_baked_meshes()[0])));
+		CHECK_FALSE(is_instance_visible(get_render_instance(mi_a->get_instance())));
+		CHECK_FALSE(is_instance_visible(get_render_instance(mi_b->get_instance())));
+		CHECK_FALSE(is_instance_visible(get_render_instance(hidden->get_instance())));
+
+		// Hiding a batched instance batches again without it.
+		mi_b->set_visible(false);
+		MessageQueue::get_singleton()->flush();
+		CHECK(int(batch->get_statistics()["source_instance_count"]) == 1);
+		CHECK_FALSE(is_instance_visible(get_render_instance(mi_a->get_instance())));
+		CHECK_FALSE(is_instance_visible(get_render_instance(mi_b->get_instance())));
+
+		// Showing an instance batches it again, instead of drawing it on its own.
+		mi_b->set_visible(true);
+		hidden->set_visible(true);
+		MessageQueue::get_singleton()->flush();
+		CHECK(int(batch->get_statistics()["source_instance_count"]) == 3);
+		CHECK_FALSE(is_instance_visible(get_render_instance(mi_b->get_instance())));
+		CHECK_FALSE(is_instance_visible(get_render_instance(hidden->get_instance())));
+
+		// Hiding and showing the batch itself keeps the instances batched.
+		batch->set_visible(false);
+		MessageQueue::get_singleton()->flush();
+		CHECK_FALSE(is_instance_visible(find_render_instance(batch->get_baked_meshes()[0])));
+		batch->set_visible(true);
+		MessageQueue::get_singleton()->flush();
+		CHECK(int(batch->get_statistics()["source_instance_count"]) == 3);
+		CHECK(is_instance_visible(find_render_instance(batch->get_baked_meshes()[0])));
+		CHECK_FALSE(is_instance_visible(get_render_instance(mi_a->get_instance())));
+
+		batch->clear_baked_meshes();
+		CHECK(is_instance_visible(get_render_instance(mi_a->get_instance())));
+		CHECK(is_instance_visible(get_render_instance(mi_b->get_instance())));
+	}
+
+	SUBCASE("Mirrored instances keep their winding and normals") {
+		add_mesh_instance(batch, mesh, material_a, Transform3D(Basis().scaled(Vector3(-1, 2, 1)), Vector3(3, 0, 0)));
+		batch->make_baked_meshes();
+
+		Array baked_meshes = batch->get_baked_meshes();
+		REQUIRE(baked_meshes.size() == 1);
+		Ref<ArrayMesh> baked = baked_meshes[0];
+		Array arrays = baked->surface_get_arrays(0);
+		PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+		PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+		PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+		REQUIRE(indices.size() == 3);
+
+		const Vector3 face_normal = (vertices[indices[1]] - vertices[indices[0]]).cross(vertices[indices[2]] - vertices[indices[0]]);
+		for (int i = 0; i < 3; i++) {
+			const Vector3 normal = normals[indices[i]];
+			CHECK(Math::is_equal_approx(normal.length(), (real_t)1.0, (real_t)0.01));
+			CHECK(normal.z > 0.99);
+			CHECK(face_normal.dot(normal) > 0);
+		}
+		CHECK(vertices.has(Vector3(3, 0, 0)));
+		CHECK(vertices.has(Vector3(2, 0, 0)));
+		CHECK(vertices.has(Vector3(3, 2, 0)));
+	}
+
+#ifdef MODULE_MESHOPTIMIZER_ENABLED
+	SUBCASE("Groups of clusters get a simplified proxy") {
+		Ref<PlaneMesh> plane;
+		plane.instantiate();
+		plane->set_subdivide_width(15);
+		plane->set_subdivide_depth(15);
+
+		batch->set_hlod_distance(100);
+		batch->set_hlod_group_size(4);
+		for (int i = 0; i < 4; i++) {
+			add_mesh_instance(batch, plane, material_a, Transform3D(Basis(), Vector3(i * 2, 0, 0)));
+			add_mesh_instance(batch, plane, material_a, Transform3D(Basis(), Vector3(i * 2 + 10, 0, 0)));
+		}
+		batch->make_baked_meshes();
+
+		CHECK(batch->get_baked_meshes().size() == 2);
+		REQUIRE(batch->get_hlod_meshes().size() == 1);
+
+		// The proxy is drawn beyond the HLOD distance, and the baked meshes of its group only closer than that.
+		RendererSceneCull::Instance *proxy = find_render_instance(batch->get_hlod_meshes()[0]);
+		REQUIRE(proxy != nullptr);
+		CHECK(proxy->visibility_range_begin == doctest::Approx(100.0));
+		CHECK(proxy->visibility_range_end == 0.0);
+		CHECK(proxy->visibility_parent == nullptr);
+		for (int i = 0; i < batch->get_baked_meshes().size(); i++) {
+			RendererSceneCull::Instance *baked = find_render_instance(batch->get_baked_meshes()[i]);
+			REQUIRE(baked != nullptr);
+			CHECK(baked->visibility_parent == proxy);
+			CHECK(baked->visibility_range_begin == 0.0);
+		}
+
+		Dictionary stats = batch->get_statistics();
+		CHECK(int(stats["source_instance_count"]) == 8);
+		CHECK(int(stats["source_triangle_count"]) == 8 * 16 * 16 * 2);
+		CHECK(int(stats["baked_instance_count"]) == 2);
+		CHECK(int(stats["hlod_instance_count"]) == 1);
+		CHECK(int(stats["hlod_triangle_count"]) > 0);
+		CHECK(int(stats["hlod_triangle_count"]) < int(stats["source_triangle_count"]) / 4);
+
+		batch->clear_baked_meshes();
+		CHECK(batch->get_hlod_meshes().is_empty());
+		CHECK(int(batch->get_statistics()["source_triangle_count"]) == 0);
+	}
+#endif // MODULE_MESHOPTIMIZER_ENABLED
+
+	memdelete(batch);
+}
+
+} // namespace TestStaticBatch3D
+
+#endif // TEST_STATIC_BATCH_3D_H
@@ -0,0 +1,355 @@
+/**************************************************************************/
+/*  test_tile_map_layer.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_TILE_MAP_LAYER_H
+#define TEST_TILE_MAP_LAYER_H
+
+#include "scene/2d/tile_map_layer.h"
+#include "scene/main/window.h"
+#include "scene/resources/image_texture.h"
+#include "scene/resources/world_2d.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTileMapLayer {
+
+// A tile set with two 16x16 tiles, and an alternative of the first one using a material.
+static Ref<TileSet> create_test_tile_set(int &r_source_id, const Ref<Material> &p_material) {
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_set->set_tile_size(Vector2i(16, 16));
+
+	Ref<TileSetAtlasSource> atlas_source;
+	atlas_source.instantiate();
+	atlas_source->set_texture(ImageTexture::create_from_image(Image::create_empty(32, 16, false, Image::FORMAT_RGBA8)));
+	atlas_source->set_texture_region_size(Vector2i(16, 16));
+	atlas_source->create_tile(Vector2i(0, 0));
+	atlas_source->create_tile(Vector2i(1, 0));
+	int alternative = atlas_source->create_alternative_tile(Vector2i(0, 0));
+	atlas_source->get_tile_data(Vector2i(0, 0), alternative)->set_material(p_material);
+
+	r_source_id = tile_set->add_source(atlas_source);
+	return tile_set;
+}
+
+// The number of draw commands of each canvas item the layer draws its tiles in.
+static HashMap<RID, int> get_tile_canvas_items(const TileMapLayer *p_layer) {
+	List<RID> owned;
+	RSG::canvas->canvas_item_owner.get_owned_list(&owned);
+	HashMap<RID, int> result;
+	for (const RID &rid : owned) {
+		const RendererCanvasCull::Item *item = RSG::canvas->canvas_item_owner.get_or_null(rid);
+		// Debug quadrants are drawn above everything else.
+		if (item->parent != p_layer->get_canvas_item() || item->z_index == RS::CANVAS_ITEM_Z_MAX - 1) {
+			continue;
+		}
+		int command_count = 0;
+		for (const RendererCanvasRender::Item::Command *command = item->commands; command; command = command->next) {
+			command_count++;
+		}
+		result[rid] = command_count;
+	}
+	return result;
+}
+
+static RID find_canvas_item_with_material(const HashMap<RID, int> &p_canvas_items, const Ref<Material> &p_material) {
+	for (const KeyValue<RID, int> &E : p_canvas_items) {
+		if (RSG::canvas->canvas_item_owner.get_or_null(E.key)->material == (p_material.is_valid() ? p_material->get_rid() : RID())) {
+			return E.key;
+		}
+	}
+	return RID();
+}
+
+TEST_CASE("[SceneTree][TileMapLayer] Rendering updates only redraw what changed") {
+	Ref<CanvasItemMaterial> material;
+	material.instantiate();
+	int source_id = 0;
+	Ref<TileSet> tile_set = create_test_tile_set(source_id, material);
+
+	TileMapLayer *layer = memnew(TileMapLayer);
+	layer->set_tile_set(tile_set);
+	layer->set_rendering_quadrant_size(4);
+	SceneTree::get_singleton()->get_root()->add_child(layer);
+
+	// The first quadrant is drawn in two canvas items, as its two right columns use a material. The second quadrant
+	// is drawn in one.
+	for (int x = 0; x < 8; x++) {
+		for (int y = 0; y < 4; y++) {
+			layer->set_cell(Vector2i(x, y), source_id, Vector2i(0, 0), (x == 2 || x == 3) ? 1 : 0);
+		}
+	}
+	layer->update_internals();
+
+	HashMap<RID, int> canvas_items = get_tile_canvas_items(layer);
+	REQUIRE(canvas_items.size() == 3);
+	const RID material_ci = find_canvas_item_with_material(canvas_items, material);
+	REQUIRE(material_ci.is_valid());
+	CHECK(canvas_items[material_ci] == 8);
+	RID first_ci;
+	RID second_ci;
+	for (const KeyValue<RID, int> &E : canvas_items) {
+		if (E.key == material_ci) {
+			continue;
+		}
+		if (E.value == 8) {
+			first_ci = E.key;
+		} else if (E.value == 16) {
+			second_ci = E.key;
+		}
+	}
+	REQUIRE(first_ci.is_valid());
+	REQUIRE(second_ci.is_valid());
+
+	// Canvas items that are redrawn are cleared, which drops these extra commands.
+	RenderingServer::get_singleton()->canvas_item_add_rect(material_ci, Rect2(0, 0, 1, 1), Color(1, 1, 1));
+	RenderingServer::get_singleton()->canvas_item_add_rect(second_ci, Rect2(0, 0, 1, 1), Color(1, 1, 1));
+
+	SUBCASE("Changing a tile only redraws the canvas item it's drawn in") {
+		layer->set_cell(Vector2i(0, 0), source_id, Vector2i(1, 0));
+		layer->update_internals();
+
+		canvas_items = get_tile_canvas_items(layer);
+		REQUIRE(canvas_items.size() == 3);
+		REQUIRE(canvas_items.has(first_ci));
+		CHECK(canvas_items[first_ci] == 8);
+		CHECK(canvas_items[material_ci] == 9);
+		CHECK(canvas_items[second_ci] == 17);
+
+		// Cells are drawn sorted, so the changed one comes first.
+		const RendererCanvasRender::Item::Command *command = RSG::canvas->canvas_item_owner.get_or_null(first_ci)->commands;
+		REQUIRE(command != nullptr);
+		REQUIRE(command->type == RendererCanvasRender::Item::Command::TYPE_RECT);
+		CHECK(static_cast<const RendererCanvasRender::Item::CommandRect *>(command)->source.position == Vector2(16, 0));
+	}
+
+	SUBCASE("Erasing and adding cells only redraws the canvas item they're drawn in") {
+		layer->erase_cell(Vector2i(1, 1));
+		layer->update_internals();
+		canvas_items = get_tile_canvas_items(layer);
+		REQUIRE(canvas_items.size() == 3);
+		CHECK(canvas_items[first_ci] == 7);
+		CHECK(canvas_items[material_ci] == 9);
+		CHECK(canvas_items[second_ci] == 17);
+
+		layer->set_cell(Vector2i(1, 1), source_id, Vector2i(0, 0));
+		layer->update_internals();
+		canvas_items = get_tile_canvas_items(layer);
+		REQUIRE(canvas_items.size() == 3);
+		CHECK(canvas_items[first_ci] == 8);
+		CHECK(canvas_items[material_ci] == 9);
+	}
+
+	SUBCASE("Changing how cells are grouped recreates the quadrant's canvas items") {
+		layer->set_cell(Vector2i(0, 0), source_id, Vector2i(0, 0), 1);
+		layer->update_internals();
+
+		// The material cell at (0, 0) is sorted first, then come the other cells of the column.
+		canvas_items = get_tile_canvas_items(layer);
+		CHECK(canvas_items.size() == 4);
+		CHECK_FALSE(canvas_items.has(first_ci));
+		CHECK_FALSE(canvas_items.has(material_ci));
+		REQUIRE(canvas_items.has(second_ci));
+		CHECK(canvas_items[second_ci] == 17);
+	}
+
+	SUBCASE("Emptying a quadrant frees its canvas items") {
+		for (int x = 4; x < 8; x++) {
+			for (int y = 0; y < 4; y++) {
+				layer->erase_cell(Vector2i(x, y));
+			}
+		}
+		layer->update_internals();
+
+		canvas_items = get_tile_canvas_items(layer);
+		CHECK(canvas_items.size() == 2);
+		CHECK_FALSE(canvas_items.has(second_ci));
+		CHECK(canvas_items[material_ci] == 9);
+	}
+
+	SUBCASE("Changing the self modulate redraws every cell") {
+		layer->set_self_modulate(Color(1, 0, 0));
+		layer->update_internals();
+
+		canvas_items = get_tile_canvas_items(layer);
+		REQUIRE(canvas_items.size() == 3);
+		CHECK_FALSE(canvas_items.has(first_ci));
+		CHECK_FALSE(canvas_items.has(material_ci));
+		CHECK_FALSE(canvas_items.has(second_ci));
+		CHECK(canvas_items[find_canvas_item_with_material(canvas_items, material)] == 8);
+	}
+
+	memdelete(layer);
+}
+
+// A tile set with a single tile, whose collision polygon covers it entirely.
+static Ref<TileSet> create_full_collision_tile_set(const Vector2i &p_tile_size, int &r_source_id) {
+	Ref<TileSet> tile_set;
+	tile_set.instantiate();
+	tile_set->set_tile_size(p_tile_size);
+	tile_set->add_physics_layer();
+
+	Ref<TileSetAtlasSource> atlas_source;
+	atlas_source.instantiate();
+	atlas_source->set_texture(ImageTexture::create_from_image(Image::create_empty(p_tile_size.x, p_tile_size.y, false, Image::FORMAT_RGBA8)));
+	atlas_source->set_texture_region_size(p_tile_size);
+	atlas_source->create_tile(Vector2i(0, 0));
+	r_source_id = tile_set->add_source(atlas_source);
+
+	const Vector2 half_size = Vector2(p_tile_size) / 2.0;
+	Vector<Vector2> points = { -half_size, Vector2(half_size.x, -half_size.y), half_size, Vector2(-half_size.x, half_size.y) };
+	TileData *tile_data = atlas_source->get_tile_data(Vector2i(0, 0), 0);
+	tile_data->add_collision_polygon(0);
+	tile_data->set_collision_polygon_points(0, 0, points);
+
+	return tile_set;
+}
+
+// The body colliding with the given point, and the index of its shape containing it.
+static RID get_body_at(const TileMapLayer *p_layer, const Vector2 &p_position, int *r_shape = nullptr) {
+	PhysicsDirectSpaceState2D::PointParameters parameters;
+	parameters.position = p_position;
+	PhysicsDirectSpaceState2D::ShapeResult result;
+	if (p_layer->get_world_2d()->get_direct_space_state()->intersect_point(parameters, &result, 1) == 0) {
+		return RID();
+	}
+	if (r_shape) {
+		*r_shape = result.shape;
+	}
+	return result.rid;
+}
+
+// The number of polygons drawn in the layer's debug quadrants.
+static int count_debug_polygons(const TileMapLayer *p_layer) {
+	List<RID> owned;
+	RSG::canvas->canvas_item_owner.get_owned_list(&owned);
+	int count = 0;
+	for (const RID &rid : owned) {
+		const RendererCanvasCull::Item *item = RSG::canvas->canvas_item_owner.get_or_null(rid);
+		if (item->parent != p_layer->get_canvas_item() || item->z_index != RS::CANVAS_ITEM_Z_MAX - 1) {
+			continue;
+		}
+		for (const RendererCanvasRender::Item::Command *command = item->commands; command; command = command->next) {
+			count += command->type == RendererCanvasRender::Item::Command::TYPE_POLYGON;
+		}
+	}
+	return count;
+}
+
+TEST_CASE("[SceneTree][TileMapLayer] Collision merging") {
+	int source_id = 0;
+
+	SUBCASE("Full rectangle tiles are merged") {
+		TileMapLayer *layer = memnew(TileMapLayer);
+		layer->set_tile_set(create_full_collision_tile_set(Vector2i(16, 16), source_id));
+		layer->set_use_collision_merging(true);
+		SceneTree::get_singleton()->get_root()->add_child(layer);
+
+		// The top row is merged into one rectangle, the cell below it into another one.
+		for (int x = 0; x < 3; x++) {
+			layer->set_cell(Vector2i(x, 0), source_id, Vector2i(0, 0), x == 1 ? TileSetAtlasSource::TRANSFORM_TRANSPOSE : 0);
+		}
+		layer->set_cell(Vector2i(0, 1), source_id, Vector2i(0, 0));
+		layer->update_internals();
+
+		int shape = -1;
+		const RID body = get_body_at(layer, layer->map_to_local(Vector2i(0, 0)), &shape);
+		REQUIRE(body.is_valid());
+		CHECK(layer->get_coords_for_body_rid(body) == Vector2i(0, 0));
+		for (int x = 1; x < 3; x++) {
+			int other_shape = -1;
+			CHECK(get_body_at(layer, layer->map_to_local(Vector2i(x, 0)), &other_shape) == body);
+			CHECK(other_shape == shape);
+		}
+		int below_shape = -1;
+		CHECK(get_body_at(layer, layer->map_to_local(Vector2i(0, 1)), &below_shape) == body);
+		CHECK(below_shape != shape);
+
+		// Without merging, each cell has its own body.
+		layer->set_use_collision_merging(false);
+		layer->update_internals();
+		const RID cell_body = get_body_at(layer, layer->map_to_local(Vector2i(1, 0)));
+		REQUIRE(cell_body.is_valid());
+		CHECK(layer->get_coords_for_body_rid(cell_body) == Vector2i(1, 0));
+		CHECK(get_body_at(layer, layer->map_to_local(Vector2i(0, 0))) != cell_body);
+
+		memdelete(layer);
+	}
+
+	SUBCASE("Merged tiles are drawn with the visible collision shapes") {
+		TileMapLayer *layer = memnew(TileMapLayer);
+		layer->set_tile_set(create_full_collision_tile_set(Vector2i(16, 16), source_id));
+		layer->set_use_collision_merging(true);
+		layer->set_collision_visibility_mode(TileMapLayer::DEBUG_VISIBILITY_MODE_FORCE_SHOW);
+		SceneTree::get_singleton()->get_root()->add_child(layer);
+
+		for (int x = 0; x < 4; x++) {
+			layer->set_cell(Vector2i(x, 0), source_id, Vector2i(0, 0));
+		}
+		layer->update_internals();
+		CHECK(count_debug_polygons(layer) == 4);
+
+		layer->set_use_collision_merging(false);
+		layer->update_internals();
+		CHECK(count_debug_polygons(layer) == 4);
+
+		memdelete(layer);
+	}
+
+	SUBCASE("Transposed tiles are not merged when tiles are not square") {
+		TileMapLayer *layer = memnew(TileMapLayer);
+		layer->set_tile_set(create_full_collision_tile_set(Vector2i(32, 16), source_id));
+		layer->set_use_collision_merging(true);
+		SceneTree::get_singleton()->get_root()->add_child(layer);
+
+		layer->set_cell(Vector2i(0, 0), source_id, Vector2i(0, 0));
+		layer->set_cell(Vector2i(1, 0), source_id, Vector2i(0, 0), TileSetAtlasSource::TRANSFORM_TRANSPOSE);
+		layer->update_internals();
+
+		const RID merged_body = get_body_at(layer, layer->map_to_local(Vector2i(0, 0)));
+		REQUIRE(merged_body.is_valid());
+		const RID cell_body = get_body_at(layer, layer->map_to_local(Vector2i(1, 0)));
+		REQUIRE(cell_body.is_valid());
+		CHECK(cell_body != merged_body);
+		CHECK(layer->get_coords_for_body_rid(cell_body) == Vector2i(1, 0));
+
+		// The transposed shape is 16 pixels wide, and 32 pixels high.
+		CHECK_FALSE(get_body_at(layer, layer->map_to_local(Vector2i(1, 0)) + Vector2(12, 0)).is_valid());
+		CHECK(get_body_at(layer, layer->map_to_local(Vector2i(1, 0)) + Vector2(0, 12)) == cell_body);
+
+		memdelete(layer);
+	}
+}
+
+} // namespace TestTileMapLayer
+
+#endif // TEST_TILE_MAP_LAYER_H
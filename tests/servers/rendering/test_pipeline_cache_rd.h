@@ -0,0 +1,228 @@
+/**************************************************************************/
+/*  test_pipeline_cache_rd.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PIPELINE_CACHE_RD_H
+#define TEST_PIPELINE_CACHE_RD_H
+
+#include "core/version.h"
+#include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPipelineCacheRD {
+
+static PipelineCacheRD::Usage make_test_usage() {
+	PipelineCacheRD::Usage usage;
+	usage.wireframe = true;
+	usage.render_pass = 1;
+	usage.bool_specializations = 0b101;
+	usage.view_count = 2;
+	usage.samples = RD::TEXTURE_SAMPLES_4;
+
+	RD::AttachmentFormat color;
+	color.format = RD::DATA_FORMAT_R16G16B16A16_SFLOAT;
+	color.samples = RD::TEXTURE_SAMPLES_4;
+	color.usage_flags = RD::TEXTURE_USAGE_COLOR_ATTACHMENT_BIT | RD::TEXTURE_USAGE_SAMPLING_BIT;
+	usage.attachments.push_back(color);
+	RD::AttachmentFormat depth;
+	depth.format = RD::DATA_FORMAT_D32_SFLOAT;
+	depth.samples = RD::TEXTURE_SAMPLES_4;
+	depth.usage_flags = RD::TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	usage.attachments.push_back(depth);
+
+	RD::FramebufferPass depth_pass;
+	depth_pass.depth_attachment = 1;
+	usage.passes.push_back(depth_pass);
+	RD::FramebufferPass color_pass;
+	color_pass.color_attachments.push_back(0);
+	color_pass.preserve_attachments.push_back(1);
+	color_pass.depth_attachment = 1;
+	usage.passes.push_back(color_pass);
+
+	usage.use_vertex_format = true;
+	RD::VertexAttribute position;
+	position.format = RD::DATA_FORMAT_R32G32B32_SFLOAT;
+	position.stride = 12;
+	usage.vertex_attributes.push_back(position);
+	RD::VertexAttribute transform;
+	transform.location = 4;
+	transform.offset = 16;
+	transform.format = RD::DATA_FORMAT_R32G32B32A32_SFLOAT;
+	transform.stride = 64;
+	transform.frequency = RD::VERTEX_FREQUENCY_INSTANCE;
+	usage.vertex_attributes.push_back(transform);
+	return usage;
+}
+
+TEST_CASE("[PipelineCacheRD] Usage encoding round trip") {
+	const PipelineCacheRD::Usage usage = make_test_usage();
+	const PackedInt64Array data = PipelineCacheRD::encode_usage(usage);
+
+	PipelineCacheRD::Usage decoded;
+	REQUIRE(PipelineCacheRD::decode_usage(data, decoded));
+	CHECK(decoded.wireframe == usage.wireframe);
+	CHECK(decoded.render_pass == usage.render_pass);
+	CHECK(decoded.bool_specializations == usage.bool_specializations);
+	CHECK(decoded.view_count == usage.view_count);
+	CHECK(decoded.samples == usage.samples);
+
+	REQUIRE(decoded.attachments.size() == usage.attachments.size());
+	for (int i = 0; i < usage.attachments.size(); i++) {
+		CHECK(decoded.attachments[i].format == usage.attachments[i].format);
+		CHECK(decoded.attachments[i].samples == usage.attachments[i].samples);
+		CHECK(decoded.attachments[i].usage_flags == usage.attachments[i].usage_flags);
+	}
+	REQUIRE(decoded.passes.size() == usage.passes.size());
+	for (int i = 0; i < usage.passes.size(); i++) {
+		CHECK(decoded.passes[i].color_attachments == usage.passes[i].color_attachments);
+		CHECK(decoded.passes[i].input_attachments == usage.passes[i].input_attachments);
+		CHECK(decoded.passes[i].resolve_attachments == usage.passes[i].resolve_attachments);
+		CHECK(decoded.passes[i].preserve_attachments == usage.passes[i].preserve_attachments);
+		CHECK(decoded.passes[i].depth_attachment == usage.passes[i].depth_attachment);
+		CHECK(decoded.passes[i].vrs_attachment == usage.passes[i].vrs_attachment);
+	}
+	REQUIRE(decoded.use_vertex_format);
+	REQUIRE(decoded.vertex_attributes.size() == usage.vertex_attributes.size());
+	for (int i = 0; i < usage.vertex_attributes.size(); i++) {
+		CHECK(decoded.vertex_attributes[i].location == usage.vertex_attributes[i].location);
+		CHECK(decoded.vertex_attributes[i].offset == usage.vertex_attributes[i].offset);
+		CHECK(decoded.vertex_attributes[i].format == usage.vertex_attributes[i].format);
+		CHECK(decoded.vertex_attributes[i].stride == usage.vertex_attributes[i].stride);
+		CHECK(decoded.vertex_attributes[i].frequency == usage.vertex_attributes[i].frequency);
+	}
+	CHECK(PipelineCacheRD::encode_usage(decoded) == data);
+
+	SUBCASE("Without vertex format") {
+		PipelineCacheRD::Usage no_vertex_format = usage;
+		no_vertex_format.use_vertex_format = false;
+		no_vertex_format.vertex_attributes.clear();
+		REQUIRE(PipelineCacheRD::decode_usage(PipelineCacheRD::encode_usage(no_vertex_format), decoded));
+		CHECK_FALSE(decoded.use_vertex_format);
+		CHECK(decoded.vertex_attributes.is_empty());
+	}
+}
+
+TEST_CASE("[PipelineCacheRD] Corrupt usage data is rejected") {
+	const PackedInt64Array data = PipelineCacheRD::encode_usage(make_test_usage());
+	PipelineCacheRD::Usage decoded;
+
+	SUBCASE("Truncated") {
+		for (int size = 0; size < data.size(); size++) {
+			PackedInt64Array truncated = data;
+			truncated.resize(size);
+			CHECK_FALSE(PipelineCacheRD::decode_usage(truncated, decoded));
+		}
+	}
+
+	SUBCASE("Trailing data") {
+		PackedInt64Array extended = data;
+		extended.push_back(0);
+		CHECK_FALSE(PipelineCacheRD::decode_usage(extended, decoded));
+	}
+
+	SUBCASE("Huge or negative counts") {
+		// The attachment count follows the state and view count, and the sample count.
+		PackedInt64Array corrupt = data;
+		corrupt.set(5, 1LL << 40);
+		CHECK_FALSE(PipelineCacheRD::decode_usage(corrupt, decoded));
+		corrupt.set(5, -2);
+		CHECK_FALSE(PipelineCacheRD::decode_usage(corrupt, decoded));
+	}
+
+	SUBCASE("Out of range formats") {
+		PackedInt64Array corrupt = data;
+		corrupt.set(4, RD::TEXTURE_SAMPLES_MAX);
+		CHECK_FALSE(PipelineCacheRD::decode_usage(corrupt, decoded));
+		corrupt = data;
+		corrupt.set(6, RD::DATA_FORMAT_MAX);
+		CHECK_FALSE(PipelineCacheRD::decode_usage(corrupt, decoded));
+	}
+}
+
+TEST_CASE("[PipelineCacheRD] Corrupt usage manifests are rejected") {
+	const PackedInt64Array usage = PipelineCacheRD::encode_usage(make_test_usage());
+	HashMap<String, LocalVector<PackedInt64Array>> usage_manifest;
+
+	Array usages;
+	usages.push_back(usage);
+	Dictionary caches;
+	caches["SceneForwardClustered/1234/abcd"] = usages;
+	Dictionary manifest;
+	manifest["version"] = VERSION_FULL_BUILD;
+	manifest["caches"] = caches;
+
+	REQUIRE(PipelineCacheRD::parse_usage_manifest(manifest, usage_manifest));
+	REQUIRE(usage_manifest.size() == 1);
+	REQUIRE(usage_manifest.has("SceneForwardClustered/1234/abcd"));
+	CHECK(usage_manifest["SceneForwardClustered/1234/abcd"].size() == 1);
+
+	SUBCASE("Not a manifest") {
+		CHECK_FALSE(PipelineCacheRD::parse_usage_manifest(Variant(), usage_manifest));
+		CHECK_FALSE(PipelineCacheRD::parse_usage_manifest(usages, usage_manifest));
+		CHECK(usage_manifest.is_empty());
+	}
+
+	SUBCASE("Another engine version") {
+		manifest["version"] = "0.0.0";
+		CHECK_FALSE(PipelineCacheRD::parse_usage_manifest(manifest, usage_manifest));
+		manifest.erase("version");
+		CHECK_FALSE(PipelineCacheRD::parse_usage_manifest(manifest, usage_manifest));
+		CHECK(usage_manifest.is_empty());
+	}
+
+	SUBCASE("Caches of the wrong type") {
+		manifest["caches"] = usages;
+		CHECK_FALSE(PipelineCacheRD::parse_usage_manifest(manifest, usage_manifest));
+		CHECK(usage_manifest.is_empty());
+	}
+
+	SUBCASE("Corrupt entries are dropped") {
+		PackedInt64Array truncated = usage;
+		truncated.resize(usage.size() / 2);
+		Array corrupt_usages;
+		corrupt_usages.push_back(truncated);
+		corrupt_usages.push_back("not a usage");
+		corrupt_usages.push_back(usage);
+		caches["SceneForwardClustered/1234/abcd"] = corrupt_usages;
+		caches["CanvasShaderRD/5678/ef01"] = "not a list of usages";
+		caches[42] = usages;
+		caches["CopyShaderRD/9abc/2345"] = Array();
+
+		CHECK(PipelineCacheRD::parse_usage_manifest(manifest, usage_manifest));
+		REQUIRE(usage_manifest.size() == 1);
+		REQUIRE(usage_manifest.has("SceneForwardClustered/1234/abcd"));
+		REQUIRE(usage_manifest["SceneForwardClustered/1234/abcd"].size() == 1);
+		CHECK(usage_manifest["SceneForwardClustered/1234/abcd"][0] == usage);
+	}
+}
+
+} // namespace TestPipelineCacheRD
+
+#endif // TEST_PIPELINE_CACHE_RD_H
@@ -0,0 +1,256 @@
+/**************************************************************************/
+/*  test_raster_occlusion_cull.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RASTER_OCCLUSION_CULL_H
+#define TEST_RASTER_OCCLUSION_CULL_H
+
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/rendering/raster_occlusion_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRasterOcclusionCull {
+
+class TestRasterHZBuffer : public RasterOcclusionCull::RasterHZBuffer {
+public:
+	float get_depth(int p_x, int p_y) const {
+		return mips[0][p_y * sizes[0].x + p_x];
+	}
+
+	void render(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, const LocalVector<Vector3> &p_vertices, const LocalVector<int32_t> &p_indices) {
+		begin(p_cam_transform, p_cam_projection, p_cam_orthogonal);
+		add_triangles(p_vertices.ptr(), p_vertices.size(), p_indices.ptr(), p_indices.size());
+		rasterize();
+	}
+};
+
+// Brute force version of the camera rays traced by the Embree-based implementation.
+class ReferenceHZBuffer : public RendererSceneOcclusionCull::HZBuffer {
+public:
+	float get_depth(int p_x, int p_y) const {
+		return mips[0][p_y * sizes[0].x + p_x];
+	}
+
+	void render(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal, const LocalVector<Vector3> &p_vertices, const LocalVector<int32_t> &p_indices) {
+		const Size2i &size = sizes[0];
+		real_t z_near = p_cam_projection.get_z_near();
+		Vector3 camera_dir = -p_cam_transform.basis.get_column(2);
+
+		Vector2 viewport_half = p_cam_projection.get_viewport_half_extents();
+		Vector3 pixel_corner = p_cam_transform.xform(Vector3(-viewport_half.x, -viewport_half.y, -z_near));
+		Vector3 pixel_u_interp = p_cam_transform.xform(Vector3(viewport_half.x, -viewport_half.y, -z_near)) - pixel_corner;
+		Vector3 pixel_v_interp = p_cam_transform.xform(Vector3(-viewport_half.x, viewport_half.y, -z_near)) - pixel_corner;
+
+		for (int y = 0; y < size.y; y++) {
+			for (int x = 0; x < size.x; x++) {
+				Vector3 pixel_pos = pixel_corner + (x + 0.5f) / size.x * pixel_u_interp + (y + 0.5f) / size.y * pixel_v_interp;
+				Vector3 origin = p_cam_orthogonal ? pixel_pos - camera_dir * z_near : p_cam_transform.origin;
+				Vector3 dir = p_cam_orthogonal ? camera_dir : (pixel_pos - origin).normalized();
+
+				float depth = p_cam_projection.get_z_far() * 1.05f;
+				for (uint32_t i = 0; i + 2 < p_indices.size(); i += 3) {
+					Vector3 hit;
+					if (Geometry3D::ray_intersects_triangle(origin, dir, p_vertices[p_indices[i]], p_vertices[p_indices[i + 1]], p_vertices[p_indices[i + 2]], &hit)) {
+						float distance = (hit - origin).length();
+						if (distance >= z_near) {
+							depth = MIN(depth, distance);
+						}
+					}
+				}
+				mips[0][y * size.x + x] = depth;
+			}
+		}
+		update_mips();
+	}
+};
+
+static void add_quad(const Transform3D &p_xform, const Vector2 &p_size, LocalVector<Vector3> &r_vertices, LocalVector<int32_t> &r_indices) {
+	int32_t base = r_vertices.size();
+	r_vertices.push_back(p_xform.xform(Vector3(-p_size.x, -p_size.y, 0.0) * 0.5));
+	r_vertices.push_back(p_xform.xform(Vector3(p_size.x, -p_size.y, 0.0) * 0.5));
+	r_vertices.push_back(p_xform.xform(Vector3(p_size.x, p_size.y, 0.0) * 0.5));
+	r_vertices.push_back(p_xform.xform(Vector3(-p_size.x, p_size.y, 0.0) * 0.5));
+	const int32_t quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int32_t index : quad_indices) {
+		r_indices.push_back(base + index);
+	}
+}
+
+static void add_random_quads(RandomPCG &p_rng, uint32_t p_count, LocalVector<Vector3> &r_vertices, LocalVector<int32_t> &r_indices) {
+	for (uint32_t i = 0; i < p_count; i++) {
+		Transform3D xform;
+		xform.basis = Basis::from_euler(Vector3(p_rng.random(-0.8, 0.8), p_rng.random(-0.8, 0.8), p_rng.random(-Math_PI, Math_PI)));
+		xform.origin = Vector3(p_rng.random(-15.0, 15.0), p_rng.random(-8.0, 8.0), p_rng.random(-40.0, -4.0));
+		add_quad(xform, Vector2(p_rng.random(2.0, 8.0), p_rng.random(2.0, 8.0)), r_vertices, r_indices);
+	}
+}
+
+template <typename T>
+static bool is_box_occluded(const T &p_buffer, const AABB &p_box, const Transform3D &p_cam_transform, const Projection &p_cam_projection) {
+	const real_t bounds[6] = { p_box.position.x, p_box.position.y, p_box.position.z, p_box.position.x + p_box.size.x, p_box.position.y + p_box.size.y, p_box.position.z + p_box.size.z };
+	uint64_t occlusion_timeout = 0;
+	return p_buffer.is_occluded(bounds, p_cam_transform.origin, p_cam_transform.affine_inverse(), p_cam_projection, p_cam_projection.get_z_near(), occlusion_timeout);
+}
+
+TEST_CASE("[RasterOcclusionCull] Wall occludes what is behind it") {
+	bool jitter_enabled = RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled;
+	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = false;
+
+	LocalVector<Vector3> vertices;
+	LocalVector<int32_t> indices;
+	add_quad(Transform3D(Basis(), Vector3(0, 0, -10)), Vector2(6, 6), vertices, indices);
+
+	TestRasterHZBuffer buffer;
+	buffer.resize(Size2i(128, 72));
+	Transform3D camera_transform;
+
+	SUBCASE("Perspective") {
+		Projection projection;
+		projection.set_perspective(70.0, 16.0 / 9.0, 0.05, 100.0);
+		buffer.render(camera_transform, projection, false, vertices, indices);
+
+		CHECK_MESSAGE(Math::is_equal_approx(buffer.get_depth(64, 36), 10.0f, 0.1f), "The wall depth should be the distance to the camera.");
+		CHECK(buffer.get_depth(0, 0) > 100.0f);
+		CHECK(is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1)), camera_transform, projection));
+		CHECK_FALSE(is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -5.5), Vector3(1, 1, 1)), camera_transform, projection));
+		CHECK_FALSE(is_box_occluded(buffer, AABB(Vector3(9.5, -0.5, -20.5), Vector3(1, 1, 1)), camera_transform, projection));
+	}
+
+	SUBCASE("Orthogonal") {
+		Projection projection;
+		projection.set_orthogonal(20.0, 16.0 / 9.0, 0.05, 100.0, true);
+		buffer.render(camera_transform, projection, true, vertices, indices);
+
+		CHECK(Math::is_equal_approx(buffer.get_depth(64, 36), 10.0f, 0.1f));
+		CHECK(is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -20.5), Vector3(1, 1, 1)), camera_transform, projection));
+		CHECK_FALSE(is_box_occluded(buffer, AABB(Vector3(-0.5, -0.5, -5.5), Vector3(1, 1, 1)), camera_transform, projection));
+		CHECK_FALSE(is_box_occluded(buffer, AABB(Vector3(7.5, -0.5, -20.5), Vector3(1, 1, 1)), camera_transform, projection));
+	}
+
+	SUBCASE("Floor crossing the near plane") {
+		LocalVector<Vector3> floor_vertices;
+		LocalVector<int32_t> floor_indices;
+		add_quad(Transform3D(Basis(Vector3(1, 0, 0), -Math_PI / 2.0), Vector3(0, -1, 0)), Vector2(40, 40), floor_vertices, floor_indices);
+
+		Projection projection;
+		projection.set_perspective(70.0, 16.0 / 9.0, 0.05, 100.0);
+		buffer.render(camera_transform, projection, false, floor_vertices, floor_indices);
+
+		// The floor goes behind the camera, so it's clipped instead of wrapping around.
+		CHECK(buffer.get_depth(64, 0) < 25.0f);
+		CHECK(buffer.get_depth(64, 71) > 100.0f);
+	}
+
+	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = jitter_enabled;
+}
+
+TEST_CASE("[RasterOcclusionCull] Rasterized depth matches ray traced depth") {
+	bool jitter_enabled = RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled;
+	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = false;
+
+	RandomPCG rng(4321);
+	LocalVector<Vector3> vertices;
+	LocalVector<int32_t> indices;
+	add_random_quads(rng, 40, vertices, indices);
+
+	Transform3D camera_transform;
+	camera_transform.basis = Basis::from_euler(Vector3(0.05, -0.1, 0.0));
+	Projection projection;
+	projection.set_perspective(70.0, 16.0 / 9.0, 0.05, 100.0);
+
+	const Size2i size(160, 90);
+	TestRasterHZBuffer raster_buffer;
+	raster_buffer.resize(size);
+	raster_buffer.render(camera_transform, projection, false, vertices, indices);
+	ReferenceHZBuffer reference_buffer;
+	reference_buffer.resize(size);
+	reference_buffer.render(camera_transform, projection, false, vertices, indices);
+
+	// Only pixels along triangle edges may differ.
+	int matching_pixels = 0;
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			matching_pixels += Math::is_equal_approx(raster_buffer.get_depth(x, y), reference_buffer.get_depth(x, y), 0.01f * reference_buffer.get_depth(x, y));
+		}
+	}
+	CHECK(matching_pixels >= size.x * size.y * 0.98f);
+
+	int matching_boxes = 0;
+	const int box_count = 2000;
+	for (int i = 0; i < box_count; i++) {
+		AABB box(Vector3(rng.random(-20.0, 20.0), rng.random(-10.0, 10.0), rng.random(-60.0, -2.0)), Vector3(rng.random(0.2, 2.0), rng.random(0.2, 2.0), rng.random(0.2, 2.0)));
+		matching_boxes += is_box_occluded(raster_buffer, box, camera_transform, projection) == is_box_occluded(reference_buffer, box, camera_transform, projection);
+	}
+	CHECK(matching_boxes >= box_count * 0.98f);
+
+	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = jitter_enabled;
+}
+
+TEST_CASE("[RasterOcclusionCull] Rasterization performance") {
+	// Rough comparison against ray tracing every pixel, only printed with --verbose.
+	RandomPCG rng(1234);
+	LocalVector<Vector3> vertices;
+	LocalVector<int32_t> indices;
+	add_random_quads(rng, 200, vertices, indices);
+
+	Transform3D camera_transform;
+	Projection projection;
+	projection.set_perspective(70.0, 16.0 / 9.0, 0.05, 100.0);
+
+	// Typical occlusion buffer size.
+	const Size2i size(256, 144);
+	TestRasterHZBuffer raster_buffer;
+	raster_buffer.resize(size);
+	ReferenceHZBuffer reference_buffer;
+	reference_buffer.resize(size);
+
+	uint64_t raster_begin = OS::get_singleton()->get_ticks_usec();
+	raster_buffer.render(camera_transform, projection, false, vertices, indices);
+	uint64_t raster_usec = OS::get_singleton()->get_ticks_usec() - raster_begin;
+
+	uint64_t reference_begin = OS::get_singleton()->get_ticks_usec();
+	reference_buffer.render(camera_transform, projection, false, vertices, indices);
+	uint64_t reference_usec = OS::get_singleton()->get_ticks_usec() - reference_begin;
+
+	int matching_pixels = 0;
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			matching_pixels += Math::is_equal_approx(raster_buffer.get_depth(x, y), reference_buffer.get_depth(x, y), 0.01f * reference_buffer.get_depth(x, y));
+		}
+	}
+
+	print_verbose(vformat("Filled a %dx%d occlusion buffer with %d triangles: %d usec rasterized, %d usec ray traced (brute force), %.2f%% of the pixels matching.", size.x, size.y, indices.size() / 3, raster_usec, reference_usec, matching_pixels * 100.0 / (size.x * size.y)));
+}
+
+} // namespace TestRasterOcclusionCull
+
+#endif // TEST_RASTER_OCCLUSION_CULL_H
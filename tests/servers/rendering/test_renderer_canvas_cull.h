@@ -0,0 +1,360 @@
+/**************************************************************************/
+/*  test_renderer_canvas_cull.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_CANVAS_CULL_H
+#define TEST_RENDERER_CANVAS_CULL_H
+
+#include "core/config/project_settings.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererCanvasCull {
+
+static Vector<RID> to_rids(const LocalVector<RendererCanvasCull::Item *> &p_items, const Vector<RID> &p_rids) {
+	HashMap<RendererCanvasCull::Item *, RID> rids;
+	for (const RID &rid : p_rids) {
+		rids.insert(RSG::canvas->canvas_item_owner.get_or_null(rid), rid);
+	}
+	Vector<RID> result;
+	for (RendererCanvasCull::Item *item : p_items) {
+		result.push_back(rids[item]);
+	}
+	return result;
+}
+
+// Returns the items attached for drawing, in draw order.
+static Vector<RID> render_test_canvas(RID p_canvas, const Vector<RID> &p_items, const Transform2D &p_transform, const Rect2 &p_clip_rect) {
+	RendererCanvasCull *canvas_cull = RSG::canvas;
+	const Rect2 not_drawn(-1, -1, -1, -1);
+	for (const RID &rid : p_items) {
+		canvas_cull->canvas_item_owner.get_or_null(rid)->global_rect_cache = not_drawn;
+	}
+
+	canvas_cull->render_canvas(RID(), canvas_cull->canvas_owner.get_or_null(p_canvas), p_transform, nullptr, nullptr, p_clip_rect, RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF);
+
+	LocalVector<RendererCanvasCull::Item *> drawn;
+	HashSet<RendererCanvasRender::Item *> linked;
+	for (const RID &rid : p_items) {
+		RendererCanvasCull::Item *item = canvas_cull->canvas_item_owner.get_or_null(rid);
+		if (item->global_rect_cache != not_drawn) {
+			drawn.push_back(item);
+			linked.insert(item->next);
+		}
+	}
+
+	// Drawn items are linked in draw order.
+	LocalVector<RendererCanvasCull::Item *> ordered;
+	for (RendererCanvasCull::Item *item : drawn) {
+		if (!linked.has(item)) {
+			for (RendererCanvasRender::Item *c = item; c; c = c->next) {
+				ordered.push_back(static_cast<RendererCanvasCull::Item *>(c));
+			}
+			break;
+		}
+	}
+	return to_rids(ordered, p_items);
+}
+
+// What culling every item one by one draws.
+static Vector<RID> expected_drawn_items(const Vector<RID> &p_items, const Transform2D &p_transform, const Rect2 &p_clip_rect) {
+	LocalVector<RendererCanvasCull::Item *> expected;
+	for (const RID &rid : p_items) {
+		RendererCanvasCull::Item *item = RSG::canvas->canvas_item_owner.get_or_null(rid);
+		if (item->parent.is_valid() && item->visible && item->commands && p_clip_rect.intersects((p_transform * item->xform_curr).xform(item->get_rect()), true)) {
+			expected.push_back(item);
+		}
+	}
+	expected.sort_custom<RendererCanvasCull::ItemIndexSort>();
+	return to_rids(expected, p_items);
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Spatial index") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID canvas = rs->canvas_create();
+	RID parent = rs->canvas_item_create();
+	rs->canvas_item_set_parent(parent, canvas);
+
+	// A grid of 8x8 rects as children, drawn in reverse order.
+	const int size = 40;
+	Vector<RID> children;
+	for (int i = 0; i < size * size; i++) {
+		RID child = rs->canvas_item_create();
+		rs->canvas_item_set_parent(child, parent);
+		rs->canvas_item_set_transform(child, Transform2D(0.0, Vector2((i % size) * 16.0, (i / size) * 16.0)));
+		rs->canvas_item_set_draw_index(child, size * size - i);
+		rs->canvas_item_add_rect(child, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+		children.push_back(child);
+	}
+
+	const Transform2D transform(0.3, Size2(1.5, 1.5), 0.0, Vector2(-100, -50));
+	const Rect2 clip_rect(0, 0, 320, 240);
+
+	Vector<RID> drawn_without_index = render_test_canvas(canvas, children, transform, clip_rect);
+	CHECK(drawn_without_index == expected_drawn_items(children, transform, clip_rect));
+	CHECK(drawn_without_index.size() > 0);
+	CHECK(drawn_without_index.size() < children.size() / 2);
+
+	rs->canvas_item_set_use_spatial_index(parent, true);
+	CHECK_MESSAGE(render_test_canvas(canvas, children, transform, clip_rect) == drawn_without_index, "The same items should be drawn in the same order.");
+
+	SUBCASE("Changes are picked up") {
+		// Into view.
+		rs->canvas_item_set_transform(children[size * size - 1], Transform2D(0.0, Vector2(150, 150)));
+		// Out of view.
+		rs->canvas_item_set_transform(drawn_without_index[0], Transform2D(0.0, Vector2(-1000, 0)));
+		// Redrawn larger.
+		rs->canvas_item_clear(children[size * size - 2]);
+		rs->canvas_item_add_rect(children[size * size - 2], Rect2(-2000, -2000, 4000, 4000), Color(1, 1, 1));
+		// Nothing left to draw.
+		rs->canvas_item_clear(drawn_without_index[1]);
+		// Hidden.
+		rs->canvas_item_set_visible(drawn_without_index[2], false);
+
+		Vector<RID> drawn = render_test_canvas(canvas, children, transform, clip_rect);
+		CHECK(drawn == expected_drawn_items(children, transform, clip_rect));
+		CHECK(drawn.has(children[size * size - 1]));
+		CHECK(drawn.has(children[size * size - 2]));
+		CHECK_FALSE(drawn.has(drawn_without_index[0]));
+		CHECK_FALSE(drawn.has(drawn_without_index[1]));
+		CHECK_FALSE(drawn.has(drawn_without_index[2]));
+	}
+
+	SUBCASE("Children added, removed and freed") {
+		RID added = rs->canvas_item_create();
+		rs->canvas_item_set_parent(added, parent);
+		rs->canvas_item_set_transform(added, Transform2D(0.0, Vector2(150, 150)));
+		rs->canvas_item_add_rect(added, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+		rs->canvas_item_set_parent(drawn_without_index[0], RID());
+		RID freed = drawn_without_index[1];
+		rs->free(freed);
+		children.erase(freed);
+
+		Vector<RID> items = children;
+		items.push_back(added);
+		Vector<RID> drawn = render_test_canvas(canvas, items, transform, clip_rect);
+		CHECK(drawn == expected_drawn_items(items, transform, clip_rect));
+		CHECK(drawn.has(added));
+		CHECK_FALSE(drawn.has(drawn_without_index[0]));
+
+		rs->canvas_item_set_parent(drawn_without_index[0], parent);
+		CHECK(render_test_canvas(canvas, items, transform, clip_rect) == expected_drawn_items(items, transform, clip_rect));
+		rs->free(added);
+	}
+
+	SUBCASE("Children that can't be indexed") {
+		// Items with children of their own are always culled, including after their children change.
+		RID grandchild = rs->canvas_item_create();
+		rs->canvas_item_set_parent(grandchild, children[0]);
+		rs->canvas_item_add_rect(grandchild, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+		rs->canvas_item_set_transform(children[0], Transform2D(0.0, Vector2(150, 150)));
+		rs->canvas_item_set_update_when_visible(children[1], true);
+		rs->canvas_item_set_transform(children[1], Transform2D(0.0, Vector2(160, 150)));
+
+		Vector<RID> items = children;
+		items.push_back(grandchild);
+		Vector<RID> drawn = render_test_canvas(canvas, items, transform, clip_rect);
+		CHECK(drawn.has(children[0]));
+		CHECK(drawn.has(children[1]));
+		CHECK(drawn.has(grandchild));
+
+		rs->canvas_item_set_update_when_visible(children[1], false);
+		rs->free(grandchild);
+	}
+
+	SUBCASE("Disabling the index") {
+		rs->canvas_item_set_transform(children[size * size - 1], Transform2D(0.0, Vector2(150, 150)));
+		rs->canvas_item_set_use_spatial_index(parent, false);
+		CHECK(render_test_canvas(canvas, children, transform, clip_rect) == expected_drawn_items(children, transform, clip_rect));
+	}
+
+	for (const RID &child : children) {
+		rs->free(child);
+	}
+	rs->free(parent);
+	rs->free(canvas);
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Threaded culling") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID canvas = rs->canvas_create();
+	RID parent = rs->canvas_item_create();
+	rs->canvas_item_set_parent(parent, canvas);
+
+	// A grid of 8x8 rects as children, drawn in reverse order.
+	const int size = 40;
+	Vector<RID> children;
+	for (int i = 0; i < size * size; i++) {
+		RID child = rs->canvas_item_create();
+		rs->canvas_item_set_parent(child, parent);
+		rs->canvas_item_set_transform(child, Transform2D(0.0, Vector2((i % size) * 16.0, (i / size) * 16.0)));
+		rs->canvas_item_set_draw_index(child, size * size - i);
+		rs->canvas_item_add_rect(child, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+		children.push_back(child);
+	}
+	RendererCanvasCull *canvas_cull = RSG::canvas;
+
+	// Some items in front of the others, and some behind their parent.
+	for (int i = 0; i < children.size(); i += 7) {
+		rs->canvas_item_set_z_index(children[i], 1);
+	}
+	for (int i = 0; i < children.size(); i += 11) {
+		rs->canvas_item_set_draw_behind_parent(children[i], true);
+	}
+	rs->canvas_item_add_rect(parent, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+
+	Vector<RID> items = children;
+	items.push_back(parent);
+	const Transform2D transform(0.0, Vector2(-100, -60));
+	const Rect2 clip_rect(0, 0, 320, 240);
+
+	SUBCASE("Children") {
+		canvas_cull->set_threaded_cull_minimum_items(INT_MAX);
+		Vector<RID> single_threaded = render_test_canvas(canvas, items, transform, clip_rect);
+		canvas_cull->set_threaded_cull_minimum_items(1);
+		Vector<RID> threaded = render_test_canvas(canvas, items, transform, clip_rect);
+		CHECK(single_threaded.size() > 0);
+		CHECK(threaded == single_threaded);
+	}
+
+	SUBCASE("Y-sorted subtree") {
+		rs->canvas_item_set_sort_children_by_y(parent, true);
+		canvas_cull->set_threaded_cull_minimum_items(INT_MAX);
+		Vector<RID> single_threaded = render_test_canvas(canvas, items, transform, clip_rect);
+		canvas_cull->set_threaded_cull_minimum_items(1);
+		Vector<RID> threaded = render_test_canvas(canvas, items, transform, clip_rect);
+		CHECK(single_threaded.size() > 0);
+		CHECK(threaded == single_threaded);
+	}
+
+	canvas_cull->set_threaded_cull_minimum_items(GLOBAL_GET("rendering/2d/cull/threaded_cull_minimum_items"));
+	for (const RID &child : children) {
+		rs->free(child);
+	}
+	rs->free(parent);
+	rs->free(canvas);
+}
+
+struct TestYSort {
+	const Vector<RID> *items = nullptr;
+
+	bool operator()(int p_left, int p_right) const {
+		const real_t left_y = RSG::canvas->canvas_item_owner.get_or_null((*items)[p_left])->xform_curr.columns[2].y;
+		const real_t right_y = RSG::canvas->canvas_item_owner.get_or_null((*items)[p_right])->xform_curr.columns[2].y;
+		if (Math::is_equal_approx(left_y, right_y)) {
+			return p_left < p_right;
+		}
+		return left_y < right_y;
+	}
+};
+
+// What sorting the children of a y-sorted item from scratch draws, given in child order.
+static Vector<RID> fresh_y_sort(const Vector<RID> &p_children) {
+	LocalVector<int> order;
+	for (int i = 0; i < p_children.size(); i++) {
+		order.push_back(i);
+	}
+	SortArray<int, TestYSort> sorter;
+	sorter.compare.items = &p_children;
+	sorter.sort(order.ptr(), order.size());
+
+	Vector<RID> result;
+	for (int i : order) {
+		result.push_back(p_children[i]);
+	}
+	return result;
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Y-sort order kept between frames") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID canvas = rs->canvas_create();
+	RID parent = rs->canvas_item_create();
+	rs->canvas_item_set_parent(parent, canvas);
+	rs->canvas_item_set_sort_children_by_y(parent, true);
+
+	Vector<RID> children;
+	for (int i = 0; i < 32; i++) {
+		RID child = rs->canvas_item_create();
+		rs->canvas_item_set_parent(child, parent);
+		rs->canvas_item_set_transform(child, Transform2D(0.0, Vector2(i * 4.0, 1.0 + (i * 37) % 32)));
+		rs->canvas_item_add_rect(child, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+		children.push_back(child);
+	}
+
+	const Rect2 clip_rect(0, 0, 1000, 1000);
+	CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == fresh_y_sort(children));
+	// Unchanged, the previous order is kept.
+	CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == fresh_y_sort(children));
+
+	SUBCASE("Reordering") {
+		for (int i = 0; i < children.size(); i += 3) {
+			rs->canvas_item_set_transform(children[i], Transform2D(0.0, Vector2(i * 4.0, 40.0 - i)));
+		}
+		CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == fresh_y_sort(children));
+	}
+
+	SUBCASE("Inserting") {
+		RID child = rs->canvas_item_create();
+		rs->canvas_item_set_parent(child, parent);
+		rs->canvas_item_set_transform(child, Transform2D(0.0, Vector2(0, 15.5)));
+		rs->canvas_item_add_rect(child, Rect2(0, 0, 8, 8), Color(1, 1, 1));
+		children.push_back(child);
+		CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == fresh_y_sort(children));
+	}
+
+	SUBCASE("Removing") {
+		for (int i = children.size() - 1; i >= 0; i -= 4) {
+			rs->free(children[i]);
+			children.remove_at(i);
+		}
+		CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == fresh_y_sort(children));
+	}
+
+	SUBCASE("Equal Y keeps the child order") {
+		for (int i = 0; i < children.size(); i++) {
+			rs->canvas_item_set_transform(children[i], Transform2D(0.0, Vector2(i * 4.0, 10.0)));
+		}
+		CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == children);
+		CHECK(render_test_canvas(canvas, children, Transform2D(), clip_rect) == children);
+	}
+
+	for (const RID &child : children) {
+		rs->free(child);
+	}
+	rs->free(parent);
+	rs->free(canvas);
+}
+
+} // namespace TestRendererCanvasCull
+
+#endif // TEST_RENDERER_CANVAS_CULL_H
@@ -0,0 +1,218 @@
+/**************************************************************************/
+/*  test_renderer_scene_cull.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "core/math/random_pcg.h"
+#include "servers/rendering/renderer_scene_cull.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+static RendererSceneCull::Frustum make_test_frustum() {
+	Projection projection;
+	projection.set_perspective(70.0, 16.0 / 9.0, 0.05, 500.0);
+	Transform3D camera_transform;
+	camera_transform.basis = Basis::from_euler(Vector3(-0.3, 0.6, 0.0));
+	camera_transform.origin = Vector3(5.0, 20.0, -3.0);
+	return RendererSceneCull::Frustum(projection.get_projection_planes(camera_transform));
+}
+
+static void fill_test_instances(RandomPCG &p_rng, uint32_t p_count, LocalVector<RendererSceneCull::InstanceBounds> &r_bounds, LocalVector<uint32_t> &r_layer_masks, LocalVector<RendererSceneCull::InstanceCullBlock> &r_blocks) {
+	r_bounds.resize(p_count);
+	r_layer_masks.resize(p_count);
+	r_blocks.resize((p_count + RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE - 1) / RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE);
+	for (uint32_t i = 0; i < p_count; i++) {
+		Vector3 position(p_rng.random(-500.0, 500.0), p_rng.random(-100.0, 100.0), p_rng.random(-500.0, 500.0));
+		Vector3 size(p_rng.random(0.1, 20.0), p_rng.random(0.1, 20.0), p_rng.random(0.1, 20.0));
+		r_bounds[i] = RendererSceneCull::InstanceBounds(AABB(position, size));
+		r_layer_masks[i] = 1 << (p_rng.rand() % 4);
+
+		RendererSceneCull::InstanceCullBlock &block = r_blocks[i / RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE];
+		block.set_bounds(i % RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE, r_bounds[i]);
+		block.layer_mask[i % RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE] = r_layer_masks[i];
+	}
+}
+
+TEST_CASE("[RendererSceneCull] Block frustum culling matches per-instance culling") {
+	RandomPCG rng(1234);
+	RendererSceneCull::Frustum frustum = make_test_frustum();
+
+	LocalVector<RendererSceneCull::InstanceBounds> bounds;
+	LocalVector<uint32_t> layer_masks;
+	LocalVector<RendererSceneCull::InstanceCullBlock> blocks;
+	const uint32_t count = 4099; // Last block is partially filled.
+	fill_test_instances(rng, count, bounds, layer_masks, blocks);
+
+	const uint32_t visible_layers = 0b0101;
+	uint32_t mismatches = 0;
+	uint32_t visible = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		bool expected = (layer_masks[i] & visible_layers) && bounds[i].in_frustum(frustum);
+		bool result = blocks[i / RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE].cull(frustum, visible_layers) & (1 << (i % RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE));
+		mismatches += expected != result;
+		visible += result;
+	}
+	CHECK_MESSAGE(mismatches == 0, "Block culling should give the same result as InstanceBounds::in_frustum().");
+	CHECK_MESSAGE(visible > 0, "Some instances should be visible.");
+	CHECK_MESSAGE(visible < count / 2, "Most instances should be culled.");
+
+	SUBCASE("Unused lanes are never visible") {
+		RendererSceneCull::InstanceCullBlock &last_block = blocks[blocks.size() - 1];
+		for (uint32_t lane = count % RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE; lane < RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE; lane++) {
+			// Even with bounds covering the whole frustum.
+			last_block.set_bounds(lane, RendererSceneCull::InstanceBounds(AABB(Vector3(-1000, -1000, -1000), Vector3(2000, 2000, 2000))));
+			last_block.clear_lane(lane);
+		}
+		uint32_t unused_lanes = ~((1u << (count % RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE)) - 1) & ((1u << RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE) - 1);
+		CHECK((last_block.cull(frustum, 0xFFFFFFFF) & unused_lanes) == 0);
+	}
+
+	SUBCASE("Copying lanes") {
+		RendererSceneCull::InstanceCullBlock block;
+		block.copy_lane(3, blocks[0], 5);
+		block.set_ignore_culling(3, true);
+		block.set_dynamic_shadow_caster(3, true);
+		CHECK(block.layer_mask[3] == layer_masks[5]);
+		CHECK(bool(block.cull(frustum, 0xFFFFFFFF) & (1 << 3)) == bounds[5].in_frustum(frustum));
+		CHECK(block.ignore_culling_mask == (1 << 3));
+		CHECK(block.dynamic_shadow_caster_mask == (1 << 3));
+
+		RendererSceneCull::InstanceCullBlock other;
+		other.copy_lane(0, block, 3);
+		CHECK(other.ignore_culling_mask == 1);
+		CHECK(other.dynamic_shadow_caster_mask == 1);
+
+		other.clear_lane(0);
+		CHECK(other.ignore_culling_mask == 0);
+		CHECK(other.dynamic_shadow_caster_mask == 0);
+	}
+}
+
+TEST_CASE("[RendererSceneCull] Frustum culling performance") {
+	// Rough comparison against culling instances one by one, only printed with --verbose.
+	RandomPCG rng(5678);
+	RendererSceneCull::Frustum frustum = make_test_frustum();
+
+	LocalVector<RendererSceneCull::InstanceBounds> bounds;
+	LocalVector<uint32_t> layer_masks;
+	LocalVector<RendererSceneCull::InstanceCullBlock> blocks;
+	const uint32_t count = 200000;
+	fill_test_instances(rng, count, bounds, layer_masks, blocks);
+
+	const uint32_t visible_layers = 0xFFFFFFFF;
+
+	uint64_t scalar_begin = OS::get_singleton()->get_ticks_usec();
+	uint32_t scalar_visible = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		scalar_visible += (layer_masks[i] & visible_layers) && bounds[i].in_frustum(frustum);
+	}
+	uint64_t scalar_usec = OS::get_singleton()->get_ticks_usec() - scalar_begin;
+
+	uint64_t block_begin = OS::get_singleton()->get_ticks_usec();
+	uint32_t block_visible = 0;
+	for (const RendererSceneCull::InstanceCullBlock &block : blocks) {
+		uint32_t mask = block.cull(frustum, visible_layers);
+		for (; mask; mask &= mask - 1) {
+			block_visible++;
+		}
+	}
+	uint64_t block_usec = OS::get_singleton()->get_ticks_usec() - block_begin;
+
+	print_verbose(vformat("Culled %d instances (%d visible one by one, %d in blocks): %d usec one by one, %d usec in blocks of %d.", count, scalar_visible, block_visible, scalar_usec, block_usec, RendererSceneCull::INSTANCE_CULL_BLOCK_SIZE));
+}
+
+TEST_CASE("[SceneTree][RendererSceneCull] Batched instance transforms") {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+	const uint32_t count = 64;
+	Vector<RID> instances;
+	for (uint32_t i = 0; i < count; i++) {
+		RID instance = rs->instance_create2(mesh, scenario);
+		rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+		rs->instance_attach_object_instance_id(instance, ObjectID(uint64_t(i + 1)));
+		instances.push_back(instance);
+	}
+
+	Vector<Transform3D> transforms;
+	transforms.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		transforms.write[i] = Transform3D(Basis(), Vector3(i * 10.0, 0, 0));
+	}
+	rs->instance_set_transforms(instances, transforms);
+
+	SUBCASE("Instances are placed") {
+		for (uint32_t i = 0; i < count; i++) {
+			Vector<ObjectID> culled = rs->instances_cull_aabb(AABB(Vector3(i * 10.0 - 1.0, -1, -1), Vector3(2, 2, 2)), scenario);
+			REQUIRE(culled.size() == 1);
+			CHECK(culled[0] == ObjectID(uint64_t(i + 1)));
+		}
+	}
+
+	SUBCASE("Small and large motions") {
+		// Every other instance moves a little, every fourth one moves far away, which reinserts it.
+		for (uint32_t i = 0; i < count; i += 2) {
+			transforms.write[i].origin += (i % 4 == 0) ? Vector3(0, 1000, 0) : Vector3(0.5, 0.25, 0);
+		}
+		rs->instance_set_transforms(instances, transforms);
+
+		for (uint32_t i = 0; i < count; i++) {
+			Vector<ObjectID> culled = rs->instances_cull_aabb(AABB(transforms[i].origin - Vector3(0.1, 0.1, 0.1), Vector3(0.2, 0.2, 0.2)), scenario);
+			REQUIRE(culled.size() == 1);
+			CHECK(culled[0] == ObjectID(uint64_t(i + 1)));
+		}
+		CHECK(rs->instances_cull_aabb(AABB(Vector3(-1, -1, -1), Vector3(count * 10.0, 2, 2)), scenario).size() == int(count - count / 4));
+	}
+
+	SUBCASE("Mismatched sizes are rejected") {
+		Vector<Transform3D> moved = transforms;
+		moved.write[0].origin = Vector3(0, 500, 0);
+		moved.resize(count - 1);
+
+		ERR_PRINT_OFF;
+		rs->instance_set_transforms(instances, moved);
+		ERR_PRINT_ON;
+
+		CHECK(rs->instances_cull_aabb(AABB(Vector3(-1, -1, -1), Vector3(2, 2, 2)), scenario).size() == 1);
+	}
+
+	for (const RID &instance : instances) {
+		rs->free(instance);
+	}
+	rs->free(mesh);
+	rs->free(scenario);
+}
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
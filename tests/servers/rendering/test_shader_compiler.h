@@ -0,0 +1,290 @@
+/**************************************************************************/
+/*  test_shader_compiler.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SHADER_COMPILER_H
+#define TEST_SHADER_COMPILER_H
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/object/worker_thread_pool.h"
+#include "servers/rendering/shader_compiler.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestShaderCompiler {
+
+// Receives what compiling reports through the identifier actions.
+struct CompileResult {
+	ShaderCompiler::GeneratedCode gen_code;
+	HashMap<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+	int blend_mode = 0;
+	bool unshaded = false;
+	bool uses_alpha = false;
+	bool uses_time = false;
+	bool writes_vertex = false;
+	Error error = FAILED;
+
+	void compile(ShaderCompiler &p_compiler, const String &p_code) {
+		ShaderCompiler::IdentifierActions actions;
+		actions.entry_point_stages["vertex"] = ShaderCompiler::STAGE_VERTEX;
+		actions.entry_point_stages["fragment"] = ShaderCompiler::STAGE_FRAGMENT;
+		actions.render_mode_values["blend_add"] = Pair<int *, int>(&blend_mode, 1);
+		actions.render_mode_values["blend_mix"] = Pair<int *, int>(&blend_mode, 0);
+		actions.render_mode_flags["unshaded"] = &unshaded;
+		actions.usage_flag_pointers["ALPHA"] = &uses_alpha;
+		actions.usage_flag_pointers["TIME"] = &uses_time;
+		actions.write_flag_pointers["VERTEX"] = &writes_vertex;
+		actions.uniforms = &uniforms;
+		error = p_compiler.compile(RS::SHADER_SPATIAL, p_code, &actions, "", gen_code);
+	}
+};
+
+static void initialize_compiler(ShaderCompiler &r_compiler) {
+	ShaderCompiler::DefaultIdentifierActions actions;
+	actions.renames["ALBEDO"] = "albedo_highp";
+	actions.renames["ALPHA"] = "alpha_highp";
+	actions.renames["TIME"] = "global_time";
+	actions.render_mode_defines["unshaded"] = "#define MODE_UNSHADED\n";
+	actions.base_uniform_string = "material.";
+	actions.base_texture_binding_index = 1;
+	actions.texture_layout_set = 2;
+	r_compiler.initialize(actions);
+}
+
+static String make_shader_code(int p_index) {
+	return vformat(R"(
+shader_type spatial;
+render_mode blend_add, unshaded;
+
+uniform vec4 albedo : source_color = vec4(1.0, 0.5, 0.25, 1.0);
+uniform float strength : hint_range(0.0, 4.0) = %d.0;
+uniform sampler2D tex : filter_nearest;
+
+void vertex() {
+	VERTEX += NORMAL * strength;
+}
+
+void fragment() {
+	ALBEDO = albedo.rgb * texture(tex, UV).rgb * sin(TIME * %d.0);
+	ALPHA = 0.5;
+}
+)",
+			p_index, p_index);
+}
+
+static void check_same_result(const CompileResult &p_a, const CompileResult &p_b) {
+	CHECK(p_a.error == OK);
+	CHECK(p_b.error == OK);
+	CHECK(p_a.gen_code.defines == p_b.gen_code.defines);
+	CHECK(p_a.gen_code.uniforms == p_b.gen_code.uniforms);
+	CHECK(p_a.gen_code.uniform_total_size == p_b.gen_code.uniform_total_size);
+	CHECK(p_a.gen_code.uniform_offsets == p_b.gen_code.uniform_offsets);
+	CHECK(p_a.gen_code.texture_uniforms.size() == p_b.gen_code.texture_uniforms.size());
+	CHECK(p_a.gen_code.uses_fragment_time == p_b.gen_code.uses_fragment_time);
+	for (int i = 0; i < ShaderCompiler::STAGE_MAX; i++) {
+		CHECK(p_a.gen_code.stage_globals[i] == p_b.gen_code.stage_globals[i]);
+	}
+	CHECK(p_a.gen_code.code.size() == p_b.gen_code.code.size());
+	for (const KeyValue<String, String> &E : p_a.gen_code.code) {
+		REQUIRE(p_b.gen_code.code.has(E.key));
+		CHECK(p_b.gen_code.code[E.key] == E.value);
+	}
+
+	CHECK(p_a.blend_mode == p_b.blend_mode);
+	CHECK(p_a.unshaded == p_b.unshaded);
+	CHECK(p_a.uses_alpha == p_b.uses_alpha);
+	CHECK(p_a.uses_time == p_b.uses_time);
+	CHECK(p_a.writes_vertex == p_b.writes_vertex);
+
+	CHECK(p_a.uniforms.size() == p_b.uniforms.size());
+	for (const KeyValue<StringName, ShaderLanguage::ShaderNode::Uniform> &E : p_a.uniforms) {
+		REQUIRE(p_b.uniforms.has(E.key));
+		const ShaderLanguage::ShaderNode::Uniform &uniform = p_b.uniforms[E.key];
+		CHECK(uniform.order == E.value.order);
+		CHECK(uniform.texture_order == E.value.texture_order);
+		CHECK(uniform.type == E.value.type);
+		CHECK(uniform.hint == E.value.hint);
+		CHECK(uniform.filter == E.value.filter);
+		CHECK(uniform.hint_range[1] == E.value.hint_range[1]);
+		REQUIRE(uniform.default_value.size() == E.value.default_value.size());
+		for (int i = 0; i < uniform.default_value.size(); i++) {
+			CHECK(uniform.default_value[i].uint == E.value.default_value[i].uint);
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][ShaderCompiler] Generated code cache") {
+	const String cache_dir = TestUtils::get_temp_path("shader_compiler_cache");
+	if (DirAccess::exists(cache_dir)) {
+		Ref<DirAccess> da = DirAccess::open(cache_dir);
+		da->erase_contents_recursive();
+	}
+	ShaderCompiler::set_cache_dir(cache_dir);
+
+	ShaderCompiler compiler;
+	initialize_compiler(compiler);
+	const String code = make_shader_code(2);
+
+	CompileResult compiled;
+	compiled.compile(compiler, code);
+	REQUIRE(compiled.error == OK);
+	CHECK(compiled.blend_mode == 1);
+	CHECK(compiled.unshaded);
+	CHECK(compiled.uses_alpha);
+	CHECK(compiled.uses_time);
+	CHECK(compiled.writes_vertex);
+	CHECK(compiled.uniforms.size() == 3);
+	CHECK(DirAccess::get_files_at(cache_dir).size() == 1);
+
+	SUBCASE("Unchanged shaders are read from the cache") {
+		CompileResult cached;
+		cached.compile(compiler, code);
+		check_same_result(compiled, cached);
+		CHECK(DirAccess::get_files_at(cache_dir).size() == 1);
+
+		// Another compiler set up the same way shares the cache, as on the next run.
+		ShaderCompiler other_compiler;
+		initialize_compiler(other_compiler);
+		CompileResult cached_other;
+		cached_other.compile(other_compiler, code);
+		check_same_result(compiled, cached_other);
+		CHECK(DirAccess::get_files_at(cache_dir).size() == 1);
+	}
+
+	SUBCASE("Changed shaders and compilers are compiled again") {
+		CompileResult changed;
+		changed.compile(compiler, make_shader_code(3));
+		CHECK(changed.error == OK);
+		CHECK(DirAccess::get_files_at(cache_dir).size() == 2);
+
+		ShaderCompiler other_compiler;
+		ShaderCompiler::DefaultIdentifierActions actions;
+		actions.base_uniform_string = "other.";
+		other_compiler.initialize(actions);
+		CompileResult other;
+		other.compile(other_compiler, code);
+		CHECK(other.error == OK);
+		CHECK(DirAccess::get_files_at(cache_dir).size() == 3);
+	}
+
+	SUBCASE("Failed compilations are not cached") {
+		ERR_PRINT_OFF;
+		CompileResult failed;
+		failed.compile(compiler, "shader_type spatial;\nvoid fragment() { ALBEDO = undefined_value; }\n");
+		ERR_PRINT_ON;
+		CHECK(failed.error != OK);
+		CHECK(DirAccess::get_files_at(cache_dir).size() == 1);
+	}
+
+	SUBCASE("Corrupt entries are compiled again without replaying anything") {
+		const String plain_code = "shader_type spatial;\nuniform float strength = 1.0;\nvoid fragment() { ALBEDO = vec3(strength); }\n";
+		CompileResult plain;
+		plain.compile(compiler, plain_code);
+		REQUIRE(plain.error == OK);
+		CHECK_FALSE(plain.unshaded);
+		CHECK_FALSE(plain.uses_alpha);
+
+		// Find the entry just written, which is the only one besides the first shader's.
+		String plain_path;
+		for (const String &file : DirAccess::get_files_at(cache_dir)) {
+			Ref<FileAccess> f = FileAccess::open(cache_dir.path_join(file), FileAccess::READ);
+			Dictionary entry = f->get_var();
+			if (Dictionary(entry["uniform_nodes"]).size() == 1) {
+				plain_path = cache_dir.path_join(file);
+			}
+		}
+		REQUIRE(!plain_path.is_empty());
+
+		// Flags that would be replayed come before the uniform that fails to load.
+		Dictionary entry = FileAccess::open(plain_path, FileAccess::READ)->get_var();
+		entry["render_modes"] = PackedStringArray{ "unshaded" };
+		entry["usage_flags"] = PackedStringArray{ "ALPHA" };
+		Dictionary uniform_nodes;
+		uniform_nodes["strength"] = Array();
+		entry["uniform_nodes"] = uniform_nodes;
+		FileAccess::open(plain_path, FileAccess::WRITE)->store_var(entry);
+
+		ERR_PRINT_OFF;
+		CompileResult recompiled;
+		recompiled.compile(compiler, plain_code);
+		ERR_PRINT_ON;
+		check_same_result(plain, recompiled);
+		CHECK_FALSE(recompiled.unshaded);
+		CHECK_FALSE(recompiled.uses_alpha);
+
+		// The entry was written again when compiling.
+		CompileResult cached;
+		cached.compile(compiler, plain_code);
+		check_same_result(plain, cached);
+
+		FileAccess::open(plain_path, FileAccess::WRITE)->store_var("not a cache entry");
+		CompileResult garbage;
+		garbage.compile(compiler, plain_code);
+		check_same_result(plain, garbage);
+	}
+
+	ShaderCompiler::set_cache_dir(String());
+}
+
+struct ConcurrentCompilation {
+	ShaderCompiler *compiler = nullptr;
+	Vector<String> codes;
+	LocalVector<CompileResult> results;
+
+	void compile(uint32_t p_index, void *p_userdata) {
+		results[p_index].compile(*compiler, codes[p_index]);
+	}
+};
+
+TEST_CASE("[SceneTree][ShaderCompiler] Concurrent compilation") {
+	ShaderCompiler compiler;
+	initialize_compiler(compiler);
+
+	ConcurrentCompilation concurrent;
+	concurrent.compiler = &compiler;
+	for (int i = 0; i < 32; i++) {
+		concurrent.codes.push_back(make_shader_code(i));
+	}
+	concurrent.results.resize(concurrent.codes.size());
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(&concurrent, &ConcurrentCompilation::compile, (void *)nullptr, concurrent.codes.size());
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (int i = 0; i < concurrent.codes.size(); i++) {
+		CompileResult sequential;
+		sequential.compile(compiler, concurrent.codes[i]);
+		check_same_result(sequential, concurrent.results[i]);
+	}
+}
+
+} // namespace TestShaderCompiler
+
+#endif // TEST_SHADER_COMPILER_H